@@ -0,0 +1,70 @@
+// 3D sprite budget example: 1024 sprites move in an area 4 times the screen, only the ones on screen are drawn,
+// and when the budget is low the least important ones are dropped
+
+// Includes
+#include <PA9.h>       // Include for PA_Lib
+
+#include "all_gfx.h"
+
+#define N_SPRITES 1024
+
+typedef struct{
+	s32 x, y, vx, vy;
+} spritepos;
+spritepos sprites[N_SPRITES];
+
+int main(void){
+	u16 gfx[3];
+	s32 i;
+	u16 angle;
+
+	PA_Init();    // Initializes PA_Lib
+
+	PA_Init3D(); // Uses Bg0
+	PA_Reset3DSprites();
+
+	PA_LoadDefaultText(1, 0);
+	PA_OutputSimpleText(1, 1, 8, "Hold A for a budget of 100");
+
+	gfx[0] = PA_3DCreateTex((void*)mollusk_Texture, 64, 64, TEX_16BITS);
+	gfx[1] = PA_3DCreateTex((void*)AnarX_Texture, 64, 64, TEX_16BITS);
+	gfx[2] = PA_3DCreateTex((void*)Abrexxes_Texture, 64, 64, TEX_16BITS);
+
+	for(i = 0; i < N_SPRITES; i++){
+		u8 type = PA_Rand()%3;
+
+		sprites[i].x = PA_Rand()%512 - 128;
+		sprites[i].y = PA_Rand()%384 - 96;
+		PA_3DCreateSpriteFromTex(i, gfx[type], 64, 64, 0, sprites[i].x, sprites[i].y);
+		PA_3DSetSpriteWidthHeight(i, 16, 16);
+
+		// The mollusks stay on screen whatever the budget
+		PA_3DSetSpriteImportance(i, (type == 0) ? 255 : type * 64);
+
+		angle = PA_Rand()&511;
+		sprites[i].vx = PA_Cos(angle)>>7;
+		sprites[i].vy = -PA_Sin(angle)>>7;
+	}
+
+	while(1){
+		for(i = 0; i < N_SPRITES; i++){ // Bounce on the edges of the area
+			sprites[i].x += sprites[i].vx;
+			if(((sprites[i].x <= -128)&&(sprites[i].vx < 0))||((sprites[i].x >= 383)&&(sprites[i].vx > 0))) sprites[i].vx = -sprites[i].vx;
+			sprites[i].y += sprites[i].vy;
+			if(((sprites[i].y <= -96)&&(sprites[i].vy < 0))||((sprites[i].y >= 287)&&(sprites[i].vy > 0))) sprites[i].vy = -sprites[i].vy;
+			PA_3DSetSpriteXY(i, sprites[i].x, sprites[i].y);
+		}
+
+		PA_3DSetBudget(Pad.Held.A ? 100 : PA_3D_MAXVERTICES / 4);
+
+		PA_OutputText(1, 1, 2, "Submitted : %d    ", PA_3DBudgetInfos.Submitted);
+		PA_OutputText(1, 1, 3, "Culled    : %d    ", PA_3DBudgetInfos.Culled);
+		PA_OutputText(1, 1, 4, "Dropped   : %d    ", PA_3DBudgetInfos.Dropped);
+		PA_OutputText(1, 1, 5, "Polygons  : %d, vertices : %d    ", PA_3DBudgetInfos.Polygons, PA_3DBudgetInfos.Vertices);
+
+		PA_WaitForVBL();
+		PA_3DProcess();  // Draws the sprites on screen, within the budget
+	}
+
+	return 0;
+}
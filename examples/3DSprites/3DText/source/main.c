@@ -0,0 +1,79 @@
+// 3D text example: a label above each of 128 moving 3D sprites, and damage numbers where the screen is touched,
+// all drawn by the 3D hardware with a single texture for the font
+
+// Includes
+#include <PA9.h>       // Include for PA_Lib
+
+#include "all_gfx.h"
+
+#define N_SPRITES 128
+#define N_HITS 16
+
+typedef struct{
+	s32 x, y, vx, vy;
+} spritepos;
+spritepos sprites[N_SPRITES];
+
+typedef struct{
+	s16 x, y, time, damage;
+} hit;
+hit hits[N_HITS];
+
+int main(void){
+	u16 gfx;
+	s32 i, nexthit = 0;
+	u16 angle;
+
+	PA_Init();    // Initializes PA_Lib
+
+	PA_Init3D(); // Uses Bg0
+	PA_Reset3DSprites();
+
+	// Font 0 for the labels, font 2 for the damage numbers, each with its own 3D palette
+	PA_3DLoadFont(0, 1);
+	PA_3DLoadFont(2, 2);
+
+	gfx = PA_3DCreateTex((void*)mollusk_Texture, 64, 64, TEX_16BITS);
+
+	for(i = 0; i < N_SPRITES; i++){
+		sprites[i].x = 16 + PA_Rand()%224;
+		sprites[i].y = 16 + PA_Rand()%160;
+		PA_3DCreateSpriteFromTex(i, gfx, 64, 64, 0, sprites[i].x, sprites[i].y);
+		PA_3DSetSpriteWidthHeight(i, 16, 16);
+		angle = PA_Rand()&511;
+		sprites[i].vx = PA_Cos(angle)>>8;
+		sprites[i].vy = -PA_Sin(angle)>>8;
+	}
+
+	while(1){
+		for(i = 0; i < N_SPRITES; i++){
+			sprites[i].x += sprites[i].vx;
+			if(((sprites[i].x <= 8)&&(sprites[i].vx < 0))||((sprites[i].x >= 255-8)&&(sprites[i].vx > 0))) sprites[i].vx = -sprites[i].vx;
+			sprites[i].y += sprites[i].vy;
+			if(((sprites[i].y <= 8)&&(sprites[i].vy < 0))||((sprites[i].y >= 191-8)&&(sprites[i].vy > 0))) sprites[i].vy = -sprites[i].vy;
+			PA_3DSetSpriteXY(i, sprites[i].x, sprites[i].y);
+
+			PA_3DText(0, sprites[i].x - 4, sprites[i].y - 16, PA_RGB(31, 31, 0), "%d", i);
+		}
+
+		if(Stylus.Newpress){
+			hits[nexthit].x = Stylus.X;
+			hits[nexthit].y = Stylus.Y;
+			hits[nexthit].time = 60;
+			hits[nexthit].damage = 1 + PA_Rand()%999;
+			nexthit = (nexthit + 1) % N_HITS;
+		}
+
+		for(i = 0; i < N_HITS; i++){ // Damage numbers go up and disappear after a second
+			if(hits[i].time == 0) continue;
+			hits[i].time--;
+			hits[i].y--;
+			PA_3DText(2, hits[i].x, hits[i].y, PA_RGB(31, 4, 4), "-%d", hits[i].damage);
+		}
+
+		PA_WaitForVBL();
+		PA_3DProcess();  // Draws the sprites, then the text
+	}
+
+	return 0;
+}
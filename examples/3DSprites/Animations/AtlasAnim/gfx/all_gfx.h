@@ -0,0 +1,19 @@
+// Graphics converted using PAGfx by Mollusk.
+
+#pragma once
+
+#include <PA_BgStruct.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+// Sprites:
+extern const unsigned char explosion_Texture[28672] _GFX_ALIGN; // Palette: explosion_Pal
+
+// Palettes:
+extern const unsigned short explosion_Pal[256] _GFX_ALIGN;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,51 @@
+/* Many animated 3D sprites sharing one texture : all the frames are packed in an atlas
+and copied to VRAM once, animations only change the part of the texture that is shown.
+Thanks to http://www.reinerstileset.4players.de:1059/englisch.htm and Arog for the sprite ;)
+*/
+
+// Includes
+#include <PA9.h>
+
+// PAGfxConverter Include
+#include "all_gfx.h"
+
+#define NSPRITES 48
+
+// Main function
+int main(void)	{
+	PA_3DAtlas *atlas;
+	s32 explosion;
+	int i;
+
+	// PAlib init
+	PA_Init();
+
+	PA_Init3D(); // Uses Bg0, Init 3D...
+	PA_Reset3DSprites(); // Init or Reset 3D Sprites
+
+	PA_LoadDefaultText(1, 0);
+
+	// Load the sprite palette
+	PA_Load3DSpritePal(0, (void*)explosion_Pal);
+
+	// The 7 frames of 64x64 fit in a 256x128 texture, 4 on each row
+	atlas = PA_3DAtlasCreate(256, 128, TEX_256COL);
+	explosion = PA_3DAtlasAdd(atlas, (void*)explosion_Texture, 64, 64, 7);
+	PA_3DAtlasLoad(atlas);
+
+	// A lot of sprites, all using the same texture, at different speeds
+	for(i = 0; i < NSPRITES; i ++){
+		PA_3DCreateSpriteFromAtlas(i, atlas, explosion, 0, 16 + (i & 7) * 32, 16 + (i >> 3) * 32);
+		PA_3DStartSpriteAnim(i, 0, 6, 5 + i);
+	}
+
+	PA_OutputText(1, 1, 1, "%d animated sprites, 1 texture", NSPRITES);
+
+	while(1)
+	{
+		PA_WaitForVBL();
+		PA_3DProcess(); // Update...
+	}
+
+	return 0;
+}
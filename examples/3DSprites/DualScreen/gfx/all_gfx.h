@@ -0,0 +1,18 @@
+// Graphics converted using PAGfx by Mollusk.
+
+#pragma once
+
+#include <PA_BgStruct.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+// Sprites:
+extern const unsigned char mollusk_Texture[4096] _GFX_ALIGN; // 16bit texture
+
+// Palettes:
+
+#ifdef __cplusplus
+}
+#endif
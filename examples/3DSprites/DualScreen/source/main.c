@@ -0,0 +1,44 @@
+// Dual screen 3D : sprites on both screens, the top one drawn once every 3 frames.
+// Move the sprite of the bottom screen with the stylus, hold A to draw the top screen more often.
+
+// Includes
+#include <PA9.h>       // Include for PA_Lib
+
+#include "all_gfx.h"
+
+int main(void){
+	u16 tex;
+	s32 angle = 0;
+
+	PA_Init();    // Initializes PA_Lib
+
+	// The top screen is drawn 1 frame out of 3, and the bottom one the 2 others
+	PA_Init3DDualEx(3);
+
+	// Text on the bottom screen, next to the 3D : it is captured with it and never blinks
+	PA_LoadDefaultText(0, 1);
+
+	tex = PA_3DCreateTex((void*)mollusk_Texture, 64, 64, TEX_16BITS);
+
+	// Y from 0 to 191 is the top screen, from PA_ScreenSpace the bottom one
+	PA_3DCreateSpriteFromTex(0, tex, 64, 64, 0, 128, 96);
+	PA_3DCreateSpriteFromTex(1, tex, 64, 64, 0, 128, PA_ScreenSpace + 96);
+
+	while(1) {
+		if(Stylus.Held) PA_3DSetSpriteXY(1, Stylus.X, PA_ScreenSpace + Stylus.Y);
+
+		angle += 4;
+		PA_3DSetSpriteRotateZ(0, angle);
+
+		if(Pad.Newpress.A) PA_3DDualSetRatio(2);
+		if(Pad.Released.A) PA_3DDualSetRatio(3);
+
+		PA_OutputText(0, 1, 1, "Top    : %d polygons, latency %d   ", PA_3DDualInfos.Polygons[PA_3DDUAL_SUB], PA_3DDualInfos.Latency[PA_3DDUAL_SUB]);
+		PA_OutputText(0, 1, 2, "Bottom : %d polygons, latency %d   ", PA_3DDualInfos.Polygons[PA_3DDUAL_MAIN], PA_3DDualInfos.Latency[PA_3DDUAL_MAIN]);
+
+		PA_WaitForVBL();
+		PA_3DProcess();  // Draws the screen of this frame
+	}
+
+	return 0;
+}
@@ -0,0 +1,57 @@
+// 3D particles example: a fountain follows the stylus, A throws 1000 sparks at once and B 4000,
+// and the time taken to move and draw them is shown
+
+// Includes
+#include <PA9.h>       // Include for PA_Lib
+
+#include "all_gfx.h"
+
+int main(void){
+	u16 tex;
+	s16 fountain, sparks;
+	u32 ticks = 0;
+
+	PA_Init();    // Initializes PA_Lib
+
+	PA_Init3D(); // Uses Bg0
+	PA_Reset3DSprites();
+
+	PA_LoadDefaultText(1, 0);
+
+	tex = PA_3DCreateTex((void*)mollusk_Texture, 64, 64, TEX_16BITS);
+
+	// Small blue drops going up and falling back, 4 per frame
+	fountain = PA_3DCreateEmitter(tex, 64, 64, 0, 128, 160);
+	PA_3DSetEmitterLook(fountain, 4, 4, PA_RGB(12, 20, 31), 1024);
+	PA_3DSetEmitterDirection(fountain, 128, 24, 3 << 8, 1 << 8);
+	PA_3DSetEmitterGravity(fountain, 0, 16);
+	PA_3DSetEmitterLife(fountain, 60, 30);
+	PA_3DSetEmitterRate(fountain, 4 << 8);
+
+	// Yellow sparks in every direction, only thrown by bursts
+	sparks = PA_3DCreateEmitter(tex, 64, 64, 0, 128, 96);
+	PA_3DSetEmitterLook(sparks, 2, 2, PA_RGB(31, 28, 8), 1100);
+	PA_3DSetEmitterDirection(sparks, 0, 256, 1 << 8, 2 << 8);
+	PA_3DSetEmitterGravity(sparks, 0, 4);
+	PA_3DSetEmitterLife(sparks, 40, 40);
+
+	while(1){
+		if(Stylus.Held) PA_3DSetEmitterXY(fountain, Stylus.X, Stylus.Y);
+		if(Pad.Newpress.A) PA_3DEmitterBurst(sparks, 1000);
+		if(Pad.Newpress.B) PA_3DEmitterBurst(sparks, 4000);
+
+		PA_OutputText(1, 1, 2, "Alive   : %d    ", PA_3DParticleInfos.Alive);
+		PA_OutputText(1, 1, 3, "Drawn   : %d    ", PA_3DParticleInfos.Drawn);
+		PA_OutputText(1, 1, 4, "Culled  : %d    ", PA_3DParticleInfos.Culled);
+		PA_OutputText(1, 1, 5, "Dropped : %d    ", PA_3DParticleInfos.Dropped);
+		PA_OutputText(1, 1, 7, "PA_3DProcess : %d us    ", ticks / 33);
+
+		PA_WaitForVBL();
+
+		cpuStartTiming(2); // 33 MHz ticks
+		PA_3DProcess();  // Moves the particles, then draws them with the sprites
+		ticks = cpuEndTiming();
+	}
+
+	return 0;
+}
@@ -0,0 +1,37 @@
+// Palette fades computed in RAM and uploaded once per VBL
+
+// Includes
+#include <PA9.h>       // Include for PA_Lib
+
+// Function: main()
+int main(){
+	s32 level = 0, speed = 1;
+	u16 color = PA_RGB(0, 0, 0);
+
+	PA_Init();    // PA Init...
+
+	PA_PalShadowInit(); // Palettes are now kept in RAM, before loading anything
+
+	PA_LoadDefaultText(0, 0); // Text on both screens
+	PA_LoadDefaultText(1, 0);
+
+	PA_OutputSimpleText(1, 1, 2, "This screen fades in and out");
+	PA_OutputText(1, 1, 4, "%c1Red %c2Green %c3Blue %c4Purple");
+	PA_OutputSimpleText(0, 1, 2, "Press A to fade to black");
+	PA_OutputSimpleText(0, 1, 3, "Press B to fade to white");
+
+	while(1)  {
+		if (Pad.Newpress.A) color = PA_RGB(0, 0, 0);
+		if (Pad.Newpress.B) color = PA_RGB(31, 31, 31);
+
+		level += speed;
+		if ((level == 0) || (level == 32)) speed = -speed;
+
+		// All the palettes of the top screen at once, uploaded at the next VBL
+		PA_PalShadowScreenFade(1, level, color);
+
+		PA_WaitForVBL();
+	}
+
+	return 0;
+}
@@ -0,0 +1,41 @@
+// Raster effects: a wave on the text and a gradient sky, both changed at each line
+
+// Includes
+#include <PA9.h>       // Include for PA_Lib
+
+u16 wave[192 + 1];  // Horizontal scroll of the text, for each line
+u16 sky[192 + 1];   // Backdrop color, for each line
+s32 phase = 0;
+
+// Called at each VBL, before the frame is drawn
+void MoveWave(void){
+	s32 i;
+	for (i = 0; i < 192; i++) wave[i] = (PA_Sin((i << 3) + phase) * 6) >> 8;
+}
+
+// Function: main()
+int main(){
+	s32 i;
+
+	PA_Init();    // PA Init...
+
+	PA_LoadDefaultText(0, 0); // Text on the bottom screen, background 0
+	PA_LoadDefaultText(1, 0);
+
+	for (i = 0; i < 20; i++) PA_OutputSimpleText(0, 4, i + 2, "Raster effects !");
+	PA_OutputSimpleText(1, 1, 2, "The backdrop gradient and the");
+	PA_OutputSimpleText(1, 1, 3, "wave are written by HBlank DMA");
+
+	// Dark blue to orange
+	for (i = 0; i < 192; i++) sky[i] = PA_RGB(i * 31 / 191, i * 16 / 191, 16 - i * 16 / 191);
+
+	PA_RasterAdd(&REG_BG0HOFS, wave, 2, MoveWave);
+	PA_RasterAdd(BG_PALETTE, sky, 2, NULL); // Color 0 is the backdrop
+
+	while(1)  {
+		phase += 8;
+		PA_WaitForVBL();
+	}
+
+	return 0;
+}
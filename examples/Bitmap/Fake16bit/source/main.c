@@ -27,7 +27,7 @@ int main()
 {
 	PA_Init();
 	PA_InitFake16bitBg(0, 3);
-	PA_InitFake16bitBg(1, 3);
+	PA_InitFake16bitBgEx(1, 3, 64); // 64 colors per line, the lines that change get new colors at the VBL
 	int oldx = 0, oldy = 0;
 	while(true)
 	{
@@ -0,0 +1,58 @@
+// Gif player example: several gifs decoded a little at each frame, the game keeps running
+
+// Includes
+#include <PA9.h>       // Include for PA_Lib
+
+#include "bartman.h" // gif to include
+
+// Function: main()
+int main(){
+	PA_GifPlayer *players[2];
+	s32 budget = 32;
+	u8 pause = 0;
+
+	PA_Init();    // PA Init...
+
+	PA_Init8bitBg(1, 3); 	// Init a 8 bit Bg on screen 1
+
+	PA_LoadDefaultText(0, 0); // Text on bottom screen
+
+	PA_OutputSimpleText(0, 1, 2, "Press Start to pause/unpause");
+	PA_OutputSimpleText(0, 1, 3, "Press Up/Down to change the");
+	PA_OutputSimpleText(0, 1, 4, "decoding time per frame");
+
+	// Two players on the same screen, they share the palette
+	players[0] = PA_GifPlayerOpenBg(1, 0, 0, bartman);
+	players[1] = PA_GifPlayerOpenBg(1, 128, 96, bartman);
+	PA_GifPlayerSpeed(players[1], 512); // Twice as fast
+
+	// The first one keeps its frames after the first loop, up to 256KB
+	PA_GifPlayerCache(players[0], 256*1024);
+
+	while(1)  {
+		s32 i;
+
+		if (Pad.Newpress.Start) {
+			pause = !pause;
+			for (i = 0; i < 2; i++) PA_GifPlayerPause(players[i], pause);
+		}
+
+		if (Pad.Newpress.Up) budget += 4;
+		if (Pad.Newpress.Down && (budget > 4)) budget -= 4;
+
+		for (i = 0; i < 2; i++) {
+			PA_GifPlayerBudget(players[i], budget);
+			PA_GifPlayerStep(players[i]);
+		}
+
+		PA_OutputText(0, 1, 7, "Budget : %d lines   ", budget);
+		PA_OutputText(0, 1, 9, "Gif 1 : frame %d, %d lines %s  ", players[0]->Frame, PA_GifPlayerDecodeTime(players[0]),
+		              PA_GifPlayerCached(players[0]) ? "cached" : "");
+		PA_OutputText(0, 1, 10, "Gif 2 : frame %d, %d lines   ", players[1]->Frame, PA_GifPlayerDecodeTime(players[1]));
+
+		// Sprites, input... would be handled here as usual
+		PA_WaitForVBL();
+	}
+
+	return 0;
+} // End of main()
@@ -0,0 +1,54 @@
+// Gif recording example: draw with the stylus, the drawing is recorded to a gif on the card
+
+// Includes
+#include <PA9.h>       // Include for PA_Lib
+#include <fat.h>
+
+// Function: main()
+int main(){
+	PA_GifRecorder *rec = NULL;
+	u8 octree = 0;
+
+	PA_Init();    // PA Init...
+
+	PA_LoadDefaultText(1, 0); // Text on top screen
+	PA_Init16bitBg(0, 3); 	// Init a 16 bit Bg on screen 0, to draw on
+
+	PA_WaitForVBL();  PA_WaitForVBL();  PA_WaitForVBL();  // wait a few VBLs
+
+	if (!fatInitDefault()) { //Initialise fat library
+		PA_OutputSimpleText(1, 1, 1, "Can't initialize FAT");
+		while (1)
+			PA_WaitForVBL();
+	}
+
+	PA_OutputSimpleText(1, 1, 1, "Draw on the bottom screen");
+	PA_OutputSimpleText(1, 1, 3, "Press A to start/stop recording");
+	PA_OutputSimpleText(1, 1, 4, "Press B to change the palette");
+
+	while(1)  {
+		if (Pad.Newpress.A) {
+			if (rec) { // Stop, the gif is ready
+				PA_GifRecordStop(rec);
+				rec = NULL;
+			} else {
+				rec = PA_GifRecordStart("record.gif", PA_GIFREC_BG, 0, octree ? PA_GIFREC_OCTREE : PA_GIFREC_FIXED);
+				if (rec == NULL) PA_OutputSimpleText(1, 1, 10, "Can't create record.gif");
+			}
+		}
+
+		if (Pad.Newpress.B && (rec == NULL)) octree = !octree;
+
+		PA_16bitDraw(0, PA_RGB((PA_VBLCount >> 2) & 31, 31 - ((PA_VBLCount >> 3) & 31), 16)); // Color changes with time
+
+		if (rec) PA_GifRecordStep(rec); // Grabs and encodes a little, once per frame
+
+		PA_OutputText(1, 1, 6, "Recording : %s  ", rec ? "yes" : "no");
+		PA_OutputText(1, 1, 7, "Palette   : %s  ", octree ? "octree" : "fixed");
+		PA_OutputText(1, 1, 8, "Frames    : %d    ", rec ? PA_GifRecordFrames(rec) : 0);
+
+		PA_WaitForVBL();
+	}
+
+	return 0;
+}
@@ -0,0 +1,53 @@
+// Fixed point math example: a ring of points turns and follows the stylus, each point knows its angle and distance to it
+
+// Includes
+#include <PA9.h>       // Include for PA_Lib
+
+#define POINTS 64
+
+int main(void){
+	PA_Point ring[POINTS], shown[POINTS];
+	u16 angles[POINTS];
+	u32 dists[POINTS];
+	PA_Transform2 t;
+	s32 i, angle = 0;
+
+	PA_Init();    // PA Init...
+
+	PA_LoadDefaultText(1, 0);
+	PA_Init16bitBg(0, 3);
+
+	// A ring of radius 40, computed once
+	for (i = 0; i < POINTS; i++) {
+		ring[i].x = (40 * PA_CosF(i * PA_ANGLE_TURN / POINTS)) >> PA_FIXED_PRECISION;
+		ring[i].y = (40 * PA_SinF(i * PA_ANGLE_TURN / POINTS)) >> PA_FIXED_PRECISION;
+	}
+
+	while(1)  {
+		angle += 16; // A 256th of a turn each frame
+
+		// Turn, grow and shrink, and center on the stylus, all the points at once
+		PA_Transform2RotScale(&t, angle, PA_FIXED_ONE + (PA_SinF(angle * 3) >> 2), Stylus.X, Stylus.Y);
+		PA_TransformPoints(&t, ring, shown, POINTS);
+
+		// Angle and distance from each point to the center of the screen
+		PA_PointsAngle(shown, POINTS, 128, 96, angles);
+		PA_PointsDistance(shown, POINTS, 128, 96, dists);
+
+		PA_Clear16bitBg(0);
+
+		for (i = 0; i < POINTS; i++) {
+			if ((shown[i].x >= 0) && (shown[i].x < 256) && (shown[i].y >= 0) && (shown[i].y < 192))
+				PA_Put16bitPixel(0, shown[i].x, shown[i].y, PA_RGB(31, 31, 31));
+		}
+
+		PA_OutputText(1, 1, 2, "Point 0 angle    : %d    ", angles[0]);
+		PA_OutputText(1, 1, 3, "Point 0 distance : %d    ", dists[0]);
+		PA_OutputText(1, 1, 5, "Stylus angle     : %d    ", PA_Atan2F(Stylus.Y - 96, Stylus.X - 128));
+		PA_OutputText(1, 1, 6, "Stylus distance  : %d    ", PA_LengthF(Stylus.X - 128, Stylus.Y - 96));
+
+		PA_WaitForVBL();
+	}
+
+	return 0;
+}
@@ -0,0 +1,77 @@
+// Flow field example: touch the bottom screen to send the units there, hold A to draw walls
+
+// Includes
+#include <PA9.h>       // Include for PA_Lib
+
+#define WIDTH  32 // One cell per letter of the text
+#define HEIGHT 24
+#define UNITS  24
+
+typedef struct {
+	u16 x, y;
+} Unit;
+
+int main(void){
+	PA_PathGrid *grid;
+	PA_PathField *field;
+	Unit units[UNITS];
+	s32 i, x, y;
+
+	PA_Init();    // PA Init...
+
+	PA_LoadDefaultText(1, 0);
+	PA_LoadDefaultText(0, 0);
+
+	grid = PA_PathCreate(WIDTH, HEIGHT, 1); // 8 directions
+	field = PA_PathFieldCreate(grid);
+
+	// A few walls
+	for (y = 4; y < 20; y++) PA_PathSetCost(grid, 10, y, PA_PATH_WALL);
+	for (x = 14; x < 28; x++) PA_PathSetCost(grid, x, 12, PA_PATH_WALL);
+
+	for (i = 0; i < UNITS; i++) {
+		units[i].x = i;
+		units[i].y = 0;
+	}
+
+	PA_PathFieldStart(field, 20, 20);
+
+	PA_OutputSimpleText(1, 1, 1, "Touch the screen to send");
+	PA_OutputSimpleText(1, 1, 2, "the units, hold A to draw walls");
+
+	while(1)  {
+		if (Stylus.Held) {
+			x = Stylus.X >> 3;
+			y = Stylus.Y >> 3;
+
+			if (Pad.Held.A) {
+				PA_PathSetCost(grid, x, y, PA_PATH_WALL);
+			}
+
+			// The field is computed again, a little at each frame
+			PA_PathFieldStart(field, x, y);
+		}
+
+		PA_PathFieldStep(field, 256);
+
+		for (y = 0; y < HEIGHT; y++)
+			for (x = 0; x < WIDTH; x++)
+				PA_OutputSimpleText(0, x, y, (PA_PathGetCost(grid, x, y) == PA_PATH_WALL) ? "#" : " ");
+
+		// Every unit reads its direction from the same field, 8 times a second
+		for (i = 0; i < UNITS; i++) {
+			u8 dir = PA_PathFieldDir(field, units[i].x, units[i].y);
+
+			if ((dir != PA_PATH_NODIR) && ((PA_VBLCount & 7) == 0)) {
+				units[i].x += PA_PathDX[dir];
+				units[i].y += PA_PathDY[dir];
+			}
+
+			PA_OutputSimpleText(0, units[i].x, units[i].y, "o");
+		}
+
+		PA_WaitForVBL();
+	}
+
+	return 0;
+}
@@ -0,0 +1,68 @@
+// Profiler example : sprites, text and some made-up game code, with the share of the frame
+// each one takes shown as bars. Up and Down change the game code's work, A sends the
+// trace to the no$gba debug window, to open in chrome://tracing or Perfetto.
+
+// Includes
+#include <PA9.h>
+
+// PAGfxConverter Include
+#include "all_gfx.h"
+
+#define NSPRITES 64
+
+// Stands for the game's code, a zone of its own with a zone inside
+static u32 Game(u32 work) {
+	u32 i, sum = 0;
+
+	PA_PROFILE_BEGIN("Game");
+	for (i = 0; i < work; i++) sum += PA_Rand() & 0xFF;
+
+	PA_PROFILE_BEGIN("AI");
+	for (i = 0; i < work / 2; i++) sum ^= PA_Rand();
+	PA_ProfileEnd();
+
+	PA_ProfileEnd();
+	return sum;
+}
+
+static void Output(const char *line) {
+	nocashMessage(line);
+	nocashMessage("\n");
+}
+
+// Main function
+int main(void)	{
+	u32 work = 2000;
+	int i;
+
+	// PAlib init
+	PA_Init();
+
+	PA_LoadDefaultText(0, 0);
+	PA_LoadDefaultText(1, 0);
+
+	// Timers 0 and 1, the last 1024 starts and ends kept
+	PA_ProfileStart(0, 1024);
+
+	PA_LoadSpritePal(0, 0, (void*)sprite0_Pal);
+	for(i = 0; i < NSPRITES; i++){
+		PA_CreateSprite(0, i, (void*)som_Sprite, OBJ_SIZE_16X32, 1, 0, (i % 16) * 16, (i / 16) * 32);
+		PA_StartSpriteAnim(0, i, 0, 11, 4 + (i & 15));
+	}
+
+	while(1)
+	{
+		if(Pad.Held.Up) work += 100;
+		if(Pad.Held.Down && (work > 100)) work -= 100;
+		if(Pad.Newpress.A) PA_ProfileDump(Output);
+
+		Game(work);
+
+		PA_OutputText(1, 0, 0, "Work : %d   ", work);
+		PA_ProfileShowBars(1, 2);
+
+		PA_WaitForVBL();
+	}
+
+	return 0;
+}
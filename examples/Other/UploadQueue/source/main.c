@@ -0,0 +1,49 @@
+// Upload queue example : many animated sprites, their frames are copied during the VBL
+// within a budget. Press A and B to change the budget and see the copies wait.
+
+// Includes
+#include <PA9.h>
+
+// PAGfxConverter Include
+#include "all_gfx.h"
+
+#define NSPRITES 96
+
+// Main function
+int main(void)	{
+	u32 budget = PA_UPLOAD_BUDGET;
+	int i;
+
+	// PAlib init
+	PA_Init();
+
+	PA_LoadDefaultText(1, 0);
+
+	// Copies to VRAM now wait for the VBL
+	PA_UploadInit(budget);
+
+	PA_LoadSpritePal(0, 0, (void*)sprite0_Pal);
+
+	// Each sprite has its own gfx, so each frame change is a copy
+	for(i = 0; i < NSPRITES; i++){
+		PA_CreateSprite(0, i, (void*)som_Sprite, OBJ_SIZE_16X32, 1, 0, (i % 16) * 16, (i / 16) * 32);
+		PA_StartSpriteAnim(0, i, 0, 11, 4 + (i & 15));
+	}
+
+	while(1)
+	{
+		if(Pad.Newpress.A) budget += 1024;
+		if(Pad.Newpress.B && (budget > 1024)) budget -= 1024;
+		PA_UploadSetBudget(budget);
+
+		PA_OutputText(1, 1, 1, "Budget   : %d bytes   ", budget);
+		PA_OutputText(1, 1, 3, "Queued   : %d bytes   ", PA_UploadCounters.Queued);
+		PA_OutputText(1, 1, 4, "Uploaded : %d bytes   ", PA_UploadCounters.Uploaded);
+		PA_OutputText(1, 1, 5, "Deferred : %d bytes   ", PA_UploadCounters.Deferred);
+		PA_OutputText(1, 1, 6, "Copies   : %d, merged %d   ", PA_UploadCounters.Copies, PA_UploadCounters.Merged);
+
+		PA_WaitForVBL();
+	}
+
+	return 0;
+}
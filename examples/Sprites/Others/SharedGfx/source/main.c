@@ -0,0 +1,67 @@
+/* With PA_SetGfxDedup, PA_CreateSprite doesn't copy the same image twice :
+sprites created from the same data share their gfx in VRAM, and one of them
+gets its own copy only when it is animated or drawn on. With
+PA_GFXDEDUP_CONTENT, images copied in other buffers are found too, from their
+pixels.
+*/
+
+// Includes
+#include <PA9.h>
+
+// PAGfx Include
+#include "all_gfx.h"
+
+// VRAM left for the sprites of a screen, in 128 byte blocks
+u16 FreeBlocks(u8 screen){
+	u16 i, blocks = 0;
+	for (i = 0; i < n_free_mem[screen]; i++) blocks += free_mem[screen][i].free;
+	return blocks;
+}
+
+// Main function
+int main(void){
+	// PAlib init
+	PA_Init();
+	PA_LoadDefaultText(1, 0);
+
+	PA_LoadSpritePal(0, 0, (void*)sprite0_Pal);
+
+	// The same image, copied in RAM : another pointer, but the same pixels
+	u8 *copy = (u8*)malloc(sizeof(vaisseau_Sprite));
+	memcpy(copy, vaisseau_Sprite, sizeof(vaisseau_Sprite));
+
+	PA_SetGfxDedup(PA_GFXDEDUP_CONTENT);
+
+	PA_OutputSimpleText(1, 0, 8, "A : sprite from the image");
+	PA_OutputSimpleText(1, 0, 9, "B : sprite from its copy");
+	PA_OutputSimpleText(1, 0, 10, "Touch a sprite to draw on it");
+
+	u8 nsprites = 0;
+
+	// Infinite loop
+	while(1)
+	{
+		if ((Pad.Newpress.A || Pad.Newpress.B) && (nsprites < 128)) {
+			PA_CreateSprite(0, nsprites, Pad.Newpress.A ? (void*)vaisseau_Sprite : (void*)copy, OBJ_SIZE_32X32, 1, 0, PA_Rand()%224, PA_Rand()%160);
+			++nsprites;
+		}
+
+		// Drawing on a sprite gives it its own gfx first, the others don't change
+		if (Stylus.Held) {
+			u8 i;
+			for (i = 0; i < nsprites; i++) {
+				if (PA_SpriteTouched(i)) {
+					PA_InitSpriteDraw(0, i);
+					PA_SetSpritePixel(0, i, Stylus.X - PA_GetSpriteX(0, i), Stylus.Y - PA_GetSpriteY(0, i), 1);
+					break;
+				}
+			}
+		}
+
+		PA_OutputText(1, 0, 12, "Sprites : %d   ", nsprites);
+		PA_OutputText(1, 0, 13, "Free VRAM : %d bytes     ", FreeBlocks(0) << 7);
+
+		PA_WaitForVBL();
+	}
+	return 0;
+}
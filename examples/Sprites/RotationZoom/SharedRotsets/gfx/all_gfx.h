@@ -0,0 +1,19 @@
+// Graphics converted using PAGfx by Mollusk.
+
+#pragma once
+
+#include <PA_BgStruct.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+// Sprites:
+extern const unsigned char vaisseau_Sprite[1024] _GFX_ALIGN; // Palette: sprite0_Pal
+
+// Palettes:
+extern const unsigned short sprite0_Pal[256] _GFX_ALIGN;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,49 @@
+/* Only 32 rotsets per screen, but 128 turning sprites : PA_SetSpriteRotZoom
+gives the sprites with the same angle and zoom the same rotset, and each matrix
+is computed once per frame. Here the sprites turn at 16 different angles, and
+the palette is loaded through PA_AllocSpritePal, which would give the same slot
+to every sprite loading those colors.
+*/
+
+// Includes
+#include <PA9.h>
+
+// PAGfx Include
+#include "all_gfx.h"
+
+// Main function
+int main(void){
+	// PAlib init
+	PA_Init();
+	PA_LoadDefaultText(1, 0);
+
+	s8 pal = PA_AllocSpritePal(0, (void*)sprite0_Pal);
+
+	u8 i;
+	for (i = 0; i < 128; i++) {
+		PA_CreateSprite(0, i, (void*)vaisseau_Sprite, OBJ_SIZE_32X32, 1, pal, (i & 15) * 15, (i >> 4) * 20);
+	}
+
+	u16 angle = 0;
+	u16 zoom = 256;
+
+	// Infinite loop
+	while(1)
+	{
+		zoom -= Pad.Held.Up - Pad.Held.Down;
+		angle = (angle + 2) & 511;
+
+		u8 used = 0;
+		for (i = 0; i < 128; i++) {
+			// 16 angles, 32 apart
+			PA_SetSpriteRotZoom(0, i, angle + ((i & 15) << 5), zoom, zoom);
+		}
+		for (i = 0; i < 32; i++) used += (pa_rotsetrefs[0][i] > 0);
+
+		PA_OutputText(1, 0, 10, "Turning sprites : 128");
+		PA_OutputText(1, 0, 11, "Rotsets used : %d  ", used);
+
+		PA_WaitForVBL();
+	}
+	return 0;
+}
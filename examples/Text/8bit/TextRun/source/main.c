@@ -0,0 +1,58 @@
+// This example compares PA_8bitText with text runs, which keep the text layout
+// and only draw the letters again when the text changes. The top screen shows
+// how many letters each method can draw in one frame.
+
+// Includes
+#include <PA9.h>       // Include for PA_Lib
+
+#define FRAME_TICKS 560190 // Bus clock ticks in one frame
+
+const char benchtext[] = "The quick brown fox jumps over the lazy dog 0123456789";
+
+// Function: main()
+int main()
+{
+	PA_Init();    // Initializes PA_Lib
+
+	PA_LoadDefaultText(1, 0);
+
+	PA_SetBgPalCol(0, 1, PA_RGB(31, 31, 31));
+	PA_SetBgPalCol(0, 2, PA_RGB(31, 31, 0));
+	PA_Init8bitBg(0, 3);
+
+	// A text run keeps its own copy of the layout
+	PA_TextRun bench, clock;
+	PA_InitTextRun(&bench, PA_TEXTRUN_8BIT, 0, 0, 100, 255, 159, 2, 2, 0);
+	PA_SetTextRun(&bench, benchtext);
+	PA_InitTextRun(&clock, PA_TEXTRUN_8BIT, 0, 0, 170, 255, 191, 1, 2, 0);
+
+	char counter[32];
+	u32 frame = 0;
+
+	// Infinite loop to keep the program running
+	while (1)
+	{
+		// Old way: layout and draw every letter
+		cpuStartTiming(0);
+		s32 n = PA_8bitText(0, 0, 0, 255, 95, benchtext, 1, 2, 0, 100000);
+		u32 ticks = cpuEndTiming();
+		PA_OutputText(1, 0, 0, "PA_8bitText: %d letters/frame   ", (s32)((n * (u64)FRAME_TICKS) / ticks));
+
+		// Text run, forced to be drawn again from the glyph cache
+		PA_RedrawTextRun(&bench);
+		cpuStartTiming(0);
+		n = PA_DrawTextRun(&bench);
+		ticks = cpuEndTiming();
+		PA_OutputText(1, 0, 2, "Text run: %d letters/frame   ", (s32)((n * (u64)FRAME_TICKS) / ticks));
+
+		// Most of the time this text doesn't change and nothing is drawn
+		sprintf(counter, "%ld seconds", frame / 60);
+		PA_SetTextRun(&clock, counter);
+		PA_DrawTextRun(&clock);
+
+		frame++;
+		PA_WaitForVBL();
+	}
+
+	return 0;
+} // End of main()
@@ -0,0 +1,65 @@
+// This example shows the formatting commands of the text functions, and
+// compares PA_Format with the standard snprintf: the top screen shows how many
+// characters each one formats in a millisecond.
+
+// Includes
+#include <PA9.h>       // Include for PA_Lib
+#include <stdio.h>
+
+#define MS_TICKS 33514 // Bus clock ticks in one millisecond
+#define LOOPS 200
+
+// Function: main()
+int main()
+{
+	PA_Init();    // Initializes PA_Lib
+
+	PA_LoadDefaultText(0, 0);
+	PA_LoadDefaultText(1, 0);
+
+	char buffer[64];
+	s32 i, n;
+	u32 ticks;
+	s32 angle = 0;
+
+	// Infinite loop to keep the program running
+	while (1)
+	{
+		// A typical HUD line, formatted LOOPS times
+		cpuStartTiming(0);
+		for (i = 0, n = 0; i < LOOPS; i++) n += PA_Format(buffer, sizeof(buffer), "Score %06d Lives %2d Pos %x", i * 37, i & 7, i);
+		ticks = cpuEndTiming();
+		PA_OutputText(1, 0, 0, "PA_Format: %d chars/ms   ", (s32)((n * (u64)MS_TICKS) / ticks));
+
+		cpuStartTiming(0);
+		for (i = 0, n = 0; i < LOOPS; i++) n += snprintf(buffer, sizeof(buffer), "Score %06d Lives %2d Pos %x", i * 37, i & 7, i);
+		ticks = cpuEndTiming();
+		PA_OutputText(1, 0, 1, "snprintf:  %d chars/ms   ", (s32)((n * (u64)MS_TICKS) / ticks));
+
+		// Same with a float
+		cpuStartTiming(0);
+		for (i = 0, n = 0; i < LOOPS; i++) n += PA_Format(buffer, sizeof(buffer), "Speed %.2f", i * 0.37);
+		ticks = cpuEndTiming();
+		PA_OutputText(1, 0, 3, "PA_Format %%f: %d chars/ms   ", (s32)((n * (u64)MS_TICKS) / ticks));
+
+		cpuStartTiming(0);
+		for (i = 0, n = 0; i < LOOPS; i++) n += snprintf(buffer, sizeof(buffer), "Speed %.2f", i * 0.37);
+		ticks = cpuEndTiming();
+		PA_OutputText(1, 0, 4, "snprintf %%f:  %d chars/ms   ", (s32)((n * (u64)MS_TICKS) / ticks));
+
+		// What the commands look like
+		PA_OutputText(0, 0, 0, "%%d   : %d      ", -1234);
+		PA_OutputText(0, 0, 1, "%%05d : %05d", 42);
+		PA_OutputText(0, 0, 2, "%%-5d|: %-5d|", 42);
+		PA_OutputText(0, 0, 3, "%%x   : %x", 0xBEEF);
+		PA_OutputText(0, 0, 4, "%%f3  : %f3", 3.14159);
+		PA_OutputText(0, 0, 5, "%%q   : %q      ", PA_Cos(angle)); // Fixed point, 8 bits after the point
+		PA_OutputText(0, 0, 6, "%%s   : %8s", "right");
+		PA_OutputText(0, 0, 7, "%%c   : %c1red %c2green %c0white");
+
+		angle = (angle + 1) & 511;
+		PA_WaitForVBL();
+	}
+
+	return 0;
+} // End of main()
@@ -11,6 +11,7 @@
 	\section core_lib Core library
 	- \ref General "General functions"
 	- \ref Debug "Debugging utilities"
+	- \ref Profile "Frame profiler"
 	- \ref Math "Math functions"
 	- \ref cxx "C++ wrappers"
 
@@ -19,18 +20,23 @@
 	- \ref BgRot "Rotating background functions"
 	- \ref TileDual "Dual background functions"
 	- \ref Text "Text system"
+	- \ref Format "Text formatting"
 	- \ref Mode7 "Mode 7 functions"
 
 	\section bmp_section Bitmapped backgrounds
 	- \ref Bitmap "Bitmapped background functions"
 	- \ref c16 "16-color bitmapped background functions"
 	- \ref Fake16bit "Fake 16-bit background functions"
+	- \ref TextRun "Text runs"
+	- \ref FontAtlas "Font atlases"
 	- \ref Gif "GIF functions"
 
 	\section spr_section Sprites
 	- \ref Sprite "Sprite functions"
 	- \ref SpriteDual "Dual sprite functions"
 	- \ref f3DSprites "3D Sprite functions"
+	- \ref f3DText "3D text"
+	- \ref f3DParticles "3D particles"
 
 	\section pal_section Palettes
 	- \ref Palette "Palette functions"
@@ -48,6 +54,7 @@
 
 	\section misc_section Misc.
 	- \ref SpecialFx "Special effects"
+	- \ref Upload "VRAM upload queue"
 
 	\example Text/Normal/HelloWorld/source/main.c
 	\example Backgrounds/Effects/Mode7/source/main.c
@@ -73,9 +80,14 @@ extern "C"{
 #include "arm9/jpeg.h"
 
 #include "arm9/PA_Assert.h"
+#include "arm9/PA_Profile.h"
 #include "arm9/PA_General.h"
+#include "arm9/PA_Format.h"
+#include "arm9/PA_Upload.h"
 #include "arm9/PA_Text.h"
 #include "arm9/PA_TextBits.h"
+#include "arm9/PA_TextRun.h"
+#include "arm9/PA_FontAtlas.h"
 #include "arm9/PA_BgTiles.h"
 #include "arm9/PA_BgLargeMap.h"
 #include "arm9/PA_Sprite.h"
@@ -84,24 +96,31 @@ extern "C"{
 #include "arm9/PA_Micro.h"
 #include "arm9/PA_Draw.h"
 #include "arm9/PA_Interrupt.h"
+#include "arm9/PA_Raster.h"
 #include "arm9/PA_Keys.h"
 #include "arm9/PA_Motion.h"
 #include "arm9/PA_BgRot.h"
 #include "arm9/PA_Timer.h"
 #include "arm9/PA_Math.h"
+#include "arm9/PA_Fixed.h"
 #include "arm9/PA_Palette.h"
 #include "arm9/PA_PaletteDual.h"
+#include "arm9/PA_PaletteShadow.h"
 #include "arm9/PA_SpecialFx.h"
 #include "arm9/PA_TileDual.h"
 #include "arm9/PA_Keyboard.h"
 #include "arm9/PA_Window.h"
 #include "arm9/PA_Mode7.h"
 #include "arm9/PA_3DSprites.h"
+#include "arm9/PA_3DText.h"
+#include "arm9/PA_3DParticles.h"
 #include "arm9/PA_IA.h"
+#include "arm9/PA_Path.h"
 #include "arm9/PA_Reco.h"
 #include "arm9/PA_16c.h"
 #include "arm9/PA_Wifi.h"
 #include "arm9/PA_Gif.h"
+#include "arm9/PA_GifRecord.h"
 #include "arm9/PA_BgTrans.h"
 #include "arm9/PA_KeysSpecial.h"
 #include "arm9/PA_Fake16bit.h"
@@ -175,6 +175,16 @@ static inline void PA_InitComplete16c(u8 bg, void *Palette){
 */
 s16 PA_16cText(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, const char* text, u8 color, u8 size, s32 limit);
 
+/*! \fn s16 PA_16cTextf(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, u8 color, u8 size, s32 limit, const char* text, ...)
+    \brief
+         \~english Same as PA_16cText, but the text is formatted like printf (see PA_VFormat). The text comes last, followed by its arguments. Color codes are ignored.
+         \~french Comme PA_16cText, mais le texte est formaté comme printf (voir PA_VFormat). Le texte vient en dernier, suivi de ses arguments. Les codes couleur sont ignorés.
+    \~\param text
+         \~english Text, such as "Score: %d"
+         \~french Texte, tel que "Score : %d"
+*/
+s16 PA_16cTextf(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, u8 color, u8 size, s32 limit, const char* text, ...);
+
 /*! \def PA_16cCustomFont(c16_slot, c16_font)
 	\deprecated
     \brief
@@ -193,6 +203,7 @@ s16 PA_16cText(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, const char*
 	c16_tiles[c16_slot] = (u32*)(void*)c16_font##_Tiles;\
 	pa_bittextdefaultsize[c16_slot] = (u8*)c16_font##_Sizes;\
 	pa_bittextpoliceheight[c16_slot] = c16_font##_Height;\
+	PA_ResetGlyphCache(c16_slot);\
 }while(0)
 
 
@@ -0,0 +1,247 @@
+#ifndef _PA_3DPARTICLES
+#define _PA_3DPARTICLES
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \file PA_3DParticles.h
+    \brief Thousands of small 3D quads thrown by emitters
+
+    Particles are not 3D sprites : they have no rotation nor zoom, so they
+    are kept in one array per field (positions, speeds, lives...) and moved
+    in fixed point in a single loop. They are drawn by PA_3DProcess after the
+    sprites, emitter by emitter with the texture set once, each particle a
+    quad with its corners already computed, without any matrix.
+*/
+
+#include "PA9.h"
+
+#define PA_3DPARTICLES_MAX 4096 // Particles alive at once
+#define PA_3DEMITTERS_MAX 32
+
+/// A source of particles, all with the same image
+typedef struct{
+	u8 Alive;
+	s16 Texture;
+	u8 Palette;
+	u16 Width, Height;   // Image in the texture
+	u16 SizeX, SizeY;    // Size on screen
+	u16 Color, Priority; // Vertex color (white keeps the texture colors), priority like the sprites
+	s32 X, Y;            // Position, .8 fixed point
+	u16 Rate, Accum;     // Particles thrown each frame, .8 fixed point
+	s16 Angle, Spread;   // Direction, 512 for a full turn like PA_Cos, and random added on each side
+	s32 Speed, SpeedRand;// Pixels per frame, .8 fixed point
+	s32 GravityX, GravityY; // Added to the speed each frame, .8 fixed point
+	u16 Life, LifeRand;  // Frames
+	u16 NParticles;      // Particles of this emitter alive
+}PA_3DEmitter;
+extern PA_3DEmitter pa_3demitters[PA_3DEMITTERS_MAX];
+
+/// What the particles did in the last frame
+typedef struct{
+	u16 Alive;   // Particles alive
+	u16 Drawn;   // Sent to the 3D hardware
+	u16 Culled;  // Off screen
+	u16 Dropped; // On screen, but over the polygon budget
+}PA_3DParticleInfo;
+extern PA_3DParticleInfo PA_3DParticleInfos;
+
+// Moves the particles and throws new ones, called by PA_3DProcess
+void PA_3DUpdateParticles(void);
+// Draws the particles, budget quads at most, called by PA_3DProcess. Returns the quads drawn.
+u16 PA_3DDrawParticles(s16 ydecal, u16 budget);
+
+/** @defgroup f3DParticles 3D particles
+ *  Thousands of small 3D quads thrown by emitters
+ *  @{
+ */
+
+/*! \fn void PA_3DResetParticles(void)
+    \brief
+         \~english Delete all the emitters and particles
+         \~french Efface tous les émetteurs et particules
+*/
+void PA_3DResetParticles(void);
+
+/*! \fn s16 PA_3DCreateEmitter(u16 texture, u16 width, u16 height, u8 palette, s16 x, s16 y)
+    \brief
+         \~english Create a particle emitter, which throws nothing until PA_3DSetEmitterRate or PA_3DEmitterBurst. Particles go up at 1 pixel per frame and live 60 frames by default. Returns the emitter number, or -1 if they are all used.
+         \~french Crée un émetteur de particules, qui ne lance rien avant PA_3DSetEmitterRate ou PA_3DEmitterBurst. Les particules montent à 1 pixel par frame et vivent 60 frames par défaut. Renvoie le numéro de l'émetteur, ou -1 s'ils sont tous utilisés.
+    \~\param texture
+         \~english Texture, from PA_3DCreateTex
+         \~french Texture, de PA_3DCreateTex
+    \~\param width
+         \~english Width of the image
+         \~french Largeur de l'image
+    \~\param height
+         \~english Height of the image
+         \~french Hauteur de l'image
+    \~\param palette
+         \~english 3D palette slot
+         \~french Emplacement de palette 3D
+    \~\param x
+         \~english X position
+         \~french Position X
+    \~\param y
+         \~english Y position, like for the 3D sprites
+         \~french Position Y, comme pour les sprites 3D
+*/
+s16 PA_3DCreateEmitter(u16 texture, u16 width, u16 height, u8 palette, s16 x, s16 y);
+
+/*! \fn void PA_3DDeleteEmitter(u8 emitter)
+    \brief
+         \~english Delete an emitter and all its particles
+         \~french Efface un émetteur et toutes ses particules
+    \~\param emitter
+         \~english Emitter number
+         \~french Numéro de l'émetteur
+*/
+void PA_3DDeleteEmitter(u8 emitter);
+
+/*! \fn void PA_3DEmitterBurst(u8 emitter, u16 n)
+    \brief
+         \~english Throw particles right now, for example for an explosion. Stops at PA_3DPARTICLES_MAX particles alive.
+         \~french Lance des particules tout de suite, par exemple pour une explosion. S'arrête à PA_3DPARTICLES_MAX particules en vie.
+    \~\param emitter
+         \~english Emitter number
+         \~french Numéro de l'émetteur
+    \~\param n
+         \~english Number of particles
+         \~french Nombre de particules
+*/
+void PA_3DEmitterBurst(u8 emitter, u16 n);
+
+/*! \fn static inline void PA_3DSetEmitterXY(u8 emitter, s16 x, s16 y)
+    \brief
+         \~english Move an emitter, the particles already thrown don't move with it
+         \~french Déplace un émetteur, les particules déjà lancées ne bougent pas avec
+    \~\param emitter
+         \~english Emitter number
+         \~french Numéro de l'émetteur
+    \~\param x
+         \~english X position
+         \~french Position X
+    \~\param y
+         \~english Y position
+         \~french Position Y
+*/
+static inline void PA_3DSetEmitterXY(u8 emitter, s16 x, s16 y){
+	pa_3demitters[emitter].X = x << 8;
+	pa_3demitters[emitter].Y = y << 8;
+}
+
+/*! \fn static inline void PA_3DSetEmitterRate(u8 emitter, u16 rate)
+    \brief
+         \~english Set how many particles an emitter throws by itself
+         \~french Règle combien de particules un émetteur lance tout seul
+    \~\param emitter
+         \~english Emitter number
+         \~french Numéro de l'émetteur
+    \~\param rate
+         \~english Particles per frame, .8 fixed point : 256 for 1 each frame, 64 for 1 every 4 frames, 0 to stop
+         \~french Particules par frame, virgule fixe .8 : 256 pour 1 à chaque frame, 64 pour 1 toutes les 4 frames, 0 pour arrêter
+*/
+static inline void PA_3DSetEmitterRate(u8 emitter, u16 rate){
+	pa_3demitters[emitter].Rate = rate;
+}
+
+/*! \fn static inline void PA_3DSetEmitterDirection(u8 emitter, s16 angle, s16 spread, s32 speed, s32 speedrand)
+    \brief
+         \~english Set the direction and speed of the new particles
+         \~french Règle la direction et la vitesse des nouvelles particules
+    \~\param emitter
+         \~english Emitter number
+         \~french Numéro de l'émetteur
+    \~\param angle
+         \~english Angle, 512 for a full turn, like PA_Cos. 128 goes up.
+         \~french Angle, 512 pour un tour complet, comme PA_Cos. 128 va vers le haut.
+    \~\param spread
+         \~english Random angle added on each side, 256 to go in every direction
+         \~french Angle au hasard ajouté de chaque côté, 256 pour aller dans toutes les directions
+    \~\param speed
+         \~english Speed in pixels per frame, .8 fixed point (256 for 1 pixel)
+         \~french Vitesse en pixels par frame, virgule fixe .8 (256 pour 1 pixel)
+    \~\param speedrand
+         \~english Random speed added, .8 fixed point
+         \~french Vitesse au hasard ajoutée, virgule fixe .8
+*/
+static inline void PA_3DSetEmitterDirection(u8 emitter, s16 angle, s16 spread, s32 speed, s32 speedrand){
+	pa_3demitters[emitter].Angle = angle;
+	pa_3demitters[emitter].Spread = spread;
+	pa_3demitters[emitter].Speed = speed;
+	pa_3demitters[emitter].SpeedRand = speedrand;
+}
+
+/*! \fn static inline void PA_3DSetEmitterGravity(u8 emitter, s32 gx, s32 gy)
+    \brief
+         \~english Set what is added to the speed of the particles each frame, also for the ones already thrown
+         \~french Règle ce qui est ajouté à la vitesse des particules à chaque frame, aussi pour celles déjà lancées
+    \~\param emitter
+         \~english Emitter number
+         \~french Numéro de l'émetteur
+    \~\param gx
+         \~english X, .8 fixed point
+         \~french X, virgule fixe .8
+    \~\param gy
+         \~english Y, .8 fixed point, positive to fall
+         \~french Y, virgule fixe .8, positif pour tomber
+*/
+static inline void PA_3DSetEmitterGravity(u8 emitter, s32 gx, s32 gy){
+	pa_3demitters[emitter].GravityX = gx;
+	pa_3demitters[emitter].GravityY = gy;
+}
+
+/*! \fn static inline void PA_3DSetEmitterLife(u8 emitter, u16 life, u16 liferand)
+    \brief
+         \~english Set how long the new particles live
+         \~french Règle combien de temps vivent les nouvelles particules
+    \~\param emitter
+         \~english Emitter number
+         \~french Numéro de l'émetteur
+    \~\param life
+         \~english Frames, 0 counts as 1
+         \~french Frames, 0 compte pour 1
+    \~\param liferand
+         \~english Random frames added
+         \~french Frames au hasard ajoutées
+*/
+static inline void PA_3DSetEmitterLife(u8 emitter, u16 life, u16 liferand){
+	pa_3demitters[emitter].Life = life;
+	pa_3demitters[emitter].LifeRand = liferand;
+}
+
+/*! \fn static inline void PA_3DSetEmitterLook(u8 emitter, u16 sizex, u16 sizey, u16 color, u16 priority)
+    \brief
+         \~english Set how the particles of an emitter are drawn
+         \~french Règle comment sont dessinées les particules d'un émetteur
+    \~\param emitter
+         \~english Emitter number
+         \~french Numéro de l'émetteur
+    \~\param sizex
+         \~english Width on screen
+         \~french Largeur à l'écran
+    \~\param sizey
+         \~english Height on screen
+         \~french Hauteur à l'écran
+    \~\param color
+         \~english Color the texture is multiplied by, PA_RGB(31, 31, 31) to keep it as it is
+         \~french Couleur par laquelle la texture est multipliée, PA_RGB(31, 31, 31) pour la garder telle quelle
+    \~\param priority
+         \~english Priority, like PA_3DSetSpritePrio
+         \~french Priorité, comme PA_3DSetSpritePrio
+*/
+static inline void PA_3DSetEmitterLook(u8 emitter, u16 sizex, u16 sizey, u16 color, u16 priority){
+	pa_3demitters[emitter].SizeX = sizex;
+	pa_3demitters[emitter].SizeY = sizey;
+	pa_3demitters[emitter].Color = color & 0x7FFF;
+	pa_3demitters[emitter].Priority = priority;
+}
+
+/** @} */ // end of 3DParticles
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
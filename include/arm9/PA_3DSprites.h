@@ -26,10 +26,29 @@ static inline void PA_Set3D(bool texture_mapping, bool shader, bool alpha_test,
 
 void PA_Load3DSpritePal(u16 palette_number, void* palette);
 
+// Set the display capture register (REG_DISPCAPCNT)
+void PA_SetRegCapture(bool enable, uint8 srcBlend, uint8 destBlend, uint8 bank, uint8 offset, uint8 size, uint8 source, uint8 srcOffset);
+
 typedef struct{
 	s16 x, y;
 }pa3dcorners;
 
+/// A frame packed in an atlas texture, in pixels
+typedef struct{
+	u16 X, Y, Width, Height;
+}PA_3DAtlasFrame;
+
+/// Many images and animation frames packed in a single texture
+typedef struct{
+	u16 Width, Height;
+	u8 Type;
+	s16 Texture; // -1 until PA_3DAtlasLoad
+	u8 *Data; // Texture being packed, freed once in VRAM
+	u16 ShelfX, ShelfY, ShelfHeight; // Images are put side by side in rows
+	PA_3DAtlasFrame *Frames;
+	u16 NFrames, MaxFrames;
+}PA_3DAtlas;
+
 typedef struct{
 	u8 Alive;
 	s32 X, Y;
@@ -42,6 +61,10 @@ typedef struct{
 	u16 Priority;
 	pa3dcorners corner[4]; // Corners...
 	u8 alpha, polyID;
+	s32 U, V; // Top left of the image in the texture
+	PA_3DAtlas *Atlas; // If not NULL, frames are taken from it instead of uploaded
+	u16 AtlasFrame; // Atlas frame used as frame 0
+	u8 Importance; // The least important sprites are dropped first when over the polygon budget
 }pa3dsprites;
 extern pa3dsprites pa_3dsprites[PA_NMAXSPRITES];
 
@@ -210,7 +233,7 @@ static inline void PA_3DSetSpritePal(u16 sprite, u16 palette){
 
 void PA_3DUpdateGfx(u16 texture, void *image);
 
-/// Sets the animation frame of a 3D sprite.
+/// Sets the animation frame of a 3D sprite. Sprites made from an atlas only change their texture coordinates, others copy the frame to VRAM.
 void PA_3DSetSpriteFrame(u16 sprite, u16 frame);
 
 /// Sets the top left corner of a 3D sprite.
@@ -252,6 +275,21 @@ static inline void PA_3DSetSpriteAlpha(u16 sprite, u8 alpha){
 	pa_3dsprites[sprite].alpha = alpha;
 }
 
+/*! \fn static inline void PA_3DSetSpriteImportance(u16 sprite, u8 importance)
+    \brief
+         \~english Set how important a 3D sprite is. When there are more sprites on screen than the polygon budget, the least important ones aren't drawn.
+         \~french Règle l'importance d'un sprite 3D. Quand il y a plus de sprites à l'écran que le budget de polygones, les moins importants ne sont pas dessinés.
+    \~\param sprite
+         \~english Sprite number
+         \~french Numéro du sprite
+    \~\param importance
+         \~english 0 (dropped first) to 255 (dropped last), 128 by default
+         \~french 0 (enlevé en premier) à 255 (enlevé en dernier), 128 par défaut
+*/
+static inline void PA_3DSetSpriteImportance(u16 sprite, u8 importance){
+	pa_3dsprites[sprite].Importance = importance;
+}
+
 /*! \fn void PA_3DStartSpriteAnimEx(u16 sprite, s16 firstframe, s16 lastframe, s16 speed, u8 type, s16 ncycles)
     \brief
          \~english Start a 3D sprite animation. Once started, it continues on and on by itself until you stop it !
@@ -436,6 +474,167 @@ static inline void PA_3DSetSpriteVisible(u16 sprite, u8 visible){ pa_3dsprites[s
 
 void PA_Init3DDual(void);
 
+#define PA_3DDUAL_MAIN 0 // Scene shown by the main engine, on the bottom screen unless the screens are switched
+#define PA_3DDUAL_SUB  1 // Scene captured and shown on the other screen
+#define PA_3DDUAL_NONE 0xFF
+
+/// What the dual screen 3D mode did with each scene
+typedef struct{
+	u16 Polygons[2], Vertices[2]; // In the last frame drawn for each scene
+	u32 Frames[2];                // Frames drawn for each scene
+	u16 Latency[2];               // VBLs from PA_3DDualFlush to the scene being on screen
+}PA_3DDualInfo;
+
+extern PA_3DDualInfo PA_3DDualInfos;
+
+/*! \fn void PA_Init3DDualEx(u8 ratio)
+    \brief
+         \~english 3D on both screens, without blinking. The 3D hardware draws the sub scene one frame out of ratio and the main scene the rest of the time. The sub scene is captured and stays on its screen until the next one, the main screen shows a capture of its last frame while the sub scene is drawn. Textures can only use VRAM bank A (like PA_Init3D), bank B keeps the capture. The 2D backgrounds and sprites of the main screen are captured with it, so a 2D interface there doesn't blink either.
+         \~french De la 3D sur les deux écrans, sans clignotement. Le matériel 3D dessine la scène secondaire une frame sur ratio et la scène principale le reste du temps. La scène secondaire est capturée et reste sur son écran jusqu'à la suivante, l'écran principal montre une capture de sa dernière frame pendant que la scène secondaire est dessinée. Les textures ne peuvent utiliser que la banque A (comme PA_Init3D), la banque B garde la capture. Les fonds et sprites 2D de l'écran principal sont capturés avec, donc une interface 2D dessus ne clignote pas non plus.
+    \~\param ratio
+         \~english 2 for 30 frames per second on each screen, 3 or more to draw the sub scene less often (20 for the main scene, 40 for the other...), 0 to draw it only when PA_3DDualRefreshSub is called
+         \~french 2 pour 30 images par seconde sur chaque écran, 3 ou plus pour dessiner la scène secondaire moins souvent (20 pour la principale, 40 pour l'autre...), 0 pour la dessiner seulement quand PA_3DDualRefreshSub est appelé
+*/
+void PA_Init3DDualEx(u8 ratio);
+
+/*! \fn void PA_3DDualSetRatio(u8 ratio)
+    \brief
+         \~english Change how often the sub scene is drawn
+         \~french Change la fréquence à laquelle la scène secondaire est dessinée
+    \~\param ratio
+         \~english 1 frame out of ratio, 0 only when PA_3DDualRefreshSub is called
+         \~french 1 frame sur ratio, 0 seulement quand PA_3DDualRefreshSub est appelé
+*/
+void PA_3DDualSetRatio(u8 ratio);
+
+/*! \fn u8 PA_3DDualScene(void)
+    \brief
+         \~english Scene to draw in this frame, PA_3DDUAL_MAIN or PA_3DDUAL_SUB. PA_3DProcess uses it to draw the 3D sprites of the right screen.
+         \~french Scène à dessiner dans cette frame, PA_3DDUAL_MAIN ou PA_3DDUAL_SUB. PA_3DProcess s'en sert pour dessiner les sprites 3D du bon écran.
+*/
+u8 PA_3DDualScene(void);
+
+/*! \fn void PA_3DDualFlush(void)
+    \brief
+         \~english Send the scene drawn to the 3D hardware, instead of glFlush. Already done by PA_3DProcess.
+         \~french Envoie la scène dessinée au matériel 3D, à la place de glFlush. Déjà fait par PA_3DProcess.
+*/
+void PA_3DDualFlush(void);
+
+/*! \fn void PA_3DDualRefreshSub(void)
+    \brief
+         \~english Draw the sub scene in the next frame, for example when something moved in it
+         \~french Dessine la scène secondaire à la prochaine frame, par exemple quand quelque chose y a bougé
+*/
+void PA_3DDualRefreshSub(void);
+
+/*! \fn PA_3DAtlas* PA_3DAtlasCreate(u16 width, u16 height, u8 type)
+    \brief
+         \~english Start packing images in a single texture. Sprites made from it all share the texture, and animating them only changes the part of it that is shown, nothing is copied to VRAM. Returns NULL if out of memory.
+         \~french Commence à ranger des images dans une seule texture. Les sprites créés à partir d'elle partagent tous la texture, et les animer change seulement la partie affichée, rien n'est copié en VRAM. Renvoie NULL s'il n'y a plus de mémoire.
+    \~\param width
+         \~english Width of the texture, 8 to 1024, power of 2
+         \~french Largeur de la texture, de 8 à 1024, puissance de 2
+    \~\param height
+         \~english Height of the texture, 8 to 1024, power of 2
+         \~french Hauteur de la texture, de 8 à 1024, puissance de 2
+    \~\param type
+         \~english Texture type (TEX_256COL, TEX_16BITS...), the same for all the images
+         \~french Type de texture (TEX_256COL, TEX_16BITS...), le même pour toutes les images
+*/
+PA_3DAtlas* PA_3DAtlasCreate(u16 width, u16 height, u8 type);
+
+/*! \fn s32 PA_3DAtlasAdd(PA_3DAtlas *atlas, void *image, u16 width, u16 height, u16 nframes)
+    \brief
+         \~english Pack an image, with all its animation frames, in the atlas. The image is given like for PA_3DCreateTex, frames one after the other, but doesn't need a power of 2 size. Returns the number of its first frame in the atlas, or -1 if there is no room left. Adding the tallest images first packs them better.
+         \~french Range une image, avec toutes ses frames d'animation, dans l'atlas. L'image est donnée comme pour PA_3DCreateTex, les frames les unes après les autres, mais n'a pas besoin d'une taille en puissance de 2. Renvoie le numéro de sa première frame dans l'atlas, ou -1 s'il n'y a plus de place. Ajouter les images les plus hautes en premier les range mieux.
+    \~\param atlas
+         \~english Atlas
+         \~french Atlas
+    \~\param image
+         \~english Image
+         \~french Image
+    \~\param width
+         \~english Width of a frame, multiple of 4
+         \~french Largeur d'une frame, multiple de 4
+    \~\param height
+         \~english Height of a frame
+         \~french Hauteur d'une frame
+    \~\param nframes
+         \~english Number of frames
+         \~french Nombre de frames
+*/
+s32 PA_3DAtlasAdd(PA_3DAtlas *atlas, void *image, u16 width, u16 height, u16 nframes);
+
+/*! \fn s16 PA_3DAtlasLoad(PA_3DAtlas *atlas)
+    \brief
+         \~english Copy the atlas to VRAM, once all the images are added. Returns the texture, also usable with PA_3DSetSpriteTex.
+         \~french Copie l'atlas en VRAM, une fois toutes les images ajoutées. Renvoie la texture, aussi utilisable avec PA_3DSetSpriteTex.
+    \~\param atlas
+         \~english Atlas
+         \~french Atlas
+*/
+s16 PA_3DAtlasLoad(PA_3DAtlas *atlas);
+
+/*! \fn void PA_3DAtlasDelete(PA_3DAtlas *atlas)
+    \brief
+         \~english Delete an atlas. Its texture stays in VRAM until the sprites using it are deleted too.
+         \~french Efface un atlas. Sa texture reste en VRAM jusqu'à ce que les sprites qui l'utilisent soient effacés aussi.
+    \~\param atlas
+         \~english Atlas
+         \~french Atlas
+*/
+void PA_3DAtlasDelete(PA_3DAtlas *atlas);
+
+/*! \fn void PA_3DCreateSpriteFromAtlas(u16 sprite, PA_3DAtlas *atlas, u16 frame, u8 palette, s16 x, s16 y)
+    \brief
+         \~english Create a 3D sprite showing an image of a loaded atlas. PA_3DSetSpriteFrame and the animation functions then count frames from this one, and only change the texture coordinates.
+         \~french Crée un sprite 3D qui affiche une image d'un atlas chargé. PA_3DSetSpriteFrame et les fonctions d'animation comptent ensuite les frames à partir de celle-ci, et changent seulement les coordonnées de texture.
+    \~\param sprite
+         \~english Sprite number
+         \~french Numéro du sprite
+    \~\param atlas
+         \~english Atlas, already loaded with PA_3DAtlasLoad
+         \~french Atlas, déjà chargé avec PA_3DAtlasLoad
+    \~\param frame
+         \~english First frame of the image, as returned by PA_3DAtlasAdd
+         \~french Première frame de l'image, comme renvoyée par PA_3DAtlasAdd
+    \~\param palette
+         \~english Palette number
+         \~french Numéro de palette
+    \~\param x
+         \~english X position
+         \~french Position X
+    \~\param y
+         \~english Y position
+         \~french Position Y
+*/
+void PA_3DCreateSpriteFromAtlas(u16 sprite, PA_3DAtlas *atlas, u16 frame, u8 palette, s16 x, s16 y);
+
+#define PA_3D_MAXPOLYGONS 2048 // Polygon RAM of the 3D hardware
+#define PA_3D_MAXVERTICES 6144 // Vertex RAM, 4 per sprite unless the sprite is cut by a screen edge
+
+/// What PA_3DProcess drew in the last frame
+typedef struct{
+	u16 Submitted; // Sprites sent to the 3D hardware
+	u16 Culled;    // Sprites skipped because they were off screen
+	u16 Dropped;   // Sprites on screen skipped to stay in the budget
+	u16 Polygons, Vertices; // Really stored by the 3D hardware
+	u8 Overflow;   // The 3D hardware ran out of polygon or vertex RAM
+}PA_3DBudgetInfo;
+
+extern PA_3DBudgetInfo PA_3DBudgetInfos;
+
+/*! \fn void PA_3DSetBudget(u16 polygons)
+    \brief
+         \~english Set the most sprites PA_3DProcess sends in a frame. Sprites off screen are never sent, and over the budget the least important ones (see PA_3DSetSpriteImportance) are dropped. The budget is lowered by itself when sprites cut by the screen edges take more vertices, so the 3D hardware never overflows.
+         \~french Règle le plus de sprites que PA_3DProcess envoie dans une frame. Les sprites hors de l'écran ne sont jamais envoyés, et au-delà du budget les moins importants (voir PA_3DSetSpriteImportance) sont enlevés. Le budget baisse tout seul quand des sprites coupés par les bords de l'écran prennent plus de sommets, pour que le matériel 3D ne déborde jamais.
+    \~\param polygons
+         \~english Sprites, PA_3D_MAXPOLYGONS at most, PA_3D_MAXVERTICES/4 by default
+         \~french Sprites, PA_3D_MAXPOLYGONS au plus, PA_3D_MAXVERTICES/4 par défaut
+*/
+void PA_3DSetBudget(u16 polygons);
+
 /** @} */ // end of 3DSprites
 
 #endif
@@ -0,0 +1,107 @@
+#ifndef _PA_3DTEXT
+#define _PA_3DTEXT
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \file PA_3DText.h
+    \brief Text drawn by the 3D hardware, above or among the 3D sprites
+
+    Each bitmap font is copied once to VRAM, all its letters in a 4 color
+    texture. Strings are queued during the frame and drawn by PA_3DProcess
+    font by font, so a whole font costs a single texture change whatever
+    the number of strings, and each letter is a single quad.
+*/
+
+#include "PA9.h"
+
+#define PA_3DTEXT_LETTERS 1024 // Letters queued in a frame at most
+#define PA_3DTEXT_STRINGS 256  // Strings queued in a frame at most
+#define PA_3DTEXT_PRIO 2048    // Default priority, above the 3D sprites
+
+extern u16 pa_3DTextLetters; // Letters queued for the next PA_3DProcess
+
+// Draws the strings queued, called by PA_3DProcess
+void PA_3DDrawText(s16 ydecal);
+
+/** @defgroup f3DText 3D text
+ *  Text drawn by the 3D hardware, above or among the 3D sprites
+ *  @{
+ */
+
+/*! \fn s16 PA_3DLoadFont(u8 size, u8 palette)
+    \brief
+         \~english Copy a bitmap font (the ones of PA_16bitText, default or added with PA_AddBitmapFont) to VRAM as a texture, before using it with PA_3DText. Returns the texture, or -1 if out of memory.
+         \~french Copie une police bitmap (celles de PA_16bitText, par défaut ou ajoutée avec PA_AddBitmapFont) en VRAM comme texture, avant de l'utiliser avec PA_3DText. Renvoie la texture, ou -1 s'il n'y a plus de mémoire.
+    \~\param size
+         \~english Font slot, from 0 to 9
+         \~french Emplacement de la police, de 0 à 9
+    \~\param palette
+         \~english 3D palette slot used by the font, only its first 2 colors are changed
+         \~french Emplacement de palette 3D utilisé par la police, seules ses 2 premières couleurs sont changées
+*/
+s16 PA_3DLoadFont(u8 size, u8 palette);
+
+/*! \fn void PA_3DUnloadFont(u8 size)
+    \brief
+         \~english Free the texture of a font loaded with PA_3DLoadFont
+         \~french Libère la texture d'une police chargée avec PA_3DLoadFont
+    \~\param size
+         \~english Font slot
+         \~french Emplacement de la police
+*/
+void PA_3DUnloadFont(u8 size);
+
+/*! \fn void PA_3DSetTextPrio(u16 priority)
+    \brief
+         \~english Priority of the strings queued from now on, like PA_3DSetSpritePrio. PA_3DTEXT_PRIO by default, above the sprites.
+         \~french Priorité des textes ajoutés à partir de là, comme PA_3DSetSpritePrio. PA_3DTEXT_PRIO par défaut, au-dessus des sprites.
+    \~\param priority
+         \~english Priority
+         \~french Priorité
+*/
+void PA_3DSetTextPrio(u16 priority);
+
+/*! \fn u8 PA_3DText(u8 size, s16 x, s16 y, u16 color, const char *text, ...)
+    \brief
+         \~english Draw a string at the next PA_3DProcess, only for that frame. The text is formatted like printf (see PA_VFormat), \\n goes to the line. Returns 0 if the queue is full and the string is not drawn.
+         \~french Dessine un texte au prochain PA_3DProcess, seulement pour cette frame. Le texte est formaté comme printf (voir PA_VFormat), \\n va à la ligne. Renvoie 0 si la file est pleine et que le texte n'est pas dessiné.
+    \~\param size
+         \~english Font slot, loaded with PA_3DLoadFont
+         \~french Emplacement de la police, chargée avec PA_3DLoadFont
+    \~\param x
+         \~english X of the top left corner, in pixels
+         \~french X du coin en haut à gauche, en pixels
+    \~\param y
+         \~english Y of the top left corner, like for the 3D sprites (from PA_ScreenSpace for the other screen in dual screen 3D)
+         \~french Y du coin en haut à gauche, comme pour les sprites 3D (à partir de PA_ScreenSpace pour l'autre écran en 3D sur deux écrans)
+    \~\param color
+         \~english Color, PA_RGB(r, g, b)
+         \~french Couleur, PA_RGB(r, g, b)
+    \~\param text
+         \~english Text, followed by its arguments
+         \~french Texte, suivi de ses arguments
+*/
+u8 PA_3DText(u8 size, s16 x, s16 y, u16 color, const char *text, ...);
+
+/*! \fn s16 PA_3DTextWidth(u8 size, const char *text)
+    \brief
+         \~english Width in pixels of the longest line of a string, for example to center it
+         \~french Largeur en pixels de la plus longue ligne d'un texte, par exemple pour le centrer
+    \~\param size
+         \~english Font slot
+         \~french Emplacement de la police
+    \~\param text
+         \~english Text
+         \~french Texte
+*/
+s16 PA_3DTextWidth(u8 size, const char *text);
+
+/** @} */ // end of 3DText
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
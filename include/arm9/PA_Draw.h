@@ -104,6 +104,78 @@ void PA_Init16bitBg(u8 screen, u8 bg_priority);
 void PA_Init16bitDblBuffer(u8 screen, u8 bg_priority);
 void PA_16bitSwapBuffer(u8 screen);
 
+#define PA_MAX_DIRTY_RECTS 16
+
+typedef struct {
+	s16 x1, y1, x2, y2; // x2 and y2 are excluded
+} PA_DirtyRect;
+
+typedef struct {
+	u8 On;
+	u8 Full;
+	u8 NRects;
+	PA_DirtyRect Rect[PA_MAX_DIRTY_RECTS];
+	u32 Rows[6]; // Lines written by the pixel functions, one bit each
+} PA_DirtyRectInfo;
+
+extern PA_DirtyRectInfo PA_DirtyRects[2];
+
+// Cheaper than a rectangle for each pixel, the whole line is copied at the swap
+#define PA_DirtyRow(screen, y) (PA_DirtyRects[screen].Rows[(y) >> 5] |= 1u << ((y) & 31))
+
+/*! \fn void PA_EnableDirtyRects(u8 screen, u8 on)
+    \brief
+         \~english Enable or disable dirty rectangle tracking on a double buffered bitmap background (PA_Init8bitDblBuffer or PA_Init16bitDblBuffer). When enabled, all PA_Draw and bitmap text functions record the areas they modify, and PA_8bitSwapBuffer/PA_16bitSwapBuffer only copy those areas to the new back buffer, so it is not needed to redraw the whole screen every frame. The pixel functions mark their whole line. The first swap after enabling copies the whole screen, as the two buffers may still differ anywhere.
+         \~french Active ou dsactive le suivi des zones modifies sur un fond bitmap  double buffer (PA_Init8bitDblBuffer ou PA_Init16bitDblBuffer). Une fois activ, les fonctions de dessin et de texte bitmap enregistrent les zones qu'elles modifient, et PA_8bitSwapBuffer/PA_16bitSwapBuffer ne copient que ces zones dans le nouveau buffer arrire. Plus besoin de tout redessiner  chaque frame. Les fonctions de pixel marquent toute leur ligne. Le premier change aprs l'activation copie tout l'cran, car les deux buffers peuvent encore diffrer partout.
+    \~\param screen
+         \~english Chose de screen (0 or 1)
+         \~french Choix de l'cran (0 ou 1)
+    \~\param on
+         \~english 1 to enable, 0 to disable
+         \~french 1 pour activer, 0 pour dsactiver
+*/
+void PA_EnableDirtyRects(u8 screen, u8 on);
+
+void PA_AddDirtyRectEx(u8 screen, s16 x1, s16 y1, s16 x2, s16 y2);
+
+/*! \fn static inline void PA_AddDirtyRect(u8 screen, s16 x1, s16 y1, s16 x2, s16 y2)
+    \brief
+         \~english Mark an area of a double buffered background as modified. Use this if you write directly to PA_DrawBg. Does nothing if dirty rectangle tracking is disabled.
+         \~french Marque une zone d'un fond  double buffer comme modifie. A utiliser si on crit directement dans PA_DrawBg. Ne fait rien si le suivi n'est pas activ.
+    \~\param screen
+         \~english Chose de screen (0 or 1)
+         \~french Choix de l'cran (0 ou 1)
+    \~\param x1
+         \~english X coordinate of the top left corner
+         \~french Coordonne X du coin suprieur gauche
+    \~\param y1
+         \~english Y coordinate of the top left corner
+         \~french Coordonne Y du coin suprieur gauche
+    \~\param x2
+         \~english X coordinate of the bottom right corner (excluded)
+         \~french Coordonne X du coin infrieur droit (exclue)
+    \~\param y2
+         \~english Y coordinate of the bottom right corner (excluded)
+         \~french Coordonne Y du coin infrieur droit (exclue)
+*/
+static inline void PA_AddDirtyRect(u8 screen, s16 x1, s16 y1, s16 x2, s16 y2) {
+	if (PA_DirtyRects[screen].On) PA_AddDirtyRectEx(screen, x1, y1, x2, y2);
+}
+
+/*! \fn static inline void PA_SetDirtyFull(u8 screen)
+    \brief
+         \~english Mark the whole screen as modified, the next swap will copy the full buffer.
+         \~french Marque tout l'cran comme modifi, le prochain change copiera tout le buffer.
+    \~\param screen
+         \~english Chose de screen (0 or 1)
+         \~french Choix de l'cran (0 ou 1)
+*/
+static inline void PA_SetDirtyFull(u8 screen) {
+	PA_DirtyRects[screen].Full = 1;
+}
+
+void PA_CopyDirtyRects(u8 screen, const void *front);
+
 /*! \fn static inline void PA_Put8bitPixel(u8 screen, s16 x, s16 y, u8 color) 
     \brief
          \~english Draw a pixel on screen, on an 8 bit background
@@ -127,6 +199,7 @@ static inline void PA_Put8bitPixel(u8 screen, s16 x, s16 y, u8 color) {
 	u32 decal = ((x&1)<<3);
 	PA_DrawBg[screen][pos] &= 0xff00>>decal;
 	PA_DrawBg[screen][pos] |= color<<decal;
+	PA_DirtyRow(screen, y);
 }
 
 /*! \fn static inline void PA_Put2_8bitPixels(u8 screen, s16 x, s16 y, u16 colors)
@@ -149,6 +222,7 @@ static inline void PA_Put8bitPixel(u8 screen, s16 x, s16 y, u8 color) {
 */
 static inline void PA_Put2_8bitPixels(u8 screen, s16 x, s16 y, u16 colors) {		
 	PA_DrawBg[screen][(x >> 1) + (y << 7)] = colors;
+	PA_DirtyRow(screen, y);
 }
 
 /*! \fn static inline void PA_PutDouble8bitPixels(u8 screen, s16 x, s16 y, u8 color1, u8 color2)
@@ -195,6 +269,7 @@ static inline void PA_PutDouble8bitPixels(u8 screen, s16 x, s16 y, u8 color1, u8
 */
 static inline void PA_Put4_8bitPixels(u8 screen, s16 x, s16 y, u32 colors) {
 	PA_DrawBg32[screen][(x >> 2) + (y << 6)] = colors;
+	PA_DirtyRow(screen, y);
 }
 
 /*! \fn static inline u8 PA_Get8bitPixel(u8 screen, u8 x, u8 y)
@@ -238,6 +313,7 @@ static inline u8 PA_Get8bitPixel(u8 screen, u8 x, u8 y) {
 */
 static inline void PA_Put16bitPixel(u8 screen, s16 x, s16 y, u16 color) {
 	PA_DrawBg[screen][x + (y << 8)] = color;
+	PA_DirtyRow(screen, y);
 }
 
 /*! \def PA_Get16bitPixel(x, y)
@@ -440,6 +516,7 @@ void PA_16bitDraw(u8 screen, u16 color);
 #define PA_Load8bitBitmap(screen, bitmap) do{ \
 	DC_FlushRange(bitmap, 256 * 192); \
 	dmaCopy(bitmap, (void*)PA_DrawBg[screen], 256 * 192); \
+	PA_SetDirtyFull(screen); \
 } while(0)
 
 /*! \def PA_Load16bitBitmap(screen, bitmap)
@@ -455,7 +532,8 @@ void PA_16bitDraw(u8 screen, u16 color);
 */
 #define PA_Load16bitBitmap(screen, bitmap) do{u32 PA_temp; \
 	for (PA_temp = 0; PA_temp < 256*192; PA_temp++)\
-	PA_DrawBg[screen][PA_temp] = bitmap[PA_temp] | (1 << 15);}while(0)
+	PA_DrawBg[screen][PA_temp] = bitmap[PA_temp] | (1 << 15);\
+	PA_SetDirtyFull(screen);}while(0)
 
 
 /*! \def PA_Clear8bitBg(screen)
@@ -466,7 +544,10 @@ void PA_16bitDraw(u8 screen, u16 color);
          \~english Chose de screen (0 or 1)
          \~french Choix de l'écran (0 ou 1)		 
 */
-#define PA_Clear8bitBg(screen) dmaFillWords(0, (void*)PA_DrawBg[screen], 256*96*2);
+#define PA_Clear8bitBg(screen) do{ \
+	dmaFillWords(0, (void*)PA_DrawBg[screen], 256*96*2); \
+	PA_SetDirtyFull(screen); \
+} while(0)
 
 /*! \def PA_Clear16bitBg(screen)
     \brief
@@ -476,7 +557,10 @@ void PA_16bitDraw(u8 screen, u16 color);
          \~english Chose de screen (0 or 1)
          \~french Choix de l'écran (0 ou 1)		 
 */
-#define PA_Clear16bitBg(screen) dmaFillWords(0, (void*)PA_DrawBg[screen], 256*192*2)
+#define PA_Clear16bitBg(screen) do{ \
+	dmaFillWords(0, (void*)PA_DrawBg[screen], 256*192*2); \
+	PA_SetDirtyFull(screen); \
+} while(0)
 
 
 /*! \fn static inline void PA_LoadJpeg(u8 screen, void *jpeg)
@@ -491,9 +575,12 @@ void PA_16bitDraw(u8 screen, u16 color);
          \~french image au format jpeg...	 
 */
 static inline void PA_LoadJpeg(u8 screen, void *jpeg) {
+	PA_ProfileBegin(PA_PROFILE_JPEG);
 	REG_IME = 0;
 	JPEG_DecompressImage((u8*)jpeg, PA_DrawBg[screen], 256, 192);
 	REG_IME = 1;	
+	PA_ProfileEnd();
+	PA_SetDirtyFull(screen);
 }
 
 
@@ -539,7 +626,10 @@ void PA_LoadBmpToBuffer(u16 *Buffer, s16 x, s16 y, void *bmp, s16 SWidth);
          \~french image au format BMP...	 
 */
 static inline void PA_LoadBmpEx(u8 screen, s16 x, s16 y, void *bmp){
+	BMP_Headers *Bmpinfo = (BMP_Headers*)((u8*)bmp + 14);
 	PA_LoadBmpToBuffer(PA_DrawBg[screen], x, y, bmp, 256);
+	s32 height = (s32)Bmpinfo->Height;
+	PA_AddDirtyRect(screen, x, y, x + Bmpinfo->Width, y + ((height < 0) ? -height : height)); // Negative for the images stored from the top
 }
 
 
@@ -585,7 +675,8 @@ static inline u16 PA_GetBmpWidth(void *bmpdata){
 static inline u16 PA_GetBmpHeight(void *bmpdata){
 	u8 *temp = (u8*)bmpdata;
 	BMP_Headers *Bmpinfo = (BMP_Headers*)(temp+14);
-	return Bmpinfo->Height;
+	s32 height = (s32)Bmpinfo->Height;
+	return (height < 0) ? -height : height; // Negative for the images stored from the top
 }
 /** @} */ // end of Draw
 
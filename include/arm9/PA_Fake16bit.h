@@ -17,6 +17,8 @@ extern "C" {
 
 extern u16* PA_DrawFake16[2];
 extern bool PA_HasFake16bitBg[2];
+extern u32 PA_Fake16Dirty[2][6]; // One bit per line that changed
+extern s32 PA_Fake16Budget;     // Lines given new colors at each VBL, fewer if the vertical blank ends first
 
 /** @defgroup Fake16bit Fake 16bit bitmap mode
  *  Functions to handle fake 16 bit backgrounds that take up less
@@ -37,6 +39,70 @@ extern bool PA_HasFake16bitBg[2];
 */
 extern void PA_InitFake16bitBg(u8 screen, u8 prio);
 
+/*! \fn void PA_InitFake16bitBgEx(u8 screen, u8 prio, u16 colors)
+    \brief
+         \~english Initialize a fake 16 bit background with less colors per line. Each line that changed gets its best colors at the next VBL (PA_Fake16Budget lines per VBL, 32 by default, and only while the vertical blank lasts), and only those colors are written before each line is drawn, which leaves time for other raster effects. With 256 colors, it is the same as PA_InitFake16bitBg.
+         \~french Initialise un fond 16 bit simulé avec moins de couleurs par ligne. Chaque ligne qui a changé reçoit ses meilleures couleurs au VBL suivant (PA_Fake16Budget lignes par VBL, 32 par défaut, et seulement tant que dure le blanc vertical), et seulement ces couleurs sont écrites avant que chaque ligne soit affichée, ce qui laisse du temps aux autres effets raster. Avec 256 couleurs, c'est la même chose que PA_InitFake16bitBg.
+    \~\param screen
+         \~english Choose the screen (0 or 1)
+         \~french Choix de l'écran (0 ou 1)
+    \~\param prio
+         \~english Background priority (from 0 to 3, being 0 the highest)
+         \~french Priorité du fond (de 0 à 3, 0 étant la plus haute)
+    \~\param colors
+         \~english Colors per line, from 8 to 256. 64 is usually enough for pictures.
+         \~french Couleurs par ligne, de 8 à 256. 64 suffit en général pour des photos.
+*/
+extern void PA_InitFake16bitBgEx(u8 screen, u8 prio, u16 colors);
+
+/*! \fn u16 PA_Fake16bitQuantizeLine(const u16 *line, u16 width, u16 colors, u16 *palette, u8 *indexes)
+    \brief
+         \~english Reduce a line of 15 bit colors to a palette. The exact colors are kept if there are few enough of them, otherwise bits are dropped, blue first, until they fit and each color is the average of its pixels. Returns the number of colors used.
+         \~french Réduit une ligne de couleurs 15 bit à une palette. Les couleurs exactes sont gardées s'il y en a assez peu, sinon des bits sont enlevés, le bleu d'abord, jusqu'à ce qu'elles tiennent et chaque couleur est la moyenne de ses pixels. Renvoie le nombre de couleurs utilisées.
+    \~\param line
+         \~english Pixels of the line
+         \~french Pixels de la ligne
+    \~\param width
+         \~english Number of pixels
+         \~french Nombre de pixels
+    \~\param colors
+         \~english Maximum colors, from 8 to 256
+         \~french Nombre maximum de couleurs, de 8 à 256
+    \~\param palette
+         \~english Palette to fill
+         \~french Palette à remplir
+    \~\param indexes
+         \~english Palette index of each pixel
+         \~french Numéro de couleur de chaque pixel
+*/
+u16 PA_Fake16bitQuantizeLine(const u16 *line, u16 width, u16 colors, u16 *palette, u8 *indexes);
+
+/*! \fn void PA_Fake16bitDirty(u8 screen, s16 y1, s16 y2)
+    \brief
+         \~english Mark lines as changed, so they get new colors. Done by the fake 16 bit functions, use it if you write directly to PA_DrawFake16.
+         \~french Marque des lignes comme changées, pour qu'elles reçoivent de nouvelles couleurs. Fait par les fonctions 16 bit simulées, à utiliser si vous écrivez directement dans PA_DrawFake16.
+    \~\param screen
+         \~english Choose the screen (0 or 1)
+         \~french Choix de l'écran (0 ou 1)
+    \~\param y1
+         \~english First line
+         \~french Première ligne
+    \~\param y2
+         \~english Last line
+         \~french Dernière ligne
+*/
+void PA_Fake16bitDirty(u8 screen, s16 y1, s16 y2);
+
+/*! \fn void PA_Fake16bitUpdate(u8 screen)
+    \brief
+         \~english Give new colors to all the lines that changed now, instead of a few at each VBL
+         \~french Donne de nouvelles couleurs à toutes les lignes qui ont changé maintenant, au lieu de quelques unes à chaque VBL
+    \~\param screen
+         \~english Choose the screen (0 or 1)
+         \~french Choix de l'écran (0 ou 1)
+*/
+void PA_Fake16bitUpdate(u8 screen);
+
 /*! \fn void PA_DrawFake16bitLine(u8 screen, u16 x1, u16 y1, u16 x2, u16 y2, u16 color)
     \brief
          \~english Draws a line on a fake 16 bit background
@@ -76,6 +142,7 @@ extern void PA_DrawFake16bitLine(u8 screen, u16 x1, u16 y1, u16 x2, u16 y2, u16
 #define PA_LoadFake16bitBitmap(screen, bitmap) do{ \
 	DC_FlushRange(bitmap, 256 * 192 * 2); \
 	dmaCopy(bitmap, (void*)PA_DrawFake16[screen], 256 * 192 * 2); \
+	PA_Fake16bitDirty(screen, 0, 191); \
 } while(0)
 
 /*! \def PA_ClearFake16bitBg(screen)
@@ -86,7 +153,10 @@ extern void PA_DrawFake16bitLine(u8 screen, u16 x1, u16 y1, u16 x2, u16 y2, u16
          \~english Choose the screen (0 or 1)
          \~french [nothing]
 */
-#define PA_ClearFake16bitBg(screen) dmaFillWords(0, (void*)PA_DrawFake16[screen], 256*192*2)
+#define PA_ClearFake16bitBg(screen) do{ \
+	dmaFillWords(0, (void*)PA_DrawFake16[screen], 256*192*2); \
+	PA_Fake16bitDirty(screen, 0, 191); \
+} while(0)
 
 /*! \def PA_PutFake16bitPixel(screen, x, y, color)
     \brief
@@ -105,7 +175,7 @@ extern void PA_DrawFake16bitLine(u8 screen, u16 x1, u16 y1, u16 x2, u16 y2, u16
          \~english 15 bits color. You can use the PA_RGB macro to set the RGB values...
          \~french Couleur de 15 bits.On peut utiliser la macro PA_RGB pour entrer les valeurs RGB...
 */
-#define PA_PutFake16bitPixel(screen, x, y, color) PA_DrawFake16[screen][(x) + 256 * (y)] = color
+#define PA_PutFake16bitPixel(screen, x, y, color) (PA_DrawFake16[screen][(x) + 256 * (y)] = color, PA_Fake16Dirty[screen][(y) >> 5] |= 1u << ((y) & 31))
 
 /*! \def PA_GetFake16bitPixel(screen, x, y)
     \brief
@@ -169,7 +239,10 @@ extern void PA_DrawFake16bitLine(u8 screen, u16 x1, u16 y1, u16 x2, u16 y2, u16
          \~english BMP image...
          \~french image au format BMP...	 
 */
-#define PA_Fake16bitLoadBmpEx(screen, bmp, x, y) PA_LoadBmpToBuffer(PA_DrawFake16[screen], x, y, bmp, 256)
+#define PA_Fake16bitLoadBmpEx(screen, bmp, x, y) do{ \
+	PA_LoadBmpToBuffer(PA_DrawFake16[screen], x, y, bmp, 256); \
+	PA_Fake16bitDirty(screen, 0, 191); \
+} while(0)
 
 /*! \def PA_Fake16bitLoadBmp(screen, bmp)
     \brief
@@ -201,7 +274,10 @@ extern void PA_DrawFake16bitLine(u8 screen, u16 x1, u16 y1, u16 x2, u16 y2, u16
          \~english Gif image...
          \~french image au format Gif...	 
 */
-#define PA_Fake16bitLoadGifXY(screen, gif, x, y) DecodeGif((const u8*)gif, (u8*)(PA_DrawFake16[screen] + x + (y<<8)), NULL, 1, 256);
+#define PA_Fake16bitLoadGifXY(screen, gif, x, y) do{ \
+	DecodeGif((const u8*)gif, (u8*)(PA_DrawFake16[screen] + x + (y<<8)), NULL, 1, 256); \
+	PA_Fake16bitDirty(screen, 0, 191); \
+} while(0)
 
 /*! \def PA_Fake16bitLoadGif(screen, gif)
     \brief
@@ -227,7 +303,12 @@ extern void PA_DrawFake16bitLine(u8 screen, u16 x1, u16 y1, u16 x2, u16 y2, u16
          \~english jpeg image...
          \~french image au format jpeg...	 
 */
-#define PA_Fake16bitLoadJpeg(screen, jpeg) JPEG_DecompressImage((u8*)jpeg, PA_DrawFake16[screen], 256, 192)
+#define PA_Fake16bitLoadJpeg(screen, jpeg) do{ \
+	PA_ProfileBegin(PA_PROFILE_JPEG); \
+	JPEG_DecompressImage((u8*)jpeg, PA_DrawFake16[screen], 256, 192); \
+	PA_ProfileEnd(); \
+	PA_Fake16bitDirty(screen, 0, 191); \
+} while(0)
 
 #ifdef __cplusplus
 }
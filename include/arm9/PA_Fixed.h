@@ -0,0 +1,330 @@
+#ifndef _PA_Fixed
+#define _PA_Fixed
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \file PA_Fixed.h
+    \brief Fixed point math : precise trigonometry, hardware division and square root, arrays of points
+
+    Numbers are .12 fixed point (4096 is 1), like PA_mulf32 and the 3D hardware.
+    Angles go from 0 to 4095 for a full turn, 8 times finer than PA_Sin and
+    PA_Cos. Divisions and square roots use the DS hardware, and can be started
+    and read later to do something else while they are computed. Functions
+    working on arrays of points keep the hardware busy all the time.
+*/
+
+#include "PA9.h"
+
+#define PA_FIXED_PRECISION 12
+#define PA_FIXED_ONE (1 << PA_FIXED_PRECISION)
+#define PA_TOFIXED(a) ((a) << PA_FIXED_PRECISION)
+#define PA_TOINTEGER(a) ((a) >> PA_FIXED_PRECISION)
+
+#define PA_ANGLE_TURN 4096 // Angles of the .12 functions, for a full turn
+
+/// Simple point structure.
+typedef struct{
+	/// X value.
+	int x;
+	/// Y value.
+	int y;
+}PA_Point;
+
+// Rotation and scale, then translation
+typedef struct{
+	s32 a, b, c, d;      // x' = a*x + b*y + tx, y' = c*x + d*y + ty, .12 fixed point
+	s32 tx, ty;
+} PA_Transform2;
+
+extern const u16 PA_SinQuarter[1025];
+extern const u16 PA_AtanTable[1025];
+
+/** @defgroup Fixed Fixed point math
+ *  .12 fixed point trigonometry, hardware division and square root, arrays of points
+ *  @{
+ */
+
+/*! \fn static inline s32 PA_SinF(s32 angle)
+    \brief
+         \~english Sine of an angle, from -4096 to 4096. The angle goes from 0 to 4095 for a full turn, any value works.
+         \~french Sinus d'un angle, de -4096 à 4096. L'angle va de 0 à 4095 pour un tour complet, n'importe quelle valeur marche.
+    \~\param angle
+         \~english Angle, 4096 for a full turn
+         \~french Angle, 4096 pour un tour complet
+*/
+static inline s32 PA_SinF(s32 angle){
+	u32 a = angle & 4095;
+	s32 v = PA_SinQuarter[(a & 1024) ? 1024 - (a & 1023) : (a & 1023)];
+	return (a & 2048) ? -v : v;
+}
+
+/*! \fn static inline s32 PA_CosF(s32 angle)
+    \brief
+         \~english Cosine of an angle, from -4096 to 4096
+         \~french Cosinus d'un angle, de -4096 à 4096
+    \~\param angle
+         \~english Angle, 4096 for a full turn
+         \~french Angle, 4096 pour un tour complet
+*/
+static inline s32 PA_CosF(s32 angle){
+	return PA_SinF(angle + 1024);
+}
+
+/*! \fn u16 PA_Atan2F(s32 y, s32 x)
+    \brief
+         \~english Angle of a vector, from 0 to 4095, 0 being to the right and 1024 towards positive y. Off by 1 at most.
+         \~french Angle d'un vecteur, de 0 à 4095, 0 étant vers la droite et 1024 vers les y positifs. Faux de 1 au plus.
+    \~\param y
+         \~english Y of the vector
+         \~french Y du vecteur
+    \~\param x
+         \~english X of the vector
+         \~french X du vecteur
+*/
+u16 PA_Atan2F(s32 y, s32 x);
+
+/*! \fn static inline void PA_DivStart(s32 num, s32 den)
+    \brief
+         \~english Start an integer division on the hardware, PA_DivResult gets the result. Other code can run in between, as long as it doesn't divide (an interrupt dividing would change the result).
+         \~french Lance une division entière sur le matériel, PA_DivResult récupère le résultat. D'autre code peut tourner entre les deux, tant qu'il ne divise pas (une interruption qui divise changerait le résultat).
+    \~\param num
+         \~english Number to divide
+         \~french Nombre à diviser
+    \~\param den
+         \~english Number to divide by
+         \~french Diviseur
+*/
+static inline void PA_DivStart(s32 num, s32 den){
+	div32_asynch(num, den);
+}
+
+/*! \fn static inline s32 PA_DivResult(void)
+    \brief
+         \~english Result of the division started by PA_DivStart, PA_DivF32Start or PA_InvF32Start, waits for it if needed
+         \~french Résultat de la division lancée par PA_DivStart, PA_DivF32Start ou PA_InvF32Start, l'attend si besoin
+*/
+static inline s32 PA_DivResult(void){
+	return div32_result();
+}
+
+/*! \fn static inline void PA_DivF32Start(s32 num, s32 den)
+    \brief
+         \~english Start a .12 fixed point division on the hardware, PA_DivResult gets the result
+         \~french Lance une division en virgule fixe .12 sur le matériel, PA_DivResult récupère le résultat
+    \~\param num
+         \~english Number to divide
+         \~french Nombre à diviser
+    \~\param den
+         \~english Number to divide by
+         \~french Diviseur
+*/
+static inline void PA_DivF32Start(s32 num, s32 den){
+	divf32_asynch(num, den);
+}
+
+/*! \fn static inline void PA_InvF32Start(s32 x)
+    \brief
+         \~english Start computing 1/x in .12 fixed point, PA_DivResult gets the result
+         \~french Lance le calcul de 1/x en virgule fixe .12, PA_DivResult récupère le résultat
+    \~\param x
+         \~english Number, .12 fixed point
+         \~french Nombre, virgule fixe .12
+*/
+static inline void PA_InvF32Start(s32 x){
+	divf32_asynch(PA_FIXED_ONE, x);
+}
+
+/*! \fn static inline s32 PA_InvF32(s32 x)
+    \brief
+         \~english 1/x in .12 fixed point
+         \~french 1/x en virgule fixe .12
+    \~\param x
+         \~english Number, .12 fixed point
+         \~french Nombre, virgule fixe .12
+*/
+static inline s32 PA_InvF32(s32 x){
+	return divf32(PA_FIXED_ONE, x);
+}
+
+/*! \fn static inline void PA_SqrtStart(u32 x)
+    \brief
+         \~english Start an integer square root on the hardware, PA_SqrtResult gets the result
+         \~french Lance une racine carrée entière sur le matériel, PA_SqrtResult récupère le résultat
+    \~\param x
+         \~english Number
+         \~french Nombre
+*/
+static inline void PA_SqrtStart(u32 x){
+	sqrt32_asynch(x);
+}
+
+/*! \fn static inline void PA_Sqrt64Start(u64 x)
+    \brief
+         \~english Start the square root of a 64 bit number, PA_SqrtResult gets the result
+         \~french Lance la racine carrée d'un nombre de 64 bits, PA_SqrtResult récupère le résultat
+    \~\param x
+         \~english Number
+         \~french Nombre
+*/
+static inline void PA_Sqrt64Start(u64 x){
+	sqrt64_asynch(x);
+}
+
+/*! \fn static inline u32 PA_SqrtResult(void)
+    \brief
+         \~english Result of the square root started by PA_SqrtStart or PA_Sqrt64Start, rounded down, waits for it if needed
+         \~french Résultat de la racine carrée lancée par PA_SqrtStart ou PA_Sqrt64Start, arrondi en dessous, l'attend si besoin
+*/
+static inline u32 PA_SqrtResult(void){
+	return sqrt32_result();
+}
+
+/*! \fn static inline u32 PA_Sqrt32(u32 x)
+    \brief
+         \~english Integer square root, rounded down, with the hardware
+         \~french Racine carrée entière, arrondie en dessous, avec le matériel
+    \~\param x
+         \~english Number
+         \~french Nombre
+*/
+static inline u32 PA_Sqrt32(u32 x){
+	sqrt32_asynch(x);
+	return sqrt32_result();
+}
+
+/*! \fn static inline u32 PA_LengthF(s32 x, s32 y)
+    \brief
+         \~english Length of a vector, in the same unit as x and y
+         \~french Longueur d'un vecteur, dans la même unité que x et y
+    \~\param x
+         \~english X of the vector
+         \~french X du vecteur
+    \~\param y
+         \~english Y of the vector
+         \~french Y du vecteur
+*/
+static inline u32 PA_LengthF(s32 x, s32 y){
+	sqrt64_asynch((s64)x * x + (s64)y * y);
+	return sqrt64_result();
+}
+
+/*! \fn void PA_NormalizeF(PA_Point *v)
+    \brief
+         \~english Give a vector a length of 1 (4096), keeping its direction. A zero vector stays zero.
+         \~french Donne une longueur de 1 (4096) à un vecteur, en gardant sa direction. Un vecteur nul reste nul.
+    \~\param v
+         \~english Vector
+         \~french Vecteur
+*/
+void PA_NormalizeF(PA_Point *v);
+
+/*! \fn void PA_Transform2RotScale(PA_Transform2 *t, s32 angle, s32 scale, s32 x, s32 y)
+    \brief
+         \~english Make a transform that rotates and scales points around 0, then moves them
+         \~french Fait une transformation qui tourne et agrandit les points autour de 0, puis les déplace
+    \~\param t
+         \~english Transform
+         \~french Transformation
+    \~\param angle
+         \~english Angle, 4096 for a full turn
+         \~french Angle, 4096 pour un tour complet
+    \~\param scale
+         \~english Scale, .12 fixed point (4096 keeps the size)
+         \~french Agrandissement, virgule fixe .12 (4096 garde la taille)
+    \~\param x
+         \~english Moved by this much in X after the rotation
+         \~french Déplacé de tant en X après la rotation
+    \~\param y
+         \~english Moved by this much in Y after the rotation
+         \~french Déplacé de tant en Y après la rotation
+*/
+void PA_Transform2RotScale(PA_Transform2 *t, s32 angle, s32 scale, s32 x, s32 y);
+
+/*! \fn void PA_TransformPoints(const PA_Transform2 *t, const PA_Point *in, PA_Point *out, s32 n)
+    \brief
+         \~english Apply a transform to an array of points, for example the positions of all the entities of a formation. in and out can be the same array.
+         \~french Applique une transformation à un tableau de points, par exemple les positions de toutes les entités d'une formation. in et out peuvent être le même tableau.
+    \~\param t
+         \~english Transform
+         \~french Transformation
+    \~\param in
+         \~english Points
+         \~french Points
+    \~\param out
+         \~english Points transformed
+         \~french Points transformés
+    \~\param n
+         \~english Number of points
+         \~french Nombre de points
+*/
+void PA_TransformPoints(const PA_Transform2 *t, const PA_Point *in, PA_Point *out, s32 n);
+
+/*! \fn void PA_MovePoints(PA_Point *pos, const PA_Point *speed, s32 n)
+    \brief
+         \~english Add its speed to each point
+         \~french Ajoute sa vitesse à chaque point
+    \~\param pos
+         \~english Positions
+         \~french Positions
+    \~\param speed
+         \~english Speeds
+         \~french Vitesses
+    \~\param n
+         \~english Number of points
+         \~french Nombre de points
+*/
+void PA_MovePoints(PA_Point *pos, const PA_Point *speed, s32 n);
+
+/*! \fn void PA_PointsDistance(const PA_Point *pos, s32 n, s32 x, s32 y, u32 *dist)
+    \brief
+         \~english Distance from each point to a position. The square root of a point is computed by the hardware while the next one is prepared.
+         \~french Distance de chaque point à une position. La racine carrée d'un point est calculée par le matériel pendant que le suivant est préparé.
+    \~\param pos
+         \~english Points
+         \~french Points
+    \~\param n
+         \~english Number of points
+         \~french Nombre de points
+    \~\param x
+         \~english X of the position
+         \~french X de la position
+    \~\param y
+         \~english Y of the position
+         \~french Y de la position
+    \~\param dist
+         \~english Gets the n distances
+         \~french Reçoit les n distances
+*/
+void PA_PointsDistance(const PA_Point *pos, s32 n, s32 x, s32 y, u32 *dist);
+
+/*! \fn void PA_PointsAngle(const PA_Point *pos, s32 n, s32 x, s32 y, u16 *angle)
+    \brief
+         \~english Angle from each point to a position (0-4095, see PA_Atan2F), for example for enemies aiming at the player. The division of a point is computed by the hardware while the next one is prepared.
+         \~french Angle de chaque point vers une position (0-4095, voir PA_Atan2F), par exemple pour des ennemis qui visent le joueur. La division d'un point est calculée par le matériel pendant que le suivant est préparé.
+    \~\param pos
+         \~english Points
+         \~french Points
+    \~\param n
+         \~english Number of points
+         \~french Nombre de points
+    \~\param x
+         \~english X of the position
+         \~french X de la position
+    \~\param y
+         \~english Y of the position
+         \~french Y de la position
+    \~\param angle
+         \~english Gets the n angles
+         \~french Reçoit les n angles
+*/
+void PA_PointsAngle(const PA_Point *pos, s32 n, s32 x, s32 y, u16 *angle);
+
+/** @} */ // end of Fixed
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
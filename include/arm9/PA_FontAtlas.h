@@ -0,0 +1,213 @@
+#ifndef _PA_FONTATLAS
+#define _PA_FONTATLAS
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \file PA_FontAtlas.h
+    \brief Variable width fonts with UTF-8 text and kerning
+
+    A font atlas holds any number of glyphs, indexed by Unicode codepoint.
+    Glyphs are 1 bit images of up to 16x16 pixels, stored in pages so that
+    big fonts opened from the filesystem only keep a few pages in memory.
+    Atlases are made from PAGfx fonts with the PAFontAtlas tool.
+*/
+
+#include "PA9.h"
+#include <stdio.h>
+
+#define PA_FONTATLAS_MAGIC   0x41464150 // "PAFA"
+#define PA_FONTATLAS_VERSION 1
+
+// Number of glyph pages kept in memory for fonts opened from a file
+#define PA_FONTATLAS_CACHE 4
+
+// File header, all offsets are from the start of the file
+typedef struct {
+	u32 Magic;
+	u16 Version;
+	u8 Height;         // Height of every glyph, 16 at most
+	u8 PageShift;      // 1 << PageShift glyphs per page
+	u32 NGlyphs;
+	u32 NKerns;
+	u32 CodesOffset;   // u32 codepoints, sorted
+	u32 MetricsOffset; // PA_FontAtlasMetrics for each glyph
+	u32 KernOffset;    // PA_FontAtlasKern pairs, sorted by Left then Right
+	u32 PagesOffset;   // Glyph images, Height u16 lines per glyph
+} PA_FontAtlasHeader;
+
+typedef struct {
+	u8 Width;   // Width of the glyph image
+	u8 Advance; // Distance to the next letter
+} PA_FontAtlasMetrics;
+
+typedef struct {
+	u16 Left, Right; // Glyph numbers
+	s16 Amount;      // Added to the advance of the left glyph
+} PA_FontAtlasKern;
+
+typedef struct {
+	PA_FontAtlasHeader Header;
+	const u32 *Codes;
+	const PA_FontAtlasMetrics *Metrics;
+	const PA_FontAtlasKern *Kerns;
+	const u16 *Pages;   // All the glyph images, NULL if opened from a file
+	void *Resident;     // Memory allocated for the tables of a file
+
+	// Pages loaded from a file
+	FILE *File;
+	u32 PageSize;       // In bytes
+	s32 PageNum[PA_FONTATLAS_CACHE];
+	u32 PageUsed[PA_FONTATLAS_CACHE];
+	u16 *PageData[PA_FONTATLAS_CACHE];
+	u32 Clock;
+} PA_FontAtlas;
+
+/** @defgroup FontAtlas Font atlases
+ *  Variable width fonts with UTF-8 text and kerning
+ *  @{
+ */
+
+/*! \fn PA_FontAtlas* PA_LoadFontAtlas(const void *data)
+    \brief
+         \~english Use a font atlas that is already in memory (for example included with the data folder). Nothing is copied. Returns NULL if the data isn't a font atlas.
+         \~french Utilise une police déjà en mémoire (par exemple incluse avec le dossier data). Rien n'est copié. Renvoie NULL si ce n'est pas une police.
+    \~\param data
+         \~english Font atlas data, aligned on 4 bytes
+         \~french Données de la police, alignées sur 4 octets
+*/
+PA_FontAtlas* PA_LoadFontAtlas(const void *data);
+
+/*! \fn PA_FontAtlas* PA_OpenFontAtlas(const char *filename)
+    \brief
+         \~english Open a font atlas from the filesystem. Only the index is kept in memory, glyph pages are loaded when they are needed. Returns NULL if the file can't be read.
+         \~french Ouvre une police depuis le système de fichiers. Seul l'index est gardé en mémoire, les pages de lettres sont chargées quand on en a besoin. Renvoie NULL si le fichier ne peut pas être lu.
+    \~\param filename
+         \~english Path of the file
+         \~french Chemin du fichier
+*/
+PA_FontAtlas* PA_OpenFontAtlas(const char *filename);
+
+/*! \fn void PA_CloseFontAtlas(PA_FontAtlas *font)
+    \brief
+         \~english Free a font atlas, and close its file
+         \~french Libère une police, et ferme son fichier
+    \~\param font
+         \~english Font atlas
+         \~french Police
+*/
+void PA_CloseFontAtlas(PA_FontAtlas *font);
+
+/*! \fn u32 PA_UTF8Decode(const char **text)
+    \brief
+         \~english Read a character from an UTF-8 string and move to the next one. Invalid bytes give 0xFFFD.
+         \~french Lit un caractère d'un texte en UTF-8 et passe au suivant. Les octets invalides donnent 0xFFFD.
+    \~\param text
+         \~english Pointer to the string
+         \~french Pointeur vers le texte
+*/
+u32 PA_UTF8Decode(const char **text);
+
+/*! \fn s32 PA_FontAtlasGlyph(const PA_FontAtlas *font, u32 code)
+    \brief
+         \~english Get the glyph number of a character, or -1 if it isn't in the font
+         \~french Renvoie le numéro de lettre d'un caractère, ou -1 s'il n'est pas dans la police
+    \~\param font
+         \~english Font atlas
+         \~french Police
+    \~\param code
+         \~english Unicode codepoint
+         \~french Code Unicode
+*/
+s32 PA_FontAtlasGlyph(const PA_FontAtlas *font, u32 code);
+
+/*! \fn s32 PA_FontAtlasKerning(const PA_FontAtlas *font, s32 left, s32 right)
+    \brief
+         \~english Get the kerning between two glyphs, 0 if there is none
+         \~french Renvoie le crénage entre deux lettres, 0 s'il n'y en a pas
+    \~\param font
+         \~english Font atlas
+         \~french Police
+    \~\param left
+         \~english Glyph number of the first letter
+         \~french Numéro de la première lettre
+    \~\param right
+         \~english Glyph number of the second letter
+         \~french Numéro de la deuxième lettre
+*/
+s32 PA_FontAtlasKerning(const PA_FontAtlas *font, s32 left, s32 right);
+
+/*! \fn const u16* PA_FontAtlasImage(PA_FontAtlas *font, s32 glyph)
+    \brief
+         \~english Get the image of a glyph, one u16 per line with bit 0 as the leftmost pixel. For fonts opened from a file it stays valid until another page is loaded.
+         \~french Renvoie l'image d'une lettre, un u16 par ligne avec le bit 0 pour le pixel de gauche. Pour les polices ouvertes depuis un fichier, elle reste valide jusqu'au chargement d'une autre page.
+    \~\param font
+         \~english Font atlas
+         \~french Police
+    \~\param glyph
+         \~english Glyph number
+         \~french Numéro de la lettre
+*/
+const u16* PA_FontAtlasImage(PA_FontAtlas *font, s32 glyph);
+
+/*! \fn s32 PA_FontAtlasTextWidth(const PA_FontAtlas *font, const char *text)
+    \brief
+         \~english Width in pixels of an UTF-8 string on a single line
+         \~french Largeur en pixels d'un texte UTF-8 sur une seule ligne
+    \~\param font
+         \~english Font atlas
+         \~french Police
+    \~\param text
+         \~english UTF-8 text
+         \~french Texte en UTF-8
+*/
+s32 PA_FontAtlasTextWidth(const PA_FontAtlas *font, const char *text);
+
+/*! \fn s32 PA_FontAtlasText(u8 mode, u8 screen, PA_FontAtlas *font, s16 basex, s16 basey, s16 maxx, s16 maxy, const char *text, u16 color, u8 transp, s32 limit)
+    \brief
+         \~english Write UTF-8 text in a box with a font atlas, cutting lines between words. Returns the number of letters written.
+         \~french Ecrire un texte UTF-8 dans une zone avec une police, en coupant les lignes entre les mots. Renvoie le nombre de lettres écrites.
+    \~\param mode
+         \~english Background type: PA_TEXTRUN_8BIT, PA_TEXTRUN_16BIT or PA_TEXTRUN_16C
+         \~french Type de fond : PA_TEXTRUN_8BIT, PA_TEXTRUN_16BIT ou PA_TEXTRUN_16C
+    \~\param screen
+         \~english Chose de screen (0 or 1)
+         \~french Choix de l'écran (0 ou 1)
+    \~\param font
+         \~english Font atlas
+         \~french Police
+    \~\param basex
+         \~english X coordinate of the top left corner
+         \~french Coordonnée X du coin supérieur gauche
+    \~\param basey
+         \~english Y coordinate of the top left corner
+         \~french Coordonnée Y du coin supérieur gauche
+    \~\param maxx
+         \~english X coordinate of the down right corner
+         \~french Coordonnée X du coin inférieur droit
+    \~\param maxy
+         \~english Y coordinate of the down right corner
+         \~french Coordonnée Y du coin inférieur droit
+    \~\param text
+         \~english UTF-8 text
+         \~french Texte en UTF-8
+    \~\param color
+         \~english Palette color (8 bit and 16c) or 15 bit color (16 bit)
+         \~french Couleur de la palette (8 bit et 16c) ou couleur de 15 bits (16 bit)
+    \~\param transp
+         \~english 0 to erase what is under the letters, 1 to draw them over the background. 16c text is always transparent.
+         \~french 0 pour effacer ce qu'il y a sous les lettres, 1 pour écrire par-dessus. Le texte 16c est toujours transparent.
+    \~\param limit
+         \~english Maximum number of letters to write
+         \~french Nombre maximum de lettres à écrire
+*/
+s32 PA_FontAtlasText(u8 mode, u8 screen, PA_FontAtlas *font, s16 basex, s16 basey, s16 maxx, s16 maxy, const char *text, u16 color, u8 transp, s32 limit);
+
+/** @} */ // end of FontAtlas
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
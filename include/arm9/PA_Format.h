@@ -0,0 +1,67 @@
+#ifndef _PA_FORMAT
+#define _PA_FORMAT
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \file PA_Format.h
+    \brief printf-like formatting without floating point for integers
+
+    Used by all the text functions. %d, %u and %x only use integer maths, %f
+    takes the double apart with integer maths too, so no soft-float code is
+    called, and %q/%Q print fixed point numbers directly. Nothing is
+    allocated. PAlib color codes (%c followed by a digit) are copied as they are
+    for the text functions to handle.
+*/
+
+#include <nds.h>
+#include <stdarg.h>
+
+/** @defgroup Format Text formatting
+ *  printf-like formatting without floating point for integers
+ *  @{
+ */
+
+/*! \fn s32 PA_VFormat(char *out, u32 size, const char *format, va_list args)
+    \brief
+         \~english Format a string like vsnprintf. Supports %d %i %u %x %X %s %c %f %% and %q/%Q for fixed point numbers with 8/12 bits after the point (3 decimals by default), with the flags - 0 + and space, a width and a precision (or * for both), %fN for N decimals like PA_OutputText, and l/ll/h length modifiers. %x gives capital letters like %X, as the text functions always did. %c followed by a digit is a color code and is copied as it is. Returns the length of the result, which is cut to fit in size-1 characters.
+         \~french Formate un texte comme vsnprintf. Gère %d %i %u %x %X %s %c %f %% et %q/%Q pour les nombres à virgule fixe avec 8/12 bits après la virgule (3 décimales par défaut), avec les options - 0 + et espace, une largeur et une précision (ou * pour les deux), %fN pour N chiffres après la virgule comme PA_OutputText, et les tailles l/ll/h. %x donne des lettres majuscules comme %X, comme les fonctions de texte l'ont toujours fait. %c suivi d'un chiffre est un code couleur et est recopié tel quel. Renvoie la longueur du résultat, qui est coupé pour tenir dans size-1 caractères.
+    \~\param out
+         \~english Buffer for the result
+         \~french Tampon pour le résultat
+    \~\param size
+         \~english Size of the buffer
+         \~french Taille du tampon
+    \~\param format
+         \~english Format string
+         \~french Texte de format
+    \~\param args
+         \~english Arguments
+         \~french Arguments
+*/
+s32 PA_VFormat(char *out, u32 size, const char *format, va_list args);
+
+/*! \fn s32 PA_Format(char *out, u32 size, const char *format, ...)
+    \brief
+         \~english Same as PA_VFormat, with the arguments given directly
+         \~french Comme PA_VFormat, avec les arguments donnés directement
+    \~\param out
+         \~english Buffer for the result
+         \~french Tampon pour le résultat
+    \~\param size
+         \~english Size of the buffer
+         \~french Taille du tampon
+    \~\param format
+         \~english Format string
+         \~french Texte de format
+*/
+s32 PA_Format(char *out, u32 size, const char *format, ...);
+
+/** @} */ // end of Format
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -278,6 +278,9 @@ static inline void PA_SetLedBlink(u8 blink, u8 speed);
 */
 u8 PA_CheckLid();
 
+extern u8 PA_ProfileOn; // From PA_Profile.h, which not every file includes before this one
+void PA_ProfileIdle(void);
+
 /*! \fn static inline void PA_WaitForVBL()
     \brief
          \~english Wait for the VBlank to occur
@@ -285,6 +288,7 @@ u8 PA_CheckLid();
 */
 static inline void PA_WaitForVBL(){
 	if(pa_checklid) PA_CheckLid();
+	if(PA_ProfileOn) PA_ProfileIdle();
 
 	// Let other threads interrupt the main thread
 	//swiWaitForVBlank();
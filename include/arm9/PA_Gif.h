@@ -34,6 +34,79 @@ extern PA_GifInfos PA_GifInfo;
 
 void PA_Load16bitGif(u8 screen, s16 x, s16 y, void *gif);
 
+// Destinations for the gif player
+#define PA_GIF_8BIT   0 // 8 bit buffer, with a 256 color palette
+#define PA_GIF_16BIT  1 // 16 bit buffer
+#define PA_GIF_SPRITE 2 // 256 color sprite or texture gfx, in 8x8 tiles
+
+// State of the gif player cache
+#define PA_GIFCACHE_OFF      0
+#define PA_GIFCACHE_BUILDING 1 // Frames are kept while the gif plays the first time
+#define PA_GIFCACHE_READY    2 // Frames are played from the cache
+#define PA_GIFCACHE_FULL     3 // Bigger than the limit, the gif is decoded each time
+
+// Frame kept in the cache: the area that changed since the frame before
+typedef struct {
+	s16 X1, Y1, X2, Y2;
+	s32 Delay;
+	u16 *Palette;        // New palette, NULL if it didn't change
+	u8 *Pixels;          // Area of the canvas once the frame is drawn
+} PA_GifCacheFrame;
+
+typedef struct {
+	GifFileType *File;
+	const u8 *Data;      // Gif file, kept to start again when looping
+	u8 Mode;             // PA_GIF_8BIT, PA_GIF_16BIT or PA_GIF_SPRITE
+	void *Dest;
+	s16 DestWidth;       // Pixels per line of the destination
+	u16 *Palette;        // Palette to update, NULL for none
+	s8 Screen;           // Screen for the dirty rectangles, -1 if not a background
+	s16 X, Y;            // Position on that screen
+	u16 Colors[256];     // Palette of the frame being decoded
+
+	u8 *Canvas;          // Whole gif image, as palette indexes (colors in 16 bit mode)
+	u8 *Line;            // Line being decoded
+	s16 Width, Height;
+	u8 BgIndex;          // Background color, for disposal
+	u16 BgColor;
+
+	u8 Play;             // 0 stop, 1 play, 2 pause
+	u8 Loop;             // Start again at the end
+	s32 Speed;           // 256 for normal speed, 512 for twice as fast...
+	s32 Frame;           // Frames shown since the start
+	s32 Budget;          // Decoding time allowed at each step, in scanlines
+
+	// Frame being decoded
+	u8 State;
+	u8 Ready;            // Decoded and waiting for its time
+	u8 Pass, Interlace;
+	s16 Row, Left, Top, ImgWidth, ImgHeight;
+	s16 Transp;          // Transparent color, -1 for none
+	u8 Disposal;         // What to do with the frame once it has been shown
+	s32 Delay;           // In 1/100 of a second
+
+	// Previous frame, disposed before drawing the next one
+	u8 PrevDisposal;
+	s16 PrevLeft, PrevTop, PrevWidth, PrevHeight;
+	u8 *Saved;           // Area under the previous frame, for disposal 3 (restore to previous)
+	u32 SavedSize;       // Bytes allocated for it
+
+	// Area to copy to the destination
+	s16 X1, Y1, X2, Y2;
+	u8 PaletteChanged;
+
+	u32 ShowTime;        // PA_VBLCount at which the decoded frame can be shown
+	u32 DecodeLines;     // Time spent decoding the current frame, in scanlines
+	u32 LastDecodeLines; // Same for the last frame shown
+
+	// Decoded frames, see PA_GifPlayerCache
+	u8 CacheState;       // PA_GIFCACHE_...
+	u32 CacheMax, CacheSize; // In bytes
+	PA_GifCacheFrame *CacheFrames;
+	s32 CacheCount, CacheAlloc, CacheFrame;
+	const u16 *CachePalette; // Last palette kept
+} PA_GifPlayer;
+
 int DecodeGif(const u8 *userData, u8 *ScreenBuff, u16* Palette, u8 nBits, s16 SWidth);
 
 /** @defgroup Gif Gif functions
@@ -177,6 +250,176 @@ static inline s32 PA_GifGetFrame(void){
 	return PA_GifInfo.CurrentFrame;
 }
 
+/*! \fn PA_GifPlayer* PA_GifPlayerOpen(const void *gif, u8 mode, void *dest, s16 destwidth, u16 *palette)
+    \brief
+         \~english Open an animated gif to play it without blocking: call PA_GifPlayerStep once per frame. Several gifs can be played at the same time. Returns NULL if there isn't enough memory.
+         \~french Ouvre un gif animé pour le jouer sans bloquer : appeler PA_GifPlayerStep une fois par frame. Plusieurs gifs peuvent être joués en même temps. Renvoie NULL s'il n'y a pas assez de mémoire.
+    \~\param gif
+         \~english Gif file, it must stay in memory until the player is closed
+         \~french Fichier gif, il doit rester en mémoire jusqu'à la fermeture
+    \~\param mode
+         \~english PA_GIF_8BIT (8 bit buffer), PA_GIF_16BIT (16 bit buffer) or PA_GIF_SPRITE (256 color sprite gfx, the gif width and height must be multiples of 8)
+         \~french PA_GIF_8BIT (tampon 8 bit), PA_GIF_16BIT (tampon 16 bit) ou PA_GIF_SPRITE (gfx de sprite 256 couleurs, la largeur et la hauteur du gif doivent être des multiples de 8)
+    \~\param dest
+         \~english Where to draw the top left corner of the gif
+         \~french Où dessiner le coin supérieur gauche du gif
+    \~\param destwidth
+         \~english Width of the destination in pixels (256 for a screen), not used for sprites
+         \~french Largeur de la destination en pixels (256 pour un écran), pas utilisé pour les sprites
+    \~\param palette
+         \~english Palette to update with the gif's colors for 8 bit and sprite modes, NULL to leave it alone
+         \~french Palette à mettre à jour avec les couleurs du gif en modes 8 bit et sprite, NULL pour ne pas y toucher
+*/
+PA_GifPlayer* PA_GifPlayerOpen(const void *gif, u8 mode, void *dest, s16 destwidth, u16 *palette);
+
+/*! \fn PA_GifPlayer* PA_GifPlayerOpenBg(u8 screen, s16 x, s16 y, const void *gif)
+    \brief
+         \~english Open an animated gif to play it on an 8 bit or 16 bit background, like PA_LoadGifXY but without blocking
+         \~french Ouvre un gif animé pour le jouer sur un fond 8 bit ou 16 bit, comme PA_LoadGifXY mais sans bloquer
+    \~\param screen
+         \~english Chose de screen (0 or 1)
+         \~french Choix de l'écran (0 ou 1)
+    \~\param x
+         \~english X position on the screen
+         \~french Position X à l'écran
+    \~\param y
+         \~english Y position on the screen
+         \~french Position Y à l'écran
+    \~\param gif
+         \~english Gif file
+         \~french Fichier gif
+*/
+PA_GifPlayer* PA_GifPlayerOpenBg(u8 screen, s16 x, s16 y, const void *gif);
+
+/*! \fn u8 PA_GifPlayerStep(PA_GifPlayer *player)
+    \brief
+         \~english Decode the gif for at most the time budget, and show the next frame when its time has come. Call it once per frame. Returns 1 when a new frame has been shown.
+         \~french Décode le gif pendant au plus le temps autorisé, et affiche l'image suivante quand c'est son tour. A appeler une fois par frame. Renvoie 1 quand une nouvelle image a été affichée.
+    \~\param player
+         \~english Gif player
+         \~french Lecteur de gif
+*/
+u8 PA_GifPlayerStep(PA_GifPlayer *player);
+
+/*! \fn void PA_GifPlayerClose(PA_GifPlayer *player)
+    \brief
+         \~english Stop a gif and free its memory
+         \~french Arrête un gif et libère sa mémoire
+    \~\param player
+         \~english Gif player
+         \~french Lecteur de gif
+*/
+void PA_GifPlayerClose(PA_GifPlayer *player);
+
+/*! \fn u8 PA_GifPlayerCache(PA_GifPlayer *player, u32 maxsize)
+    \brief
+         \~english Keep the frames of a looping gif the first time it's played, so the next loops only copy the areas that changed instead of decoding again. The gif file and the decoder are freed once all the frames are kept. If the frames need more than maxsize bytes, they are dropped and the gif is decoded each time as usual. Call it before the first PA_GifPlayerStep, returns 0 if it's too late.
+         \~french Garde les images d'un gif qui boucle la première fois qu'il est joué, pour que les boucles suivantes ne fassent que copier les zones qui ont changé au lieu de décoder à nouveau. Le fichier gif et le décodeur sont libérés une fois toutes les images gardées. Si les images prennent plus de maxsize octets, elles sont abandonnées et le gif est décodé à chaque fois comme d'habitude. A appeler avant le premier PA_GifPlayerStep, renvoie 0 si c'est trop tard.
+    \~\param player
+         \~english Gif player
+         \~french Lecteur de gif
+    \~\param maxsize
+         \~english Memory allowed for the cache, in bytes
+         \~french Mémoire autorisée pour le cache, en octets
+*/
+u8 PA_GifPlayerCache(PA_GifPlayer *player, u32 maxsize);
+
+/*! \fn static inline u8 PA_GifPlayerCached(PA_GifPlayer *player)
+    \brief
+         \~english Returns 1 if the gif is played from the cache
+         \~french Renvoie 1 si le gif est joué depuis le cache
+    \~\param player
+         \~english Gif player
+         \~french Lecteur de gif
+*/
+static inline u8 PA_GifPlayerCached(PA_GifPlayer *player){
+	return player->CacheState == PA_GIFCACHE_READY;
+}
+
+/*! \fn static inline void PA_GifPlayerBudget(PA_GifPlayer *player, s32 lines)
+    \brief
+         \~english Set how long PA_GifPlayerStep can decode, in scanlines (63.5 microseconds each, 263 per frame). 32 by default.
+         \~french Règle combien de temps PA_GifPlayerStep peut décoder, en lignes d'écran (63.5 microsecondes chacune, 263 par frame). 32 par défaut.
+    \~\param player
+         \~english Gif player
+         \~french Lecteur de gif
+    \~\param lines
+         \~english Time in scanlines
+         \~french Temps en lignes
+*/
+static inline void PA_GifPlayerBudget(PA_GifPlayer *player, s32 lines){
+	player->Budget = lines;
+}
+
+/*! \fn static inline void PA_GifPlayerSpeed(PA_GifPlayer *player, s32 speed)
+    \brief
+         \~english Set the speed of a gif
+         \~french Changer la vitesse d'un gif
+    \~\param player
+         \~english Gif player
+         \~french Lecteur de gif
+    \~\param speed
+         \~english 256 for normal, 512 for 2x, 128 for half speed...
+         \~french 256 pour normal, 512 pour 2x, 128 pour la moitié...
+*/
+static inline void PA_GifPlayerSpeed(PA_GifPlayer *player, s32 speed){
+	player->Speed = speed;
+}
+
+/*! \fn static inline void PA_GifPlayerLoop(PA_GifPlayer *player, u8 loop)
+    \brief
+         \~english Play the gif again when it ends (on by default)
+         \~french Rejouer le gif quand il est fini (activé par défaut)
+    \~\param player
+         \~english Gif player
+         \~french Lecteur de gif
+    \~\param loop
+         \~english 1 to loop, 0 to stop at the end
+         \~french 1 pour boucler, 0 pour s'arrêter à la fin
+*/
+static inline void PA_GifPlayerLoop(PA_GifPlayer *player, u8 loop){
+	player->Loop = loop;
+}
+
+/*! \fn static inline void PA_GifPlayerPause(PA_GifPlayer *player, u8 pause)
+    \brief
+         \~english Pause or unpause a gif
+         \~french Mettre en pause ou reprendre un gif
+    \~\param player
+         \~english Gif player
+         \~french Lecteur de gif
+    \~\param pause
+         \~english 1 to pause, 0 to play
+         \~french 1 pour la pause, 0 pour jouer
+*/
+static inline void PA_GifPlayerPause(PA_GifPlayer *player, u8 pause){
+	if (player->Play) player->Play = pause ? 2 : 1;
+}
+
+/*! \fn static inline u8 PA_GifPlayerPlaying(PA_GifPlayer *player)
+    \brief
+         \~english Returns 0 once a gif that doesn't loop has ended, 1 if it's playing, 2 if it's paused
+         \~french Renvoie 0 quand un gif qui ne boucle pas est fini, 1 s'il est joué, 2 s'il est en pause
+    \~\param player
+         \~english Gif player
+         \~french Lecteur de gif
+*/
+static inline u8 PA_GifPlayerPlaying(PA_GifPlayer *player){
+	return player->Play;
+}
+
+/*! \fn static inline u32 PA_GifPlayerDecodeTime(PA_GifPlayer *player)
+    \brief
+         \~english Time spent decoding the last frame shown, in scanlines (63.5 microseconds each)
+         \~french Temps passé à décoder la dernière image affichée, en lignes d'écran (63.5 microsecondes chacune)
+    \~\param player
+         \~english Gif player
+         \~french Lecteur de gif
+*/
+static inline u32 PA_GifPlayerDecodeTime(PA_GifPlayer *player){
+	return player->LastDecodeLines;
+}
+
 /*
 /N! \fn void PA_GifToTiles(void *gif, u16 *temppal)
     \brief
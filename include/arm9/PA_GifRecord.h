@@ -0,0 +1,167 @@
+#ifndef _PA_GifRecord
+#define _PA_GifRecord
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \file PA_GifRecord.h
+    \brief Record the screen to an animated gif
+
+    Frames are grabbed from a bitmap background or from the main screen with
+    the display capture, then compared, quantised and encoded a few lines at
+    each frame, so a short clip can be recorded while the game runs. A frame
+    is written once the next one that changed is grabbed, with the time it
+    really stayed on screen.
+*/
+
+#include <PA9.h>
+
+#include "gif/gif_lib.h"
+
+// Where the frames come from
+#define PA_GIFREC_BG      0 // 8 or 16 bit bitmap background
+#define PA_GIFREC_CAPTURE 1 // Output of the main screen, with display capture
+
+// How 15 bit colors become 256
+#define PA_GIFREC_FIXED   0 // Fixed palette, 3 bits of red and green and 2 of blue
+#define PA_GIFREC_OCTREE  1 // Best 256 colors of each frame
+
+#define PA_OCTREE_LEVELS 5 // 5 bits per component
+#define PA_OCTREE_NODES  1536
+
+typedef struct {
+	u32 R, G, B, Count;  // Sum of the colors in the node
+	u16 Child[8];        // 0 for none, the root is never a child
+	u16 Next;            // Next node to reduce on the same level, or next free node
+	u8 Leaf, Index;      // Palette index of a leaf
+} PA_OctreeNode;
+
+typedef struct {
+	PA_OctreeNode Nodes[PA_OCTREE_NODES];
+	u16 Reducible[PA_OCTREE_LEVELS];
+	u16 Free, Used;
+	u16 Leaves;
+} PA_Octree;
+
+typedef struct {
+	GifFileType *Gif;
+	FILE *File;
+	u8 Source;           // PA_GIFREC_BG or PA_GIFREC_CAPTURE
+	u8 Screen;           // Screen of the background, or VRAM bank (0-3 for A-D) for the capture
+	u8 Quantize;         // PA_GIFREC_FIXED or PA_GIFREC_OCTREE
+	s16 Width, Height;
+
+	u16 *Frame;          // Frame just grabbed, 15 bit colors
+	u16 *Prev;           // Frame before, written once the next one is grabbed and its time on screen known
+	u8 *Line;            // Palette indexes of the line being encoded
+	PA_Octree *Octree;
+	GifColorType Colors[256];
+
+	u8 State;
+	s32 Row;
+	s16 X1, Y1, X2, Y2;  // Area of Frame that changed
+	s16 PX1, PY1, PX2, PY2; // Same for Prev, the area written
+	u8 HasPrev;          // Prev holds a frame not written yet
+
+	s32 Interval;        // VBLs between 2 frames
+	s32 Budget;          // Time allowed at each step, in scanlines
+	u32 GrabTime;        // PA_VBLCount when Frame was grabbed
+	u32 PrevTime;        // Same for Prev
+	s32 Frames;          // Frames written
+	u32 StepLines;       // Time taken by the last step, in scanlines
+} PA_GifRecorder;
+
+/** @defgroup GifRecord Gif recording
+ *  Record the screen to an animated gif
+ *  @{
+ */
+
+/*! \fn PA_GifRecorder* PA_GifRecordStart(const char *filename, u8 source, u8 screen, u8 quantize)
+    \brief
+         \~english Start recording a gif. Call PA_GifRecordStep once per frame, it grabs a frame every few VBLs and encodes it a little at each step. Returns NULL if the file can't be created or there isn't enough memory. Only the area that changed is written for each frame.
+         \~french Commence l'enregistrement d'un gif. Appeler PA_GifRecordStep une fois par frame, il prend une image toutes les quelques VBLs et l'encode un peu à chaque fois. Renvoie NULL si le fichier ne peut pas être créé ou s'il n'y a pas assez de mémoire. Seule la zone qui a changé est écrite pour chaque image.
+    \~\param filename
+         \~english Gif file to write
+         \~french Fichier gif à écrire
+    \~\param source
+         \~english PA_GIFREC_BG to record a 8 or 16 bit bitmap background, PA_GIFREC_CAPTURE to record everything shown on the main screen (2D and 3D) with the display capture. The capture can't be used by the dual screen 3D at the same time.
+         \~french PA_GIFREC_BG pour enregistrer un fond bitmap 8 ou 16 bit, PA_GIFREC_CAPTURE pour enregistrer tout ce qui est affiché sur l'écran principal (2D et 3D) avec la capture d'écran. La capture ne peut pas être utilisée par la 3D sur les 2 écrans en même temps.
+    \~\param screen
+         \~english Screen of the background for PA_GIFREC_BG, free VRAM bank to capture to (0-3 for A-D) for PA_GIFREC_CAPTURE
+         \~french Ecran du fond pour PA_GIFREC_BG, banque de VRAM libre où capturer (0-3 pour A-D) pour PA_GIFREC_CAPTURE
+    \~\param quantize
+         \~english PA_GIFREC_FIXED for a fast fixed palette, PA_GIFREC_OCTREE to find the best 256 colors of each frame
+         \~french PA_GIFREC_FIXED pour une palette fixe rapide, PA_GIFREC_OCTREE pour trouver les 256 meilleures couleurs de chaque image
+*/
+PA_GifRecorder* PA_GifRecordStart(const char *filename, u8 source, u8 screen, u8 quantize);
+
+/*! \fn u8 PA_GifRecordStep(PA_GifRecorder *rec)
+    \brief
+         \~english Grab the next frame when it's time, and work on the current one for at most the time budget. Call it once per frame. Returns 1 when a frame has been written.
+         \~french Prend l'image suivante quand c'est le moment, et travaille sur l'image en cours pendant au plus le temps autorisé. A appeler une fois par frame. Renvoie 1 quand une image a été écrite.
+    \~\param rec
+         \~english Gif recorder
+         \~french Enregistreur de gif
+*/
+u8 PA_GifRecordStep(PA_GifRecorder *rec);
+
+/*! \fn void PA_GifRecordStop(PA_GifRecorder *rec)
+    \brief
+         \~english Finish the frame being written, write the last frame, close the gif file and free the memory
+         \~french Termine l'image en cours d'écriture, écrit la dernière image, ferme le fichier gif et libère la mémoire
+    \~\param rec
+         \~english Gif recorder
+         \~french Enregistreur de gif
+*/
+void PA_GifRecordStop(PA_GifRecorder *rec);
+
+/*! \fn static inline void PA_GifRecordInterval(PA_GifRecorder *rec, s32 vbls)
+    \brief
+         \~english Set how often a frame is grabbed, in VBLs. 6 by default (10 frames per second). Frames come later if the encoding takes longer.
+         \~french Règle tous les combien une image est prise, en VBLs. 6 par défaut (10 images par seconde). Les images arrivent plus tard si l'encodage prend plus de temps.
+    \~\param rec
+         \~english Gif recorder
+         \~french Enregistreur de gif
+    \~\param vbls
+         \~english Number of VBLs
+         \~french Nombre de VBLs
+*/
+static inline void PA_GifRecordInterval(PA_GifRecorder *rec, s32 vbls){
+	rec->Interval = vbls;
+}
+
+/*! \fn static inline void PA_GifRecordBudget(PA_GifRecorder *rec, s32 lines)
+    \brief
+         \~english Set how long PA_GifRecordStep can work, in scanlines (63.5 microseconds each, 263 per frame). 32 by default.
+         \~french Règle combien de temps PA_GifRecordStep peut travailler, en lignes d'écran (63.5 microsecondes chacune, 263 par frame). 32 par défaut.
+    \~\param rec
+         \~english Gif recorder
+         \~french Enregistreur de gif
+    \~\param lines
+         \~english Time in scanlines
+         \~french Temps en lignes
+*/
+static inline void PA_GifRecordBudget(PA_GifRecorder *rec, s32 lines){
+	rec->Budget = lines;
+}
+
+/*! \fn static inline s32 PA_GifRecordFrames(PA_GifRecorder *rec)
+    \brief
+         \~english Number of frames written so far
+         \~french Nombre d'images écrites jusqu'ici
+    \~\param rec
+         \~english Gif recorder
+         \~french Enregistreur de gif
+*/
+static inline s32 PA_GifRecordFrames(PA_GifRecorder *rec){
+	return rec->Frames;
+}
+
+/** @} */ // end of GifRecord
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
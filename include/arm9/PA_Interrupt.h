@@ -16,8 +16,13 @@ typedef void (*funcpointer)();
 extern funcpointer MotionVBL;
 extern funcpointer GHPadVBL;
 extern funcpointer PaddleVBL;
+extern funcpointer PaletteVBL;
+extern funcpointer RasterVBL;
+extern funcpointer UploadVBL;
+extern funcpointer Dual3DVBL;
 
 extern s32 PA_VBLCounter[16]; // VBL counters
+extern vu32 PA_VBLCount; // Number of VBLs since PA_Init
 extern bool PA_VBLCounterOn[16]; // VBL counters enable/disable flag
 
 extern funcpointer CustomVBL;
@@ -8,6 +8,7 @@ extern "C" {
 #include "PA9.h"
 
 #include "PA_Interrupt.h"
+#include "PA_Fixed.h"
 
 
 /** @defgroup Math Math functions
@@ -145,9 +146,7 @@ static inline u64 PA_Distance(s32 x1, s32 y1, s32 x2, s32 y2) {
          \~french Coordonn?e Y du deuxi?me point
 */
 static inline u64 PA_TrueDistance(s32 x1, s32 y1, s32 x2, s32 y2) {
-   s64 h = x1 - x2;
-   s64 v = y1 - y2;
-   return(swiSqrt(h*h + v*v));
+   return PA_LengthF(x1 - x2, y1 - y2); // Hardware square root
 }
 
 /*! \fn u16 PA_AdjustAngle(u16 angle, s16 anglerot, s32 startx, s32 starty, s32 targetx, s32 targety)
@@ -194,35 +193,12 @@ u16 PA_AdjustAngle(u16 angle, s16 anglerot, s32 startx, s32 starty, s32 targetx,
          \~french Coordonn?e Y de la cible
 */
 static inline u16 PA_GetAngle(s32 startx, s32 starty, s32 targetx, s32 targety) {
-	u16 angle = 0;
-	u16 anglerot = 180;
-
-	while(anglerot > 5) {
-		angle = PA_AdjustAngle(angle, anglerot, startx, starty, targetx, targety);
-		anglerot = (anglerot - ((3 * anglerot) >> 3)); // On diminue petit ? petit la rotation...
-	}
-
-	// Ajustement encore plus précis...
-	anglerot = 4;
-	angle = PA_AdjustAngle(angle, anglerot, startx, starty, targetx, targety);
-	anglerot = 2;
-	angle = PA_AdjustAngle(angle, anglerot, startx, starty, targetx, targety);
-	anglerot = 1;
-	angle = PA_AdjustAngle(angle, anglerot, startx, starty, targetx, targety);
-
-	return angle;
+	// 4096 angles with y going up, rounded to 512
+	return ((PA_Atan2F(starty - targety, targetx - startx) + 4) >> 3) & 511;
 }
 
 // fincs additions
 
-/// Simple point structure.
-typedef struct{
-	/// X value.
-	int x;
-	/// Y value.
-	int y;
-}PA_Point;
-
 /*! \fn int PA_mulf32(int a, int b)
     \brief
          \~english Multiplies two .12 fixed point integers
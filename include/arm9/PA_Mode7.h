@@ -73,22 +73,20 @@ extern s16 mode7_distance;
 
 /*! \fn void PA_InitMode7(u8 bg_select)
     \brief
-         \~english Initialize Mode 7 for a given background. You MUST be in video mode 1 or 2
-         \~french Initialise le Mode 7 pour un fond donné. Vous devez etre en mode 1 ou 2 impérativement !
+         \~english Initialize Mode 7 for a given background of the bottom screen. You MUST be in video mode 1 or 2. It is a raster effect, so it can be used with the fake 16 bit backgrounds and the other raster effects.
+         \~french Initialise le Mode 7 pour un fond donné de l'écran du bas. Vous devez etre en mode 1 ou 2 impérativement ! C'est un effet raster, il peut donc être utilisé avec les fonds 16 bit simulés et les autres effets raster.
     \~\param bg_select
          \~english Bg number, 2 in mode 1, 2 or 3 in mode 2
          \~french Numéro du fond. 2 en mode 1, 2 ou 3 en mode 2
 */
 void PA_InitMode7(u8 bg_select);
 
-/*! \fn static inline void PA_DeInitMode7(void)
+/*! \fn void PA_DeInitMode7(void)
     \brief
          \~english DeInitialize Mode 7
          \~french DesInitialise le Mode 7
 */
-static inline void PA_DeInitMode7(){
-	irqDisable(IRQ_HBLANK);
-}
+void PA_DeInitMode7(void);
 
 
 /*! \fn static inline void PA_Mode7Angle(s16 angle)
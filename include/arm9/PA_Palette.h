@@ -196,6 +196,34 @@ static inline void PA_LoadSpritePal(u8 screen, u8 palette_number, void* palette)
 	PA_LoadSpriteExtPal(screen, palette_number, palette);
 }
 
+extern u8 pa_sprpalrefs[2][16]; // Users of each sprite palette from PA_AllocSpritePal, 0 if free
+
+/*! \fn s8 PA_AllocSpritePal(u8 screen, void* palette)
+    \brief
+         \~english Get a sprite palette slot with those colors : the one already loaded with the same colors if there is one, else a free one, from palette 15 down, where the palette is loaded. Release it with PA_FreeSpritePal, and don't load another palette there with PA_LoadSpritePal. Returns the palette number, or -1 if they are all used.
+         \~french Obtenir un emplacement de palette de sprites avec ces couleurs : celui déjà chargé avec les mêmes couleurs s'il y en a un, sinon un libre, à partir de la palette 15 en descendant, où la palette est chargée. Le libérer avec PA_FreeSpritePal, et ne pas y charger une autre palette avec PA_LoadSpritePal. Renvoie le numéro de la palette, ou -1 s'ils sont tous utilisés.
+    \~\param screen
+         \~english Screen...
+         \~french Ecran...
+    \~\param palette
+         \~english Palette to load ((void*)palette_name)
+         \~french Nom de la palette à charger ((void*)nom_palette)
+*/
+s8 PA_AllocSpritePal(u8 screen, void* palette);
+
+/*! \fn void PA_FreeSpritePal(u8 screen, u8 palette_number)
+    \brief
+         \~english Release a palette from PA_AllocSpritePal. It is free again once all its users released it.
+         \~french Libérer une palette de PA_AllocSpritePal. Elle redevient libre une fois que tous ses utilisateurs l'ont libérée.
+    \~\param screen
+         \~english Screen...
+         \~french Ecran...
+    \~\param palette_number
+         \~english Palette number
+         \~french Numéro de la palette
+*/
+void PA_FreeSpritePal(u8 screen, u8 palette_number);
+
 /*! \fn PA_LoadBgPalN(u8 screen, u8 bg_number, u8 pal_number, void* palette)
     \brief
          \~english Load a 256 color palette in the Background palettes, to a given slot
@@ -0,0 +1,173 @@
+#ifndef _PA_PaletteShadow
+#define _PA_PaletteShadow
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \file PA_PaletteShadow.h
+    \brief Palettes kept in RAM, faded there and uploaded once per VBL
+
+    Every palette (standard and extended, backgrounds and sprites) can have a
+    copy in RAM. Colors, fades and crossfades are computed on that copy with
+    small lookup tables, and each palette that changed is copied to the
+    hardware once during the next VBL, with a single VRAM bank switch for all
+    the extended palettes of a bank.
+*/
+
+#include <PA9.h>
+
+// Palette numbers for the functions below
+#define PA_PAL_PER_SCREEN 82
+#define PA_PAL_BG(screen)            ((screen) * PA_PAL_PER_SCREEN) // Standard background palette
+#define PA_PAL_SPRITE(screen)        (PA_PAL_BG(screen) + 1)        // Standard sprite palette
+#define PA_PAL_BGEXT(screen, bg, n)  (PA_PAL_BG(screen) + 2 + ((bg) << 4) + (n)) // Extended palette n (0-15) of background bg (0-3)
+#define PA_PAL_SPRITEEXT(screen, n)  (PA_PAL_BG(screen) + 66 + (n)) // Extended sprite palette n (0-15)
+
+// What is applied to the colors
+#define PA_PALFX_NONE  0
+#define PA_PALFX_FADE  1 // Fade to a color
+#define PA_PALFX_CROSS 2 // Crossfade to another palette
+
+typedef struct {
+	u16 *Base;           // Colors given by the program, NULL if the palette isn't used
+	u16 *Shown;          // Colors after the fade, uploaded at the VBL
+	const u16 *Target;   // Palette to crossfade to
+	u16 Color;           // Color to fade to
+	u8 Effect, Level;    // PA_PALFX_..., level from 0 (none) to 32 (full)
+	vu8 Dirty;           // Upload at the next VBL
+} PA_PalShadow;
+
+extern PA_PalShadow PA_PalShadows[2 * PA_PAL_PER_SCREEN];
+extern u8 PA_PalShadowOn;
+
+/** @defgroup PaletteShadow Palette shadows
+ *  Keep palettes in RAM, fade them there and upload them once per VBL
+ *  @{
+ */
+
+/*! \fn void PA_PalShadowInit(void)
+    \brief
+         \~english Start keeping the palettes in RAM. From now on PA_LoadBgPalN, PA_LoadSpriteExtPal, PA_SetBgPalNCol and PA_SetSpritePalCol only change the RAM copy, and what changed is uploaded at the next VBL. Colors written straight to the palette memory (BG_PALETTE, PA_SetBgPalCol...) are overwritten by the RAM copy the next time it changes.
+         \~french Commence à garder les palettes en RAM. A partir de là PA_LoadBgPalN, PA_LoadSpriteExtPal, PA_SetBgPalNCol et PA_SetSpritePalCol changent seulement la copie en RAM, et ce qui a changé est envoyé au prochain VBL. Les couleurs écrites directement dans la mémoire des palettes (BG_PALETTE, PA_SetBgPalCol...) sont écrasées par la copie en RAM la prochaine fois qu'elle change.
+*/
+void PA_PalShadowInit(void);
+
+/*! \fn void PA_PalShadowStop(void)
+    \brief
+         \~english Stop keeping the palettes in RAM and free the memory. What is on screen stays as it is.
+         \~french Arrête de garder les palettes en RAM et libère la mémoire. Ce qui est à l'écran reste tel quel.
+*/
+void PA_PalShadowStop(void);
+
+/*! \fn u16* PA_PalShadowGet(u16 pal)
+    \brief
+         \~english Get the RAM copy of a palette, with the colors it has now. Call PA_PalShadowUpdate after changing it. Returns NULL if there isn't enough memory.
+         \~french Récupère la copie en RAM d'une palette, avec ses couleurs actuelles. Appeler PA_PalShadowUpdate après l'avoir changée. Renvoie NULL s'il n'y a pas assez de mémoire.
+    \~\param pal
+         \~english Palette, PA_PAL_BG(screen), PA_PAL_SPRITE(screen), PA_PAL_BGEXT(screen, bg, n) or PA_PAL_SPRITEEXT(screen, n)
+         \~french Palette, PA_PAL_BG(screen), PA_PAL_SPRITE(screen), PA_PAL_BGEXT(screen, bg, n) ou PA_PAL_SPRITEEXT(screen, n)
+*/
+u16* PA_PalShadowGet(u16 pal);
+
+/*! \fn void PA_PalShadowUpdate(u16 pal)
+    \brief
+         \~english Apply the fade to the colors of a palette after they were changed through PA_PalShadowGet, and upload it at the next VBL
+         \~french Applique le fondu aux couleurs d'une palette après qu'elles ont été changées avec PA_PalShadowGet, et l'envoie au prochain VBL
+    \~\param pal
+         \~english Palette (PA_PAL_...)
+         \~french Palette (PA_PAL_...)
+*/
+void PA_PalShadowUpdate(u16 pal);
+
+/*! \fn void PA_PalShadowLoad(u16 pal, const void *colors)
+    \brief
+         \~english Load a 256 color palette into the RAM copy
+         \~french Charge une palette de 256 couleurs dans la copie en RAM
+    \~\param pal
+         \~english Palette (PA_PAL_...)
+         \~french Palette (PA_PAL_...)
+    \~\param colors
+         \~english 256 colors
+         \~french 256 couleurs
+*/
+void PA_PalShadowLoad(u16 pal, const void *colors);
+
+/*! \fn void PA_PalShadowSetCol(u16 pal, u8 color_number, u16 color)
+    \brief
+         \~english Change one color of the RAM copy
+         \~french Change une couleur de la copie en RAM
+    \~\param pal
+         \~english Palette (PA_PAL_...)
+         \~french Palette (PA_PAL_...)
+    \~\param color_number
+         \~english Color number (0-255)
+         \~french Numéro de la couleur (0-255)
+    \~\param color
+         \~english Color, given by PA_RGB
+         \~french Couleur, donnée par PA_RGB
+*/
+void PA_PalShadowSetCol(u16 pal, u8 color_number, u16 color);
+
+/*! \fn void PA_PalShadowFade(u16 pal, u8 level, u16 color)
+    \brief
+         \~english Fade a palette to a color. The colors given to the palette are kept, so the fade can go back to 0.
+         \~french Fait un fondu d'une palette vers une couleur. Les couleurs données à la palette sont gardées, donc le fondu peut revenir à 0.
+    \~\param pal
+         \~english Palette (PA_PAL_...)
+         \~french Palette (PA_PAL_...)
+    \~\param level
+         \~english From 0 (palette as it is) to 32 (only the color)
+         \~french De 0 (palette telle quelle) à 32 (seulement la couleur)
+    \~\param color
+         \~english Color to fade to, PA_RGB(0, 0, 0) for black
+         \~french Couleur vers laquelle aller, PA_RGB(0, 0, 0) pour noir
+*/
+void PA_PalShadowFade(u16 pal, u8 level, u16 color);
+
+/*! \fn void PA_PalShadowCrossfade(u16 pal, u8 level, const u16 *target)
+    \brief
+         \~english Crossfade a palette to another one. The other palette is read every time the level changes, so it has to stay in memory.
+         \~french Fait un fondu enchaîné d'une palette vers une autre. L'autre palette est lue à chaque changement de niveau, elle doit donc rester en mémoire.
+    \~\param pal
+         \~english Palette (PA_PAL_...)
+         \~french Palette (PA_PAL_...)
+    \~\param level
+         \~english From 0 (palette as it is) to 32 (only the target)
+         \~french De 0 (palette telle quelle) à 32 (seulement la cible)
+    \~\param target
+         \~english 256 colors to go to
+         \~french 256 couleurs vers lesquelles aller
+*/
+void PA_PalShadowCrossfade(u16 pal, u8 level, const u16 *target);
+
+/*! \fn void PA_PalShadowScreenFade(u8 screen, u8 level, u16 color)
+    \brief
+         \~english Fade the palettes of a screen to a color, for example to black between 2 levels : the standard ones and the extended ones loaded or changed since PA_PalShadowInit. The lookup tables are computed once for all the palettes.
+         \~french Fait un fondu des palettes d'un écran vers une couleur, par exemple vers le noir entre 2 niveaux : les palettes standard et les palettes étendues chargées ou changées depuis PA_PalShadowInit. Les tables sont calculées une seule fois pour toutes les palettes.
+    \~\param screen
+         \~english Screen (0-1)
+         \~french Ecran (0-1)
+    \~\param level
+         \~english From 0 (palettes as they are) to 32 (only the color)
+         \~french De 0 (palettes telles quelles) à 32 (seulement la couleur)
+    \~\param color
+         \~english Color to fade to
+         \~french Couleur vers laquelle aller
+*/
+void PA_PalShadowScreenFade(u8 screen, u8 level, u16 color);
+
+/*! \fn void PA_PalShadowUpload(void)
+    \brief
+         \~english Copy the palettes that changed to the hardware. Done at each VBL by PA_vblFunc, so only needed with a custom VBL.
+         \~french Copie les palettes qui ont changé vers le matériel. Fait à chaque VBL par PA_vblFunc, donc seulement utile avec un VBL personnalisé.
+*/
+void PA_PalShadowUpload(void);
+
+/** @} */ // end of PaletteShadow
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
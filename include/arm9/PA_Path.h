@@ -0,0 +1,329 @@
+#ifndef _PA_Path
+#define _PA_Path
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \file PA_Path.h
+    \brief Pathfinding on a grid
+
+    A grid keeps the cost of each cell and the memory of its searches, so it
+    is made once and used for every search. Paths are found with A* and a
+    binary heap, a few hundred cells at a time if needed so a long search can
+    be spread over several frames. Many units going to the same place can
+    share a flow field, which gives the direction to take from any cell.
+*/
+
+#include <PA9.h>
+
+#define PA_PATH_WALL 0     // Cost of a cell that can't be walked on
+
+// Search results
+#define PA_PATH_FOUND      1
+#define PA_PATH_SEARCHING  0
+#define PA_PATH_NONE      -1 // No path, or not enough memory
+
+#define PA_PATH_NODIR 0xFF // No direction, for the goal and cells that can't reach it
+
+// Moving straight costs 5 times the cost of the cell, diagonally 7 times
+#define PA_PATH_STRAIGHT 5
+#define PA_PATH_DIAGONAL 7
+
+typedef struct {
+	u16 x, y;
+} PA_PathPoint;
+
+typedef struct {
+	u32 F, Cell;         // Estimated cost of the whole path, cell
+} PA_PathOpen;
+
+// What a search keeps for each cell
+typedef struct {
+	u32 *G;              // Cost from the start (to the goal for a flow field)
+	u16 *Stamp;          // Search that set G, so nothing is cleared between searches
+	u8 *Dir;             // Direction the cell was reached by, 0x80 once it's done
+	PA_PathOpen *Open;   // Binary heap of the cells to look at
+	u32 OpenCount, OpenSize;
+	u32 Start, Goal;
+	u16 Search;
+	s8 Status;
+} PA_PathSearch;
+
+typedef struct {
+	u16 Width, Height;
+	u8 *Cost;            // Cost of walking on each cell, 1-255, PA_PATH_WALL for walls
+	u8 Diagonals;        // 8 directions instead of 4
+	PA_PathSearch Astar;
+} PA_PathGrid;
+
+typedef struct {
+	PA_PathGrid *Grid;
+	PA_PathSearch Flow;
+} PA_PathField;
+
+// Directions : right, down right, down, down left, left, up left, up, up right
+extern const s8 PA_PathDX[8];
+extern const s8 PA_PathDY[8];
+
+/** @defgroup Path Pathfinding
+ *  Find paths on a grid, for one unit or many going to the same place
+ *  @{
+ */
+
+/*! \fn PA_PathGrid* PA_PathCreate(u16 width, u16 height, u8 diagonals)
+    \brief
+         \~english Create a grid, with all the cells at cost 1. Returns NULL if there isn't enough memory (8 bytes per cell).
+         \~french Crée une grille, avec toutes les cases à un coût de 1. Renvoie NULL s'il n'y a pas assez de mémoire (8 octets par case).
+    \~\param width
+         \~english Width, in cells
+         \~french Largeur, en cases
+    \~\param height
+         \~english Height, in cells
+         \~french Hauteur, en cases
+    \~\param diagonals
+         \~english 1 to move in 8 directions, 0 for 4. Diagonals never cut the corner of a wall.
+         \~french 1 pour aller dans 8 directions, 0 pour 4. Les diagonales ne coupent jamais le coin d'un mur.
+*/
+PA_PathGrid* PA_PathCreate(u16 width, u16 height, u8 diagonals);
+
+/*! \fn void PA_PathDelete(PA_PathGrid *grid)
+    \brief
+         \~english Free a grid. Delete its flow fields first.
+         \~french Libère une grille. Supprimer ses champs de direction avant.
+    \~\param grid
+         \~english Grid
+         \~french Grille
+*/
+void PA_PathDelete(PA_PathGrid *grid);
+
+/*! \fn static inline void PA_PathSetCost(PA_PathGrid *grid, u16 x, u16 y, u8 cost)
+    \brief
+         \~english Change the cost of walking on a cell. Searches that already started don't see it, start them again.
+         \~french Change le coût pour marcher sur une case. Les recherches déjà commencées ne le voient pas, les recommencer.
+    \~\param grid
+         \~english Grid
+         \~french Grille
+    \~\param x
+         \~english X position of the cell
+         \~french Position X de la case
+    \~\param y
+         \~english Y position of the cell
+         \~french Position Y de la case
+    \~\param cost
+         \~english 1 (fastest) to 255, or PA_PATH_WALL
+         \~french 1 (le plus rapide) à 255, ou PA_PATH_WALL
+*/
+static inline void PA_PathSetCost(PA_PathGrid *grid, u16 x, u16 y, u8 cost){
+	grid->Cost[y * grid->Width + x] = cost;
+}
+
+/*! \fn static inline u8 PA_PathGetCost(PA_PathGrid *grid, u16 x, u16 y)
+    \brief
+         \~english Get the cost of walking on a cell
+         \~french Récupère le coût pour marcher sur une case
+    \~\param grid
+         \~english Grid
+         \~french Grille
+    \~\param x
+         \~english X position of the cell
+         \~french Position X de la case
+    \~\param y
+         \~english Y position of the cell
+         \~french Position Y de la case
+*/
+static inline u8 PA_PathGetCost(PA_PathGrid *grid, u16 x, u16 y){
+	return grid->Cost[y * grid->Width + x];
+}
+
+/*! \fn static inline void PA_PathLoadCosts(PA_PathGrid *grid, const u8 *costs)
+    \brief
+         \~english Load the costs of all the cells, a line after the other
+         \~french Charge les coûts de toutes les cases, une ligne après l'autre
+    \~\param grid
+         \~english Grid
+         \~french Grille
+    \~\param costs
+         \~english width*height costs
+         \~french width*height coûts
+*/
+static inline void PA_PathLoadCosts(PA_PathGrid *grid, const u8 *costs){
+	memcpy(grid->Cost, costs, grid->Width * grid->Height);
+}
+
+/*! \fn s8 PA_PathStart(PA_PathGrid *grid, u16 startx, u16 starty, u16 goalx, u16 goaly)
+    \brief
+         \~english Start looking for a path, PA_PathStep does the search. Returns PA_PATH_SEARCHING, or PA_PATH_NONE if the start or the goal is a wall.
+         \~french Commence à chercher un chemin, PA_PathStep fait la recherche. Renvoie PA_PATH_SEARCHING, ou PA_PATH_NONE si le départ ou l'arrivée est un mur.
+    \~\param grid
+         \~english Grid
+         \~french Grille
+    \~\param startx
+         \~english Start X position
+         \~french Position X de départ
+    \~\param starty
+         \~english Start Y position
+         \~french Position Y de départ
+    \~\param goalx
+         \~english Goal X position
+         \~french Position X d'arrivée
+    \~\param goaly
+         \~english Goal Y position
+         \~french Position Y d'arrivée
+*/
+s8 PA_PathStart(PA_PathGrid *grid, u16 startx, u16 starty, u16 goalx, u16 goaly);
+
+/*! \fn s8 PA_PathStep(PA_PathGrid *grid, u32 budget)
+    \brief
+         \~english Go on with the search started by PA_PathStart, looking at budget cells at most, to keep the frame rate with long searches. Returns PA_PATH_FOUND, PA_PATH_NONE, or PA_PATH_SEARCHING if it has to be called again.
+         \~french Continue la recherche commencée par PA_PathStart, en regardant budget cases au plus, pour garder le nombre d'images par seconde avec les longues recherches. Renvoie PA_PATH_FOUND, PA_PATH_NONE, ou PA_PATH_SEARCHING s'il faut la rappeler.
+    \~\param grid
+         \~english Grid
+         \~french Grille
+    \~\param budget
+         \~english Cells to look at, 0 to search until the end
+         \~french Cases à regarder, 0 pour chercher jusqu'au bout
+*/
+s8 PA_PathStep(PA_PathGrid *grid, u32 budget);
+
+/*! \fn static inline s8 PA_PathFind(PA_PathGrid *grid, u16 startx, u16 starty, u16 goalx, u16 goaly)
+    \brief
+         \~english Find a path in one go. Returns PA_PATH_FOUND or PA_PATH_NONE.
+         \~french Trouve un chemin d'un coup. Renvoie PA_PATH_FOUND ou PA_PATH_NONE.
+    \~\param grid
+         \~english Grid
+         \~french Grille
+    \~\param startx
+         \~english Start X position
+         \~french Position X de départ
+    \~\param starty
+         \~english Start Y position
+         \~french Position Y de départ
+    \~\param goalx
+         \~english Goal X position
+         \~french Position X d'arrivée
+    \~\param goaly
+         \~english Goal Y position
+         \~french Position Y d'arrivée
+*/
+static inline s8 PA_PathFind(PA_PathGrid *grid, u16 startx, u16 starty, u16 goalx, u16 goaly){
+	if (PA_PathStart(grid, startx, starty, goalx, goaly) == PA_PATH_NONE) return PA_PATH_NONE;
+	return PA_PathStep(grid, 0);
+}
+
+/*! \fn u32 PA_PathGet(PA_PathGrid *grid, PA_PathPoint *points, u32 max)
+    \brief
+         \~english Get the path found, from the start to the goal, both included. Returns the number of cells in the path (0 if none was found), even if it is more than max.
+         \~french Récupère le chemin trouvé, du départ à l'arrivée, les deux inclus. Renvoie le nombre de cases du chemin (0 si aucun n'a été trouvé), même s'il y en a plus que max.
+    \~\param grid
+         \~english Grid
+         \~french Grille
+    \~\param points
+         \~english Gets the first max cells of the path, or NULL to only get its length
+         \~french Reçoit les max premières cases du chemin, ou NULL pour avoir seulement sa longueur
+    \~\param max
+         \~english Size of points
+         \~french Taille de points
+*/
+u32 PA_PathGet(PA_PathGrid *grid, PA_PathPoint *points, u32 max);
+
+/*! \fn static inline u32 PA_PathCost(PA_PathGrid *grid)
+    \brief
+         \~english Cost of the path found : the sum of the costs of the cells walked on after the start, times PA_PATH_STRAIGHT or PA_PATH_DIAGONAL
+         \~french Coût du chemin trouvé : la somme des coûts des cases parcourues après le départ, fois PA_PATH_STRAIGHT ou PA_PATH_DIAGONAL
+    \~\param grid
+         \~english Grid
+         \~french Grille
+*/
+static inline u32 PA_PathCost(PA_PathGrid *grid){
+	return (grid->Astar.Status == PA_PATH_FOUND) ? grid->Astar.G[grid->Astar.Goal] : 0;
+}
+
+/*! \fn PA_PathField* PA_PathFieldCreate(PA_PathGrid *grid)
+    \brief
+         \~english Create a flow field on a grid, for many units going to the same goal : the field is computed once and each unit reads the direction to take from its cell. Returns NULL if there isn't enough memory (7 bytes per cell).
+         \~french Crée un champ de directions sur une grille, pour beaucoup d'unités allant au même endroit : le champ est calculé une fois et chaque unité lit la direction à prendre depuis sa case. Renvoie NULL s'il n'y a pas assez de mémoire (7 octets par case).
+    \~\param grid
+         \~english Grid, its costs are used
+         \~french Grille, ses coûts sont utilisés
+*/
+PA_PathField* PA_PathFieldCreate(PA_PathGrid *grid);
+
+/*! \fn void PA_PathFieldDelete(PA_PathField *field)
+    \brief
+         \~english Free a flow field
+         \~french Libère un champ de directions
+    \~\param field
+         \~english Flow field
+         \~french Champ de directions
+*/
+void PA_PathFieldDelete(PA_PathField *field);
+
+/*! \fn s8 PA_PathFieldStart(PA_PathField *field, u16 goalx, u16 goaly)
+    \brief
+         \~english Start computing the field towards a goal, PA_PathFieldStep does it. Returns PA_PATH_SEARCHING, or PA_PATH_NONE if the goal is a wall.
+         \~french Commence à calculer le champ vers une arrivée, PA_PathFieldStep le fait. Renvoie PA_PATH_SEARCHING, ou PA_PATH_NONE si l'arrivée est un mur.
+    \~\param field
+         \~english Flow field
+         \~french Champ de directions
+    \~\param goalx
+         \~english Goal X position
+         \~french Position X d'arrivée
+    \~\param goaly
+         \~english Goal Y position
+         \~french Position Y d'arrivée
+*/
+s8 PA_PathFieldStart(PA_PathField *field, u16 goalx, u16 goaly);
+
+/*! \fn s8 PA_PathFieldStep(PA_PathField *field, u32 budget)
+    \brief
+         \~english Go on computing the field, budget cells at most. The closest cells are done first, and their direction can be used right away. Returns PA_PATH_FOUND once every cell is done, or PA_PATH_SEARCHING.
+         \~french Continue à calculer le champ, budget cases au plus. Les cases les plus proches sont faites en premier, et leur direction peut être utilisée tout de suite. Renvoie PA_PATH_FOUND une fois que toutes les cases sont faites, ou PA_PATH_SEARCHING.
+    \~\param field
+         \~english Flow field
+         \~french Champ de directions
+    \~\param budget
+         \~english Cells to do, 0 to do all of them
+         \~french Cases à faire, 0 pour toutes les faire
+*/
+s8 PA_PathFieldStep(PA_PathField *field, u32 budget);
+
+/*! \fn u8 PA_PathFieldDir(PA_PathField *field, u16 x, u16 y)
+    \brief
+         \~english Direction to take from a cell to go to the goal (0-7, see PA_PathDX and PA_PathDY), or PA_PATH_NODIR on the goal, on cells that can't reach it and on cells not done yet
+         \~french Direction à prendre depuis une case pour aller à l'arrivée (0-7, voir PA_PathDX et PA_PathDY), ou PA_PATH_NODIR sur l'arrivée, sur les cases qui ne peuvent pas l'atteindre et sur les cases pas encore faites
+    \~\param field
+         \~english Flow field
+         \~french Champ de directions
+    \~\param x
+         \~english X position of the cell
+         \~french Position X de la case
+    \~\param y
+         \~english Y position of the cell
+         \~french Position Y de la case
+*/
+u8 PA_PathFieldDir(PA_PathField *field, u16 x, u16 y);
+
+/*! \fn u32 PA_PathFieldCost(PA_PathField *field, u16 x, u16 y)
+    \brief
+         \~english Cost of going from a cell to the goal, 0xFFFFFFFF if it can't or isn't done yet
+         \~french Coût pour aller d'une case à l'arrivée, 0xFFFFFFFF si elle ne peut pas ou n'est pas encore faite
+    \~\param field
+         \~english Flow field
+         \~french Champ de directions
+    \~\param x
+         \~english X position of the cell
+         \~french Position X de la case
+    \~\param y
+         \~english Y position of the cell
+         \~french Position Y de la case
+*/
+u32 PA_PathFieldCost(PA_PathField *field, u16 x, u16 y);
+
+/** @} */ // end of Path
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
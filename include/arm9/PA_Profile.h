@@ -0,0 +1,165 @@
+#ifndef _PA_Profile
+#define _PA_Profile
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \file PA_Profile.h
+    \brief Time spent in each part of a frame, to the bus cycle
+
+    Two hardware timers are cascaded into a 32 bit counter running at the bus
+    clock (33.5 MHz, 560190 ticks per frame). Zones are named and nest; each
+    gives how long it took in the last frame, interrupts excluded. The VBL,
+    the OAM copy, the upload queue, PA_3DProcess, the text functions and the
+    GIF and JPEG decoders are zones already. Every start and end can also be
+    kept in a ring buffer and written out as a Chrome trace
+    (chrome://tracing or Perfetto).
+*/
+
+#include <PA9.h>
+
+#define PA_PROFILE_ZONES 32 // Names, PAlib's included
+#define PA_PROFILE_DEPTH 16 // Zones inside each other
+#define PA_PROFILE_HZ 33513982 // Timer ticks per second
+#define PA_PROFILE_FRAME 560190 // Ticks per frame
+#define PA_PROFILE_VBLANK 151230 // Ticks of the vertical blank, 71 lines
+
+// PAlib's own zones
+#define PA_PROFILE_VBL 0 // PA_vblFunc
+#define PA_PROFILE_OAM 1 // Sprites copied to OAM
+#define PA_PROFILE_UPLOAD 2 // Upload queue copied to VRAM
+#define PA_PROFILE_3D 3 // PA_3DProcess
+#define PA_PROFILE_TEXT 4 // PA_OutputText and the bitmap text functions
+#define PA_PROFILE_GIF 5 // GIF decoding
+#define PA_PROFILE_JPEG 6 // JPEG decoding
+#define PA_PROFILE_USER 7 // First zone from PA_ProfileZone
+
+typedef struct {
+	const char *Name; // NULL if not used
+	u32 Ticks; // In the last frame, zones inside it included, interrupts excluded
+	u32 Max;   // Most ticks in a frame since PA_ProfileStart
+	u16 Calls; // Times started in the last frame
+} PA_ProfileZoneInfo;
+
+extern u8 PA_ProfileOn;
+extern PA_ProfileZoneInfo PA_ProfileZones[PA_PROFILE_ZONES];
+extern u32 PA_ProfileBusyTicks; // Last frame, from the VBL to the first PA_WaitForVBL
+
+// Used by PA_ProfileBegin and PA_ProfileEnd
+void PA_ProfilePush(u8 zone);
+void PA_ProfilePop(void);
+// Called by PA_WaitForVBL : the main code is done for this frame
+void PA_ProfileIdle(void);
+
+/** @defgroup Profile Frame profiler
+ *  Time spent in each part of a frame, to the bus cycle
+ *  @{
+ */
+
+/*! \fn u8 PA_ProfileStart(u8 timer, u16 events)
+    \brief
+         \~english Start profiling, from the next VBL on. PA_ProfileZones then holds the ticks of each zone in the last frame. Returns 0 if the trace buffer can't be allocated.
+         \~french Commence à profiler, à partir du prochain VBL. PA_ProfileZones contient alors les ticks de chaque zone dans la dernière frame. Renvoie 0 si le tampon de trace ne peut pas être alloué.
+    \~\param timer
+         \~english First of the two hardware timers used, 0 or 2 (timers 0 and 1, or 2 and 3), else it returns 0. The millisecond timers of PA_Timer.h use timers 1 and 2.
+         \~french Premier des deux timers hardware utilisés, 0 ou 2 (timers 0 et 1, ou 2 et 3), sinon elle renvoie 0. Les timers en millisecondes de PA_Timer.h utilisent les timers 1 et 2.
+    \~\param events
+         \~english Starts and ends kept for PA_ProfileDump, the oldest are replaced. 8 bytes each, 0 for no trace.
+         \~french Débuts et fins gardés pour PA_ProfileDump, les plus anciens sont remplacés. 8 octets chacun, 0 pour pas de trace.
+*/
+u8 PA_ProfileStart(u8 timer, u16 events);
+
+/*! \fn void PA_ProfileStop(void)
+    \brief
+         \~english Stop profiling, stop the timers and free the trace
+         \~french Arrête de profiler, arrête les timers et libère la trace
+*/
+void PA_ProfileStop(void);
+
+/*! \fn u8 PA_ProfileZone(const char *name)
+    \brief
+         \~english Get a zone number for a name, the same one each time. Returns PA_PROFILE_ZONES if there are no zones left.
+         \~french Obtenir un numéro de zone pour un nom, le même à chaque fois. Renvoie PA_PROFILE_ZONES s'il n'y a plus de zones.
+    \~\param name
+         \~english Name, which must stay there (a string constant)
+         \~french Nom, qui doit rester là (un texte constant)
+*/
+u8 PA_ProfileZone(const char *name);
+
+/*! \fn static inline void PA_ProfileBegin(u8 zone)
+    \brief
+         \~english Start a zone. Costs a test when not profiling.
+         \~french Commence une zone. Coûte un test quand on ne profile pas.
+    \~\param zone
+         \~english Zone, from PA_ProfileZone
+         \~french Zone, de PA_ProfileZone
+*/
+static inline void PA_ProfileBegin(u8 zone) {
+	if (PA_ProfileOn) PA_ProfilePush(zone);
+}
+
+/*! \fn static inline void PA_ProfileEnd(void)
+    \brief
+         \~english End the last zone started
+         \~french Termine la dernière zone commencée
+*/
+static inline void PA_ProfileEnd(void) {
+	if (PA_ProfileOn) PA_ProfilePop();
+}
+
+/*! \def PA_PROFILE_BEGIN(name)
+    \brief
+         \~english Start a zone from its name, looked up only the first time. End it with PA_ProfileEnd.
+         \~french Commence une zone à partir de son nom, cherché seulement la première fois. La terminer avec PA_ProfileEnd.
+    \~\param name
+         \~english Name, a string constant
+         \~french Nom, un texte constant
+*/
+#define PA_PROFILE_BEGIN(name) do { \
+	static u8 pa_profilezone = PA_PROFILE_ZONES; \
+	if (PA_ProfileOn) { \
+		if (pa_profilezone == PA_PROFILE_ZONES) pa_profilezone = PA_ProfileZone(name); \
+		PA_ProfilePush(pa_profilezone); \
+	} } while (0)
+
+/*! \fn void PA_ProfileShowBars(u8 screen, u16 y)
+    \brief
+         \~english Show the share of the last frame taken by each zone as text bars, a line per zone used, after a line for the share of the frame the CPU was busy, up to the first PA_WaitForVBL, and the VBL's share of the vertical blank. Needs the text of PA_LoadDefaultText on that screen.
+         \~french Affiche la part de la dernière frame prise par chaque zone en barres de texte, une ligne par zone utilisée, après une ligne pour la part de la frame où le CPU était occupé, jusqu'au premier PA_WaitForVBL, et la part du blanc vertical prise par le VBL. Nécessite le texte de PA_LoadDefaultText sur cet écran.
+    \~\param screen
+         \~english Screen
+         \~french Ecran
+    \~\param y
+         \~english First line, in tiles
+         \~french Première ligne, en tiles
+*/
+void PA_ProfileShowBars(u8 screen, u16 y);
+
+/*! \fn void PA_ProfileDump(void (*output)(const char *line))
+    \brief
+         \~english Write the events kept as a Chrome trace (JSON), a line at a time, for example to nocashMessage for the no$gba debug window. The main code and the VBL are two threads.
+         \~french Ecrit les évènements gardés en trace Chrome (JSON), une ligne à la fois, par exemple vers nocashMessage pour la fenêtre de debug de no$gba. Le code principal et le VBL sont deux threads.
+    \~\param output
+         \~english Function given each line, without the line feed
+         \~french Fonction à qui chaque ligne est donnée, sans le retour à la ligne
+*/
+void PA_ProfileDump(void (*output)(const char *line));
+
+/*! \fn u8 PA_ProfileSave(const char *filename)
+    \brief
+         \~english Save the events kept as a Chrome trace file. Returns 0 if the file can't be written.
+         \~french Sauve les évènements gardés dans un fichier de trace Chrome. Renvoie 0 si le fichier ne peut pas être écrit.
+    \~\param filename
+         \~english File name, like "fat:/trace.json"
+         \~french Nom du fichier, comme "fat:/trace.json"
+*/
+u8 PA_ProfileSave(const char *filename);
+
+/** @} */ // end of Profile
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef _PA_Raster
+#define _PA_Raster
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \file PA_Raster.h
+    \brief Change registers or palettes at each scanline
+
+    Effects give a table with the values to write for each of the 192 lines.
+    Effects writing to registers that follow each other are merged, the
+    biggest ones are written by HBlank DMA channels and the rest by a single
+    HBlank interrupt, so several effects (mode 7, fake 16 bit backgrounds,
+    waves, gradients...) can run at the same time.
+*/
+
+#include <PA9.h>
+
+#define PA_RASTER_MAX      8   // Effects at the same time
+#define PA_RASTER_LINES    192
+#define PA_RASTER_DMA      1   // First DMA channel used, channel 3 is left to dmaCopy
+#define PA_RASTER_CHANNELS 2   // DMA channels used
+#define PA_RASTER_MERGE    64  // Maximum bytes per line of merged effects
+#define PA_RASTER_CPU      0xFF
+
+typedef struct {
+	u8 *Dest;             // Register or palette written, NULL if the effect is free
+	const u8 *Table;      // Size bytes for each line
+	const u8 *NextTable;  // Table to use from the next frame
+	u16 Size;             // Bytes per line
+	funcpointer Prepare;  // Called at each VBL, before the frame is drawn
+} PA_RasterEffect;
+
+// Effects written together, by one DMA channel or by the interrupt
+typedef struct {
+	u8 *Dest;
+	const u8 *Table;
+	u8 *Merged;           // Lines of the effects side by side, NULL for a single effect written by the CPU
+	u16 Size;
+	u8 Channel;           // DMA channel or PA_RASTER_CPU
+	u8 First, Count;      // Effects in PA_RasterOrder
+} PA_RasterGroup;
+
+extern PA_RasterEffect PA_RasterEffects[PA_RASTER_MAX];
+
+/** @defgroup Raster Raster effects
+ *  Change registers or palettes at each scanline
+ *  @{
+ */
+
+/*! \fn s8 PA_RasterAdd(volatile void *dest, const void *table, u16 size, funcpointer prepare)
+    \brief
+         \~english Add a raster effect : size bytes from the table are written to dest before each line is drawn. Returns the effect number, or -1 if there are already PA_RASTER_MAX effects or not enough memory. The effect starts at the next VBL.
+         \~french Ajoute un effet raster : size octets de la table sont écrits à dest avant que chaque ligne soit affichée. Renvoie le numéro de l'effet, ou -1 s'il y a déjà PA_RASTER_MAX effets ou pas assez de mémoire. L'effet commence au VBL suivant.
+    \~\param dest
+         \~english Register or palette to write to, for example &REG_BG0HOFS or BG_PALETTE
+         \~french Registre ou palette où écrire, par exemple &REG_BG0HOFS ou BG_PALETTE
+    \~\param table
+         \~english Values for each of the 192 lines, size bytes each. It is read by DMA, so keep it in main RAM. If you change it yourself, do it at the VBL or in a second table given to PA_RasterTable.
+         \~french Valeurs pour chacune des 192 lignes, de size octets chacune. Elle est lue par DMA, elle doit donc être en RAM principale. Si vous la changez vous-même, faites-le au VBL ou dans une deuxième table donnée à PA_RasterTable.
+    \~\param size
+         \~english Bytes per line, a multiple of 2
+         \~french Octets par ligne, un multiple de 2
+    \~\param prepare
+         \~english Function called at each VBL before the table is used, to fill it, or NULL
+         \~french Fonction appelée à chaque VBL avant que la table soit utilisée, pour la remplir, ou NULL
+*/
+s8 PA_RasterAdd(volatile void *dest, const void *table, u16 size, funcpointer prepare);
+
+/*! \fn void PA_RasterRemove(s8 effect)
+    \brief
+         \~english Remove a raster effect. The registers keep the last values written.
+         \~french Enlève un effet raster. Les registres gardent les dernières valeurs écrites.
+    \~\param effect
+         \~english Effect number, given by PA_RasterAdd
+         \~french Numéro de l'effet, donné par PA_RasterAdd
+*/
+void PA_RasterRemove(s8 effect);
+
+/*! \fn static inline void PA_RasterTable(s8 effect, const void *table)
+    \brief
+         \~english Use another table from the next frame, to double buffer the tables
+         \~french Utilise une autre table à partir de la frame suivante, pour avoir 2 tables
+    \~\param effect
+         \~english Effect number
+         \~french Numéro de l'effet
+    \~\param table
+         \~english New table
+         \~french Nouvelle table
+*/
+static inline void PA_RasterTable(s8 effect, const void *table){
+	PA_RasterEffects[effect].NextTable = (const u8*)table;
+}
+
+/*! \fn void PA_RasterVBL(void)
+    \brief
+         \~english Prepare the tables and start the transfers for the next frame. Done at each VBL by PA_vblFunc, so only needed with a custom VBL.
+         \~french Prépare les tables et lance les transferts pour la frame suivante. Fait à chaque VBL par PA_vblFunc, donc seulement utile avec un VBL personnalisé.
+*/
+void PA_RasterVBL(void);
+
+/** @} */ // end of Raster
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -16,13 +16,14 @@ extern "C" {
 typedef struct{
 	u8 x, y;
 } PA_StylusPosition;
-extern PA_StylusPosition PA_StylusPos[20000];
 
 #define PA_RECOTESTS 30
+#define PA_RECO_POINTS 64 // Points kept along the drawing, whatever its length
 
 typedef struct{
 	char letter;
 	char code[16];
+	u8 strokes; // Strokes to draw the shape, 0 or 1 for a single one
 } PA_FormType;
 
 extern PA_FormType PA_Graffiti[PA_RECOTESTS];		
@@ -32,6 +33,17 @@ typedef struct{
 } PA_RecoValues;
 extern PA_RecoValues PA_Reco;
 
+// Drawing in progress : point k is pixel k*Step of the path
+typedef struct{
+	PA_StylusPosition Points[PA_RECO_POINTS];
+	u16 Count, Step;
+	u8 X, Y;                          // Last pixel
+	u8 OldX, OldY, VeryOldX, VeryOldY; // Last pixel 1 and 2 frames ago
+	u8 Strokes;
+	s32 Waiting;                      // Frames left to start another stroke
+} PA_RecoPath;
+extern PA_RecoPath PA_RecoPts;
+
 typedef struct{
 	u32 Length;
 	u8 minX, minY, maxX, maxY; // Shape limits
@@ -39,6 +51,7 @@ typedef struct{
 	s16 Angle;
 	s32 Difference;
 	u8 Shape;
+	u8 Strokes;
 } PA_RecoInfos;
 extern PA_RecoInfos PA_RecoInfo;
 
@@ -46,8 +59,12 @@ extern char PA_RecoShape[16]; // Stores the recognized pattern
 
 extern u8 PA_UseGraffiti;
 
-extern u8 PA_CustomReco; // number of custom shapes
-extern PA_FormType PA_CustomShape[200];
+extern s32 PA_RecoStrokeDelay;
+
+extern u16 PA_CustomReco; // number of custom shapes
+extern PA_FormType *PA_CustomShape;
+
+void PA_StylusLine(u8 x1, u8 y1, u8 x2, u8 y2);
 
 /** @defgroup Reco Shape Recognition
  *  Draw a shape and have it recognized !
@@ -63,7 +80,24 @@ extern PA_FormType PA_CustomShape[200];
 char PA_CheckLetter();
 
 /*!
-    \fn static inline void PA_RecoAddShape(char letter, char *shape)
+    \fn void PA_RecoAddShapeEx(char letter, const char *shape, u8 strokes)
+    \brief
+		\~english Adds a new shape drawn in several strokes to the recognition system. Shapes are kept in a growing list, so there is no limit to their number.
+		\~french Ajouter une nouvelle forme dessinée en plusieurs traits au système de reconnaissance. Les formes sont gardées dans une liste qui grandit, il n'y a donc pas de limite à leur nombre.
+    \~\param letter
+      \~english Letter it will return for that shape
+      \~french Lettre renvoyée par le système de reconnaissance pour cette forme
+    \~\param shape
+      \~english 15 characters string given by the recognition system in PA_RecoShape
+      \~french Chaine de 15 caractères fournie par le systeme de reconnaissance in PA_RecoShape
+    \~\param strokes
+      \~english Number of strokes, given in PA_RecoInfo.Strokes. Only used with PA_SetRecoStrokeDelay.
+      \~french Nombre de traits, donné dans PA_RecoInfo.Strokes. Utilisé seulement avec PA_SetRecoStrokeDelay.
+*/
+void PA_RecoAddShapeEx(char letter, const char *shape, u8 strokes);
+
+/*!
+    \fn static inline void PA_RecoAddShape(char letter, const char *shape)
     \brief
 		\~english Adds a new shape to the recognition system
 		\~french Ajouter une nouvelle forme au système de reconnaissance
@@ -74,23 +108,46 @@ char PA_CheckLetter();
       \~english 15 characters string given by the recognition system in PA_RecoShape
       \~french Chaine de 15 caractères fournie par le systeme de reconnaissance in PA_RecoShape
 */
-static inline void PA_RecoAddShape(char letter, char *shape){
-	PA_CustomShape[PA_CustomReco].letter = letter;
-	int i;
-	for (i = 0; i < 16; i++)
-		PA_CustomShape[PA_CustomReco].code[i] = shape[i];
-	PA_CustomReco++;
+static inline void PA_RecoAddShape(char letter, const char *shape){
+	PA_RecoAddShapeEx(letter, shape, 1);
 }
 
 /*!
-    \fn static inline void PA_ResetRecoSys(void)
+    \fn void PA_ResetRecoSys(void)
     \brief
 		\~english Resets the Recognition system
 		\~french Réinitialise le systeme de reconnaissance
 */
-static inline void PA_ResetRecoSys(){
-	PA_CustomReco = 0;
-	PA_UseGraffiti = 1;
+void PA_ResetRecoSys(void);
+
+/*!
+    \fn char PA_RecoMatch(const char *code, u8 strokes, s32 *difference)
+    \brief
+		\~english Finds the shape closest to a 15 characters string, like PA_CheckLetter does. With many custom shapes, they are sorted in an index and the ones far from the string are skipped : about 6 times faster than comparing them all with 20000 shapes, 3 times for strings unlike any shape. Returns the letter, 0 if there are no shapes, and the difference is then 65000.
+		\~french Trouve la forme la plus proche d'une chaine de 15 caractères, comme PA_CheckLetter. Avec beaucoup de formes, elles sont rangées dans un index et celles loin de la chaine sont sautées : environ 6 fois plus rapide que de toutes les comparer avec 20000 formes, 3 fois pour une chaine qui ne ressemble à aucune forme. Renvoie la lettre, 0 s'il n'y a pas de formes, et la différence est alors 65000.
+    \~\param code
+      \~english 15 characters string, like PA_RecoShape
+      \~french Chaine de 15 caractères, comme PA_RecoShape
+    \~\param strokes
+      \~english Number of strokes drawn
+      \~french Nombre de traits dessinés
+    \~\param difference
+      \~english Gets the difference with the shape found, or NULL
+      \~french Reçoit la différence avec la forme trouvée, ou NULL
+*/
+char PA_RecoMatch(const char *code, u8 strokes, s32 *difference);
+
+/*!
+    \fn static inline void PA_SetRecoStrokeDelay(s32 frames)
+    \brief
+		\~english Allow shapes drawn in several strokes : after the stylus is released, PA_CheckLetter waits that many frames for another stroke before analyzing the shape. The jump between 2 strokes is part of the shape. 0 (default) analyzes each stroke on release.
+		\~french Permet les formes dessinées en plusieurs traits : après que le stylet est levé, PA_CheckLetter attend ce nombre de frames un autre trait avant d'analyser la forme. Le saut entre 2 traits fait partie de la forme. 0 (par défaut) analyse chaque trait quand le stylet est levé.
+    \~\param frames
+      \~english Frames to wait, 0 for single strokes
+      \~french Frames à attendre, 0 pour un seul trait
+*/
+static inline void PA_SetRecoStrokeDelay(s32 frames){
+	PA_RecoStrokeDelay = frames;
 }
 
 /*!
@@ -80,6 +80,15 @@ extern u8 obj_per_gfx[2][1024]; // Nombre de sprites utilisant un gfx donné...
 extern u8 pa_obj_created[2][128];
 extern mem_usage free_mem[2][1024];
 
+// Same gfx loaded again by the PA_CreateSprite functions : shared instead of copied
+#define PA_GFXDEDUP_OFF 0 // The default
+#define PA_GFXDEDUP_POINTER 1 // Same source pointer and size
+#define PA_GFXDEDUP_CONTENT 2 // Same pixels, even from another buffer
+
+extern u8 pa_gfxshared[2][1024]; // Sprites sharing a gfx through PA_CreateSprite, besides the first
+extern u8 pa_obj_sharedgfx[2][128]; // The sprite got its gfx from PA_CreateSprite
+extern u8 pa_gfxkeytype[2][1024]; // The gfx can be found again from its source
+
 extern u16 FirstGfx[2];
 
 extern const u16 PA_obj_sizes[4][3];
@@ -173,6 +182,34 @@ void PA_UpdateOAM(void);
 
 u16 PA_CreateGfx(u8 screen, void* obj_data, u8 obj_shape, u8 obj_size, u8 color_mode);
 
+// Gfx for PA_CreateSprite : the one already loaded from the same data if there is one
+u16 PA_CreateSpriteGfx(u8 screen, u8 obj_number, void* obj_data, u8 obj_shape, u8 obj_size, u8 color_mode);
+// The gfx no longer holds the image it was loaded from, so it isn't shared anymore
+void PA_UnlinkGfx(u8 screen, u16 gfx);
+
+/*! \fn void PA_SetGfxDedup(u8 mode)
+    \brief
+         \~english Choose how the PA_CreateSprite functions find a gfx already loaded, to share it instead of copying the same image again. A sprite sharing its gfx this way gets its own copy as soon as it is animated or drawn on, so it looks like it has its own. PA_CreateGfx always loads a new gfx.
+         \~french Choisit comment les fonctions PA_CreateSprite trouvent un gfx déjà chargé, pour le partager au lieu de copier la même image encore. Un sprite qui partage son gfx de cette manière en reçoit sa propre copie dès qu'il est animé ou qu'on dessine dessus, il a donc l'air d'avoir le sien. PA_CreateGfx charge toujours un nouveau gfx.
+    \~\param mode
+         \~english PA_GFXDEDUP_OFF (default) to always copy, PA_GFXDEDUP_POINTER for the same data pointer, PA_GFXDEDUP_CONTENT to also compare the pixels of images copied in other buffers (slower to create sprites). Only use PA_GFXDEDUP_POINTER if each buffer always holds the same image : a buffer loaded again with another image would still give the old one
+         \~french PA_GFXDEDUP_OFF (par défaut) pour toujours copier, PA_GFXDEDUP_POINTER pour le même pointeur de données, PA_GFXDEDUP_CONTENT pour comparer aussi les pixels d'images copiées dans d'autres buffers (création des sprites plus lente). N'utiliser PA_GFXDEDUP_POINTER que si chaque buffer garde toujours la même image : un buffer rechargé avec une autre image donnerait encore l'ancienne
+*/
+void PA_SetGfxDedup(u8 mode);
+
+/*! \fn void PA_UnshareSpriteGfx(u8 screen, u8 obj_number)
+    \brief
+         \~english Give a sprite its own copy of a gfx it shares since PA_CreateSprite. Done by itself before animating it or drawing on it.
+         \~french Donne à un sprite sa propre copie d'un gfx qu'il partage depuis PA_CreateSprite. Fait tout seul avant de l'animer ou de dessiner dessus.
+    \~\param screen
+         \~english Chose de screen (0 or 1)
+         \~french Choix de l'écran (0 ou 1)
+    \~\param obj_number
+         \~english Sprite number
+         \~french Numéro du sprite
+*/
+void PA_UnshareSpriteGfx(u8 screen, u8 obj_number);
+
 /*! \fn void PA_ResetSpriteSys(void)
     \brief
          \~english Reset the sprite system, memory, etc...
@@ -222,10 +259,10 @@ void PA_ResetSpriteSys(void);
 */
 
 static inline void PA_CreateSprite(u8 screen, u8 obj_number, void* obj_data, u8 obj_shape, u8 obj_size, u8 color_mode, u8 palette, s16 x, s16 y) {
-	PA_obj[screen][obj_number].atr2 = PA_CreateGfx(screen, obj_data, obj_shape, obj_size, color_mode) + (palette << 12);
+	PA_obj[screen][obj_number].atr2 = PA_CreateSpriteGfx(screen, obj_number, obj_data, obj_shape, obj_size, color_mode) + (palette << 12);
 	PA_obj[screen][obj_number].atr0 = (y&PA_OBJ_Y) + (color_mode << 13) + (obj_shape << 14);
 	PA_obj[screen][obj_number].atr1 = (x & PA_OBJ_X) + (obj_size << 14);
-	obj_per_gfx[screen][PA_obj[screen][obj_number].atr2]++;
+	obj_per_gfx[screen][PA_obj[screen][obj_number].atr2 & OBJ_GFX]++; // PA_GetSpriteGfx is defined further
 	pa_obj_created[screen][obj_number]=1;
 };
 
@@ -280,10 +317,10 @@ static inline void PA_CreateSprite(u8 screen, u8 obj_number, void* obj_data, u8
          \~french Position Y du sprite
 */
 static inline void PA_CreateSpriteEx(u8 screen, u8 obj_number, void* obj_data, u8 obj_shape, u8 obj_size, u8 color_mode, u8 palette, u8 obj_mode, u8 mosaic, u8 hflip, u8 vflip, u8 prio, u8 dblsize, s16 x, s16 y) {
-	PA_obj[screen][obj_number].atr2 = PA_CreateGfx(screen, obj_data, obj_shape, obj_size, color_mode) + (prio << 10) + (palette << 12);
+	PA_obj[screen][obj_number].atr2 = PA_CreateSpriteGfx(screen, obj_number, obj_data, obj_shape, obj_size, color_mode) + (prio << 10) + (palette << 12);
 	PA_obj[screen][obj_number].atr0 = (y&PA_OBJ_Y) + (dblsize << 9) + (obj_mode << 10) + (mosaic << 12) + ((color_mode) << 13) + (obj_shape << 14);
 	PA_obj[screen][obj_number].atr1 = (x & PA_OBJ_X) + (hflip << 12) + (vflip << 13) + (obj_size << 14);
-	obj_per_gfx[screen][PA_obj[screen][obj_number].atr2]++;
+	obj_per_gfx[screen][PA_obj[screen][obj_number].atr2 & OBJ_GFX]++; // PA_GetSpriteGfx is defined further
 	pa_obj_created[screen][obj_number]=1;
 };
 
@@ -329,10 +366,10 @@ static inline void PA_CreateSpriteEx(u8 screen, u8 obj_number, void* obj_data, u
          \~french Position Y du sprite
 */
 static inline void PA_Create16bitSpriteEx(u8 screen, u8 obj_number, void* obj_data, u8 obj_shape, u8 obj_size, u8 mosaic, u8 hflip, u8 vflip, u8 prio, u8 dblsize, s16 x, s16 y){
-	PA_obj[screen][obj_number].atr2 = PA_CreateGfx(screen, obj_data, obj_shape, obj_size, 2) + (prio << 10) + (15 << 12);
+	PA_obj[screen][obj_number].atr2 = PA_CreateSpriteGfx(screen, obj_number, obj_data, obj_shape, obj_size, 2) + (prio << 10) + (15 << 12);
 	PA_obj[screen][obj_number].atr0 = (y&PA_OBJ_Y) + (dblsize << 9) + (3 << 10) + (mosaic << 12) + (0 << 13) + (obj_shape << 14);
 	PA_obj[screen][obj_number].atr1 = (x & PA_OBJ_X) + (hflip << 12) + (vflip << 13) + (obj_size << 14);
-	obj_per_gfx[screen][PA_obj[screen][obj_number].atr2]++;
+	obj_per_gfx[screen][PA_obj[screen][obj_number].atr2 & OBJ_GFX]++; // PA_GetSpriteGfx is defined further
 	pa_obj_created[screen][obj_number]=1;
 }
 
@@ -366,8 +403,9 @@ static inline void PA_Create16bitSpriteFromGfx(u8 screen, u8 obj_number, u16 gfx
 	PA_obj[screen][obj_number].atr2 = gfx + (15 << 12);
 	PA_obj[screen][obj_number].atr0 = (y&PA_OBJ_Y) + (3 << 10) + (obj_shape << 14);
 	PA_obj[screen][obj_number].atr1 = (x & PA_OBJ_X) + (obj_size << 14);
-	obj_per_gfx[screen][PA_obj[screen][obj_number].atr2]++;
+	obj_per_gfx[screen][gfx]++;
 	pa_obj_created[screen][obj_number]=1;
+	pa_obj_sharedgfx[screen][obj_number]=0; // Uses the gfx like a clone
 }
 
 /*! \fn static inline void PA_Create16bitSprite(u8 screen, u8 obj_number, void* obj_data, u8 obj_shape, u8 obj_size, s16 x, s16 y)
@@ -438,6 +476,7 @@ static inline void PA_CreateSpriteFromGfx(u8 screen, u8 obj_number, u16 obj_gfx,
 	PA_obj[screen][obj_number].atr1 = (x & PA_OBJ_X) + (obj_size << 14);
 	obj_per_gfx[screen][obj_gfx]++;
 	pa_obj_created[screen][obj_number]=1;
+	pa_obj_sharedgfx[screen][obj_number]=0; // Uses the gfx like a clone
 };
 
 /*! \fn static inline void PA_CreateSpriteExFromGfx(u8 screen, u8 obj_number, u16 obj_gfx, u8 obj_shape, u8 obj_size, u8 color_mode, u8 palette, u8 obj_mode, u8 mosaic, u8 hflip, u8 vflip, u8 prio, u8 dblsize, s16 x, s16 y)
@@ -496,6 +535,7 @@ static inline void PA_CreateSpriteExFromGfx(u8 screen, u8 obj_number, u16 obj_gf
 	PA_obj[screen][obj_number].atr1 = (x & PA_OBJ_X) + (hflip << 12) + (vflip << 13) + (obj_size << 14);
 	obj_per_gfx[screen][obj_gfx]++;
 	pa_obj_created[screen][obj_number]=1;
+	pa_obj_sharedgfx[screen][obj_number]=0; // Uses the gfx like a clone
 };
 
 /*! \def PA_UpdateSpriteGfx(screen, obj_number, obj_data)
@@ -530,9 +570,9 @@ static inline void PA_CreateSpriteExFromGfx(u8 screen, u8 obj_number, u16 obj_gf
 */
 
 static inline void PA_UpdateGfx(u8 screen, u16 gfx_number, void *obj_data) {
+	if (pa_gfxkeytype[screen][gfx_number]) PA_UnlinkGfx(screen, gfx_number);
 	size_t size = 2 * (used_mem[screen][gfx_number] << (MEM_DECAL+1));
-	DC_FlushRange(obj_data, size);
-	dmaCopy(obj_data, (void*)(SPRITE_GFX1 + (0x200000 *  (screen)) + ((gfx_number) << NUMBER_DECAL)),size);
+	PA_UploadCopy(obj_data, (void*)(SPRITE_GFX1 + (0x200000 *  (screen)) + ((gfx_number) << NUMBER_DECAL)), size, PA_UPLOAD_DIRECT);
 }
 
 /*! \fn static inline void PA_UpdateGfxAndMem(u8 screen, u8 gfx_number, void *obj_data)
@@ -551,9 +591,9 @@ static inline void PA_UpdateGfx(u8 screen, u16 gfx_number, void *obj_data) {
 */
 
 static inline void PA_UpdateGfxAndMem(u8 screen, u8 gfx_number, void *obj_data){
+	if (pa_gfxkeytype[screen][gfx_number]) PA_UnlinkGfx(screen, gfx_number);
 	size_t size = 4 * (used_mem[screen][gfx_number] << MEM_DECAL);
-	DC_FlushRange(obj_data, size);
-	dmaCopyWords(3, obj_data, (void*)(SPRITE_GFX1 + (0x200000 *  (screen)) + ((gfx_number) << NUMBER_DECAL)),size);
+	PA_UploadCopy(obj_data, (void*)(SPRITE_GFX1 + (0x200000 *  (screen)) + ((gfx_number) << NUMBER_DECAL)), size, PA_UPLOAD_DIRECT);
 	PA_SpriteAnimP[screen][gfx_number] = (u16*)obj_data; // mémorise la source de l'image...
 }
 
@@ -688,6 +728,75 @@ static inline void PA_SetRotsetNoAngle(u8 screen, u8 rotset, u16 zoomx, u16 zoom
 	PA_obj[screen][obj_num + 3].atr3 = zoomy;
 }
 
+extern u8 pa_rotsetrefs[2][32]; // Users of each rotset from PA_AllocRotset, 0 if free
+
+/*! \fn s8 PA_AllocRotset(u8 screen, s16 angle, u16 zoomx, u16 zoomy)
+    \brief
+         \~english Get a rotset with that rotation and zoom : the one already used with the same values if there is one, else a free one, from rotset 31 down. Its matrix is computed once at the next VBL. Release it with PA_FreeRotset, and don't change it with PA_SetRotset. Returns the rotset, or -1 if they are all used.
+         \~french Obtenir un rotset avec cette rotation et ce zoom : celui déjà utilisé avec les mêmes valeurs s'il y en a un, sinon un libre, à partir du rotset 31 en descendant. Sa matrice est calculée une fois au prochain VBL. Le libérer avec PA_FreeRotset, et ne pas le changer avec PA_SetRotset. Renvoie le rotset, ou -1 s'ils sont tous utilisés.
+    \~\param screen
+         \~english Chose de screen (0 or 1)
+         \~french Choix de l'écran (0 ou 1)
+    \~\param angle
+         \~english Angle, between 0 and 512
+         \~french Angle, entre 0 et 512
+    \~\param zoomx
+         \~english Horizontal zoom, 256 is unzoomed
+         \~french Zoom horizontal, 256 est pas de zoom
+    \~\param zoomy
+         \~english Vertical zoom, 256 is unzoomed
+         \~french Zoom vertical, 256 est pas de zoom
+*/
+s8 PA_AllocRotset(u8 screen, s16 angle, u16 zoomx, u16 zoomy);
+
+/*! \fn void PA_FreeRotset(u8 screen, u8 rotset)
+    \brief
+         \~english Release a rotset from PA_AllocRotset. It is free again once all its users released it.
+         \~french Libérer un rotset de PA_AllocRotset. Il redevient libre une fois que tous ses utilisateurs l'ont libéré.
+    \~\param screen
+         \~english Chose de screen (0 or 1)
+         \~french Choix de l'écran (0 ou 1)
+    \~\param rotset
+         \~english Rotset
+         \~french Rotset
+*/
+void PA_FreeRotset(u8 screen, u8 rotset);
+
+/*! \fn u8 PA_SetSpriteRotZoom(u8 screen, u8 sprite, s16 angle, u16 zoomx, u16 zoomy)
+    \brief
+         \~english Rotate and zoom a sprite without choosing its rotset : sprites with the same angle and zoom share one, so many more than 32 sprites can turn if their angles are rounded a little. The rotset is released by PA_SetSpriteRotZoomDisable or PA_DeleteSprite. Returns 0 if all the rotsets are used, the sprite then keeps its transform.
+         \~french Faire tourner et zoomer un sprite sans choisir son rotset : les sprites avec le même angle et le même zoom en partagent un, donc bien plus de 32 sprites peuvent tourner si leurs angles sont un peu arrondis. Le rotset est libéré par PA_SetSpriteRotZoomDisable ou PA_DeleteSprite. Renvoie 0 si tous les rotsets sont utilisés, le sprite garde alors sa transformation.
+    \~\param screen
+         \~english Chose de screen (0 or 1)
+         \~french Choix de l'écran (0 ou 1)
+    \~\param sprite
+         \~english Sprite number
+         \~french Numéro du sprite
+    \~\param angle
+         \~english Angle, between 0 and 512
+         \~french Angle, entre 0 et 512
+    \~\param zoomx
+         \~english Horizontal zoom, 256 is unzoomed
+         \~french Zoom horizontal, 256 est pas de zoom
+    \~\param zoomy
+         \~english Vertical zoom, 256 is unzoomed
+         \~french Zoom vertical, 256 est pas de zoom
+*/
+u8 PA_SetSpriteRotZoom(u8 screen, u8 sprite, s16 angle, u16 zoomx, u16 zoomy);
+
+/*! \fn void PA_SetSpriteRotZoomDisable(u8 screen, u8 sprite)
+    \brief
+         \~english Stop rotating and zooming a sprite from PA_SetSpriteRotZoom, and release its rotset
+         \~french Arrêter de faire tourner et zoomer un sprite de PA_SetSpriteRotZoom, et libérer son rotset
+    \~\param screen
+         \~english Chose de screen (0 or 1)
+         \~french Choix de l'écran (0 ou 1)
+    \~\param sprite
+         \~english Sprite number
+         \~french Numéro du sprite
+*/
+void PA_SetSpriteRotZoomDisable(u8 screen, u8 sprite);
+
 /*! \def PA_SetSpriteX(screen, obj, x)
     \brief
          \~english Set the X position of a sprite on screen
@@ -1116,6 +1225,7 @@ static inline void PA_Set16bitSpriteAlpha(u8 screen, u8 sprite, u8 alpha){
          \~french Frame de l'animation du sprite (0, 1, 2, etc...)
 */
 static inline void PA_SetSpriteAnimEx(u8 screen, u8 sprite, u8 lx, u8 ly, u8 ncolors, s16 animframe){
+	if (pa_obj_sharedgfx[screen][sprite]) PA_UnshareSpriteGfx(screen, sprite); // The other sprites keep their frame
 	u16 gfx = PA_GetSpriteGfx(screen, sprite);
 	spriteanims[screen][sprite].currentframe = animframe;
 	PA_UpdateGfx(screen, gfx, (void*)(PA_SpriteAnimP[screen][gfx] + (animframe * (lx * ly) >> (2 - ncolors))));
@@ -227,6 +227,7 @@ static inline void PA_DualCreate16bitSpriteEx(u8 obj_number, void* obj_data, u8
 	PA_obj[1][obj_number].atr1 = PA_obj[0][obj_number].atr1 = (x & PA_OBJ_X) + (hflip << 12) + (vflip << 13) + (obj_size << 14);
 	PA_DualSetSpriteXY(obj_number, x, y);
 
+	if (PA_UploadOn) PA_UploadFlush(); // gfx must be copied before being freed
 	free(gfx);
 }
 
@@ -154,8 +154,8 @@ static inline void PA_SetTextTileCol(u8 screen, u8 color){
          \~english Y coordinate in TILES (0-19) where to begin writing the text
          \~french Coordonnée Y en TILES (0-19) où commencer à afficher le text
     \~\param text
-         \~english String to output. The following commands are avaiblable : \%s to output another string, \%d to output a value, \%fX to output a float with X digits, \\n to go to the line. Here's an example : PA_OutputText(0, 0, 1, "My name is %s and I have only %d teeth", "Mollusk", 20);
-         \~french Chaine de caractère à écrire. On dispose des commandes suivantes : \%s pour une autre chaine de caractères, \%d pour écrire la valeur d'une variables, \%fX pour afficher un nombre avec X chiffres après la virgule, \\n pour aller à la ligne. Voici un exemple : PA_OutputText(0, 0, 1, "Mon nom est %s et je n'ai que %d dents...", "Mollusk", 20);
+         \~english String to output, formatted like printf by PA_VFormat. The following commands are avaiblable : \%s to output another string, \%d to output a value (\%5d or \%02d to pad it), \%x for hexadecimal, \%fX to output a float with X digits, \%q for a fixed point number with 8 bits after the point, \%cX to change the color, \\n to go to the line. Here's an example : PA_OutputText(0, 0, 1, "My name is %s and I have only %d teeth", "Mollusk", 20);
+         \~french Chaine de caractère à écrire, formatée comme printf par PA_VFormat. On dispose des commandes suivantes : \%s pour une autre chaine de caractères, \%d pour écrire la valeur d'une variables (\%5d ou \%02d pour compléter), \%x pour de l'hexadécimal, \%fX pour afficher un nombre avec X chiffres après la virgule, \%q pour un nombre à virgule fixe avec 8 bits après la virgule, \%cX pour changer de couleur, \\n pour aller à la ligne. Voici un exemple : PA_OutputText(0, 0, 1, "Mon nom est %s et je n'ai que %d dents...", "Mollusk", 20);
 */
 void PA_OutputText(u8 screen, u16 x, u16 y, const char* text, ...);
 
@@ -342,6 +342,26 @@ void PA_LoadText(u8 screen, u8 bg_number, const PA_BgStruct* font);
 s16 PA_8bitText(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, const char* text, u8 color, u8 size, u8 transp, s32 limit);
 s16 PA_16bitText(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, const char* text, u16 color, u8 size, u8 transp, s32 limit);
 
+/*! \fn s16 PA_8bitTextf(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, u8 color, u8 size, u8 transp, s32 limit, const char* text, ...)
+    \brief
+         \~english Same as PA_8bitText, but the text is formatted like printf (see PA_VFormat). The text comes last, followed by its arguments. Color codes are ignored.
+         \~french Comme PA_8bitText, mais le texte est formaté comme printf (voir PA_VFormat). Le texte vient en dernier, suivi de ses arguments. Les codes couleur sont ignorés.
+    \~\param text
+         \~english Text, such as "Score: %d"
+         \~french Texte, tel que "Score : %d"
+*/
+s16 PA_8bitTextf(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, u8 color, u8 size, u8 transp, s32 limit, const char* text, ...);
+
+/*! \fn s16 PA_16bitTextf(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, u16 color, u8 size, u8 transp, s32 limit, const char* text, ...)
+    \brief
+         \~english Same as PA_16bitText, but the text is formatted like printf (see PA_VFormat). The text comes last, followed by its arguments. Color codes are ignored.
+         \~french Comme PA_16bitText, mais le texte est formaté comme printf (voir PA_VFormat). Le texte vient en dernier, suivi de ses arguments. Les codes couleur sont ignorés.
+    \~\param text
+         \~english Text, such as "Score: %d"
+         \~french Texte, tel que "Score : %d"
+*/
+s16 PA_16bitTextf(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, u16 color, u8 size, u8 transp, s32 limit, const char* text, ...);
+
 /*! \fn s16 PA_CenterSmartText(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, const char* text, u8 color, u8 size, u8 transp)
     \brief
          \~english Basicaly the same as the SmartText function, but this time centered...
@@ -394,6 +414,7 @@ s16 PA_CenterSmartText(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, cons
 	bit8_tiles[bit8_slot] = (u8*)bit8_font##_Tiles;	\
 	pa_bittextdefaultsize[bit8_slot] = (u8*)bit8_font##_Sizes;	\
 	pa_bittextpoliceheight[bit8_slot] = bit8_font##_Height;\
+	PA_ResetGlyphCache(bit8_slot);\
 }while(0)
 
 /*! \fn void PA_AddBitmapFont(int slot, const PA_BgStruct* font)
@@ -471,14 +492,14 @@ void PA_ClearTextBg(u8 screen);
 
 /*! \fn void PA_Print(u8 screen, const char* text, ...)
     \brief
-         \~english Output text on the DS screen. Works like a printf function
-         \~french Ecrire du texte à l'écran. Marche comme la fonction printf
+         \~english Output text on the DS screen like a console. Works like a printf function, see PA_VFormat, with \%cX to change the color. When the text reaches the bottom of the screen, the background is scrolled up with the hardware scroll and only the new line is erased. PA_ClearTextBg puts it back at the top.
+         \~french Ecrire du texte à l'écran comme une console. Marche comme la fonction printf, voir PA_VFormat, avec \%cX pour changer de couleur. Quand le texte arrive en bas de l'écran, le fond est décalé vers le haut avec le scrolling et seule la nouvelle ligne est effacée. PA_ClearTextBg le remet en haut.
     \~\param screen
          \~english Chose de screen (0 or 1)
          \~french Choix de l'écran (0 ou 1)
     \~\param text
-         \~english String to output. The following commands are avaiblable : \%s to output another string, \%d to output a value, \%fX to output a float with X digits, \\n to go to the line. Here's an example : PA_OutputText(0, 0, 1, "My name is %s and I have only %d teeth", "Mollusk", 20);
-         \~french Chaine de caractère à écrire. On dispose des commandes suivantes : \%s pour une autre chaine de caractères, \%d pour écrire la valeur d'une variables, \%fX pour afficher un nombre avec X chiffres après la virgule, \\n pour aller à la ligne. Voici un exemple : PA_OutputText(0, 0, 1, "Mon nom est %s et je n'ai que %d dents...", "Mollusk", 20);
+         \~english String to output. Here's an example : PA_Print(0, "My name is %s and I have only %d teeth\\n", "Mollusk", 20);
+         \~french Chaine de caractère à écrire. Voici un exemple : PA_Print(0, "Mon nom est %s et je n'ai que %d dents...\\n", "Mollusk", 20);
 */
 void PA_Print(u8 screen, const char* text, ...);
 
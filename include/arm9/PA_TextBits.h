@@ -38,6 +38,8 @@ extern LetterPos PA_LetterPos;
 
 void PA_DoAlign(u16 start, s16 x, s16 maxx, u8 justify);
 void PA_DoLetterPos(s16 basex, s16 basey, s16 maxx, s16 maxy, const char* text, u16 color, u8 size, s32 limit);
+void PA_AddDirtyLetterPos(u8 screen, s32 limit, u8 transp);
+const char* PA_FormatBitText(const char *format, va_list args);
 
 static inline void PA_TextAlign(u8 align){
 	textinfo.align = align;
@@ -0,0 +1,206 @@
+#ifndef _PA_TEXTRUN
+#define _PA_TEXTRUN
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \file PA_TextRun.h
+    \brief Retained text objects for 8 bit, 16 bit and 16c backgrounds
+
+    A text run keeps the layout of a string and only draws it again when the
+    string, the color or the position changes. Letters are drawn from a cache
+    of rasterised glyphs, a whole glyph line at a time.
+*/
+
+#include "PA9.h"
+
+#define PA_TEXTRUN_8BIT  0
+#define PA_TEXTRUN_16BIT 1
+#define PA_TEXTRUN_16C   2
+
+typedef struct {
+	s16 X, Y;
+	char Letter;
+	u8 Width;
+} PA_TextRunGlyph;
+
+typedef struct {
+	u8 Screen;
+	u8 Mode;     // PA_TEXTRUN_8BIT, PA_TEXTRUN_16BIT or PA_TEXTRUN_16C
+	u8 Size;
+	u8 Transp;   // 0 for normal text, 1 for transparent text
+	u8 Dirty;    // Needs to be drawn again
+	u16 Color;
+	s16 BaseX, BaseY, MaxX, MaxY;
+	s32 Limit;
+
+	char *Text;  // Copy of the last string
+	s32 NGlyphs, GlyphSpace;
+	PA_TextRunGlyph *Glyphs;
+
+	s16 X1, Y1, X2, Y2; // Area covered the last time the run was drawn
+	u8 Drawn;
+} PA_TextRun;
+
+// Rows of a letter, from the cache, 16 lines of 16 pixels. c16 is 1 for the 16c fonts.
+const u16 *PA_GetGlyph(u8 c16, u8 size, u8 letter);
+
+// Draw a glyph from 1 bit rows (bit 0 is the leftmost pixel, 16 pixels at most)
+void PA_BlitGlyph8bit(u8 screen, s16 x, s16 y, const u16 *rows, u8 lx, u8 ly, u8 color, u8 transp);
+void PA_BlitGlyph16bit(u8 screen, s16 x, s16 y, const u16 *rows, u8 lx, u8 ly, u16 color, u8 transp);
+void PA_BlitGlyph16c(u8 screen, s16 x, s16 y, const u16 *rows, u8 ly, u8 color);
+
+/** @defgroup TextRun Text runs
+ *  Retained text objects for 8 bit, 16 bit and 16c backgrounds
+ *  @{
+ */
+
+/*! \fn void PA_InitTextRun(PA_TextRun *run, u8 mode, u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, u16 color, u8 size, u8 transp)
+    \brief
+         \~english Initialise a text run. The text is laid out like PA_8bitText, PA_16bitText or PA_16cText, but only when it changes.
+         \~french Initialise un texte retenu. Le texte est positionné comme avec PA_8bitText, PA_16bitText ou PA_16cText, mais seulement quand il change.
+    \~\param run
+         \~english Text run to initialise
+         \~french Texte à initialiser
+    \~\param mode
+         \~english Background type: PA_TEXTRUN_8BIT, PA_TEXTRUN_16BIT or PA_TEXTRUN_16C
+         \~french Type de fond : PA_TEXTRUN_8BIT, PA_TEXTRUN_16BIT ou PA_TEXTRUN_16C
+    \~\param screen
+         \~english Chose de screen (0 or 1)
+         \~french Choix de l'écran (0 ou 1)
+    \~\param basex
+         \~english X coordinate of the top left corner
+         \~french Coordonnée X du coin supérieur gauche
+    \~\param basey
+         \~english Y coordinate of the top left corner
+         \~french Coordonnée Y du coin supérieur gauche
+    \~\param maxx
+         \~english X coordinate of the down right corner
+         \~french Coordonnée X du coin inférieur droit
+    \~\param maxy
+         \~english Y coordinate of the down right corner
+         \~french Coordonnée Y du coin inférieur droit
+    \~\param color
+         \~english Palette color (8 bit and 16c) or 15 bit color (16 bit)
+         \~french Couleur de la palette (8 bit et 16c) ou couleur de 15 bits (16 bit)
+    \~\param size
+         \~english Size of the text, from 0 (really small) to 4 (pretty big)
+         \~french Taille du texte, de 0 (vraiment petit) à 4 (assez grand)
+    \~\param transp
+         \~english 0 to erase what is under the text, 1 to draw it over the background. 16c text is always transparent.
+         \~french 0 pour effacer ce qu'il y a sous le texte, 1 pour écrire par-dessus. Le texte 16c est toujours transparent.
+*/
+void PA_InitTextRun(PA_TextRun *run, u8 mode, u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, u16 color, u8 size, u8 transp);
+
+/*! \fn u8 PA_SetTextRun(PA_TextRun *run, const char *text)
+    \brief
+         \~english Set the string of a text run. If it's the same as the previous one nothing is done. Returns 1 if the text has changed.
+         \~french Change le texte. S'il est identique au précédent, rien n'est fait. Renvoie 1 si le texte a changé.
+    \~\param run
+         \~english Text run
+         \~french Texte
+    \~\param text
+         \~english New text
+         \~french Nouveau texte
+*/
+u8 PA_SetTextRun(PA_TextRun *run, const char *text);
+
+/*! \fn void PA_SetTextRunColor(PA_TextRun *run, u16 color)
+    \brief
+         \~english Change the color of a text run. It will be drawn again with PA_DrawTextRun.
+         \~french Change la couleur du texte. Il sera redessiné par PA_DrawTextRun.
+    \~\param run
+         \~english Text run
+         \~french Texte
+    \~\param color
+         \~english New color
+         \~french Nouvelle couleur
+*/
+void PA_SetTextRunColor(PA_TextRun *run, u16 color);
+
+/*! \fn void PA_SetTextRunPos(PA_TextRun *run, s16 basex, s16 basey, s16 maxx, s16 maxy)
+    \brief
+         \~english Move the box of a text run. The text is laid out again.
+         \~french Déplace la zone du texte. Le texte est repositionné.
+    \~\param run
+         \~english Text run
+         \~french Texte
+    \~\param basex
+         \~english X coordinate of the top left corner
+         \~french Coordonnée X du coin supérieur gauche
+    \~\param basey
+         \~english Y coordinate of the top left corner
+         \~french Coordonnée Y du coin supérieur gauche
+    \~\param maxx
+         \~english X coordinate of the down right corner
+         \~french Coordonnée X du coin inférieur droit
+    \~\param maxy
+         \~english Y coordinate of the down right corner
+         \~french Coordonnée Y du coin inférieur droit
+*/
+void PA_SetTextRunPos(PA_TextRun *run, s16 basex, s16 basey, s16 maxx, s16 maxy);
+
+/*! \fn void PA_SetTextRunLimit(PA_TextRun *run, s32 limit)
+    \brief
+         \~english Maximum number of letters to draw, to show a text letter by letter
+         \~french Nombre maximum de lettres à afficher, pour écrire un texte lettre par lettre
+    \~\param run
+         \~english Text run
+         \~french Texte
+    \~\param limit
+         \~english Maximum number of letters
+         \~french Nombre maximum de lettres
+*/
+void PA_SetTextRunLimit(PA_TextRun *run, s32 limit);
+
+/*! \fn s32 PA_DrawTextRun(PA_TextRun *run)
+    \brief
+         \~english Draw a text run if something has changed since the last time. The area of the previous text is erased if the run isn't transparent (always for 16c). Returns the number of letters drawn, 0 if nothing had to be drawn.
+         \~french Dessine le texte si quelque chose a changé depuis la dernière fois. L'ancien texte est effacé si le texte n'est pas transparent (toujours en 16c). Renvoie le nombre de lettres dessinées, 0 si rien n'a été dessiné.
+    \~\param run
+         \~english Text run
+         \~french Texte
+*/
+s32 PA_DrawTextRun(PA_TextRun *run);
+
+/*! \fn static inline void PA_RedrawTextRun(PA_TextRun *run)
+    \brief
+         \~english Force a text run to be drawn again the next time PA_DrawTextRun is called, for example after clearing the screen.
+         \~french Force le texte à être redessiné au prochain PA_DrawTextRun, par exemple après avoir effacé l'écran.
+    \~\param run
+         \~english Text run
+         \~french Texte
+*/
+static inline void PA_RedrawTextRun(PA_TextRun *run){
+	run->Dirty = 1;
+	run->Drawn = 0;
+}
+
+/*! \fn void PA_DeleteTextRun(PA_TextRun *run)
+    \brief
+         \~english Free the memory used by a text run. It doesn't erase it from the screen.
+         \~french Libère la mémoire utilisée par le texte. Il n'est pas effacé de l'écran.
+    \~\param run
+         \~english Text run
+         \~french Texte
+*/
+void PA_DeleteTextRun(PA_TextRun *run);
+
+/*! \fn void PA_ResetGlyphCache(int slot)
+    \brief
+         \~english Forget the rasterised glyphs of a font slot. This is done automatically by PA_AddBitmapFont and PA_Add16cFont.
+         \~french Oublie les lettres pré-dessinées d'une police. C'est fait automatiquement par PA_AddBitmapFont et PA_Add16cFont.
+    \~\param slot
+         \~english Font slot (0-9)
+         \~french Slot de la police (0-9)
+*/
+void PA_ResetGlyphCache(int slot);
+
+/** @} */ // end of TextRun
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
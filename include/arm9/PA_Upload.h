@@ -0,0 +1,128 @@
+#ifndef _PA_Upload
+#define _PA_Upload
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \file PA_Upload.h
+    \brief Copies to VRAM queued and done during the VBL
+
+    Sprite and background graphics, 3D textures and extended palettes all go
+    through PA_UploadCopy. Once the queue is started, the copies wait for the
+    next VBL instead of being done right away, each VRAM bank is switched once
+    for all its copies, copies following each other are merged, and the data
+    cache is flushed once. A budget limits the bytes copied during a VBL, what
+    doesn't fit is copied at the next ones.
+*/
+
+#include <PA9.h>
+
+// VRAM the copies go to, and so the bank to switch to LCD mode during the copy
+#define PA_UPLOAD_DIRECT 0 // Sprites and backgrounds, always mapped
+#define PA_UPLOAD_TEXTURE 1 // 3D textures, banks A and B
+#define PA_UPLOAD_SPRITEEXTPAL(screen) (2 + (screen)) // Banks G and I
+#define PA_UPLOAD_BGEXTPAL(screen) (4 + (screen)) // Banks E and H
+#define PA_UPLOAD_BANKS 6
+
+#define PA_UPLOAD_MAX 64 // Copies waiting for each bank
+#define PA_UPLOAD_BUDGET 32768 // Default bytes copied at each VBL
+#define PA_UPLOAD_DMA 0 // DMA channel, also used by the VBL for the OAM
+
+typedef struct {
+	const u8 *Src; // NULL to fill with 0
+	u8 *Dest;
+	u32 Size;
+} PA_UploadItem;
+
+typedef struct {
+	u32 Queued;    // Bytes queued during the last frame
+	u32 Uploaded;  // Bytes copied at the last VBL
+	u32 Deferred;  // Bytes still waiting after the last VBL
+	u16 Copies;    // Copies done at the last VBL
+	u16 Merged;    // Copies merged with the one before during the last frame
+	u16 Switches;  // Banks switched at the last VBL
+} PA_UploadStats;
+
+extern u8 PA_UploadOn;
+extern PA_UploadStats PA_UploadCounters;
+
+/** @defgroup Upload Upload queue
+ *  Copies to VRAM queued and done during the VBL
+ *  @{
+ */
+
+/*! \fn void PA_UploadInit(u32 budget)
+    \brief
+         \~english Start queuing the copies to VRAM. From now on PA_CreateGfx, PA_UpdateGfx, PA_LoadBgTilesEx, PA_LoadSpriteExtPal, PA_LoadBgPalN, PA_3DCreateTex and PA_3DUpdateGfx copy at the next VBL, the data given to them must stay there until then.
+         \~french Commence à mettre les copies vers la VRAM en attente. A partir de là PA_CreateGfx, PA_UpdateGfx, PA_LoadBgTilesEx, PA_LoadSpriteExtPal, PA_LoadBgPalN, PA_3DCreateTex et PA_3DUpdateGfx copient au prochain VBL, les données qu'on leur donne doivent rester là jusque-là.
+    \~\param budget
+         \~english Bytes copied at most during a VBL, 0 for no limit. PA_UPLOAD_BUDGET is a good start.
+         \~french Octets copiés au plus pendant un VBL, 0 pour ne pas limiter. PA_UPLOAD_BUDGET est un bon début.
+*/
+void PA_UploadInit(u32 budget);
+
+/*! \fn void PA_UploadStop(void)
+    \brief
+         \~english Copy what is still waiting, and copy right away again from now on
+         \~french Copie ce qui attend encore, et copie directement à partir de là
+*/
+void PA_UploadStop(void);
+
+/*! \fn void PA_UploadSetBudget(u32 budget)
+    \brief
+         \~english Change the bytes copied at most during a VBL
+         \~french Change le nombre d'octets copiés au plus pendant un VBL
+    \~\param budget
+         \~english Bytes, 0 for no limit
+         \~french Octets, 0 pour ne pas limiter
+*/
+void PA_UploadSetBudget(u32 budget);
+
+/*! \fn void PA_UploadCopy(const void *src, void *dest, u32 size, u8 bank)
+    \brief
+         \~english Copy data to VRAM, at the next VBL if the queue is started, right away if not
+         \~french Copie des données en VRAM, au prochain VBL si la file d'attente est lancée, directement sinon
+    \~\param src
+         \~english Data, NULL to fill with 0
+         \~french Données, NULL pour remplir de 0
+    \~\param dest
+         \~english Address in VRAM, the LCD one for banks in LCD mode during the copy
+         \~french Adresse en VRAM, celle du mode LCD pour les banques passées en mode LCD pendant la copie
+    \~\param size
+         \~english Size in bytes, multiple of 2
+         \~french Taille en octets, multiple de 2
+    \~\param bank
+         \~english PA_UPLOAD_DIRECT, PA_UPLOAD_TEXTURE, PA_UPLOAD_SPRITEEXTPAL(screen) or PA_UPLOAD_BGEXTPAL(screen)
+         \~french PA_UPLOAD_DIRECT, PA_UPLOAD_TEXTURE, PA_UPLOAD_SPRITEEXTPAL(screen) ou PA_UPLOAD_BGEXTPAL(screen)
+*/
+void PA_UploadCopy(const void *src, void *dest, u32 size, u8 bank);
+
+/*! \fn void PA_UploadFlush(void)
+    \brief
+         \~english Copy everything that is waiting right now, for example before freeing the data
+         \~french Copie tout ce qui attend tout de suite, par exemple avant de libérer les données
+*/
+void PA_UploadFlush(void);
+
+/*! \fn u32 PA_UploadPending(void)
+    \brief
+         \~english Bytes waiting to be copied
+         \~french Octets qui attendent d'être copiés
+*/
+u32 PA_UploadPending(void);
+
+/*! \fn void PA_UploadVBL(void)
+    \brief
+         \~english Copy what fits in the budget, called by the VBL once the queue is started
+         \~french Copie ce qui tient dans le budget, appelé par le VBL une fois la file d'attente lancée
+*/
+void PA_UploadVBL(void);
+
+/** @} */ // end of Upload
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
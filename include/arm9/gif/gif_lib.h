@@ -198,6 +198,10 @@ int DGifGetScreenDesc(GifFileType * GifFile);
 int DGifGetRecordType(GifFileType * GifFile, GifRecordType * GifType);
 int DGifGetImageDesc(GifFileType * GifFile);
 int DGifGetLine(GifFileType * GifFile, GifPixelType * GifLine, int GifLineLen);
+int DGifGetLine16(GifFileType * GifFile, unsigned short * GifLine,
+                  int GifLineLen, const unsigned short * GifPalette);
+int DGifGetImage(GifFileType * GifFile, void * GifDest, int GifPitch,
+                 const unsigned short * GifPalette);
 int DGifGetPixel(GifFileType * GifFile, GifPixelType GifPixel);
 int DGifGetComment(GifFileType * GifFile, char *GifComment);
 int DGifGetExtension(GifFileType * GifFile, int *GifExtCode,
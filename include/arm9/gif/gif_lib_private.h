@@ -50,6 +50,8 @@ typedef struct GifFilePrivateType {
     GifByteType Stack[LZ_MAX_CODE]; /* Decoded pixels are stacked here. */
     GifByteType Suffix[LZ_MAX_CODE + 1];    /* So we can trace the codes. */
     GifPrefixType Prefix[LZ_MAX_CODE + 1];
+    GifPrefixType Length[LZ_MAX_CODE + 1];  /* Length of each code's string. */
+    GifByteType FirstChar[LZ_MAX_CODE + 1]; /* And its first pixel. */
 } GifFilePrivateType;
 
 extern int _GifError;
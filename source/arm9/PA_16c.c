@@ -87,6 +87,7 @@ void pa_16cTextDecompress(u8 size){
 s16 PA_16cText(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, const char* text, u8 color, u8 size, s32 limit){
 	int i;
 	
+	PA_ProfileBegin(PA_PROFILE_TEXT);
 	pa_16cTextDecompress(size);
 	
 	PA_DoLetterPos(basex, basey, maxx, maxy, text, color, size, limit);
@@ -96,9 +97,21 @@ s16 PA_16cText(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, const char*
 	for(i = 0; i < limit; i ++)
 		PA_16cLetter(screen, PA_LetterPos.Letter[i].X, PA_LetterPos.Letter[i].Y, PA_LetterPos.Letter[i].Letter, PA_LetterPos.Letter[i].Size, PA_LetterPos.Letter[i].Color);
 
+	PA_ProfileEnd();
 	return limit;
 }
 
+s16 PA_16cTextf(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, u8 color, u8 size, s32 limit, const char* text, ...){
+	const char *formatted;
+	va_list varg;
+
+	va_start(varg, text);
+	formatted = PA_FormatBitText(text, varg);
+	va_end(varg);
+
+	return PA_16cText(screen, basex, basey, maxx, maxy, formatted, color, size, limit);
+}
+
 void PA_16cErase(u8 screen){
 	dmaFillWords(0, PA_Draw1632[screen], 26*8*34*4);
 }
@@ -14,6 +14,7 @@ void PADefault3DInit(){
 	if(pa_3Dscreen) PA_SwitchScreens();
 	pa_3Dscreen = 0;
 	pa_3Ddual = 0;
+	Dual3DVBL = PA_Nothing;
 }
 
 void PA_Init3D(){
@@ -0,0 +1,206 @@
+#include <PA9.h>
+
+//////////////////////////////////////////////////////////////////////
+// Particles, one array per field so the update loop only reads what it
+// needs, positions and speeds in .8 fixed point
+//////////////////////////////////////////////////////////////////////
+
+PA_3DEmitter pa_3demitters[PA_3DEMITTERS_MAX];
+PA_3DParticleInfo PA_3DParticleInfos;
+
+static s32 pa_partx[PA_3DPARTICLES_MAX], pa_party[PA_3DPARTICLES_MAX];
+static s32 pa_partvx[PA_3DPARTICLES_MAX], pa_partvy[PA_3DPARTICLES_MAX];
+static u16 pa_partlife[PA_3DPARTICLES_MAX];
+static u8 pa_partemitter[PA_3DPARTICLES_MAX];
+static u16 pa_nparticles;
+
+static u16 pa_partorder[PA_3DPARTICLES_MAX]; // Particles sorted by emitter, for drawing
+
+void PA_3DResetParticles(void){
+	memset(pa_3demitters, 0, sizeof(pa_3demitters));
+	memset(&PA_3DParticleInfos, 0, sizeof(PA_3DParticleInfos));
+	pa_nparticles = 0;
+}
+
+s16 PA_3DCreateEmitter(u16 texture, u16 width, u16 height, u8 palette, s16 x, s16 y){
+	PA_3DEmitter *em;
+	s16 i;
+
+	for(i = 0; (i < PA_3DEMITTERS_MAX) && pa_3demitters[i].Alive; i++);
+	if(i == PA_3DEMITTERS_MAX) return -1;
+
+	em = pa_3demitters + i;
+	memset(em, 0, sizeof(PA_3DEmitter));
+	em->Alive = 1;
+	em->Texture = texture;
+	em->Palette = (((textures[texture] >> 26) & 7) == TEX_4COL) ? (palette << 1) : palette;
+	em->Width = width; em->Height = height;
+	em->SizeX = width; em->SizeY = height;
+	em->Color = 0x7FFF;
+	em->Priority = 1024;
+	em->X = x << 8; em->Y = y << 8;
+	em->Angle = 128; // Up
+	em->Speed = 256;
+	em->Life = 60;
+
+	return i;
+}
+
+void PA_3DDeleteEmitter(u8 emitter){
+	u16 i = 0;
+
+	pa_3demitters[emitter].Alive = 0;
+
+	while((i < pa_nparticles) && pa_3demitters[emitter].NParticles){
+		if(pa_partemitter[i] == emitter){ // The last particle takes its place
+			pa_nparticles--;
+			pa_partx[i] = pa_partx[pa_nparticles]; pa_party[i] = pa_party[pa_nparticles];
+			pa_partvx[i] = pa_partvx[pa_nparticles]; pa_partvy[i] = pa_partvy[pa_nparticles];
+			pa_partlife[i] = pa_partlife[pa_nparticles];
+			pa_partemitter[i] = pa_partemitter[pa_nparticles];
+			pa_3demitters[emitter].NParticles--;
+		}
+		else i++;
+	}
+}
+
+void PA_3DEmitterBurst(u8 emitter, u16 n){
+	PA_3DEmitter *em = pa_3demitters + emitter;
+
+	for(; n && (pa_nparticles < PA_3DPARTICLES_MAX); n--){
+		u16 i = pa_nparticles++;
+		s16 angle = em->Angle;
+		s32 speed = em->Speed;
+
+		if(em->Spread) angle += (s32)(PA_Rand() % (em->Spread * 2 + 1)) - em->Spread;
+		if(em->SpeedRand) speed += PA_Rand() % (em->SpeedRand + 1);
+
+		pa_partx[i] = em->X;
+		pa_party[i] = em->Y;
+		pa_partvx[i] = (PA_Cos(angle & 511) * speed) >> 8;
+		pa_partvy[i] = -(PA_Sin(angle & 511) * speed) >> 8;
+		pa_partlife[i] = em->Life + (em->LifeRand ? PA_Rand() % (em->LifeRand + 1) : 0);
+		if(!pa_partlife[i]) pa_partlife[i] = 1; // Gone at the next update, a life of 0 would wrap around
+		pa_partemitter[i] = emitter;
+		em->NParticles++;
+	}
+}
+
+void PA_3DUpdateParticles(void){
+	u16 i, e;
+
+	// New particles from the emitters' rates
+	for(e = 0; e < PA_3DEMITTERS_MAX; e++){
+		PA_3DEmitter *em = pa_3demitters + e;
+
+		if(!em->Alive || !em->Rate) continue;
+		em->Accum += em->Rate;
+		PA_3DEmitterBurst(e, em->Accum >> 8);
+		em->Accum &= 255;
+	}
+
+	// Lives first : dead particles are replaced by the last ones before moving
+	for(i = 0; i < pa_nparticles;){
+		if(--pa_partlife[i]){
+			i++;
+			continue;
+		}
+
+		pa_3demitters[pa_partemitter[i]].NParticles--;
+		pa_nparticles--;
+		pa_partx[i] = pa_partx[pa_nparticles]; pa_party[i] = pa_party[pa_nparticles];
+		pa_partvx[i] = pa_partvx[pa_nparticles]; pa_partvy[i] = pa_partvy[pa_nparticles];
+		pa_partlife[i] = pa_partlife[pa_nparticles];
+		pa_partemitter[i] = pa_partemitter[pa_nparticles];
+	}
+
+	for(i = 0; i < pa_nparticles; i++){
+		const PA_3DEmitter *em = pa_3demitters + pa_partemitter[i];
+
+		pa_partvx[i] += em->GravityX;
+		pa_partvy[i] += em->GravityY;
+	}
+
+	for(i = 0; i < pa_nparticles; i++){
+		pa_partx[i] += pa_partvx[i];
+		pa_party[i] += pa_partvy[i];
+	}
+
+	PA_3DParticleInfos.Alive = pa_nparticles;
+}
+
+static inline void PA_3DParticleVertex(s16 x, s16 y, u16 z){
+	GFX_VERTEX16 = (((u32)(u16)(192 - y)) << 16) | (u16)x;
+	GFX_VERTEX16 = z;
+}
+
+u16 PA_3DDrawParticles(s16 ydecal, u16 budget){
+	u16 first[PA_3DEMITTERS_MAX], next[PA_3DEMITTERS_MAX];
+	u16 i, e, n = 0, drawn = 0, culled = 0, dropped = 0;
+
+	if(pa_nparticles == 0){
+		memset(&PA_3DParticleInfos, 0, sizeof(PA_3DParticleInfos));
+		return 0;
+	}
+
+	// Sorted by emitter in one pass, from the number of particles of each
+	for(e = 0; e < PA_3DEMITTERS_MAX; e++){
+		first[e] = next[e] = n;
+		n += pa_3demitters[e].NParticles;
+	}
+	for(i = 0; i < pa_nparticles; i++) pa_partorder[next[pa_partemitter[i]]++] = i;
+
+	for(e = 0; e < PA_3DEMITTERS_MAX; e++){
+		const PA_3DEmitter *em = pa_3demitters + e;
+		u32 u1, u2, v1, v2;
+		s16 w0, w1, h0, h1;
+
+		if(first[e] == next[e]) continue;
+
+		// Same state for all the particles of the emitter
+		GFX_TEX_FORMAT = textures[em->Texture];
+		GFX_PAL_FORMAT = em->Palette << 5;
+		GFX_POLY_FORMAT = (1<<6) | (1<<7) | (31 << 16);
+		GFX_COLOR = em->Color;
+		GFX_BEGIN = GL_QUAD;
+
+		u1 = 0; u2 = inttot16(em->Width);
+		v1 = 0; v2 = inttot16(em->Height);
+		w0 = em->SizeX >> 1; w1 = em->SizeX - w0;
+		h0 = em->SizeY >> 1; h1 = em->SizeY - h0;
+
+		for(n = first[e]; n < next[e]; n++){
+			s16 x, y;
+
+			i = pa_partorder[n];
+			x = pa_partx[i] >> 8;
+			y = (pa_party[i] >> 8) + ydecal;
+
+			if((x + w1 <= 0) || (x - w0 >= 256) || (y + h1 <= 0) || (y - h0 >= 192)){
+				culled++;
+				continue;
+			}
+			if(drawn == budget){
+				dropped++;
+				continue;
+			}
+
+			// Corners computed here, nothing for the geometry engine to transform but the projection
+			GFX_TEX_COORD = TEXTURE_PACK(u1, v2);
+			PA_3DParticleVertex(x - w0, y + h1, em->Priority);
+			GFX_TEX_COORD = TEXTURE_PACK(u2, v2);
+			PA_3DParticleVertex(x + w1, y + h1, em->Priority);
+			GFX_TEX_COORD = TEXTURE_PACK(u2, v1);
+			PA_3DParticleVertex(x + w1, y - h0, em->Priority);
+			GFX_TEX_COORD = TEXTURE_PACK(u1, v1);
+			PA_3DParticleVertex(x - w0, y - h0, em->Priority);
+			drawn++;
+		}
+	}
+
+	PA_3DParticleInfos.Drawn = drawn;
+	PA_3DParticleInfos.Culled = culled;
+	PA_3DParticleInfos.Dropped = dropped;
+
+	return drawn;
+}
@@ -26,9 +26,20 @@ uint32 activeTexture;
 void PA_3DUpdateSpriteAnims();
 void PA_3DCapture();
 
-u8 pa_3Ddual = 0;
+u8 pa_3Ddual = 0; // 1 for PA_Init3DDual, 2 for PA_Init3DDualEx
 u8 pa_3Dscreen = 0;
 
+PA_3DDualInfo PA_3DDualInfos;
+static u8 pa_3DDualRatio;
+static u8 pa_3DDualRefresh; // Sub scene asked for the next frame
+static u32 pa_3DDualCount; // Frames sent to the 3D hardware
+static u32 pa_3DDualSent[2]; // VBL count when each scene was last sent
+static vu8 pa_3DDualPending = PA_3DDUAL_NONE; // Scene sent during this frame
+static u8 pa_3DDualDrawn = PA_3DDUAL_NONE; // Scene the 3D hardware draws in this frame
+static u8 pa_3DDualShown; // 0 : the sub screen shows bank C, 1 : bank D
+static u8 pa_3DDualCapturing; // The sub scene is captured in this frame
+static u32 pa_3DDualCaptured; // When that sub scene was sent
+
 void PA_SetRegCapture(bool enable, uint8 srcBlend, uint8 destBlend, uint8 bank, uint8 offset, uint8 size, uint8 source, uint8 srcOffset){
 	uint32 value = 0;
 	if(enable) value |= 1 << 31; // 31 is enable
@@ -96,10 +107,10 @@ void PA_3DSpriteToScreen(u16 sprite, s16 ydecal){
 	u8 hflip = pa_3dsprites[sprite].Hflip;
 	u8 vflip = pa_3dsprites[sprite].Vflip; 
 
-	x1 = inttot16(pa_3dsprites[sprite].ImgWidth) * hflip;
-	x2 = inttot16(pa_3dsprites[sprite].ImgWidth) * (!hflip);
-	y1 = inttot16(pa_3dsprites[sprite].ImgHeight) * (!vflip);
-	y2 = inttot16(pa_3dsprites[sprite].ImgHeight) * vflip;
+	x1 = inttot16(pa_3dsprites[sprite].U + pa_3dsprites[sprite].ImgWidth * hflip);
+	x2 = inttot16(pa_3dsprites[sprite].U + pa_3dsprites[sprite].ImgWidth * (!hflip));
+	y1 = inttot16(pa_3dsprites[sprite].V + pa_3dsprites[sprite].ImgHeight * (!vflip));
+	y2 = inttot16(pa_3dsprites[sprite].V + pa_3dsprites[sprite].ImgHeight * vflip);
 
 	s32 zoomx0 = pa_3dsprites[sprite].Width >> 1;
 	s32 zoomx1 = (pa_3dsprites[sprite].Width + 1) >> 1;	
@@ -128,6 +139,113 @@ void PA_3DSpriteToScreen(u16 sprite, s16 ydecal){
 	MATRIX_POP = 1;
 }  
 
+PA_3DBudgetInfo PA_3DBudgetInfos;
+static u16 pa_3DBudget = PA_3D_MAXVERTICES / 4;
+static u16 pa_3DSpriteVertices = 4 << 8; // Vertices per sprite in the last frame, .8 fixed point
+static u8 pa_3DOnScreen[PA_NMAXSPRITES];
+
+// Box around the sprite, large enough for any rotation and corner moved
+static inline u8 PA_3DSpriteOnScreen(u16 sprite, s16 ydecal){
+	pa3dsprites *spr = pa_3dsprites + sprite;
+	s32 rx = (spr->Width < 0) ? -spr->Width : spr->Width;
+	s32 ry = (spr->Height < 0) ? -spr->Height : spr->Height;
+	s32 x = spr->X, y = spr->Y + ydecal, c = 0, i;
+
+	if((rx == 0) || (ry == 0)) return 0;
+
+	for(i = 0; i < 4; i++){
+		s32 cx = spr->corner[i].x, cy = spr->corner[i].y;
+		if(c < cx) c = cx;
+		if(c < -cx) c = -cx;
+		if(c < cy) c = cy;
+		if(c < -cy) c = -cy;
+	}
+
+	if(spr->RotX | spr->RotY | spr->RotZ){ // Half the diagonal is less than half the sum
+		rx = ry = ((rx + ry) >> 1) + (c << 1) + 1;
+	}else{
+		rx = (rx >> 1) + c + 1;
+		ry = (ry >> 1) + c + 1;
+	}
+
+	return (x + rx >= 0) && (x - rx < 256) && (y + ry >= 0) && (y - ry < 192);
+}
+
+// Sends the sprites on screen, the most important ones first if they don't all fit
+static void PA_3DDrawSprites(s16 ydecal){
+	u16 count[256];
+	u16 budget = pa_3DBudget, limit, visible = 0, culled = 0, dropped = 0, drawn = 0, left;
+	s32 i, keep = 0;
+
+	// Sprites cut by the screen edges took more vertices in the last frame
+	limit = (PA_3D_MAXVERTICES << 8) / pa_3DSpriteVertices;
+	if(limit < budget) budget = limit;
+	budget = (budget > pa_3DTextLetters) ? budget - pa_3DTextLetters : 0; // Room for the 3D text
+
+	memset(count, 0, sizeof(count));
+
+	for(i = 0; i < PA_NMAXSPRITES; i++){
+		pa_3DOnScreen[i] = pa_3dsprites[i].Alive && PA_3DSpriteOnScreen(i, ydecal);
+		if(pa_3DOnScreen[i]){
+			count[pa_3dsprites[i].Importance] ++;
+			visible ++;
+		}else if(pa_3dsprites[i].Alive)
+			culled ++;
+	}
+
+	// Sprites more important than keep are all drawn, then left ones as important as keep
+	left = visible;
+	if(visible > budget){
+		left = budget;
+		for(keep = 255; count[keep] < left; keep--) left -= count[keep];
+	}
+
+	for(i = 0; i < PA_NMAXSPRITES; i++){
+		if(!pa_3DOnScreen[i]) continue;
+
+		if(pa_3dsprites[i].Importance == keep){
+			if(left == 0){
+				dropped ++;
+				continue;
+			}
+			left --;
+		}else if(pa_3dsprites[i].Importance < keep){
+			dropped ++;
+			continue;
+		}
+
+		PA_3DSpriteToScreen(i, ydecal);
+		drawn ++;
+	}
+
+	PA_3DBudgetInfos.Submitted = drawn;
+	PA_3DBudgetInfos.Culled = culled;
+	PA_3DBudgetInfos.Dropped = dropped;
+
+	PA_3DDrawParticles(ydecal, budget - drawn); // With what is left of the budget
+
+	PA_3DDrawText(ydecal); // Above the sprites with the default priorities
+}
+
+// What the 3D hardware really stored, read before the flush
+static void PA_3DBudgetCount(void){
+	PA_3DBudgetInfos.Polygons = GFX_POLYGON_RAM_USAGE;
+	PA_3DBudgetInfos.Vertices = GFX_VERTEX_RAM_USAGE;
+	PA_3DBudgetInfos.Overflow = (GFX_CONTROL >> 13) & 1;
+	if(PA_3DBudgetInfos.Overflow) GFX_CONTROL |= 1 << 13; // The flag stays until 1 is written to it
+
+	pa_3DSpriteVertices = 4 << 8;
+	if(PA_3DBudgetInfos.Polygons && (PA_3DBudgetInfos.Vertices > (PA_3DBudgetInfos.Polygons << 2)))
+		pa_3DSpriteVertices = (PA_3DBudgetInfos.Vertices << 8) / PA_3DBudgetInfos.Polygons;
+	if(PA_3DBudgetInfos.Overflow) // Vertices ran out, so the real count is higher than that
+		pa_3DSpriteVertices += pa_3DSpriteVertices >> 2;
+}
+
+void PA_3DSetBudget(u16 polygons){
+	PA_Assert(polygons <= PA_3D_MAXPOLYGONS, "The 3D hardware can't draw that many polygons");
+	pa_3DBudget = polygons;
+}
+
 void PA_glReset(){
 	while(GFX_BUSY); // wait until the gfx engine is not busy
 
@@ -149,9 +267,12 @@ void PA_glReset(){
 }
 
 void PA_3DProcess(){
-	if(pa_3Ddual) PA_3DCapture();
+	PA_ProfileBegin(PA_PROFILE_3D);
+
+	if(pa_3Ddual == 1) PA_3DCapture();
 
 	PA_3DUpdateSpriteAnims(); // Update animations...
+	PA_3DUpdateParticles();
 	PA_glReset();
 	glEnable(GL_BLEND);
 	glAlphaFunc(BLEND_ALPHA);
@@ -180,26 +301,28 @@ void PA_3DProcess(){
 
 	GFX_TEX_FORMAT |= (1 << 29); // Palette index 0 = transparent
 
-	int i;
-
-	if(pa_3Ddual){
-		if(pa_3Dscreen == 1){
-			for(i = 0; i < PA_NMAXSPRITES; i ++)
-				if(pa_3dsprites[i].Alive)
-					PA_3DSpriteToScreen(i, 0);
-		}else{
-			for(i = 0; i < PA_NMAXSPRITES; i ++)
-				if(pa_3dsprites[i].Alive)
-					PA_3DSpriteToScreen(i, -PA_ScreenSpace);
-		}
+	if(pa_3Ddual == 2){ // One scene per frame, the VBL shows it on the right screen
+		u8 top = (REG_POWERCNT & SWITCH_SCREENS) ? PA_3DDUAL_MAIN : PA_3DDUAL_SUB;
+
+		PA_3DDrawSprites((PA_3DDualScene() == top) ? 0 : -PA_ScreenSpace);
+		PA_3DBudgetCount();
+		PA_3DDualFlush();
+		PA_ProfileEnd();
+		return;
+	}else if(pa_3Ddual){
+		if(pa_3Dscreen == 1)
+			PA_3DDrawSprites(0);
+		else
+			PA_3DDrawSprites(-PA_ScreenSpace);
 		PA_SwitchScreens();
 		pa_3Dscreen = !pa_3Dscreen;
 	}else // Normal
-		for(i = 0; i < PA_NMAXSPRITES; i++)
-			if(pa_3dsprites[i].Alive)
-				PA_3DSpriteToScreen(i, 0);		
+		PA_3DDrawSprites(0);
 
+	PA_3DBudgetCount();
 	GFX_FLUSH = 0;
+
+	PA_ProfileEnd();
 }
 
 void PA_3DDeleteTex(u32 tex_gfx){
@@ -298,16 +421,8 @@ s16 PA_3DCreateTex(void* obj_data, u16 width, u16 height, u8 type){
 	truenumber = (u32) &VRAM_A[i << 3];
 	used_mem3D[i] = block_size;   // Nombre de blocks
 
-	DC_FlushRange(obj_data, mem_size);
-
-	// Start Copy...
-	vramSetBankA(VRAM_A_LCD);
-
-	if(pa_3Dbanks == 2) vramSetBankB(VRAM_B_LCD);
-	dmaCopy(obj_data, (void*) truenumber, mem_size);
-	if(pa_3Dbanks == 2) vramSetBankB(VRAM_B_TEXTURE);
-
-	vramSetBankA(VRAM_A_TEXTURE);
+	// Start Copy... banks A and B go in LCD mode during it
+	PA_UploadCopy(obj_data, (void*) truenumber, mem_size, PA_UPLOAD_TEXTURE);
 
 	PA_glTexParameter(texwidth, texheight, (u32*)truenumber, type, TEXGEN_TEXCOORD);
 	free_mem3D[n_mem].free -= block_size;
@@ -338,6 +453,9 @@ void PA_3DCreateSpriteFromTex(u16 sprite, u16 texture, u16 width, u16 height, u8
 	pa_3dsprites[sprite].Priority = 1024;
 	pa_3dsprites[sprite].alpha = 31; // Solid
 	pa_3dsprites[sprite].polyID = 0; // 0 polyID by default
+	pa_3dsprites[sprite].U = 0; pa_3dsprites[sprite].V = 0;
+	pa_3dsprites[sprite].Atlas = NULL;
+	pa_3dsprites[sprite].Importance = 128;
 	
 	int i;
 	for(i = 0; i < 4; i++){
@@ -366,6 +484,7 @@ void PA_Reset3DSprites(){
 	pa_freetextures = 1024;
 	n3Dspriteanims = 0;
 	pa_3Dbanks = 1;
+	PA_3DResetParticles(); // Their textures are gone
 }
 
 void PA_Reset3DSprites2Banks(){
@@ -379,7 +498,8 @@ void PA_Reset3DSprites2Banks(){
 	for(i = 0; i < 1024; i ++) freetexslots[i] = 1023 - i; // free slots...
 	pa_freetextures = 1024;
 	n3Dspriteanims = 0;
-	pa_3Dbanks = 2; 
+	pa_3Dbanks = 2;
+	PA_3DResetParticles(); // Their textures are gone
 }
 
 void PA_3DUpdateGfx(u16 texture, void* image){
@@ -397,16 +517,19 @@ void PA_3DUpdateGfx(u16 texture, void* image){
 			break;
 	}
 
-	DC_FlushRange(image, mem_size);
-
-	vramSetBankA(VRAM_A_LCD);
-	if(pa_3Dbanks == 2) vramSetBankB(VRAM_B_LCD);
-	dmaCopy(image, (void*) &VRAM_A[(textures[texture] & 0xFFFF) << 2], mem_size);
-	if(pa_3Dbanks == 2) vramSetBankB(VRAM_B_TEXTURE);
-	vramSetBankA(VRAM_A_TEXTURE);
+	PA_UploadCopy(image, (void*) &VRAM_A[(textures[texture] & 0xFFFF) << 2], mem_size, PA_UPLOAD_TEXTURE);
 }
 
 void PA_3DSetSpriteFrame(u16 sprite, u16 frame){
+	if(pa_3dsprites[sprite].Atlas){ // All the frames are in VRAM already, just show another one
+		PA_3DAtlasFrame *f;
+		PA_Assert(pa_3dsprites[sprite].AtlasFrame + frame < pa_3dsprites[sprite].Atlas->NFrames, "Frame not in the atlas");
+		f = &pa_3dsprites[sprite].Atlas->Frames[pa_3dsprites[sprite].AtlasFrame + frame];
+		pa_3dsprites[sprite].U = f->X;
+		pa_3dsprites[sprite].V = f->Y;
+		return;
+	}
+
 	u16 texture = pa_3dsprites[sprite].textureID;
 	s16 mem_size = pa_3dsprites[sprite].ImgWidth * pa_3dsprites[sprite].ImgHeight;
 	u8 type = ((textures[texture]>>26)&7);
@@ -421,6 +544,7 @@ void PA_3DSetSpriteFrame(u16 sprite, u16 frame){
 			mem_size = mem_size >> 1;
 			break;
 	}
+	if(texturesptr[texture] == NULL) return; // No frames to copy from
 	PA_3DUpdateGfx(texture, texturesptr[texture] + mem_size*frame);
 }
 
@@ -520,3 +644,284 @@ void PA_3DCapture(){
 		PA_SetRegCapture(true, 0, 31, 3, 0, 3, 0, 0);
 	}
 }
+
+// Dual screen 3D without blinking : the main screen shows either the 3D or,
+// while the sub scene is drawn, the capture of its last frame kept in bank B.
+// The sub scene is captured in the bank the sub screen doesn't show, C as a
+// background or D as bitmap sprites, and the banks only change once it's there.
+
+#define PA_DISPLAY_MODE_MASK (0xF << 16)
+#define PA_DISPLAY_GRAPHICS  (1 << 16)
+#define PA_DISPLAY_VRAM_B    ((2 << 16) | (1 << 18))
+
+// Capture 256x192 of the graphics (or of the 3D only) to a VRAM bank, during the next frame
+static inline void PA_3DDualCaptureTo(u8 bank, u8 only3D){
+	REG_DISPCAPCNT = (1 << 31) | (only3D << 24) | (3 << 20) | (bank << 16);
+}
+
+static void PA_3DDualBanks(void){
+	if(pa_3DDualShown){
+		vramSetBankC(VRAM_C_LCD);
+		vramSetBankD(VRAM_D_SUB_SPRITE);
+	}else{
+		vramSetBankD(VRAM_D_LCD);
+		vramSetBankC(VRAM_C_SUB_BG);
+	}
+}
+
+static void PA_3DDualVBL(void){
+	u8 sent = 0;
+
+	// The sub scene captured during the frame that ended goes on its screen
+	if(pa_3DDualCapturing){
+		pa_3DDualCapturing = 0;
+		pa_3DDualShown = !pa_3DDualShown;
+		PA_3DDualBanks();
+		PA_3DDualInfos.Latency[PA_3DDUAL_SUB] = PA_VBLCount - pa_3DDualCaptured + 1;
+	}
+
+	// The scene sent during that frame is drawn from now on, if none the last one is drawn again
+	if(pa_3DDualPending != PA_3DDUAL_NONE){
+		pa_3DDualDrawn = pa_3DDualPending;
+		pa_3DDualPending = PA_3DDUAL_NONE;
+		sent = 1;
+	}
+
+	if(pa_3DDualDrawn == PA_3DDUAL_SUB){
+		REG_DISPCNT = (REG_DISPCNT & ~PA_DISPLAY_MODE_MASK) | PA_DISPLAY_VRAM_B;
+
+		if(sent){ // Nothing to capture if it didn't change
+			PA_3DDualCaptureTo(pa_3DDualShown ? 2 : 3, 1);
+			pa_3DDualCapturing = 1;
+			pa_3DDualCaptured = pa_3DDualSent[PA_3DDUAL_SUB];
+		}
+	}else if(pa_3DDualDrawn == PA_3DDUAL_MAIN){
+		REG_DISPCNT = (REG_DISPCNT & ~PA_DISPLAY_MODE_MASK) | PA_DISPLAY_GRAPHICS;
+		PA_3DDualCaptureTo(1, 0); // Kept for the frames drawing the sub scene
+
+		if(sent) PA_3DDualInfos.Latency[PA_3DDUAL_MAIN] = PA_VBLCount - pa_3DDualSent[PA_3DDUAL_MAIN] + 1;
+	}
+}
+
+void PA_Init3DDualEx(u8 ratio){
+	int x, y;
+
+	PA_Assert(ratio != 1, "The sub scene needs at least 1 frame out of 2");
+
+	PA_Init3D();
+	PA_Reset3DSprites();
+
+	// Sub screen : the capture as a 16 bit background or as bitmap sprites
+	videoSetModeSub(MODE_5_2D | DISPLAY_BG2_ACTIVE | DISPLAY_SPR_ACTIVE | DISPLAY_SPR_2D_BMP_256);
+
+	REG_BG2CNT_SUB = BG_BMP16_256x256;
+	REG_BG2PA_SUB = 256;
+	REG_BG2PB_SUB = 0;
+	REG_BG2PC_SUB = 0;
+	REG_BG2PD_SUB = 256;
+	REG_BG2X_SUB = 0;
+	REG_BG2Y_SUB = 0;
+
+	// Nothing shown until the first capture
+	vramSetBankB(VRAM_B_LCD);
+	vramSetBankC(VRAM_C_LCD);
+	vramSetBankD(VRAM_D_LCD);
+	dmaFillWords(0, VRAM_B, 256 * 192 * 2);
+	dmaFillWords(0, VRAM_C, 256 * 192 * 2);
+	dmaFillWords(0, VRAM_D, 256 * 192 * 2);
+
+	PA_ResetSpriteSysScreen(1);
+
+	for (y = 0; y < 3; y ++)for (x = 0; x < 4; x ++){
+			PA_Create16bitSpriteFromGfx(1, x + y*4, x*8 + y*256, OBJ_SIZE_64X64, x*64, y*64);
+	}
+	PA_UpdateOAM1();
+
+	memset(&PA_3DDualInfos, 0, sizeof(PA_3DDualInfos));
+	pa_3DDualRatio = ratio;
+	pa_3DDualRefresh = 1; // Something to show on the sub screen at the start
+	pa_3DDualCount = 0;
+	pa_3DDualPending = PA_3DDUAL_NONE;
+	pa_3DDualDrawn = PA_3DDUAL_NONE;
+	pa_3DDualShown = 0;
+	pa_3DDualCapturing = 0;
+	PA_3DDualBanks();
+
+	pa_3Ddual = 2;
+	Dual3DVBL = PA_3DDualVBL;
+}
+
+void PA_3DDualSetRatio(u8 ratio){
+	PA_Assert(ratio != 1, "The sub scene needs at least 1 frame out of 2");
+	pa_3DDualRatio = ratio;
+}
+
+u8 PA_3DDualScene(void){
+	if(pa_3DDualRefresh) return PA_3DDUAL_SUB;
+	if(pa_3DDualRatio && ((pa_3DDualCount % pa_3DDualRatio) == pa_3DDualRatio - 1)) return PA_3DDUAL_SUB;
+
+	return PA_3DDUAL_MAIN;
+}
+
+void PA_3DDualFlush(void){
+	u8 scene = PA_3DDualScene();
+	u16 ime;
+
+	PA_3DDualInfos.Polygons[scene] = GFX_POLYGON_RAM_USAGE;
+	PA_3DDualInfos.Vertices[scene] = GFX_VERTEX_RAM_USAGE;
+	PA_3DDualInfos.Frames[scene] ++;
+
+	if(scene == PA_3DDUAL_SUB) pa_3DDualRefresh = 0;
+	pa_3DDualCount ++;
+
+	ime = REG_IME;
+	REG_IME = 0; // The VBL must see the scene and the flush together
+	pa_3DDualSent[scene] = PA_VBLCount;
+	pa_3DDualPending = scene;
+	GFX_FLUSH = 0;
+	REG_IME = ime;
+}
+
+void PA_3DDualRefreshSub(void){
+	pa_3DDualRefresh = 1;
+}
+
+// Bits per pixel of a texture type
+static u8 PA_3DTexBits(u8 type){
+	switch(type){
+		case TEX_16BITS: return 16;
+		case TEX_4COL: return 2;
+		case TEX_16COL: return 4;
+		default: return 8;
+	}
+}
+
+PA_3DAtlas* PA_3DAtlasCreate(u16 width, u16 height, u8 type){
+	PA_3DAtlas *atlas = (PA_3DAtlas*)malloc(sizeof(PA_3DAtlas));
+
+	if(atlas == NULL) return NULL;
+
+	atlas->Width = width;
+	atlas->Height = height;
+	atlas->Type = type;
+	atlas->Texture = -1;
+	atlas->ShelfX = atlas->ShelfY = atlas->ShelfHeight = 0;
+	atlas->NFrames = 0;
+	atlas->MaxFrames = 16;
+	atlas->Frames = (PA_3DAtlasFrame*)malloc(atlas->MaxFrames * sizeof(PA_3DAtlasFrame));
+	atlas->Data = (u8*)calloc((width * height * PA_3DTexBits(type)) >> 3, 1); // Color 0 is transparent
+
+	if((atlas->Frames == NULL) || (atlas->Data == NULL)){
+		PA_3DAtlasDelete(atlas);
+		return NULL;
+	}
+
+	return atlas;
+}
+
+s32 PA_3DAtlasAdd(PA_3DAtlas *atlas, void *image, u16 width, u16 height, u16 nframes){
+	u8 bits = PA_3DTexBits(atlas->Type);
+	u32 rowsize = (width * bits) >> 3;
+	u32 stride = (atlas->Width * bits) >> 3;
+	u8 *src = (u8*)image;
+	s32 first = atlas->NFrames;
+	u16 i, y;
+
+	PA_Assert(atlas->Data != NULL, "Atlas already loaded");
+	PA_Assert((width & 3) == 0, "Atlas images must be a multiple of 4 wide");
+
+	if(atlas->NFrames + nframes > atlas->MaxFrames){
+		u16 max = atlas->MaxFrames;
+		PA_3DAtlasFrame *frames;
+
+		while(atlas->NFrames + nframes > max) max <<= 1;
+		frames = (PA_3DAtlasFrame*)realloc(atlas->Frames, max * sizeof(PA_3DAtlasFrame));
+		if(frames == NULL) return -1;
+
+		atlas->Frames = frames;
+		atlas->MaxFrames = max;
+	}
+
+	// Find a place for each frame first, so nothing is added if they don't all fit
+	u16 shelfx = atlas->ShelfX, shelfy = atlas->ShelfY, shelfheight = atlas->ShelfHeight;
+
+	for(i = 0; i < nframes; i ++){
+		if(shelfx + width > atlas->Width){ // Next row
+			shelfy += shelfheight;
+			shelfx = 0;
+			shelfheight = 0;
+		}
+
+		if((width > atlas->Width) || (shelfy + height > atlas->Height)) return -1;
+
+		atlas->Frames[first + i].X = shelfx;
+		atlas->Frames[first + i].Y = shelfy;
+		atlas->Frames[first + i].Width = width;
+		atlas->Frames[first + i].Height = height;
+
+		shelfx += width;
+		if(height > shelfheight) shelfheight = height;
+	}
+
+	for(i = 0; i < nframes; i ++){
+		u8 *dest = atlas->Data + atlas->Frames[first + i].Y * stride + ((atlas->Frames[first + i].X * bits) >> 3);
+
+		for(y = 0; y < height; y ++){
+			memcpy(dest, src, rowsize);
+			dest += stride;
+			src += rowsize;
+		}
+	}
+
+	atlas->ShelfX = shelfx;
+	atlas->ShelfY = shelfy;
+	atlas->ShelfHeight = shelfheight;
+	atlas->NFrames += nframes;
+
+	return first;
+}
+
+s16 PA_3DAtlasLoad(PA_3DAtlas *atlas){
+	if(atlas->Data == NULL) return atlas->Texture; // Already loaded
+
+	atlas->Texture = PA_3DCreateTex(atlas->Data, atlas->Width, atlas->Height, atlas->Type);
+	if(PA_UploadOn) PA_UploadFlush(); // Copied now, not at the VBL
+
+	// Frames are never copied again, the RAM copy isn't needed anymore
+	free(atlas->Data);
+	atlas->Data = NULL;
+	texturesptr[atlas->Texture] = NULL;
+
+	return atlas->Texture;
+}
+
+void PA_3DAtlasDelete(PA_3DAtlas *atlas){
+	int i;
+
+	if(atlas == NULL) return;
+
+	for(i = 0; i < PA_NMAXSPRITES; i ++) // Sprites still using it keep their current frame
+		if(pa_3dsprites[i].Alive && (pa_3dsprites[i].Atlas == atlas)){
+			PA_3DStopSpriteAnim(i);
+			pa_3dsprites[i].Atlas = NULL;
+		}
+
+	if(atlas->Texture >= 0){ // Sprites still using the texture keep it
+		obj_per_gfx3D[atlas->Texture] --;
+		if(obj_per_gfx3D[atlas->Texture] == 0) PA_3DDeleteTex(atlas->Texture);
+	}
+
+	free(atlas->Data);
+	free(atlas->Frames);
+	free(atlas);
+}
+
+void PA_3DCreateSpriteFromAtlas(u16 sprite, PA_3DAtlas *atlas, u16 frame, u8 palette, s16 x, s16 y){
+	PA_Assert(atlas->Texture >= 0, "Atlas not loaded");
+	PA_Assert(frame < atlas->NFrames, "Frame not in the atlas");
+
+	PA_3DCreateSpriteFromTex(sprite, atlas->Texture, atlas->Frames[frame].Width, atlas->Frames[frame].Height, palette, x, y);
+	pa_3dsprites[sprite].Atlas = atlas;
+	pa_3dsprites[sprite].AtlasFrame = frame;
+	PA_3DSetSpriteFrame(sprite, 0);
+}
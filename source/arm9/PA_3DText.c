@@ -0,0 +1,188 @@
+#include <PA9.h>
+
+//////////////////////////////////////////////////////////////////////
+// Bitmap fonts as 4 color textures, 16 letters per line of the texture,
+// and strings queued until PA_3DProcess draws them font by font
+//////////////////////////////////////////////////////////////////////
+
+typedef struct{
+	s16 X, Y;
+	u16 Color, Priority;
+	u16 Start, Length; // In pa_3DTextBuffer
+	u8 Size;
+}PA_3DTextString;
+
+static s16 pa_3DFontTex[10] = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+static u8 pa_3DFontPal[10];
+static u8 pa_3DFontCell[10]; // Height of a letter in the texture, 8 or 16
+
+static char pa_3DTextBuffer[PA_3DTEXT_LETTERS];
+static PA_3DTextString pa_3DTextStrings[PA_3DTEXT_STRINGS];
+static u16 pa_3DTextNStrings;
+static u16 pa_3DTextPrio = PA_3DTEXT_PRIO;
+u16 pa_3DTextLetters;
+
+s16 PA_3DLoadFont(u8 size, u8 palette){
+	u8 cell = (pa_bittextpoliceheight[size] > 8) ? 16 : 8;
+	u16 letter, x, y;
+	s16 tex;
+	u8 *data;
+
+	PA_Assert(size < 10, "Wrong font slot");
+
+	if(pa_3DFontTex[size] >= 0) return pa_3DFontTex[size];
+
+	data = (u8*)calloc(256 * 16 * cell / 4, 1);
+	if(data == NULL) return -1;
+
+	// 4 pixels per byte, 2 bits each, the leftmost in the low bits. Color 1 is the letter.
+	for(letter = 33; letter < 256; letter++){
+		const u16 *rows = PA_GetGlyph(0, size, letter);
+		u8 *dst = data + (((letter >> 4) * cell) << 6) + ((letter & 15) << 2);
+
+		for(y = 0; y < cell; y++, dst += 64)
+			for(x = 0; x < 16; x++)
+				if(rows[y] & (1 << x)) dst[x >> 2] |= 1 << ((x & 3) << 1);
+	}
+
+	// Color 0 is transparent, color 1 is white and takes the color of each string
+	vramSetBankF(VRAM_F_LCD);
+	VRAM_F[palette << 8] = 0;
+	VRAM_F[(palette << 8) + 1] = PA_RGB(31, 31, 31);
+	vramSetBankF(VRAM_F_TEX_PALETTE);
+
+	tex = PA_3DCreateTex(data, 256, 16 * cell, TEX_4COL);
+	if(PA_UploadOn) PA_UploadFlush(); // Copied now, not at the VBL
+
+	free(data);
+	texturesptr[tex] = NULL;
+
+	pa_3DFontTex[size] = tex;
+	pa_3DFontPal[size] = palette;
+	pa_3DFontCell[size] = cell;
+
+	return tex;
+}
+
+void PA_3DUnloadFont(u8 size){
+	if(pa_3DFontTex[size] < 0) return;
+
+	PA_3DDeleteTex(pa_3DFontTex[size]);
+	pa_3DFontTex[size] = -1;
+}
+
+void PA_3DSetTextPrio(u16 priority){
+	pa_3DTextPrio = priority;
+}
+
+u8 PA_3DText(u8 size, s16 x, s16 y, u16 color, const char *text, ...){
+	u16 left = PA_3DTEXT_LETTERS - pa_3DTextLetters;
+	PA_3DTextString *str;
+	va_list args;
+
+	PA_Assert(pa_3DFontTex[size] >= 0, "Font not loaded with PA_3DLoadFont");
+
+	if((pa_3DTextNStrings == PA_3DTEXT_STRINGS) || (left < 2)) return 0;
+
+	str = pa_3DTextStrings + pa_3DTextNStrings;
+	str->X = x;
+	str->Y = y;
+	str->Color = color & 0x7FFF;
+	str->Priority = pa_3DTextPrio;
+	str->Start = pa_3DTextLetters;
+	str->Size = size;
+
+	va_start(args, text);
+	str->Length = PA_VFormat(pa_3DTextBuffer + pa_3DTextLetters, left, text, args);
+	va_end(args);
+
+	pa_3DTextLetters += str->Length;
+	pa_3DTextNStrings++;
+
+	return 1;
+}
+
+s16 PA_3DTextWidth(u8 size, const char *text){
+	s16 x = 0, width = 0;
+
+	for(; *text; text++){
+		if(*text == '\n'){
+			x = 0;
+			continue;
+		}
+		x += pa_bittextdefaultsize[size][(u8)*text] + textinfo.letterspacing;
+		if(x - textinfo.letterspacing > width) width = x - textinfo.letterspacing;
+	}
+
+	return width;
+}
+
+static inline void PA_3DTextVertex(s16 x, s16 y, u16 z){
+	GFX_VERTEX16 = (((u32)(u16)(192 - y)) << 16) | (u16)x;
+	GFX_VERTEX16 = z;
+}
+
+// One quad per letter, in the quad list already started for the font
+static void PA_3DDrawString(const PA_3DTextString *str, s16 ydecal){
+	const char *text = pa_3DTextBuffer + str->Start;
+	u8 height = pa_bittextpoliceheight[str->Size], cell = pa_3DFontCell[str->Size];
+	s16 x = str->X, y = str->Y + ydecal;
+	u16 i;
+
+	GFX_COLOR = str->Color;
+
+	for(i = 0; i < str->Length; i++){
+		u8 letter = text[i];
+		u8 width = pa_bittextdefaultsize[str->Size][letter];
+
+		if(letter == '\n'){
+			x = str->X;
+			y += height + textinfo.linespacing;
+			continue;
+		}
+
+		if((letter > 32) && (x + width > 0) && (x < 256) && (y + height > 0) && (y < 192)){
+			s32 u = (letter & 15) << 4, v = (letter >> 4) * cell;
+
+			GFX_TEX_COORD = TEXTURE_PACK(inttot16(u), inttot16(v + height));
+			PA_3DTextVertex(x, y + height, str->Priority);
+			GFX_TEX_COORD = TEXTURE_PACK(inttot16(u + width), inttot16(v + height));
+			PA_3DTextVertex(x + width, y + height, str->Priority);
+			GFX_TEX_COORD = TEXTURE_PACK(inttot16(u + width), inttot16(v));
+			PA_3DTextVertex(x + width, y, str->Priority);
+			GFX_TEX_COORD = TEXTURE_PACK(inttot16(u), inttot16(v));
+			PA_3DTextVertex(x, y, str->Priority);
+		}
+
+		x += width + textinfo.letterspacing;
+	}
+}
+
+void PA_3DDrawText(s16 ydecal){
+	u16 i;
+	u8 size;
+
+	for(size = 0; size < 10; size++){
+		u8 started = 0;
+
+		if(pa_3DFontTex[size] < 0) continue;
+
+		for(i = 0; i < pa_3DTextNStrings; i++){
+			if(pa_3DTextStrings[i].Size != size) continue;
+
+			if(!started){ // The texture and the polygon format, once for all the strings of the font
+				GFX_TEX_FORMAT = textures[pa_3DFontTex[size]];
+				GFX_PAL_FORMAT = pa_3DFontPal[size] << 6; // 4 color palettes are counted in 8 bytes
+				GFX_POLY_FORMAT = (1<<6) | (1<<7) | (31 << 16);
+				GFX_BEGIN = GL_QUAD;
+				started = 1;
+			}
+
+			PA_3DDrawString(pa_3DTextStrings + i, ydecal);
+		}
+	}
+
+	// Queued again for each frame
+	pa_3DTextNStrings = 0;
+	pa_3DTextLetters = 0;
+}
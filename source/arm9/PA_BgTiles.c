@@ -105,8 +105,7 @@ void PA_LoadBgTilesEx(u8 screen, u8 bg_select, void* bg_tiles, u32 size) {
 
 	PA_BgInfo[screen][bg_select].TileSetChar = charset; // On place les tiles à un endroit précis...
 	PA_BgInfo[screen][bg_select].tilesetsize = size;    // On mémorise aussi la taille que ca fait pour pouvoir effacer plus tard...
-	DC_FlushRange((void*)CharBaseBlock(screen, charset), size * 2);
-	dmaCopy(bg_tiles, (void*)CharBaseBlock(screen, charset), size * 2);
+	PA_UploadCopy(bg_tiles, (void*)CharBaseBlock(screen, charset), size * 2, PA_UPLOAD_DIRECT); // NULL clears the tiles
 	// Save tiles pointer and position in VRAM
 	PA_BgInfo[screen][bg_select].Tiles = bg_tiles;
 	PA_BgInfo[screen][bg_select].TilePos = (u32*)CharBaseBlock(screen, PA_BgInfo[screen][bg_select].TileSetChar); // used for tile swapping
@@ -27,8 +27,8 @@ void PA_iDeaS_DebugPrintf(const char* str, ...){
 
 	va_list args;
 
-	va_start(args, 0);
-	vsnprintf(_PA_DebugText, sizeof(_PA_DebugText), str, args);
+	va_start(args, str);
+	PA_VFormat(_PA_DebugText, sizeof(_PA_DebugText), str, args);
 	va_end(args);
 
 	_PA_iDeaS_OutputText(_PA_DebugText);
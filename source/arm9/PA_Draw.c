@@ -27,12 +27,18 @@ void PA_LoadBmpToBuffer(u16 *Buffer, s16 x, s16 y, void *bmp, s16 SWidth) {
 //	u16 *gfx2 = (u16*)(temp+54); // Pour le mode 16 bit...
 	s32 r, g, b;  s16 tempx, tempy;
 	s16 lx = Bmpinfo->Width;   s16 ly = Bmpinfo->Height;
+	s16 first = ly - 1, step = -1, row; // Lines stored from the bottom...
+	if (ly < 0) { // ...or from the top when the height is negative
+		ly = -ly;
+		first = 0;
+		step = 1;
+	}
 	u16 Bits = Bmpinfo->BitsperPixel;
 	//Buffer = (u16*)(Buffer + ((x + (y*SWidth)) << 1)); // Position de départ
 	s32 i = 0;
 
 	if (Bits > 16) { // Pour 24 et 32 bits
-		for (tempy = ly - 1; tempy > -1; tempy--) {
+		for (row = 0, tempy = first; row < ly; row++, tempy += step) {
 			for (tempx = 0; tempx < lx; tempx++) {
 				b = (gfx[i] >> 3) & 31;	i++;
 				g = (gfx[i] >> 3) & 31;	i++;
@@ -47,7 +53,7 @@ void PA_LoadBmpToBuffer(u16 *Buffer, s16 x, s16 y, void *bmp, s16 SWidth) {
 			while (i&3) i++; // Padding....
 		}
 	} else if (Bits == 16) {
-		for (tempy = ly - 1; tempy > -1; tempy--) {
+		for (row = 0, tempy = first; row < ly; row++, tempy += step) {
 			for (tempx = 0; tempx < lx; tempx++) {
 				b = *gfx2 & 31;
 				g = (*gfx2 >> 5) & 31;
@@ -86,7 +92,7 @@ void PA_LoadBmpToBuffer(u16 *Buffer, s16 x, s16 y, void *bmp, s16 SWidth) {
 
 		i = 0;
 
-		for (tempy = ly - 1; tempy > -1; tempy--) {
+		for (row = 0, tempy = first; row < ly; row++, tempy += step) {
 			for (tempx = 0; tempx < lx; tempx++) {
 				Buffer[x + tempx + ((y + tempy) * SWidth)] =  palette[gfx[i]];
 				i++;
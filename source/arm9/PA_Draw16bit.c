@@ -34,6 +34,7 @@ void PA_Init16bitDblBuffer(u8 screen, u8 bg_priority) {
 	PA_DrawBg[screen] = (u16*)(0x06000000 + (0x200000 *  screen) + 192 * 512);
 	PA_DrawBg32[screen] = (u32*)PA_DrawBg[screen];
 	pa16bitbuffer[screen] = 0; // First buffer...
+	PA_EnableDirtyRects(screen, 0);
 	charsetstart[screen] = 0; // On se r�serve la moiti� de la m�moire...
 	_REG16(REG_BGCNT(screen, 3)) = bg_priority | BG_BMP16_256x256 | BG_BMP_BASE(0);
 	PA_SetDrawSize(screen, 1);
@@ -50,4 +51,7 @@ void PA_16bitSwapBuffer(u8 screen) {
 	PA_DrawBg32[screen] = (u32*)PA_DrawBg[screen];
 	_REG16(REG_BGCNT(screen, 3)) &= ~(BG_BMP_BASE(7));
 	_REG16(REG_BGCNT(screen, 3)) |= BG_BMP_BASE(pa16bitbuffer[screen] * 6);
+
+	if (PA_DirtyRects[screen].On) // Bring the new back buffer up to date
+		PA_CopyDirtyRects(screen, (void*)(0x06000000 + (0x200000 *  screen) + pa16bitbuffer[screen] * 192 * 512));
 }
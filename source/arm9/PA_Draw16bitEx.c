@@ -24,6 +24,7 @@ void PA_Draw16bitLine(u8 screen, u16 x1, u16 y1, u16 x2, u16 y2, u16 color) {
 	y = dxabs >> 1;
 	px = x1;
 	py = y1;
+	PA_AddDirtyRect(screen, (sdx > 0) ? x1 : x2, (sdy > 0) ? y1 : y2, ((sdx > 0) ? x2 : x1) + 1, ((sdy > 0) ? y2 : y1) + 1);
 	PA_Put16bitPixel(screen, px, py, color);
 
 	if (dxabs >= dyabs) {
@@ -59,6 +60,7 @@ void PA_16bitDraw(u8 screen, u16 color) {
 		s16 low = (PA_drawsize[screen] >> 1) - PA_drawsize[screen] + 1;
 		s16 high = (PA_drawsize[screen] >> 1) + 1;
 		s16 i = 0, j = 0;
+		PA_AddDirtyRect(screen, Stylus.X + low, Stylus.Y + low, Stylus.X + high, Stylus.Y + high);
 
 		for (i = low; i < high; i++)
 			for (j = low; j < high; j++)
@@ -80,6 +82,7 @@ void PA_Draw16bitLineEx(u8 screen, s16 basex, s16 basey, s16 endx, s16 endy, u16
 	s8 high = (size >> 1) + 1;
 	s16 i, j;
 	s16 x1, x2, y1, y2;
+	PA_AddDirtyRect(screen, basex + low, basey + low, basex + high, basey + high);
 
 	for (i = low; i < high; i++) {
 		for (j = low; j < high; j++) {
@@ -183,6 +186,8 @@ void PA_Draw16bitRect(u8 screen, s16 basex, s16 basey, s16 endx, s16 endy, u16 c
 
 		if (endy > 191) endy = 191;
 
+		PA_AddDirtyRect(screen, basex, basey, endx, endy);
+
 		//u16 *start = (u16*)PA_DrawBg[screen] + basex;
 		//tempvar = color;
 		for (j = basey; j < endy; j++) {
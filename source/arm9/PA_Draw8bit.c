@@ -46,6 +46,9 @@ void PA_8bitSwapBuffer(u8 screen) {
 	PA_DrawBg32[screen] = (u32*)PA_DrawBg[screen];
 	_REG16(REG_BGCNT(screen, 3)) &= ~(BG_BMP_BASE(7));
 	_REG16(REG_BGCNT(screen, 3)) |= BG_BMP_BASE(2 + pa8bitbuffer[screen] * 3);
+
+	if (PA_DirtyRects[screen].On) // Bring the new back buffer up to date
+		PA_CopyDirtyRects(screen, (void*)(0x06000000 + (0x200000 *  screen) + (128 + pa8bitbuffer[screen] * 192) * 256));
 }
 
 void PA_Init8bitDblBuffer(u8 screen, u8 bg_priority) {
@@ -54,6 +57,7 @@ void PA_Init8bitDblBuffer(u8 screen, u8 bg_priority) {
 	PA_DrawBg[screen] = (u16*)(0x06000000 + (0x200000 *  screen) + 320 * 256);
 	PA_DrawBg32[screen] = (u32*)PA_DrawBg[screen];
 	pa8bitbuffer[screen] = 0; // First buffer...
+	PA_EnableDirtyRects(screen, 0);
 	charsetstart[screen] = 2; // On se réserve la moitié de la mémoire...
 
 	int i; for (i = 8; i < 64; i++)	charblocks[screen][i] = 1; // Block la mémoire
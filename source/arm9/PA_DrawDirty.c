@@ -0,0 +1,149 @@
+#include <PA9.h>
+
+//////////////////////////////////////////////////////////////////////
+// Dirty rectangles for double buffered bitmap backgrounds
+//////////////////////////////////////////////////////////////////////
+
+PA_DirtyRectInfo PA_DirtyRects[2];
+
+void PA_EnableDirtyRects(u8 screen, u8 on) {
+	PA_DirtyRects[screen].On = on;
+	PA_DirtyRects[screen].Full = on ? 1 : 0; // The buffers may differ anywhere yet, the next swap copies all
+	PA_DirtyRects[screen].NRects = 0;
+	memset(PA_DirtyRects[screen].Rows, 0, sizeof(PA_DirtyRects[screen].Rows));
+}
+
+static inline s32 PA_DirtyArea(s16 x1, s16 y1, s16 x2, s16 y2) {
+	return (x2 - x1) * (y2 - y1);
+}
+
+// Grow a rectangle so that it also covers the given one
+static inline void PA_DirtyMerge(PA_DirtyRect *rect, s16 x1, s16 y1, s16 x2, s16 y2) {
+	if (x1 < rect->x1) rect->x1 = x1;
+	if (y1 < rect->y1) rect->y1 = y1;
+	if (x2 > rect->x2) rect->x2 = x2;
+	if (y2 > rect->y2) rect->y2 = y2;
+}
+
+void PA_AddDirtyRectEx(u8 screen, s16 x1, s16 y1, s16 x2, s16 y2) {
+	PA_DirtyRectInfo *dirty = &PA_DirtyRects[screen];
+	s32 i, best = 0, bestcost = 0x7FFFFFFF;
+
+	if (dirty->Full) return; // Everything will be copied anyway
+
+	// Put the corners in the right order and clip to the screen
+	if (x2 < x1) { s16 temp = x1; x1 = x2; x2 = temp; }
+	if (y2 < y1) { s16 temp = y1; y1 = y2; y2 = temp; }
+
+	if (x1 < 0) x1 = 0;
+	if (y1 < 0) y1 = 0;
+	if (x2 > 256) x2 = 256;
+	if (y2 > 192) y2 = 192;
+
+	if ((x1 >= x2) || (y1 >= y2)) return;
+
+	for (i = 0; i < dirty->NRects; i++) {
+		PA_DirtyRect *rect = &dirty->Rect[i];
+		s16 ux1 = (x1 < rect->x1) ? x1 : rect->x1;
+		s16 uy1 = (y1 < rect->y1) ? y1 : rect->y1;
+		s16 ux2 = (x2 > rect->x2) ? x2 : rect->x2;
+		s16 uy2 = (y2 > rect->y2) ? y2 : rect->y2;
+
+		// Extra pixels that would be copied if both rectangles were merged
+		s32 cost = PA_DirtyArea(ux1, uy1, ux2, uy2) - PA_DirtyArea(rect->x1, rect->y1, rect->x2, rect->y2)
+		           - PA_DirtyArea(x1, y1, x2, y2);
+
+		if (cost <= 0) { // Already covered, or merging doesn't waste anything
+			PA_DirtyMerge(rect, x1, y1, x2, y2);
+			return;
+		}
+
+		if (cost < bestcost) {
+			bestcost = cost;
+			best = i;
+		}
+	}
+
+	// Lines and letters are usually drawn next to each other, so merge them
+	// unless that copies a lot of extra pixels
+	if ((dirty->NRects < PA_MAX_DIRTY_RECTS) && (bestcost > 256)) {
+		PA_DirtyRect *rect = &dirty->Rect[dirty->NRects++];
+		rect->x1 = x1; rect->y1 = y1; rect->x2 = x2; rect->y2 = y2;
+	} else {
+		PA_DirtyMerge(&dirty->Rect[best], x1, y1, x2, y2);
+	}
+}
+
+void PA_CopyDirtyRects(u8 screen, const void *front) {
+	PA_DirtyRectInfo *dirty = &PA_DirtyRects[screen];
+	const u8 *src = (const u8*)front;
+	u8 *dst = (u8*)PA_DrawBg[screen];
+	u8 shift = PA_nBit[screen]; // 0 for 8 bit, 1 for 16 bit
+	u32 pitch = 256 << shift;
+	s32 i, y;
+
+	if (dirty->Full) {
+		dmaCopyWords(3, src, dst, pitch * 192);
+	} else {
+		// Lines marked by the pixel functions, one copy for each run of lines
+		for (y = 0; y < 192; y++) {
+			s32 y2 = y;
+
+			while ((y2 < 192) && (dirty->Rows[y2 >> 5] & (1u << (y2 & 31)))) y2++;
+			if (y2 > y) dmaCopyWords(3, src + y * pitch, dst + y * pitch, (y2 - y) * pitch);
+			y = y2;
+		}
+
+		for (i = 0; i < dirty->NRects; i++) {
+			PA_DirtyRect *rect = &dirty->Rect[i];
+			// VRAM can't be written by bytes, copy whole words
+			u32 start = (rect->x1 << shift) & ~3;
+			u32 end = ((rect->x2 << shift) + 3) & ~3;
+			u32 offset = rect->y1 * pitch;
+
+			if ((start == 0) && (end == pitch)) { // Full lines, only one copy
+				dmaCopyWords(3, src + offset, dst + offset, (rect->y2 - rect->y1) * pitch);
+			} else {
+				for (y = rect->y1; y < rect->y2; y++) {
+					dmaCopyWords(3, src + offset + start, dst + offset + start, end - start);
+					offset += pitch;
+				}
+			}
+		}
+	}
+
+	dirty->Full = 0;
+	dirty->NRects = 0;
+	memset(dirty->Rows, 0, sizeof(dirty->Rows));
+}
+
+void PA_AddDirtyLetterPos(u8 screen, s32 limit, u8 transp) {
+	s32 i;
+	s16 x1 = 256, y1 = 192, x2 = 0, y2 = 0;
+
+	if (!PA_DirtyRects[screen].On) return;
+
+	if (transp == 2) return; // Nothing was drawn
+
+	if (transp > 2) { // Rotated text, don't bother
+		PA_SetDirtyFull(screen);
+		return;
+	}
+
+	for (i = 0; i < limit; i++) {
+		u8 size = PA_LetterPos.Letter[i].Size;
+		s16 x = PA_LetterPos.Letter[i].X;
+		s16 y = PA_LetterPos.Letter[i].Y;
+
+		if (x < x1) x1 = x;
+		if (y < y1) y1 = y;
+
+		x += pa_bittextdefaultsize[size][(u8)PA_LetterPos.Letter[i].Letter];
+		y += pa_bittextpoliceheight[size];
+
+		if (x > x2) x2 = x;
+		if (y > y2) y2 = y;
+	}
+
+	PA_AddDirtyRectEx(screen, x1, y1, x2, y2);
+}
@@ -4,63 +4,199 @@
 
 u16* PA_DrawFake16[2];
 bool PA_HasFake16bitBg[2];
+u32 PA_Fake16Dirty[2][6]; // One bit per line that changed
+s32 PA_Fake16Budget = 32;
+static u8 PA_Fake16LineTime = 4; // Most scanlines a line took to reduce in the VBL, to stop before the display starts
 
-// Function to get the current scanline
-static inline int PA_GetScanline(){
-	int __temp = PA_GetVcount()+1;
-	if(__temp == 192) __temp = 0; // Adjust value: if we got 192, it's 0 really
-	return __temp;
+static s8 PA_Fake16Effect[2] = {-1, -1};
+static u16 *PA_Fake16Pal[2];  // Palette of each line when the colors are reduced, NULL for 256
+static u16 PA_Fake16Colors[2];
+
+static u32 PA_Fake16Recip[257]; // 65536 / n rounded up, to average the colors without dividing
+
+// Bits kept for red, green and blue at each try, blue goes first and green last
+static const u8 PA_Fake16Bits[13][3] = {
+	{5, 5, 5}, {5, 5, 4}, {4, 5, 4}, {4, 4, 4}, {4, 4, 3}, {3, 4, 3}, {3, 3, 3},
+	{3, 3, 2}, {2, 3, 2}, {2, 2, 2}, {2, 2, 1}, {1, 2, 1}, {1, 1, 1}
+};
+
+u16 PA_Fake16bitQuantizeLine(const u16 *line, u16 width, u16 colors, u16 *palette, u8 *indexes) {
+	u16 keys[512];     // Reduced color + 1, 0 for an empty slot
+	u8 slots[512];
+	u16 r[256], g[256], b[256]; // At most 31 * 256
+	u16 count[256];
+	u16 level, n = 0, x;
+
+	PA_Assert(colors >= 8, "At least 8 colors per line");
+
+	if (PA_Fake16Recip[1] == 0)
+		for (x = 1; x <= 256; x++) PA_Fake16Recip[x] = (65536 + x - 1) / x;
+
+	if (colors > 256) colors = 256;
+
+	// Drop one more bit until the line fits
+	for (level = 0; level < 13; level++) {
+		u16 cmask = ((31 << (5 - PA_Fake16Bits[level][0])) & 31)
+			| (((31 << (5 - PA_Fake16Bits[level][1])) & 31) << 5)
+			| (((31 << (5 - PA_Fake16Bits[level][2])) & 31) << 10);
+
+		memset(keys, 0, sizeof(keys));
+		n = 0;
+
+		for (x = 0; x < width; x++) {
+			u16 c = line[x] & 0x7FFF;
+			u16 key = (c & cmask) + 1;
+			u32 h = ((key * 2654435761u) >> 23); // 9 bits
+
+			while (keys[h] && (keys[h] != key)) h = (h + 1) & 511;
+
+			if (!keys[h]) {
+				if (n == colors) break; // Too many colors, try with less bits
+				keys[h] = key;
+				slots[h] = n;
+				r[n] = g[n] = b[n] = 0;
+				count[n] = 0;
+				n++;
+			}
+
+			indexes[x] = slots[h];
+
+			if (level) {
+				u8 i = slots[h];
+				r[i] += c & 31; g[i] += (c >> 5) & 31; b[i] += c >> 10;
+				count[i]++;
+			} else {
+				palette[slots[h]] = c; // Exact colors
+			}
+		}
+
+		if (x == width) break;
+	}
+
+	if (level) { // Average of the colors of each group
+		for (x = 0; x < n; x++) {
+			u32 recip = PA_Fake16Recip[count[x]];
+			palette[x] = ((r[x] * recip) >> 16) | (((g[x] * recip) >> 16) << 5) | (((b[x] * recip) >> 16) << 10);
+		}
+	}
+
+	return n;
+}
+
+// Reduce the colors of the lines that changed, at most budget lines.
+// In the VBL, also stop when the next line could go past the vertical blank.
+static void PA_Fake16bitUpdateLines(u8 screen, s32 budget, u8 vbl) {
+	u16 colors = PA_Fake16Colors[screen];
+	u8 indexes[256];
+	s32 y, x;
+
+	if (PA_Fake16Pal[screen] == NULL) return; // The lines are the palettes
+
+	for (y = 0; (y < 192) && (budget > 0); y++) {
+		u32 *dirty = &PA_Fake16Dirty[screen][y >> 5];
+		u16 *vram;
+		u16 start = 0;
+
+		if (*dirty == 0) { y |= 31; continue; } // Nothing in these 32 lines
+		if (!(*dirty & (1u << (y & 31)))) continue;
+
+		if (vbl) {
+			start = REG_VCOUNT;
+			if ((start < 192) || (start + PA_Fake16LineTime > 262)) return; // The rest waits for the next VBL
+		}
+
+		*dirty &= ~(1u << (y & 31));
+		PA_Fake16bitQuantizeLine(PA_DrawFake16[screen] + (y << 8), 256, colors, PA_Fake16Pal[screen] + y * colors, indexes);
+		DC_FlushRange(PA_Fake16Pal[screen] + y * colors, colors << 1); // Read by DMA, also when written from the main loop
+
+		vram = PA_DrawBg[screen] + (y << 7); // 2 pixels at a time, VRAM can't be written by bytes
+		for (x = 0; x < 128; x++) vram[x] = indexes[x << 1] | (indexes[(x << 1) + 1] << 8);
+
+		if (vbl) {
+			u16 end = REG_VCOUNT;
+			u16 time = (end >= start) ? (end - start + 1) : (end + 263 - start + 1);
+			if (time > PA_Fake16LineTime) PA_Fake16LineTime = (time > 70) ? 70 : time;
+		}
+
+		budget--;
+	}
 }
 
-void fake16bit_hbl(){
-	// Fake a 16 bit background
+static void PA_Fake16bitPrepare0(void) {
+	PA_Fake16bitUpdateLines(0, PA_Fake16Budget, 1);
+}
+
+static void PA_Fake16bitPrepare1(void) {
+	PA_Fake16bitUpdateLines(1, PA_Fake16Budget, 1);
+}
 
-	// Get the scanline the hardware is about to draw
-	int vc = PA_GetScanline();
+void PA_Fake16bitUpdate(u8 screen) {
+	s32 i;
 
-	if(vc < 192){ // If scanline is a valid scanline
-		// Load palette based on the line the hardware is about to draw
-		// for screen 0
-		if(PA_HasFake16bitBg[0])
-			PA_Load8bitBgPal(0, (void*) &PA_DrawFake16[0][vc << 8]);
-		// for screen 1
-		if(PA_HasFake16bitBg[1])
-			PA_Load8bitBgPal(1, (void*) &PA_DrawFake16[1][vc << 8]);
+	for (i = 0; i < 192; i++) {
+		u16 ime = REG_IME;
+		REG_IME = 0; // The VBL updates lines too
+		PA_Fake16bitUpdateLines(screen, 1, 0);
+		REG_IME = ime;
 	}
 }
 
+void PA_Fake16bitDirty(u8 screen, s16 y1, s16 y2) {
+	s16 y;
+
+	if (y1 > y2) { y = y1; y1 = y2; y2 = y; }
+	if (y1 < 0) y1 = 0;
+	if (y2 > 191) y2 = 191;
+
+	for (y = y1; y <= y2; y++) PA_Fake16Dirty[screen][y >> 5] |= 1u << (y & 31);
+}
+
 void PA_InitFake16bitBg(u8 screen, u8 prio){
+	PA_InitFake16bitBgEx(screen, prio, 256);
+}
+
+void PA_InitFake16bitBgEx(u8 screen, u8 prio, u16 colors){
 	// Function to make a fake 16 bit background!
-	// Caution: fake 16 bit bgs and mode 7 DON'T MIX
 	bool hadbg = false;
 
+	if (colors > 256) colors = 256;
+
 	// Disable fake 16 bit backgrounds
 	if(PA_HasFake16bitBg[screen]){
 		PA_HasFake16bitBg[screen] = false;
+		PA_RasterRemove(PA_Fake16Effect[screen]);
 		free(PA_DrawFake16[screen]); // Free the memory
+		free(PA_Fake16Pal[screen]);
+		PA_Fake16Pal[screen] = NULL;
 		hadbg = true;
 	}
 	// Allocate memory for a 16 bit background
-	PA_DrawFake16[screen] = calloc(256*192, sizeof(u16));
-	if(!PA_DrawFake16[screen]){
+	PA_DrawFake16[screen] = calloc(256*(192+1), sizeof(u16)); // The raster DMA reads one line more
+	if (colors < 256) PA_Fake16Pal[screen] = calloc(colors*(192+1), sizeof(u16));
+	if(!PA_DrawFake16[screen] || ((colors < 256) && !PA_Fake16Pal[screen])){
 		// ERROR!!
 		// Just hang up
 		PA_Error("Can't allocate buffer\nfor fake 16bit background!");
 		for(;;) swiWaitForVBlank();
 	}
+	PA_Fake16Colors[screen] = colors;
 	// Initialize an 8 bit background on bg 3 at the specified screen
 	if(!hadbg) // Only initialize if that screen never had a fake 16 bit background before
 		PA_Init8bitBg(screen, prio);
-	// Make each scanline display the entire palette
+	// Make each scanline display the entire palette, or the colors of the line
 	int x, y;
 	for(y = 0; y < 192; y ++)
 		for(x = 0; x < 256; x ++)
-			PA_Put8bitPixel(screen, x, y, x);
-	// Set the horizontal blank handler
-	irqSet(IRQ_HBLANK, fake16bit_hbl);
-	irqEnable(IRQ_HBLANK);
+			PA_Put8bitPixel(screen, x, y, (colors < 256) ? 0 : x);
 	// Confirm that we have a fake 16 bit background
 	PA_ClearFake16bitBg(screen); // Make sure the background is empty
+	// Each line of the buffer is the palette of that line, written before the line is drawn.
+	// With less colors, the lines that changed get their own palette at the VBL.
+	if (colors < 256)
+		PA_Fake16Effect[screen] = PA_RasterAdd((void*)(PAL_BG0 + (screen << 10)), PA_Fake16Pal[screen], colors << 1,
+			screen ? PA_Fake16bitPrepare1 : PA_Fake16bitPrepare0);
+	else
+		PA_Fake16Effect[screen] = PA_RasterAdd((void*)(PAL_BG0 + (screen << 10)), PA_DrawFake16[screen], 512, NULL);
 	PA_HasFake16bitBg[screen] = true;
 }
 
@@ -70,6 +206,8 @@ void PA_DrawFake16bitLine(u8 screen, u16 x1, u16 y1, u16 x2, u16 y2, u16 color){
 	// Copypasted (and shorted) from the real 16 bit background function
 	int i,dx,dy,sdx,sdy,dxabs,dyabs,x,y,px,py;
 
+	PA_Fake16bitDirty(screen, y1, y2);
+
 	dx=x2-x1, dy=y2-y1, dxabs = dx, sdx = 1;
 	if(dx < 0) dxabs = -dx, sdx = -1;
 	dyabs = dy, sdy = 1;
@@ -0,0 +1,293 @@
+#include <PA9.h>
+
+//////////////////////////////////////////////////////////////////////
+// Fixed point math, .12 numbers and 4096 angles per turn
+//////////////////////////////////////////////////////////////////////
+
+// Sine of the first quarter of a turn, 4096 for 1
+const u16 PA_SinQuarter[1025] = {
+	0, 6, 13, 19, 25, 31, 38, 44, 50, 57, 63, 69, 75, 82, 88, 94,
+	101, 107, 113, 119, 126, 132, 138, 144, 151, 157, 163, 170, 176, 182, 188, 195,
+	201, 207, 214, 220, 226, 232, 239, 245, 251, 257, 264, 270, 276, 283, 289, 295,
+	301, 308, 314, 320, 326, 333, 339, 345, 351, 358, 364, 370, 376, 383, 389, 395,
+	401, 408, 414, 420, 426, 433, 439, 445, 451, 458, 464, 470, 476, 483, 489, 495,
+	501, 508, 514, 520, 526, 533, 539, 545, 551, 557, 564, 570, 576, 582, 589, 595,
+	601, 607, 613, 620, 626, 632, 638, 644, 651, 657, 663, 669, 675, 682, 688, 694,
+	700, 706, 713, 719, 725, 731, 737, 744, 750, 756, 762, 768, 774, 781, 787, 793,
+	799, 805, 811, 818, 824, 830, 836, 842, 848, 854, 861, 867, 873, 879, 885, 891,
+	897, 904, 910, 916, 922, 928, 934, 940, 946, 953, 959, 965, 971, 977, 983, 989,
+	995, 1001, 1007, 1014, 1020, 1026, 1032, 1038, 1044, 1050, 1056, 1062, 1068, 1074, 1080, 1086,
+	1092, 1099, 1105, 1111, 1117, 1123, 1129, 1135, 1141, 1147, 1153, 1159, 1165, 1171, 1177, 1183,
+	1189, 1195, 1201, 1207, 1213, 1219, 1225, 1231, 1237, 1243, 1249, 1255, 1261, 1267, 1273, 1279,
+	1285, 1291, 1297, 1303, 1309, 1315, 1321, 1327, 1332, 1338, 1344, 1350, 1356, 1362, 1368, 1374,
+	1380, 1386, 1392, 1398, 1404, 1409, 1415, 1421, 1427, 1433, 1439, 1445, 1451, 1457, 1462, 1468,
+	1474, 1480, 1486, 1492, 1498, 1503, 1509, 1515, 1521, 1527, 1533, 1538, 1544, 1550, 1556, 1562,
+	1567, 1573, 1579, 1585, 1591, 1596, 1602, 1608, 1614, 1620, 1625, 1631, 1637, 1643, 1648, 1654,
+	1660, 1666, 1671, 1677, 1683, 1689, 1694, 1700, 1706, 1711, 1717, 1723, 1729, 1734, 1740, 1746,
+	1751, 1757, 1763, 1768, 1774, 1780, 1785, 1791, 1797, 1802, 1808, 1813, 1819, 1825, 1830, 1836,
+	1842, 1847, 1853, 1858, 1864, 1870, 1875, 1881, 1886, 1892, 1898, 1903, 1909, 1914, 1920, 1925,
+	1931, 1936, 1942, 1947, 1953, 1958, 1964, 1970, 1975, 1981, 1986, 1992, 1997, 2002, 2008, 2013,
+	2019, 2024, 2030, 2035, 2041, 2046, 2052, 2057, 2062, 2068, 2073, 2079, 2084, 2090, 2095, 2100,
+	2106, 2111, 2117, 2122, 2127, 2133, 2138, 2143, 2149, 2154, 2159, 2165, 2170, 2175, 2181, 2186,
+	2191, 2197, 2202, 2207, 2213, 2218, 2223, 2228, 2234, 2239, 2244, 2249, 2255, 2260, 2265, 2270,
+	2276, 2281, 2286, 2291, 2296, 2302, 2307, 2312, 2317, 2322, 2328, 2333, 2338, 2343, 2348, 2353,
+	2359, 2364, 2369, 2374, 2379, 2384, 2389, 2394, 2399, 2405, 2410, 2415, 2420, 2425, 2430, 2435,
+	2440, 2445, 2450, 2455, 2460, 2465, 2470, 2475, 2480, 2485, 2490, 2495, 2500, 2505, 2510, 2515,
+	2520, 2525, 2530, 2535, 2540, 2545, 2550, 2555, 2559, 2564, 2569, 2574, 2579, 2584, 2589, 2594,
+	2598, 2603, 2608, 2613, 2618, 2623, 2628, 2632, 2637, 2642, 2647, 2652, 2656, 2661, 2666, 2671,
+	2675, 2680, 2685, 2690, 2694, 2699, 2704, 2709, 2713, 2718, 2723, 2727, 2732, 2737, 2741, 2746,
+	2751, 2755, 2760, 2765, 2769, 2774, 2779, 2783, 2788, 2792, 2797, 2802, 2806, 2811, 2815, 2820,
+	2824, 2829, 2833, 2838, 2843, 2847, 2852, 2856, 2861, 2865, 2870, 2874, 2878, 2883, 2887, 2892,
+	2896, 2901, 2905, 2910, 2914, 2918, 2923, 2927, 2932, 2936, 2940, 2945, 2949, 2953, 2958, 2962,
+	2967, 2971, 2975, 2979, 2984, 2988, 2992, 2997, 3001, 3005, 3009, 3014, 3018, 3022, 3026, 3031,
+	3035, 3039, 3043, 3048, 3052, 3056, 3060, 3064, 3068, 3073, 3077, 3081, 3085, 3089, 3093, 3097,
+	3102, 3106, 3110, 3114, 3118, 3122, 3126, 3130, 3134, 3138, 3142, 3146, 3150, 3154, 3158, 3162,
+	3166, 3170, 3174, 3178, 3182, 3186, 3190, 3194, 3198, 3202, 3206, 3210, 3214, 3217, 3221, 3225,
+	3229, 3233, 3237, 3241, 3244, 3248, 3252, 3256, 3260, 3264, 3267, 3271, 3275, 3279, 3282, 3286,
+	3290, 3294, 3297, 3301, 3305, 3309, 3312, 3316, 3320, 3323, 3327, 3331, 3334, 3338, 3342, 3345,
+	3349, 3352, 3356, 3360, 3363, 3367, 3370, 3374, 3378, 3381, 3385, 3388, 3392, 3395, 3399, 3402,
+	3406, 3409, 3413, 3416, 3420, 3423, 3426, 3430, 3433, 3437, 3440, 3444, 3447, 3450, 3454, 3457,
+	3461, 3464, 3467, 3471, 3474, 3477, 3481, 3484, 3487, 3490, 3494, 3497, 3500, 3504, 3507, 3510,
+	3513, 3516, 3520, 3523, 3526, 3529, 3532, 3536, 3539, 3542, 3545, 3548, 3551, 3555, 3558, 3561,
+	3564, 3567, 3570, 3573, 3576, 3579, 3582, 3585, 3588, 3591, 3594, 3597, 3600, 3603, 3606, 3609,
+	3612, 3615, 3618, 3621, 3624, 3627, 3630, 3633, 3636, 3639, 3642, 3644, 3647, 3650, 3653, 3656,
+	3659, 3661, 3664, 3667, 3670, 3673, 3675, 3678, 3681, 3684, 3686, 3689, 3692, 3695, 3697, 3700,
+	3703, 3705, 3708, 3711, 3713, 3716, 3719, 3721, 3724, 3727, 3729, 3732, 3734, 3737, 3739, 3742,
+	3745, 3747, 3750, 3752, 3755, 3757, 3760, 3762, 3765, 3767, 3770, 3772, 3775, 3777, 3779, 3782,
+	3784, 3787, 3789, 3791, 3794, 3796, 3798, 3801, 3803, 3805, 3808, 3810, 3812, 3815, 3817, 3819,
+	3822, 3824, 3826, 3828, 3831, 3833, 3835, 3837, 3839, 3842, 3844, 3846, 3848, 3850, 3852, 3854,
+	3857, 3859, 3861, 3863, 3865, 3867, 3869, 3871, 3873, 3875, 3877, 3879, 3881, 3883, 3885, 3887,
+	3889, 3891, 3893, 3895, 3897, 3899, 3901, 3903, 3905, 3907, 3909, 3910, 3912, 3914, 3916, 3918,
+	3920, 3921, 3923, 3925, 3927, 3929, 3930, 3932, 3934, 3936, 3937, 3939, 3941, 3943, 3944, 3946,
+	3948, 3949, 3951, 3953, 3954, 3956, 3958, 3959, 3961, 3962, 3964, 3965, 3967, 3969, 3970, 3972,
+	3973, 3975, 3976, 3978, 3979, 3981, 3982, 3984, 3985, 3987, 3988, 3989, 3991, 3992, 3994, 3995,
+	3996, 3998, 3999, 4001, 4002, 4003, 4005, 4006, 4007, 4008, 4010, 4011, 4012, 4014, 4015, 4016,
+	4017, 4019, 4020, 4021, 4022, 4023, 4024, 4026, 4027, 4028, 4029, 4030, 4031, 4032, 4034, 4035,
+	4036, 4037, 4038, 4039, 4040, 4041, 4042, 4043, 4044, 4045, 4046, 4047, 4048, 4049, 4050, 4051,
+	4052, 4053, 4053, 4054, 4055, 4056, 4057, 4058, 4059, 4060, 4060, 4061, 4062, 4063, 4064, 4064,
+	4065, 4066, 4067, 4067, 4068, 4069, 4070, 4070, 4071, 4072, 4072, 4073, 4074, 4074, 4075, 4076,
+	4076, 4077, 4077, 4078, 4079, 4079, 4080, 4080, 4081, 4081, 4082, 4082, 4083, 4083, 4084, 4084,
+	4085, 4085, 4086, 4086, 4087, 4087, 4088, 4088, 4088, 4089, 4089, 4089, 4090, 4090, 4090, 4091,
+	4091, 4091, 4092, 4092, 4092, 4092, 4093, 4093, 4093, 4093, 4094, 4094, 4094, 4094, 4094, 4095,
+	4095, 4095, 4095, 4095, 4095, 4095, 4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096, 4096,
+	4096
+};
+
+// Arc tangent of 0 to 1 in 1024 steps, in 16ths of the 4096 angles per turn
+const u16 PA_AtanTable[1025] = {
+	0, 10, 20, 31, 41, 51, 61, 71, 81, 92, 102, 112, 122, 132, 143, 153,
+	163, 173, 183, 194, 204, 214, 224, 234, 244, 255, 265, 275, 285, 295, 305, 316,
+	326, 336, 346, 356, 367, 377, 387, 397, 407, 417, 428, 438, 448, 458, 468, 478,
+	489, 499, 509, 519, 529, 539, 550, 560, 570, 580, 590, 600, 610, 621, 631, 641,
+	651, 661, 671, 681, 692, 702, 712, 722, 732, 742, 752, 763, 773, 783, 793, 803,
+	813, 823, 833, 844, 854, 864, 874, 884, 894, 904, 914, 924, 935, 945, 955, 965,
+	975, 985, 995, 1005, 1015, 1025, 1036, 1046, 1056, 1066, 1076, 1086, 1096, 1106, 1116, 1126,
+	1136, 1146, 1156, 1166, 1177, 1187, 1197, 1207, 1217, 1227, 1237, 1247, 1257, 1267, 1277, 1287,
+	1297, 1307, 1317, 1327, 1337, 1347, 1357, 1367, 1377, 1387, 1397, 1407, 1417, 1427, 1437, 1447,
+	1457, 1467, 1477, 1487, 1497, 1507, 1517, 1527, 1537, 1547, 1557, 1567, 1577, 1587, 1597, 1607,
+	1617, 1627, 1637, 1646, 1656, 1666, 1676, 1686, 1696, 1706, 1716, 1726, 1736, 1746, 1756, 1765,
+	1775, 1785, 1795, 1805, 1815, 1825, 1835, 1845, 1854, 1864, 1874, 1884, 1894, 1904, 1914, 1923,
+	1933, 1943, 1953, 1963, 1973, 1982, 1992, 2002, 2012, 2022, 2031, 2041, 2051, 2061, 2071, 2080,
+	2090, 2100, 2110, 2120, 2129, 2139, 2149, 2159, 2168, 2178, 2188, 2198, 2207, 2217, 2227, 2237,
+	2246, 2256, 2266, 2275, 2285, 2295, 2305, 2314, 2324, 2334, 2343, 2353, 2363, 2372, 2382, 2392,
+	2401, 2411, 2421, 2430, 2440, 2450, 2459, 2469, 2478, 2488, 2498, 2507, 2517, 2526, 2536, 2546,
+	2555, 2565, 2574, 2584, 2594, 2603, 2613, 2622, 2632, 2641, 2651, 2660, 2670, 2679, 2689, 2699,
+	2708, 2718, 2727, 2737, 2746, 2756, 2765, 2775, 2784, 2793, 2803, 2812, 2822, 2831, 2841, 2850,
+	2860, 2869, 2879, 2888, 2897, 2907, 2916, 2926, 2935, 2944, 2954, 2963, 2973, 2982, 2991, 3001,
+	3010, 3019, 3029, 3038, 3047, 3057, 3066, 3075, 3085, 3094, 3103, 3113, 3122, 3131, 3141, 3150,
+	3159, 3168, 3178, 3187, 3196, 3206, 3215, 3224, 3233, 3243, 3252, 3261, 3270, 3279, 3289, 3298,
+	3307, 3316, 3325, 3335, 3344, 3353, 3362, 3371, 3380, 3390, 3399, 3408, 3417, 3426, 3435, 3444,
+	3453, 3463, 3472, 3481, 3490, 3499, 3508, 3517, 3526, 3535, 3544, 3553, 3562, 3571, 3580, 3589,
+	3599, 3608, 3617, 3626, 3635, 3644, 3653, 3662, 3670, 3679, 3688, 3697, 3706, 3715, 3724, 3733,
+	3742, 3751, 3760, 3769, 3778, 3787, 3796, 3804, 3813, 3822, 3831, 3840, 3849, 3858, 3867, 3875,
+	3884, 3893, 3902, 3911, 3920, 3928, 3937, 3946, 3955, 3964, 3972, 3981, 3990, 3999, 4007, 4016,
+	4025, 4034, 4042, 4051, 4060, 4069, 4077, 4086, 4095, 4103, 4112, 4121, 4129, 4138, 4147, 4155,
+	4164, 4173, 4181, 4190, 4199, 4207, 4216, 4224, 4233, 4242, 4250, 4259, 4267, 4276, 4284, 4293,
+	4302, 4310, 4319, 4327, 4336, 4344, 4353, 4361, 4370, 4378, 4387, 4395, 4404, 4412, 4421, 4429,
+	4438, 4446, 4454, 4463, 4471, 4480, 4488, 4497, 4505, 4513, 4522, 4530, 4539, 4547, 4555, 4564,
+	4572, 4580, 4589, 4597, 4605, 4614, 4622, 4630, 4639, 4647, 4655, 4663, 4672, 4680, 4688, 4697,
+	4705, 4713, 4721, 4730, 4738, 4746, 4754, 4762, 4771, 4779, 4787, 4795, 4803, 4812, 4820, 4828,
+	4836, 4844, 4852, 4860, 4869, 4877, 4885, 4893, 4901, 4909, 4917, 4925, 4933, 4941, 4949, 4958,
+	4966, 4974, 4982, 4990, 4998, 5006, 5014, 5022, 5030, 5038, 5046, 5054, 5062, 5070, 5078, 5086,
+	5094, 5101, 5109, 5117, 5125, 5133, 5141, 5149, 5157, 5165, 5173, 5181, 5188, 5196, 5204, 5212,
+	5220, 5228, 5235, 5243, 5251, 5259, 5267, 5275, 5282, 5290, 5298, 5306, 5313, 5321, 5329, 5337,
+	5344, 5352, 5360, 5368, 5375, 5383, 5391, 5398, 5406, 5414, 5421, 5429, 5437, 5444, 5452, 5460,
+	5467, 5475, 5483, 5490, 5498, 5505, 5513, 5521, 5528, 5536, 5543, 5551, 5559, 5566, 5574, 5581,
+	5589, 5596, 5604, 5611, 5619, 5626, 5634, 5641, 5649, 5656, 5664, 5671, 5679, 5686, 5694, 5701,
+	5708, 5716, 5723, 5731, 5738, 5745, 5753, 5760, 5768, 5775, 5782, 5790, 5797, 5804, 5812, 5819,
+	5826, 5834, 5841, 5848, 5856, 5863, 5870, 5878, 5885, 5892, 5899, 5907, 5914, 5921, 5928, 5936,
+	5943, 5950, 5957, 5964, 5972, 5979, 5986, 5993, 6000, 6008, 6015, 6022, 6029, 6036, 6043, 6050,
+	6058, 6065, 6072, 6079, 6086, 6093, 6100, 6107, 6114, 6121, 6128, 6135, 6142, 6150, 6157, 6164,
+	6171, 6178, 6185, 6192, 6199, 6206, 6213, 6220, 6227, 6234, 6240, 6247, 6254, 6261, 6268, 6275,
+	6282, 6289, 6296, 6303, 6310, 6317, 6323, 6330, 6337, 6344, 6351, 6358, 6365, 6371, 6378, 6385,
+	6392, 6399, 6406, 6412, 6419, 6426, 6433, 6440, 6446, 6453, 6460, 6467, 6473, 6480, 6487, 6493,
+	6500, 6507, 6514, 6520, 6527, 6534, 6540, 6547, 6554, 6560, 6567, 6574, 6580, 6587, 6594, 6600,
+	6607, 6613, 6620, 6627, 6633, 6640, 6646, 6653, 6660, 6666, 6673, 6679, 6686, 6692, 6699, 6705,
+	6712, 6718, 6725, 6731, 6738, 6744, 6751, 6757, 6764, 6770, 6777, 6783, 6790, 6796, 6803, 6809,
+	6815, 6822, 6828, 6835, 6841, 6848, 6854, 6860, 6867, 6873, 6879, 6886, 6892, 6898, 6905, 6911,
+	6917, 6924, 6930, 6936, 6943, 6949, 6955, 6962, 6968, 6974, 6980, 6987, 6993, 6999, 7005, 7012,
+	7018, 7024, 7030, 7037, 7043, 7049, 7055, 7061, 7068, 7074, 7080, 7086, 7092, 7098, 7105, 7111,
+	7117, 7123, 7129, 7135, 7141, 7147, 7154, 7160, 7166, 7172, 7178, 7184, 7190, 7196, 7202, 7208,
+	7214, 7220, 7226, 7232, 7238, 7244, 7250, 7256, 7262, 7268, 7274, 7280, 7286, 7292, 7298, 7304,
+	7310, 7316, 7322, 7328, 7334, 7340, 7346, 7352, 7358, 7363, 7369, 7375, 7381, 7387, 7393, 7399,
+	7405, 7411, 7416, 7422, 7428, 7434, 7440, 7446, 7451, 7457, 7463, 7469, 7475, 7480, 7486, 7492,
+	7498, 7503, 7509, 7515, 7521, 7526, 7532, 7538, 7544, 7549, 7555, 7561, 7566, 7572, 7578, 7584,
+	7589, 7595, 7601, 7606, 7612, 7618, 7623, 7629, 7635, 7640, 7646, 7651, 7657, 7663, 7668, 7674,
+	7679, 7685, 7691, 7696, 7702, 7707, 7713, 7718, 7724, 7730, 7735, 7741, 7746, 7752, 7757, 7763,
+	7768, 7774, 7779, 7785, 7790, 7796, 7801, 7807, 7812, 7818, 7823, 7828, 7834, 7839, 7845, 7850,
+	7856, 7861, 7866, 7872, 7877, 7883, 7888, 7893, 7899, 7904, 7910, 7915, 7920, 7926, 7931, 7936,
+	7942, 7947, 7952, 7958, 7963, 7968, 7974, 7979, 7984, 7990, 7995, 8000, 8005, 8011, 8016, 8021,
+	8026, 8032, 8037, 8042, 8047, 8053, 8058, 8063, 8068, 8074, 8079, 8084, 8089, 8094, 8100, 8105,
+	8110, 8115, 8120, 8125, 8131, 8136, 8141, 8146, 8151, 8156, 8161, 8166, 8172, 8177, 8182, 8187,
+	8192
+};
+
+// Ratio of the smaller coordinate to the bigger one, to divide by the
+// hardware. Returns the octant.
+#define PA_ATAN_SWAP  1
+#define PA_ATAN_NEGX  2
+#define PA_ATAN_NEGY  4
+
+static inline u8 PA_AtanPrepare(s32 y, s32 x, u32 *lo, u32 *hi) {
+	u32 ax = (x < 0) ? -(u32)x : (u32)x;
+	u32 ay = (y < 0) ? -(u32)y : (u32)y;
+	u8 octant = ((x < 0) ? PA_ATAN_NEGX : 0) | ((y < 0) ? PA_ATAN_NEGY : 0);
+	s32 shift;
+
+	if (ay > ax) {
+		*lo = ax;
+		*hi = ay;
+		octant |= PA_ATAN_SWAP;
+	} else {
+		*lo = ay;
+		*hi = ax;
+	}
+
+	// lo << 16 has to fit in 31 bits
+	shift = 17 - __builtin_clz(*hi | 1);
+	if (shift > 0) {
+		*lo >>= shift;
+		*hi >>= shift;
+	}
+
+	if (*hi == 0) *hi = 1; // 0, 0 gives 0
+
+	return octant;
+}
+
+// ratio is lo / hi in .16
+static inline u16 PA_AtanFinish(u32 ratio, u8 octant) {
+	u32 i = ratio >> 6, f = ratio & 63;
+	u32 a;
+
+	if (i >= 1024) a = PA_AtanTable[1024] << 6;
+	else a = (PA_AtanTable[i] << 6) + (PA_AtanTable[i + 1] - PA_AtanTable[i]) * f;
+
+	a = (a + 512) >> 10; // 16ths of angle and 64ths of the table
+
+	if (octant & PA_ATAN_SWAP) a = 1024 - a;
+	if (octant & PA_ATAN_NEGX) a = 2048 - a;
+	if (octant & PA_ATAN_NEGY) a = 4096 - a;
+
+	return a & 4095;
+}
+
+u16 PA_Atan2F(s32 y, s32 x) {
+	u32 lo, hi;
+	u8 octant = PA_AtanPrepare(y, x, &lo, &hi);
+
+	PA_DivStart(lo << 16, hi);
+
+	return PA_AtanFinish(PA_DivResult(), octant);
+}
+
+void PA_NormalizeF(PA_Point *v) {
+	s32 len = PA_LengthF(v->x, v->y);
+
+	if (len == 0) return;
+
+	PA_DivF32Start(v->x, len);
+	v->x = PA_DivResult();
+	PA_DivF32Start(v->y, len);
+	v->y = PA_DivResult();
+}
+
+void PA_Transform2RotScale(PA_Transform2 *t, s32 angle, s32 scale, s32 x, s32 y) {
+	s32 cos = ((s64)PA_CosF(angle) * scale + (PA_FIXED_ONE >> 1)) >> PA_FIXED_PRECISION;
+	s32 sin = ((s64)PA_SinF(angle) * scale + (PA_FIXED_ONE >> 1)) >> PA_FIXED_PRECISION;
+
+	t->a = cos;
+	t->b = -sin;
+	t->c = sin;
+	t->d = cos;
+	t->tx = x;
+	t->ty = y;
+}
+
+void PA_TransformPoints(const PA_Transform2 *t, const PA_Point *in, PA_Point *out, s32 n) {
+	s32 a = t->a, b = t->b, c = t->c, d = t->d, tx = t->tx, ty = t->ty;
+
+	while (n--) {
+		s32 x = in->x, y = in->y;
+
+		out->x = (((s64)a * x + (s64)b * y) >> PA_FIXED_PRECISION) + tx;
+		out->y = (((s64)c * x + (s64)d * y) >> PA_FIXED_PRECISION) + ty;
+		in++;
+		out++;
+	}
+}
+
+void PA_MovePoints(PA_Point *pos, const PA_Point *speed, s32 n) {
+	while (n--) {
+		pos->x += speed->x;
+		pos->y += speed->y;
+		pos++;
+		speed++;
+	}
+}
+
+// The hardware works on one point while the CPU gets the next one ready
+
+void PA_PointsDistance(const PA_Point *pos, s32 n, s32 x, s32 y, u32 *dist) {
+	s64 dx, dy;
+	s32 i;
+
+	if (n <= 0) return;
+
+	dx = pos[0].x - x;
+	dy = pos[0].y - y;
+	PA_Sqrt64Start(dx * dx + dy * dy);
+
+	for (i = 1; i < n; i++) {
+		u64 next;
+
+		dx = pos[i].x - x;
+		dy = pos[i].y - y;
+		next = dx * dx + dy * dy;
+
+		dist[i - 1] = PA_SqrtResult();
+		PA_Sqrt64Start(next);
+	}
+
+	dist[n - 1] = PA_SqrtResult();
+}
+
+void PA_PointsAngle(const PA_Point *pos, s32 n, s32 x, s32 y, u16 *angle) {
+	u32 lo, hi;
+	u8 octant, next;
+	s32 i;
+
+	if (n <= 0) return;
+
+	octant = PA_AtanPrepare(pos[0].y - y, pos[0].x - x, &lo, &hi);
+	PA_DivStart(lo << 16, hi);
+
+	for (i = 1; i < n; i++) {
+		next = PA_AtanPrepare(pos[i].y - y, pos[i].x - x, &lo, &hi);
+		angle[i - 1] = PA_AtanFinish(PA_DivResult(), octant);
+		PA_DivStart(lo << 16, hi);
+		octant = next;
+	}
+
+	angle[n - 1] = PA_AtanFinish(PA_DivResult(), octant);
+}
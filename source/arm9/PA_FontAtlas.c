@@ -0,0 +1,303 @@
+#include <PA9.h>
+
+//////////////////////////////////////////////////////////////////////
+// Variable width fonts with UTF-8 text and kerning
+//////////////////////////////////////////////////////////////////////
+
+static void PA_SetFontAtlasTables(PA_FontAtlas *font, const u8 *base) {
+	PA_FontAtlasHeader *header = &font->Header;
+
+	// The tables are read from the start of the file, in the same order
+	font->Codes = (const u32*)(base + header->CodesOffset);
+	font->Metrics = (const PA_FontAtlasMetrics*)(base + header->MetricsOffset);
+	font->Kerns = (const PA_FontAtlasKern*)(base + header->KernOffset);
+}
+
+static u8 PA_CheckFontAtlasHeader(const PA_FontAtlasHeader *header) {
+	return (header->Magic == PA_FONTATLAS_MAGIC) && (header->Version == PA_FONTATLAS_VERSION)
+	       && (header->Height > 0) && (header->Height <= 16) && (header->PageShift < 16);
+}
+
+PA_FontAtlas* PA_LoadFontAtlas(const void *data) {
+	const PA_FontAtlasHeader *header = (const PA_FontAtlasHeader*)data;
+	PA_FontAtlas *font;
+
+	if (!PA_CheckFontAtlasHeader(header)) return NULL;
+
+	font = (PA_FontAtlas*)calloc(1, sizeof(PA_FontAtlas));
+	if (font == NULL) return NULL;
+
+	font->Header = *header;
+	PA_SetFontAtlasTables(font, (const u8*)data);
+	font->Pages = (const u16*)((const u8*)data + header->PagesOffset);
+
+	return font;
+}
+
+PA_FontAtlas* PA_OpenFontAtlas(const char *filename) {
+	PA_FontAtlas *font;
+	PA_FontAtlasHeader header;
+	FILE *file = fopen(filename, "rb");
+	s32 i;
+
+	if (file == NULL) return NULL;
+
+	if ((fread(&header, sizeof(header), 1, file) != 1) || !PA_CheckFontAtlasHeader(&header)) {
+		fclose(file);
+		return NULL;
+	}
+
+	font = (PA_FontAtlas*)calloc(1, sizeof(PA_FontAtlas));
+
+	// Everything before the glyph pages stays in memory: the header, the
+	// codepoints, the metrics and the kerning pairs
+	if (font) font->Resident = malloc(header.PagesOffset);
+
+	if ((font == NULL) || (font->Resident == NULL) || fseek(file, 0, SEEK_SET)
+	    || (fread(font->Resident, 1, header.PagesOffset, file) != header.PagesOffset)) {
+		if (font) free(font->Resident);
+		free(font);
+		fclose(file);
+		return NULL;
+	}
+
+	font->Header = header;
+	PA_SetFontAtlasTables(font, (const u8*)font->Resident);
+	font->File = file;
+	font->PageSize = (header.Height << header.PageShift) * sizeof(u16);
+
+	for (i = 0; i < PA_FONTATLAS_CACHE; i++) font->PageNum[i] = -1;
+
+	return font;
+}
+
+void PA_CloseFontAtlas(PA_FontAtlas *font) {
+	s32 i;
+
+	if (font == NULL) return;
+
+	if (font->File) fclose(font->File);
+
+	for (i = 0; i < PA_FONTATLAS_CACHE; i++) free(font->PageData[i]);
+
+	free(font->Resident);
+	free(font);
+}
+
+u32 PA_UTF8Decode(const char **text) {
+	const u8 *s = (const u8*)*text;
+	u32 code = *s++;
+	u8 extra, i;
+
+	if (code < 0x80) extra = 0;
+	else if ((code & 0xE0) == 0xC0) { code &= 0x1F; extra = 1; }
+	else if ((code & 0xF0) == 0xE0) { code &= 0x0F; extra = 2; }
+	else if ((code & 0xF8) == 0xF0) { code &= 0x07; extra = 3; }
+	else { *text = (const char*)s; return 0xFFFD; }
+
+	for (i = 0; i < extra; i++) {
+		if ((*s & 0xC0) != 0x80) { // Truncated sequence, the next byte starts a new character
+			*text = (const char*)s;
+			return 0xFFFD;
+		}
+
+		code = (code << 6) | (*s++ & 0x3F);
+	}
+
+	*text = (const char*)s;
+	return code;
+}
+
+s32 PA_FontAtlasGlyph(const PA_FontAtlas *font, u32 code) {
+	s32 low = 0, high = (s32)font->Header.NGlyphs - 1;
+
+	while (low <= high) {
+		s32 mid = (low + high) >> 1;
+		u32 midcode = font->Codes[mid];
+
+		if (midcode == code) return mid;
+
+		if (midcode < code) low = mid + 1;
+		else high = mid - 1;
+	}
+
+	return -1;
+}
+
+s32 PA_FontAtlasKerning(const PA_FontAtlas *font, s32 left, s32 right) {
+	s32 low = 0, high = (s32)font->Header.NKerns - 1;
+	u32 key = (left << 16) | right;
+
+	if ((left < 0) || (right < 0)) return 0;
+
+	while (low <= high) {
+		s32 mid = (low + high) >> 1;
+		u32 midkey = (font->Kerns[mid].Left << 16) | font->Kerns[mid].Right;
+
+		if (midkey == key) return font->Kerns[mid].Amount;
+
+		if (midkey < key) low = mid + 1;
+		else high = mid - 1;
+	}
+
+	return 0;
+}
+
+const u16* PA_FontAtlasImage(PA_FontAtlas *font, s32 glyph) {
+	u32 page = glyph >> font->Header.PageShift;
+	u32 line = (glyph & ((1 << font->Header.PageShift) - 1)) * font->Header.Height;
+	s32 i, slot = 0;
+
+	if (font->Pages) return font->Pages + glyph * font->Header.Height;
+
+	font->Clock++;
+
+	for (i = 0; i < PA_FONTATLAS_CACHE; i++) {
+		if (font->PageNum[i] == (s32)page) {
+			font->PageUsed[i] = font->Clock;
+			return font->PageData[i] + line;
+		}
+
+		if (font->PageUsed[i] < font->PageUsed[slot]) slot = i; // Least recently used
+	}
+
+	if (font->PageData[slot] == NULL) {
+		font->PageData[slot] = (u16*)malloc(font->PageSize);
+		PA_Assert(font->PageData[slot] != NULL, "Not enough memory for the font page");
+	}
+
+	// The last page can be shorter, the rest of the buffer isn't used
+	fseek(font->File, font->Header.PagesOffset + page * font->PageSize, SEEK_SET);
+	fread(font->PageData[slot], 1, font->PageSize, font->File);
+
+	font->PageNum[slot] = page;
+	font->PageUsed[slot] = font->Clock;
+
+	return font->PageData[slot] + line;
+}
+
+static inline s32 PA_FontAtlasAdvance(const PA_FontAtlas *font, s32 glyph) {
+	if (glyph < 0) return font->Header.Height >> 2; // Missing letter, leave a small gap
+
+	return font->Metrics[glyph].Advance + textinfo.letterspacing;
+}
+
+// Glyph to use for a character, with a fallback for the missing ones
+static s32 PA_FontAtlasFind(const PA_FontAtlas *font, u32 code) {
+	s32 glyph = PA_FontAtlasGlyph(font, code);
+
+	if (glyph < 0) glyph = PA_FontAtlasGlyph(font, 0xFFFD);
+	if (glyph < 0) glyph = PA_FontAtlasGlyph(font, '?');
+
+	return glyph;
+}
+
+s32 PA_FontAtlasTextWidth(const PA_FontAtlas *font, const char *text) {
+	s32 width = 0, prev = -1;
+
+	while (*text && (*text != '\n')) {
+		s32 glyph = PA_FontAtlasFind(font, PA_UTF8Decode(&text));
+
+		width += PA_FontAtlasKerning(font, prev, glyph) + PA_FontAtlasAdvance(font, glyph);
+		prev = glyph;
+	}
+
+	return width;
+}
+
+static void PA_ClearFontAtlasBox(u8 mode, u8 screen, s16 x, s16 y, s16 lx, s16 ly) {
+	s16 i, j;
+
+	for (j = y; j < y + ly; j++) {
+		for (i = x; i < x + lx; i++) {
+			if (mode == PA_TEXTRUN_16BIT) PA_DrawBg[screen][(j << 8) + i] = 0;
+			else PA_Put8bitPixel(screen, i, j, 0);
+		}
+	}
+}
+
+s32 PA_FontAtlasText(u8 mode, u8 screen, PA_FontAtlas *font, s16 basex, s16 basey, s16 maxx, s16 maxy, const char *text, u16 color, u8 transp, s32 limit) {
+	u8 ly = font->Header.Height;
+	s16 x = basex, y = basey;
+	s16 x2 = basex, y2 = basey;
+	s32 prev = -1, n = 0;
+
+	if (mode == PA_TEXTRUN_16C) transp = 1;
+
+	if (y + ly > maxy + 1) return 0;
+
+	while (*text && (n < limit)) {
+		const char *word = text;
+		s32 glyph, width = 0, wprev = prev;
+
+		if (*text == '\n') {
+			text++;
+			goto newline;
+		}
+
+		if (*text == ' ') { // Spaces are never drawn at the start of a line
+			glyph = PA_FontAtlasFind(font, ' ');
+			text++;
+
+			if (x != basex) {
+				x += PA_FontAtlasKerning(font, prev, glyph) + PA_FontAtlasAdvance(font, glyph);
+				prev = glyph;
+			}
+
+			continue;
+		}
+
+		// Measure the next word to see if it fits on this line
+		while (*word && (*word != ' ') && (*word != '\n')) {
+			glyph = PA_FontAtlasFind(font, PA_UTF8Decode(&word));
+			width += PA_FontAtlasKerning(font, wprev, glyph) + PA_FontAtlasAdvance(font, glyph);
+			wprev = glyph;
+		}
+
+		if ((x != basex) && (x + width > maxx + 1)) goto newline;
+
+		while ((text < word) && (n < limit)) {
+			const char *next = text;
+			u8 lx;
+
+			glyph = PA_FontAtlasFind(font, PA_UTF8Decode(&next));
+			x += PA_FontAtlasKerning(font, prev, glyph);
+			lx = (glyph < 0) ? 0 : font->Metrics[glyph].Width;
+
+			// Words longer than a line are cut anywhere
+			if ((x != basex) && (x + lx > maxx + 1)) break;
+
+			if (glyph >= 0) {
+				const u16 *rows = PA_FontAtlasImage(font, glyph);
+
+				if (!transp) PA_ClearFontAtlasBox(mode, screen, x, y, PA_FontAtlasAdvance(font, glyph), ly);
+
+				if (mode == PA_TEXTRUN_8BIT) PA_BlitGlyph8bit(screen, x, y, rows, lx, ly, color, 1);
+				else if (mode == PA_TEXTRUN_16BIT) PA_BlitGlyph16bit(screen, x, y, rows, lx, ly, color, 1);
+				else PA_BlitGlyph16c(screen, x, y, rows, ly, color);
+			}
+
+			x += PA_FontAtlasAdvance(font, glyph);
+			if (x > x2) x2 = x;
+			y2 = y + ly;
+			prev = glyph;
+			text = next;
+			n++;
+		}
+
+		if (text == word) continue;
+
+		if (n >= limit) break;
+
+	newline:
+		x = basex;
+		y += ly + textinfo.linespacing;
+		prev = -1;
+
+		if (y + ly > maxy + 1) break;
+	}
+
+	if (mode != PA_TEXTRUN_16C) PA_AddDirtyRect(screen, basex, basey, x2, y2);
+
+	return n;
+}
@@ -0,0 +1,293 @@
+#include <PA9.h>
+
+//////////////////////////////////////////////////////////////////////
+// printf-like formatting for the text functions
+//////////////////////////////////////////////////////////////////////
+
+#define PA_FMT_LEFT  1
+#define PA_FMT_ZERO  2
+#define PA_FMT_PLUS  4
+#define PA_FMT_SPACE 8
+
+typedef struct {
+	char *Out;
+	u32 Pos, Size; // Size is the space left for letters, without the final 0
+} PA_FormatOut;
+
+static inline void PA_FormatPut(PA_FormatOut *o, char c) {
+	if (o->Pos < o->Size) o->Out[o->Pos] = c;
+	o->Pos++;
+}
+
+static void PA_FormatRepeat(PA_FormatOut *o, char c, s32 n) {
+	while (n-- > 0) PA_FormatPut(o, c);
+}
+
+// Write the digits of a number, lowest first, returns how many
+static u32 PA_FormatDigits(char *buf, u64 value, u32 base, u8 upper) {
+	const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+	u32 n = 0;
+
+	if (base == 16) {
+		do { buf[n++] = digits[value & 15]; value >>= 4; } while (value);
+	} else if (value >> 32) {
+		do { buf[n++] = '0' + (value % 10); value /= 10; } while (value);
+	} else { // 32 bit division is much faster on the ARM9
+		u32 v = (u32)value;
+		do { buf[n++] = '0' + (v % 10); v /= 10; } while (v);
+	}
+
+	return n;
+}
+
+// Sign, padding and digits, buf holds the digits lowest first
+static void PA_FormatNumber(PA_FormatOut *o, const char *buf, u32 n, char sign, u8 flags, s32 width, s32 precision) {
+	s32 zeros = (precision > (s32)n) ? precision - n : 0;
+	s32 pad = width - n - zeros - (sign ? 1 : 0);
+
+	if ((flags & PA_FMT_ZERO) && !(flags & PA_FMT_LEFT) && (precision < 0)) {
+		zeros += (pad > 0) ? pad : 0;
+		pad = 0;
+	}
+
+	if (!(flags & PA_FMT_LEFT)) PA_FormatRepeat(o, ' ', pad);
+	if (sign) PA_FormatPut(o, sign);
+	PA_FormatRepeat(o, '0', zeros);
+	while (n) PA_FormatPut(o, buf[--n]);
+	if (flags & PA_FMT_LEFT) PA_FormatRepeat(o, ' ', pad);
+}
+
+static const u32 pa_pow10[10] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+// Integer part, point and decimals. frac holds the decimals as an integer
+static void PA_FormatDecimal(PA_FormatOut *o, u64 intpart, u32 frac, char sign, u8 flags, s32 width, s32 precision) {
+	char buf[32];
+	u32 n = 0;
+	s32 i;
+
+	if (precision) {
+		for (i = 0; i < precision; i++) {
+			buf[n++] = '0' + (frac % 10);
+			frac /= 10;
+		}
+
+		buf[n++] = '.';
+	}
+
+	n += PA_FormatDigits(buf + n, intpart, 10, 0);
+	PA_FormatNumber(o, buf, n, sign, flags, width, -1);
+}
+
+static inline char PA_FormatSign(u8 negative, u8 flags) {
+	return negative ? '-' : (flags & PA_FMT_PLUS) ? '+' : (flags & PA_FMT_SPACE) ? ' ' : 0;
+}
+
+// Fixed point number with fbits bits after the point
+static void PA_FormatFixed(PA_FormatOut *o, s32 value, u8 fbits, u8 flags, s32 width, s32 precision) {
+	u32 magnitude = (value < 0) ? -(u32)value : (u32)value;
+	u32 intpart = magnitude >> fbits;
+	u64 frac = magnitude & ((1 << fbits) - 1);
+
+	if (precision > 9) precision = 9;
+
+	frac = (frac * pa_pow10[precision] + (1 << (fbits - 1))) >> fbits; // Rounded
+
+	if (frac >= pa_pow10[precision]) {
+		frac -= pa_pow10[precision];
+		intpart++;
+	}
+
+	PA_FormatDecimal(o, intpart, (u32)frac, PA_FormatSign(value < 0, flags), flags, width, precision);
+}
+
+// Decimal writing of a double using only integer maths: the value is
+// mantissa / 2^shift, split into an integer part and a fraction
+static void PA_FormatDouble(PA_FormatOut *o, double value, u8 flags, s32 width, s32 precision) {
+	union { double d; u64 u; } bits = {value};
+	u32 exp = (bits.u >> 52) & 0x7FF;
+	u64 mant = bits.u & ((1ULL << 52) - 1);
+	char sign = PA_FormatSign(bits.u >> 63, flags);
+	u64 intpart, frac = 0;
+	s32 shift;
+
+	if (exp == 0x7FF) { // Infinity or NaN
+		const char *text = mant ? "nan" : "fni"; // Digits are written backwards
+		PA_FormatNumber(o, text, 3, mant ? 0 : sign, flags & ~PA_FMT_ZERO, width, -1);
+		return;
+	}
+
+	if (precision < 0) precision = 6;
+	if (precision > 9) precision = 9;
+
+	if (exp) mant |= 1ULL << 52;
+	else exp = 1; // Denormal
+
+	shift = 1075 - exp;
+
+	if (shift <= 0) {
+		intpart = (shift < -11) ? ~0ULL : mant << -shift; // Saturate above 2^63
+	} else {
+		intpart = (shift >= 64) ? 0 : mant >> shift;
+		frac = (shift >= 64) ? mant : mant & ((1ULL << shift) - 1);
+
+		if (shift >= 84) { // frac * 10^precision is below 2^83, so it rounds to 0
+			frac = 0;
+		} else { // frac * 10^precision on 96 bits, hi:lo, so no bit of the fraction is lost
+			u64 lo = (frac & 0xFFFFFFFF) * pa_pow10[precision];
+			u64 mid = (frac >> 32) * pa_pow10[precision];
+			u64 hi = mid >> 32;
+
+			mid <<= 32;
+			lo += mid;
+			if (lo < mid) hi++;
+
+			mid = 1ULL << ((shift - 1) & 63); // Rounded
+			if (shift > 64) hi += mid;
+			else if ((lo += mid) < mid) hi++;
+
+			if (shift >= 64) frac = hi >> (shift - 64);
+			else frac = (lo >> shift) | (hi << (64 - shift));
+		}
+
+		if (frac >= pa_pow10[precision]) { // Rounded up to the next integer
+			frac -= pa_pow10[precision];
+			intpart++;
+		}
+	}
+
+	PA_FormatDecimal(o, intpart, (u32)frac, sign, flags, width, precision);
+}
+
+s32 PA_VFormat(char *out, u32 size, const char *format, va_list args) {
+	PA_FormatOut o = {out, 0, size ? size - 1 : 0};
+	char buf[32];
+
+	for (; *format; format++) {
+		u8 flags = 0, length = 0;
+		s32 width = 0, precision = -1;
+		char c;
+
+		if (*format != '%') {
+			PA_FormatPut(&o, *format);
+			continue;
+		}
+
+		c = *++format;
+
+		// PAlib color code, for the text functions
+		if ((c == 'c') && (format[1] >= '0') && (format[1] <= '9')) {
+			PA_FormatPut(&o, '%');
+			PA_FormatPut(&o, 'c');
+			PA_FormatPut(&o, *++format);
+			continue;
+		}
+
+		for (;; c = *++format) {
+			if (c == '-') flags |= PA_FMT_LEFT;
+			else if (c == '0') flags |= PA_FMT_ZERO;
+			else if (c == '+') flags |= PA_FMT_PLUS;
+			else if (c == ' ') flags |= PA_FMT_SPACE;
+			else break;
+		}
+
+		if (c == '*') {
+			width = va_arg(args, s32);
+			if (width < 0) { flags |= PA_FMT_LEFT; width = -width; }
+			c = *++format;
+		} else {
+			for (; (c >= '0') && (c <= '9'); c = *++format) width = width * 10 + (c - '0');
+		}
+
+		if (c == '.') {
+			c = *++format;
+			precision = 0;
+
+			if (c == '*') {
+				precision = va_arg(args, s32);
+				c = *++format;
+			} else {
+				for (; (c >= '0') && (c <= '9'); c = *++format) precision = precision * 10 + (c - '0');
+			}
+		}
+
+		for (; (c == 'l') || (c == 'h'); c = *++format)
+			if (c == 'l') length++;
+
+		switch (c) {
+		case 'd':
+		case 'i': {
+			s64 value = (length >= 2) ? va_arg(args, s64) : va_arg(args, s32);
+			u64 magnitude = (value < 0) ? -(u64)value : (u64)value;
+			u32 n = (magnitude || precision) ? PA_FormatDigits(buf, magnitude, 10, 0) : 0; // %.0d of 0 writes no digit, as in C
+			PA_FormatNumber(&o, buf, n, PA_FormatSign(value < 0, flags), flags, width, precision);
+			break;
+		}
+
+		case 'u':
+		case 'x':
+		case 'X': {
+			u64 value = (length >= 2) ? va_arg(args, u64) : va_arg(args, u32);
+			u32 n = (value || precision) ? PA_FormatDigits(buf, value, (c == 'u') ? 10 : 16, 1) : 0; // %x in capitals too, as PA_OutputText always wrote it
+			PA_FormatNumber(&o, buf, n, 0, flags, width, precision);
+			break;
+		}
+
+		case 'f': {
+			double value = va_arg(args, double);
+
+			if ((format[1] >= '0') && (format[1] <= '9')) precision = *++format - '0'; // %f2, like PA_OutputText
+
+			PA_FormatDouble(&o, value, flags, width, precision);
+			break;
+		}
+
+		case 'q': // Fixed point, 8 bits after the point
+		case 'Q': // Fixed point, 12 bits after the point like the 3D functions
+			PA_FormatFixed(&o, va_arg(args, s32), (c == 'q') ? 8 : 12, flags, width, (precision < 0) ? 3 : precision);
+			break;
+
+		case 's': {
+			const char *text = va_arg(args, const char*);
+			s32 i, n = 0;
+
+			if (text == NULL) text = "(null)";
+
+			while (text[n] && ((precision < 0) || (n < precision))) n++;
+
+			if (!(flags & PA_FMT_LEFT)) PA_FormatRepeat(&o, ' ', width - n);
+			for (i = 0; i < n; i++) PA_FormatPut(&o, text[i]);
+			if (flags & PA_FMT_LEFT) PA_FormatRepeat(&o, ' ', width - n);
+			break;
+		}
+
+		case 'c':
+			if (!(flags & PA_FMT_LEFT)) PA_FormatRepeat(&o, ' ', width - 1);
+			PA_FormatPut(&o, (char)va_arg(args, s32));
+			if (flags & PA_FMT_LEFT) PA_FormatRepeat(&o, ' ', width - 1);
+			break;
+
+		case 0: // % at the end of the string
+			format--;
+			break;
+
+		default: // %% and anything unknown
+			PA_FormatPut(&o, c);
+			break;
+		}
+	}
+
+	if (size) out[(o.Pos < o.Size) ? o.Pos : o.Size] = 0;
+
+	return (o.Pos < o.Size) ? o.Pos : o.Size;
+}
+
+s32 PA_Format(char *out, u32 size, const char *format, ...) {
+	va_list args;
+	s32 n;
+
+	va_start(args, format);
+	n = PA_VFormat(out, size, format, args);
+	va_end(args);
+
+	return n;
+}
@@ -47,27 +47,11 @@ void CopyLine(void* dst, void* src, int count) { // Pour 8 bit
 //	if (count >= 0) *(u16*) dst = *(u16*) src; // On finit les 2 derniers
 }
 
-void CopyLine2(void* dst, void* src, int count) { // Pour 16 bit
-	u8 *temp = (u8*)src;
-
-	do {
-		*(u16*)dst = temppalette[*temp]; // On prend la couleur de la palette
-		temp++;
-		dst = (u8*)dst + 2;
-		count -= 1;
-	} while (count > 0);
-}
-
 int DGifGetLineByte(GifFileType *GifFile, GifPixelType *Line, int LineLen) {
-	if (GifBits == 0) CopyLine(LineBuf, Line, LineLen); // On fait un backup
-
 	int result = DGifGetLine(GifFile, LineBuf, LineLen); // Nouvelle ligne
 
-	if (PA_GifInfo.CurrentFrame >=  PA_GifInfo.StartFrame) {
-		if (GifBits == 0) CopyLine(Line, LineBuf, LineLen); // Copie 8 bit
-
-		if (GifBits == 1) CopyLine2(Line, LineBuf, LineLen); // Copie 8 bit
-	}
+	// VRAM only takes 16 bit writes, so 8 bit lines go through LineBuf
+	if (PA_GifInfo.CurrentFrame >=  PA_GifInfo.StartFrame) CopyLine(Line, LineBuf, LineLen);
 
 	return result;
 }
@@ -78,7 +62,7 @@ int DGifGetLineByte(GifFileType *GifFile, GifPixelType *Line, int LineLen) {
 * Interpret the command line and scan the given GIF file.		      *
 ******************************************************************************/
 
-int DecodeGif(const u8 *userData, u8 *ScreenBuff, u16* Palette, u8 nBits, s16 SWidth) {
+static int PA_DecodeGifFile(const u8 *userData, u8 *ScreenBuff, u16* Palette, u8 nBits, s16 SWidth) {
 	int	i, j, Row, Col, Width, Height, ExtCode;
 	GifRecordType RecordType;
 	GifByteType *Extension;
@@ -133,7 +117,10 @@ int DecodeGif(const u8 *userData, u8 *ScreenBuff, u16* Palette, u8 nBits, s16 SW
 				return EXIT_FAILURE;
 				}*/
 
-				if (GifFile->Image.Interlace) {
+				if ((GifBits == 1) && (PA_GifInfo.CurrentFrame >=  PA_GifInfo.StartFrame)) {
+					// 16 bit: the colors are looked up while decoding, straight to the screen
+					GifAssert(DGifGetImage(GifFile, ScreenBuff + (((SWidth*Row) + Col) << 1), SWidth, Palette) != GIF_ERROR);
+				} else if (GifFile->Image.Interlace) {
 					/* Need to perform 4 passes on the images: */
 					for (i = 0; i < 4; i++) {
 						for (j = Row + InterlacedOffset[i]; j < Row + Height;
@@ -212,3 +199,13 @@ GifStop:
 
 	return 0;
 }
+
+int DecodeGif(const u8 *userData, u8 *ScreenBuff, u16* Palette, u8 nBits, s16 SWidth) {
+	int result;
+
+	PA_ProfileBegin(PA_PROFILE_GIF);
+	result = PA_DecodeGifFile(userData, ScreenBuff, Palette, nBits, SWidth);
+	PA_ProfileEnd();
+
+	return result;
+}
@@ -0,0 +1,545 @@
+#include <PA9.h>
+
+//////////////////////////////////////////////////////////////////////
+// Gif animations decoded a little at each frame
+//////////////////////////////////////////////////////////////////////
+
+int readFunc(GifFileType* GifFile, GifByteType* buf, int count);
+
+extern const short InterlacedOffset[];
+extern const short InterlacedJumps[];
+
+#define PA_GIFSTATE_RECORD 0 // Reading the next record
+#define PA_GIFSTATE_IMAGE  1 // Decoding the lines of an image
+#define PA_GIFSTATE_END    2
+
+#define GifAssert(c) PA_Assert(c, "GIF decoding error")
+
+// Scanlines since start, the step must last less than a frame
+static inline s32 PA_GifLinesSince(s32 start) {
+	s32 lines = PA_GetVcount() - start;
+
+	if (lines < 0) lines += 263;
+
+	return lines;
+}
+
+static void PA_GifPlayerAddArea(PA_GifPlayer *player, s16 x, s16 y, s16 width, s16 height) {
+	if (x < player->X1) player->X1 = x;
+	if (y < player->Y1) player->Y1 = y;
+	if (x + width > player->X2) player->X2 = x + width;
+	if (y + height > player->Y2) player->Y2 = y + height;
+}
+
+static void PA_GifPlayerRewind(PA_GifPlayer *player) {
+	if (player->File) DGifCloseFile(player->File);
+
+	player->File = DGifOpen((void*)player->Data, readFunc);
+	GifAssert(player->File != NULL);
+	player->State = PA_GIFSTATE_RECORD;
+}
+
+PA_GifPlayer* PA_GifPlayerOpen(const void *gif, u8 mode, void *dest, s16 destwidth, u16 *palette) {
+	PA_GifPlayer *player = (PA_GifPlayer*)calloc(1, sizeof(PA_GifPlayer));
+	u8 pixelsize = (mode == PA_GIF_16BIT) ? 2 : 1;
+	ColorMapObject *colormap;
+	s32 i;
+
+	if (player == NULL) return NULL;
+
+	player->Data = (const u8*)gif;
+	PA_GifPlayerRewind(player);
+
+	player->Width = player->File->SWidth;
+	player->Height = player->File->SHeight;
+	player->Canvas = (u8*)malloc(player->Width * player->Height * pixelsize);
+	player->Line = (u8*)malloc(player->Width);
+
+	if ((player->Canvas == NULL) || (player->Line == NULL)) {
+		PA_GifPlayerClose(player);
+		return NULL;
+	}
+
+	if (mode == PA_GIF_SPRITE) PA_Assert(((player->Width | player->Height) & 7) == 0, "Gif size must be a multiple of 8 for sprites");
+
+	// Start from the background color
+	colormap = player->File->SColorMap;
+	player->BgIndex = player->File->SBackGroundColor;
+
+	if (colormap && (player->BgIndex < colormap->ColorCount)) {
+		GifColorType *color = &colormap->Colors[player->BgIndex];
+		player->BgColor = PA_RGB8(color->Red, color->Green, color->Blue);
+	}
+
+	if (mode == PA_GIF_16BIT) {
+		u16 *canvas = (u16*)player->Canvas;
+		for (i = 0; i < player->Width * player->Height; i++) canvas[i] = player->BgColor;
+	} else {
+		memset(player->Canvas, player->BgIndex, player->Width * player->Height);
+	}
+
+	player->Mode = mode;
+	player->Dest = dest;
+	player->DestWidth = destwidth;
+	player->Palette = palette;
+	player->Screen = -1;
+	player->Play = 1;
+	player->Loop = 1;
+	player->Speed = 256;
+	player->Budget = 32;
+	player->Transp = -1;
+	player->X1 = player->Width; player->Y1 = player->Height;
+	player->ShowTime = PA_VBLCount;
+
+	return player;
+}
+
+PA_GifPlayer* PA_GifPlayerOpenBg(u8 screen, s16 x, s16 y, const void *gif) {
+	PA_GifPlayer *player;
+
+	if (PA_nBit[screen]) {
+		player = PA_GifPlayerOpen(gif, PA_GIF_16BIT, PA_DrawBg[screen] + x + (y << 8), 256, NULL);
+	} else {
+		x &= ~1; // 2 pixels per halfword
+		player = PA_GifPlayerOpen(gif, PA_GIF_8BIT, PA_DrawBg[screen] + ((x + (y << 8)) >> 1), 256, (u16*)(0x05000000 + (0x400 * screen)));
+	}
+
+	if (player) {
+		player->Screen = screen;
+		player->X = x;
+		player->Y = y;
+	}
+
+	return player;
+}
+
+static void PA_GifPlayerCacheFree(PA_GifPlayer *player) {
+	s32 i;
+
+	for (i = 0; i < player->CacheCount; i++) {
+		free(player->CacheFrames[i].Pixels);
+		free(player->CacheFrames[i].Palette);
+	}
+
+	free(player->CacheFrames);
+	player->CacheFrames = NULL;
+	player->CacheCount = player->CacheAlloc = 0;
+	player->CacheSize = 0;
+	player->CachePalette = NULL;
+}
+
+u8 PA_GifPlayerCache(PA_GifPlayer *player, u32 maxsize) {
+	if ((player->Frame > 0) || (player->CacheState != PA_GIFCACHE_OFF)) return 0;
+
+	player->CacheState = PA_GIFCACHE_BUILDING;
+	player->CacheMax = maxsize;
+
+	return 1;
+}
+
+// All the frames are kept, the decoder isn't needed anymore
+static void PA_GifPlayerCacheDone(PA_GifPlayer *player) {
+	if (player->CacheCount == 0) { // No frame at all
+		player->CacheState = PA_GIFCACHE_OFF;
+		PA_GifPlayerRewind(player);
+		return;
+	}
+
+	DGifCloseFile(player->File);
+	player->File = NULL;
+	free(player->Canvas);
+	player->Canvas = NULL;
+	free(player->Line);
+	player->Line = NULL;
+	free(player->Saved);
+	player->Saved = NULL;
+
+	player->CacheState = PA_GIFCACHE_READY;
+	player->CacheFrame = 0;
+	player->State = PA_GIFSTATE_END;
+}
+
+void PA_GifPlayerClose(PA_GifPlayer *player) {
+	if (player == NULL) return;
+
+	PA_GifPlayerCacheFree(player);
+
+	if (player->File) DGifCloseFile(player->File);
+
+	free(player->Canvas);
+	free(player->Line);
+	free(player->Saved);
+	free(player);
+}
+
+// Copy the area of the frame about to be decoded to or from Saved, for disposal 3
+static void PA_GifPlayerSaveArea(PA_GifPlayer *player, s16 left, s16 top, s16 width, s16 height, u8 restore) {
+	u8 pixelsize = (player->Mode == PA_GIF_16BIT) ? 2 : 1;
+	s16 y;
+
+	for (y = 0; y < height; y++) {
+		u8 *canvas = player->Canvas + ((top + y) * player->Width + left) * pixelsize;
+		u8 *saved = player->Saved + y * width * pixelsize;
+
+		if (restore) memcpy(canvas, saved, width * pixelsize);
+		else memcpy(saved, canvas, width * pixelsize);
+	}
+}
+
+// Apply the disposal method of the frame that was shown before
+static void PA_GifPlayerDispose(PA_GifPlayer *player) {
+	s16 x, y;
+
+	if (player->PrevDisposal == 2) { // Restore to background
+		for (y = player->PrevTop; y < player->PrevTop + player->PrevHeight; y++) {
+			if (player->Mode == PA_GIF_16BIT) {
+				u16 *canvas = (u16*)player->Canvas + y * player->Width;
+				for (x = player->PrevLeft; x < player->PrevLeft + player->PrevWidth; x++) canvas[x] = player->BgColor;
+			} else {
+				memset(player->Canvas + y * player->Width + player->PrevLeft, player->BgIndex, player->PrevWidth);
+			}
+		}
+
+		PA_GifPlayerAddArea(player, player->PrevLeft, player->PrevTop, player->PrevWidth, player->PrevHeight);
+	}
+
+	if (player->PrevDisposal == 3) { // Restore to previous, saved before the frame was drawn
+		PA_GifPlayerSaveArea(player, player->PrevLeft, player->PrevTop, player->PrevWidth, player->PrevHeight, 1);
+		PA_GifPlayerAddArea(player, player->PrevLeft, player->PrevTop, player->PrevWidth, player->PrevHeight);
+	}
+
+	player->PrevDisposal = 0;
+}
+
+static void PA_GifPlayerRecord(PA_GifPlayer *player) {
+	GifFileType *file = player->File;
+	GifRecordType type;
+	GifByteType *extension;
+	ColorMapObject *colormap;
+	int code;
+	s32 i;
+
+	if (DGifGetRecordType(file, &type) == GIF_ERROR) type = TERMINATE_RECORD_TYPE;
+
+	switch (type) {
+		case IMAGE_DESC_RECORD_TYPE:
+			GifAssert(DGifGetImageDesc(file) != GIF_ERROR);
+			GifAssert(!(file->Image.Left + file->Image.Width > file->SWidth ||
+				file->Image.Top + file->Image.Height > file->SHeight));
+
+			player->Left = file->Image.Left;
+			player->Top = file->Image.Top;
+			player->ImgWidth = file->Image.Width;
+			player->ImgHeight = file->Image.Height;
+			player->Interlace = file->Image.Interlace;
+			player->Row = 0;
+			player->Pass = 0;
+
+			colormap = (file->Image.ColorMap ? file->Image.ColorMap : file->SColorMap);
+
+			if (colormap) {
+				for (i = 0; (i < colormap->ColorCount) && (i < 256); i++) {
+					GifColorType *color = &colormap->Colors[i];
+					player->Colors[i] = PA_RGB8(color->Red, color->Green, color->Blue);
+				}
+
+				player->PaletteChanged = 1;
+			}
+
+			PA_GifPlayerDispose(player);
+
+			if (player->Disposal == 3) { // Keep what the frame covers, to put it back after
+				u32 size = player->ImgWidth * player->ImgHeight * ((player->Mode == PA_GIF_16BIT) ? 2 : 1);
+
+				if (size > player->SavedSize) {
+					free(player->Saved);
+					player->Saved = (u8*)malloc(size);
+					player->SavedSize = player->Saved ? size : 0;
+				}
+
+				if (player->Saved) PA_GifPlayerSaveArea(player, player->Left, player->Top, player->ImgWidth, player->ImgHeight, 0);
+				else player->Disposal = 1; // No memory left, the frame stays in place
+			}
+
+			player->State = PA_GIFSTATE_IMAGE;
+			break;
+
+		case EXTENSION_RECORD_TYPE:
+			DGifGetExtension(file, &code, &extension);
+
+			while (extension != NULL) {
+				if ((code == GRAPHICS_EXT_FUNC_CODE) && (extension[0] >= 4)) {
+					player->Disposal = (extension[1] >> 2) & 7;
+					player->Transp = (extension[1] & 1) ? extension[4] : -1;
+					player->Delay = extension[2] + (extension[3] << 8);
+				}
+
+				DGifGetExtensionNext(file, &extension);
+			}
+
+			break;
+
+		case TERMINATE_RECORD_TYPE:
+			if (player->CacheState == PA_GIFCACHE_BUILDING) {
+				if (player->Loop) {
+					PA_GifPlayerCacheDone(player);
+					break;
+				}
+
+				PA_GifPlayerCacheFree(player); // Played only once, no use for it
+				player->CacheState = PA_GIFCACHE_OFF;
+			}
+
+			if (player->Loop) PA_GifPlayerRewind(player);
+			else player->State = PA_GIFSTATE_END;
+			break;
+
+		default:
+			break;
+	}
+}
+
+static void PA_GifPlayerDecodeLine(PA_GifPlayer *player) {
+	u8 *line = player->Line;
+	s32 y = player->Top + player->Row;
+	s32 x, transp = player->Transp;
+
+	if (player->Mode == PA_GIF_16BIT) { // Colors are looked up now, the palette can change at each frame
+		u16 *canvas = (u16*)player->Canvas + y * player->Width + player->Left;
+
+		if (transp < 0) {
+			GifAssert(DGifGetLine16(player->File, canvas, player->ImgWidth, player->Colors) != GIF_ERROR);
+		} else {
+			GifAssert(DGifGetLine(player->File, line, player->ImgWidth) != GIF_ERROR);
+
+			for (x = 0; x < player->ImgWidth; x++)
+				if (line[x] != transp) canvas[x] = player->Colors[line[x]];
+		}
+	} else {
+		u8 *canvas = player->Canvas + y * player->Width + player->Left;
+
+		if (transp < 0) {
+			GifAssert(DGifGetLine(player->File, canvas, player->ImgWidth) != GIF_ERROR);
+		} else {
+			GifAssert(DGifGetLine(player->File, line, player->ImgWidth) != GIF_ERROR);
+
+			for (x = 0; x < player->ImgWidth; x++)
+				if (line[x] != transp) canvas[x] = line[x];
+		}
+	}
+
+	// Next line, interlaced images come in 4 passes
+	if (player->Interlace) {
+		player->Row += InterlacedJumps[player->Pass];
+
+		while ((player->Row >= player->ImgHeight) && (player->Pass < 4)) {
+			if (++player->Pass < 4) player->Row = InterlacedOffset[player->Pass];
+		}
+	} else {
+		player->Row++;
+	}
+
+	if (player->Row >= player->ImgHeight) { // Image finished
+		PA_GifPlayerAddArea(player, player->Left, player->Top, player->ImgWidth, player->ImgHeight);
+
+		player->PrevDisposal = player->Disposal;
+		player->PrevLeft = player->Left;
+		player->PrevTop = player->Top;
+		player->PrevWidth = player->ImgWidth;
+		player->PrevHeight = player->ImgHeight;
+
+		// The graphic control extension only applies to one image
+		player->Disposal = 0;
+		player->Transp = -1;
+
+		player->State = PA_GIFSTATE_RECORD;
+		player->Ready = 1;
+	}
+}
+
+// Copy the changed area to the destination. src holds the area, pitch
+// pixels per line, and palette is the new palette or NULL
+static void PA_GifPlayerPresent(PA_GifPlayer *player, const u8 *src, s32 pitch, const u16 *palette) {
+	s16 x, y;
+	s16 x1 = player->X1, x2 = player->X2, y1 = player->Y1;
+	u16 *dest = (u16*)player->Dest;
+
+	if (palette && player->Palette)
+		for (x = 0; x < 256; x++) player->Palette[x] = palette[x];
+
+	for (y = y1; y < player->Y2; y++) {
+		if (player->Mode == PA_GIF_16BIT) {
+			memcpy(dest + y * player->DestWidth + x1, (const u16*)src + (y - y1) * pitch, (x2 - x1) << 1);
+		} else {
+			const u8 *line = src + (y - y1) * pitch - x1;
+
+			// VRAM is written 2 pixels at a time, the area starts on an even pixel
+			for (x = x1; x < x2; x += 2) {
+				u16 pair = line[x];
+
+				if (x + 1 < x2) pair |= line[x + 1] << 8;
+
+				if (player->Mode == PA_GIF_8BIT) {
+					u16 *dst = dest + ((y * player->DestWidth + x) >> 1);
+
+					if (x + 1 >= x2) pair |= *dst & 0xFF00; // Keep the pixel on the right of the gif
+
+					*dst = pair;
+				} else { // 8x8 tiles
+					dest[((((y >> 3) * (player->Width >> 3) + (x >> 3)) << 6) + ((y & 7) << 3) + (x & 7)) >> 1] = pair;
+				}
+			}
+		}
+	}
+
+	if ((player->Screen >= 0) && (x1 < x2))
+		PA_AddDirtyRect(player->Screen, player->X + x1, player->Y + y1, player->X + x2, player->Y + player->Y2);
+
+	player->X1 = player->Width; player->Y1 = player->Height;
+	player->X2 = 0; player->Y2 = 0;
+}
+
+// The delay is in 1/100 of a second, 60 VBLs per second at normal speed
+static inline u32 PA_GifPlayerDelay(PA_GifPlayer *player, s32 delay) {
+	return (delay * 3 * 256) / (5 * player->Speed);
+}
+
+// Keep the area about to be shown in the cache, or give up on the cache if
+// it gets too big
+static void PA_GifPlayerCacheStore(PA_GifPlayer *player) {
+	u8 pixelsize = (player->Mode == PA_GIF_16BIT) ? 2 : 1;
+	s32 width = player->X2 - player->X1, height = player->Y2 - player->Y1, y;
+	u8 newpalette = (player->Mode != PA_GIF_16BIT)
+	                && ((player->CachePalette == NULL) || memcmp(player->CachePalette, player->Colors, 512));
+	u32 size = sizeof(PA_GifCacheFrame) + (newpalette ? 512 : 0);
+	PA_GifCacheFrame *frame;
+
+	if ((width <= 0) || (height <= 0)) width = height = 0;
+
+	size += width * height * pixelsize;
+
+	if (player->CacheSize + size > player->CacheMax) goto full;
+
+	if (player->CacheCount == player->CacheAlloc) {
+		s32 alloc = player->CacheAlloc ? player->CacheAlloc << 1 : 16;
+		PA_GifCacheFrame *frames = (PA_GifCacheFrame*)realloc(player->CacheFrames, alloc * sizeof(PA_GifCacheFrame));
+
+		if (frames == NULL) goto full;
+
+		player->CacheFrames = frames;
+		player->CacheAlloc = alloc;
+	}
+
+	frame = &player->CacheFrames[player->CacheCount];
+	frame->X1 = player->X1; frame->Y1 = player->Y1;
+	frame->X2 = player->X2; frame->Y2 = player->Y2;
+	frame->Delay = player->Delay;
+	frame->Pixels = width ? (u8*)malloc(width * height * pixelsize) : NULL;
+	frame->Palette = newpalette ? (u16*)malloc(512) : NULL;
+
+	if ((width && (frame->Pixels == NULL)) || (newpalette && (frame->Palette == NULL))) {
+		free(frame->Pixels);
+		free(frame->Palette);
+		goto full;
+	}
+
+	for (y = 0; y < height; y++)
+		memcpy(frame->Pixels + y * width * pixelsize,
+		       player->Canvas + ((player->Y1 + y) * player->Width + player->X1) * pixelsize, width * pixelsize);
+
+	if (newpalette) {
+		memcpy(frame->Palette, player->Colors, 512);
+		player->CachePalette = frame->Palette;
+	}
+
+	player->CacheCount++;
+	player->CacheSize += size;
+	return;
+
+full:
+	PA_GifPlayerCacheFree(player);
+	player->CacheState = PA_GIFCACHE_FULL;
+}
+
+// Show the decoded frame if its time has come
+static u8 PA_GifPlayerShow(PA_GifPlayer *player) {
+	u8 pixelsize = (player->Mode == PA_GIF_16BIT) ? 2 : 1;
+
+	if (!player->Ready || ((s32)(PA_VBLCount - player->ShowTime) < 0)) return 0;
+
+	if (player->Mode != PA_GIF_16BIT) { // Even area, for 16 bit writes
+		player->X1 &= ~1;
+		if ((player->X2 & 1) && (player->X2 < player->Width)) player->X2++;
+	}
+
+	if (player->CacheState == PA_GIFCACHE_BUILDING) {
+		if (player->CacheCount == 0) { // The first frame is kept whole, it also starts the next loops
+			player->X1 = player->Y1 = 0;
+			player->X2 = player->Width; player->Y2 = player->Height;
+		}
+
+		PA_GifPlayerCacheStore(player);
+	}
+
+	if (player->X1 < player->X2) {
+		PA_GifPlayerPresent(player, player->Canvas + (player->Y1 * player->Width + player->X1) * pixelsize, player->Width,
+		                    (player->PaletteChanged && (player->Mode != PA_GIF_16BIT)) ? player->Colors : NULL);
+	}
+
+	player->PaletteChanged = 0;
+	player->ShowTime = PA_VBLCount + PA_GifPlayerDelay(player, player->Delay);
+	player->Ready = 0;
+	player->Frame++;
+	player->LastDecodeLines = player->DecodeLines;
+	player->DecodeLines = 0;
+
+	return 1;
+}
+
+// Show the next frame from the cache if its time has come
+static u8 PA_GifPlayerShowCached(PA_GifPlayer *player) {
+	PA_GifCacheFrame *frame = &player->CacheFrames[player->CacheFrame];
+	s32 start = PA_GetVcount();
+
+	if ((s32)(PA_VBLCount - player->ShowTime) < 0) return 0;
+
+	player->X1 = frame->X1; player->Y1 = frame->Y1;
+	player->X2 = frame->X2; player->Y2 = frame->Y2;
+	PA_GifPlayerPresent(player, frame->Pixels, frame->X2 - frame->X1, frame->Palette);
+
+	player->ShowTime = PA_VBLCount + PA_GifPlayerDelay(player, frame->Delay);
+	player->Frame++;
+	player->LastDecodeLines = PA_GifLinesSince(start);
+
+	if (++player->CacheFrame == player->CacheCount) {
+		player->CacheFrame = 0;
+		if (!player->Loop) player->Play = 0;
+	}
+
+	return 1;
+}
+
+u8 PA_GifPlayerStep(PA_GifPlayer *player) {
+	u8 shown;
+	s32 start;
+
+	if (player->Play != 1) return 0;
+
+	if (player->CacheState == PA_GIFCACHE_READY) return PA_GifPlayerShowCached(player);
+
+	shown = PA_GifPlayerShow(player);
+	start = PA_GetVcount();
+
+	while (!player->Ready && (player->State != PA_GIFSTATE_END) && (PA_GifLinesSince(start) < player->Budget)) {
+		if (player->State == PA_GIFSTATE_RECORD) PA_GifPlayerRecord(player);
+		else PA_GifPlayerDecodeLine(player);
+	}
+
+	player->DecodeLines += PA_GifLinesSince(start);
+
+	if (!shown) shown = PA_GifPlayerShow(player); // Decoded in time, no need to wait for the next step
+
+	if ((player->State == PA_GIFSTATE_END) && !player->Ready && (player->CacheState != PA_GIFCACHE_READY)) player->Play = 0;
+
+	return shown;
+}
@@ -0,0 +1,496 @@
+#include <PA9.h>
+
+//////////////////////////////////////////////////////////////////////
+// Screen recording to animated gifs, a little at each frame
+//////////////////////////////////////////////////////////////////////
+
+#define PA_GIFREC_IDLE      0 // Waiting for the next frame
+#define PA_GIFREC_CAPTURING 1 // Display capture running
+#define PA_GIFREC_COMPARE   2 // Finding what changed since the last frame
+#define PA_GIFREC_QUANTIZE  3 // Building the octree
+#define PA_GIFREC_ENCODE    4 // Writing the lines
+#define PA_GIFREC_FAILED    5 // Couldn't write, nothing more is done
+
+static const u8 pa_gifrecloop[3] = {1, 0, 0}; // Loop forever
+
+// Scanlines since start, the step must last less than a frame
+static inline s32 PA_GifRecordLinesSince(s32 start) {
+	s32 lines = PA_GetVcount() - start;
+
+	if (lines < 0) lines += 263;
+
+	return lines;
+}
+
+static int PA_GifRecordWrite(GifFileType *gif, const GifByteType *buf, int count) {
+	return fwrite(buf, 1, count, (FILE*)gif->UserData);
+}
+
+static inline u16* PA_GifRecordBank(u8 bank) {
+	return (u16*)(0x06800000 + (bank << 17)); // LCD address of VRAM A to D
+}
+
+//////////////////////////////////////////////////////////////////////
+// Octree quantisation: colors are added to a tree with 5 levels, one per
+// bit of each component, and the deepest nodes are merged whenever there
+// are more than 256 leaves
+//////////////////////////////////////////////////////////////////////
+
+static void PA_OctreeReset(PA_Octree *tree) {
+	memset(&tree->Nodes[0], 0, sizeof(PA_OctreeNode));
+	memset(tree->Reducible, 0, sizeof(tree->Reducible));
+	tree->Free = 0;
+	tree->Used = 1;
+	tree->Leaves = 0;
+}
+
+static u16 PA_OctreeNewNode(PA_Octree *tree) {
+	u16 node;
+
+	if (tree->Free) {
+		node = tree->Free;
+		tree->Free = tree->Nodes[node].Next;
+	} else {
+		// Can't happen with 256 leaves, there are at most 4 nodes above each
+		PA_Assert(tree->Used < PA_OCTREE_NODES, "Octree is full");
+		node = tree->Used++;
+	}
+
+	memset(&tree->Nodes[node], 0, sizeof(PA_OctreeNode));
+
+	return node;
+}
+
+// Merge the children of the deepest node into it
+static void PA_OctreeReduce(PA_Octree *tree) {
+	PA_OctreeNode *node;
+	s32 level = PA_OCTREE_LEVELS - 1, i;
+	u16 n;
+
+	while ((level > 0) && !tree->Reducible[level]) level--;
+
+	n = tree->Reducible[level];
+	node = &tree->Nodes[n];
+	tree->Reducible[level] = node->Next;
+
+	for (i = 0; i < 8; i++) {
+		u16 c = node->Child[i];
+
+		if (c) {
+			PA_OctreeNode *child = &tree->Nodes[c];
+
+			node->R += child->R;
+			node->G += child->G;
+			node->B += child->B;
+			node->Count += child->Count;
+
+			child->Next = tree->Free;
+			tree->Free = c;
+			tree->Leaves--;
+			node->Child[i] = 0;
+		}
+	}
+
+	node->Leaf = 1;
+	tree->Leaves++;
+}
+
+static void PA_OctreeAdd(PA_Octree *tree, u16 color, u32 count) {
+	s32 r = color & 31, g = (color >> 5) & 31, b = (color >> 10) & 31;
+	s32 level;
+	u16 n = 0;
+
+	for (level = 0; ; level++) {
+		PA_OctreeNode *node = &tree->Nodes[n];
+		s32 shift = PA_OCTREE_LEVELS - 1 - level, i;
+
+		if (node->Leaf) {
+			node->R += r * count;
+			node->G += g * count;
+			node->B += b * count;
+			node->Count += count;
+			break;
+		}
+
+		i = (((r >> shift) & 1) << 2) | (((g >> shift) & 1) << 1) | ((b >> shift) & 1);
+
+		if (!node->Child[i]) {
+			u16 c = PA_OctreeNewNode(tree);
+
+			if (level + 1 == PA_OCTREE_LEVELS) {
+				tree->Nodes[c].Leaf = 1;
+				tree->Leaves++;
+			} else {
+				tree->Nodes[c].Next = tree->Reducible[level + 1];
+				tree->Reducible[level + 1] = c;
+			}
+
+			tree->Nodes[n].Child[i] = c;
+		}
+
+		n = tree->Nodes[n].Child[i];
+	}
+
+	while (tree->Leaves > 256) PA_OctreeReduce(tree);
+}
+
+// Give each leaf a palette index, with the average of its colors
+static void PA_OctreePalette(PA_Octree *tree, u16 n, GifColorType *colors, s32 *index) {
+	PA_OctreeNode *node = &tree->Nodes[n];
+	s32 i;
+
+	if (node->Leaf) {
+		s32 r = node->R / node->Count, g = node->G / node->Count, b = node->B / node->Count;
+
+		colors[*index].Red = (r << 3) | (r >> 2);
+		colors[*index].Green = (g << 3) | (g >> 2);
+		colors[*index].Blue = (b << 3) | (b >> 2);
+		node->Index = (*index)++;
+		return;
+	}
+
+	for (i = 0; i < 8; i++)
+		if (node->Child[i]) PA_OctreePalette(tree, node->Child[i], colors, index);
+}
+
+static u8 PA_OctreeIndex(PA_Octree *tree, u16 color) {
+	s32 r = color & 31, g = (color >> 5) & 31, b = (color >> 10) & 31;
+	s32 level;
+	u16 n = 0;
+
+	for (level = 0; !tree->Nodes[n].Leaf; level++) {
+		s32 shift = PA_OCTREE_LEVELS - 1 - level, i;
+		u16 *child = tree->Nodes[n].Child;
+
+		i = (((r >> shift) & 1) << 2) | (((g >> shift) & 1) << 1) | ((b >> shift) & 1);
+
+		if (!child[i]) { // Color that wasn't added, take any close one
+			for (i = 0; !child[i]; i++);
+		}
+
+		n = child[i];
+	}
+
+	return tree->Nodes[n].Index;
+}
+
+// 3 bits of red and green, 2 of blue
+static inline u8 PA_GifRecordFixedIndex(u16 color) {
+	return (((color >> 2) & 7) << 5) | (((color >> 7) & 7) << 2) | ((color >> 13) & 3);
+}
+
+//////////////////////////////////////////////////////////////////////
+
+PA_GifRecorder* PA_GifRecordStart(const char *filename, u8 source, u8 screen, u8 quantize) {
+	PA_GifRecorder *rec = (PA_GifRecorder*)calloc(1, sizeof(PA_GifRecorder));
+	ColorMapObject *colormap = NULL;
+	s32 i;
+
+	if (rec == NULL) return NULL;
+
+	rec->Source = source;
+	rec->Screen = screen;
+	rec->Quantize = quantize;
+	rec->Width = 256;
+	rec->Height = 192;
+	rec->Interval = 6;
+	rec->Budget = 32;
+
+	rec->Frame = (u16*)malloc(rec->Width * rec->Height * 2);
+	rec->Prev = (u16*)malloc(rec->Width * rec->Height * 2);
+	rec->Line = (u8*)malloc(rec->Width);
+	if (quantize == PA_GIFREC_OCTREE) rec->Octree = (PA_Octree*)malloc(sizeof(PA_Octree));
+
+	rec->File = fopen(filename, "wb");
+
+	if ((rec->Frame == NULL) || (rec->Prev == NULL) || (rec->Line == NULL)
+	    || ((quantize == PA_GIFREC_OCTREE) && (rec->Octree == NULL)) || (rec->File == NULL)) {
+		PA_GifRecordStop(rec);
+		return NULL;
+	}
+
+	// The fixed palette is written once for all the frames
+	if (quantize == PA_GIFREC_FIXED) {
+		for (i = 0; i < 256; i++) {
+			rec->Colors[i].Red = ((i >> 5) * 255) / 7;
+			rec->Colors[i].Green = (((i >> 2) & 7) * 255) / 7;
+			rec->Colors[i].Blue = ((i & 3) * 255) / 3;
+		}
+
+		colormap = MakeMapObject(256, rec->Colors);
+	}
+
+	EGifSetGifVersion("89a");
+	rec->Gif = EGifOpen(rec->File, PA_GifRecordWrite);
+
+	if ((rec->Gif == NULL) || ((quantize == PA_GIFREC_FIXED) && (colormap == NULL))
+	    || (EGifPutScreenDesc(rec->Gif, rec->Width, rec->Height, 8, 0, colormap) == GIF_ERROR)) {
+		if (colormap) FreeMapObject(colormap);
+		PA_GifRecordStop(rec);
+		return NULL;
+	}
+
+	if (colormap) FreeMapObject(colormap); // The gif keeps its own copy
+
+	EGifPutExtensionFirst(rec->Gif, APPLICATION_EXT_FUNC_CODE, 11, (void*)"NETSCAPE2.0");
+	EGifPutExtensionLast(rec->Gif, APPLICATION_EXT_FUNC_CODE, 3, (void*)pa_gifrecloop);
+
+	if (source == PA_GIFREC_CAPTURE) (&VRAM_A_CR)[screen] = VRAM_ENABLE; // LCD mode, for the CPU
+
+	rec->GrabTime = PA_VBLCount - rec->Interval; // First frame right away
+
+	return rec;
+}
+
+static void PA_GifRecordStartImage(PA_GifRecorder *rec);
+
+static void PA_GifRecordStartCompare(PA_GifRecorder *rec) {
+	rec->State = PA_GIFREC_COMPARE;
+	rec->Row = 0;
+
+	if (rec->HasPrev) {
+		rec->X1 = rec->Width; rec->Y1 = rec->Height;
+		rec->X2 = 0; rec->Y2 = 0;
+	} else { // First frame, all of it
+		rec->X1 = 0; rec->Y1 = 0;
+		rec->X2 = rec->Width; rec->Y2 = rec->Height;
+		rec->Row = rec->Height;
+	}
+}
+
+// The frame grabbed is held in Prev until the next one that changes
+static void PA_GifRecordKeep(PA_GifRecorder *rec) {
+	u16 *swap = rec->Prev;
+
+	rec->Prev = rec->Frame;
+	rec->Frame = swap;
+	rec->PX1 = rec->X1; rec->PY1 = rec->Y1;
+	rec->PX2 = rec->X2; rec->PY2 = rec->Y2;
+	rec->PrevTime = rec->GrabTime;
+	rec->HasPrev = 1;
+	rec->State = PA_GIFREC_IDLE;
+}
+
+// Start writing the frame held in Prev, it stayed on screen until GrabTime
+static void PA_GifRecordWritePrev(PA_GifRecorder *rec) {
+	if (rec->Quantize == PA_GIFREC_OCTREE) {
+		PA_OctreeReset(rec->Octree);
+		rec->Row = rec->PY1;
+		rec->State = PA_GIFREC_QUANTIZE;
+	} else {
+		PA_GifRecordStartImage(rec);
+	}
+}
+
+// Take a new frame from the background, or start the capture
+static void PA_GifRecordGrab(PA_GifRecorder *rec) {
+	s32 i;
+
+	rec->GrabTime = PA_VBLCount;
+
+	if (rec->Source == PA_GIFREC_CAPTURE) {
+		PA_SetRegCapture(true, 0, 31, rec->Screen, 0, 3, 0, 0);
+		rec->State = PA_GIFREC_CAPTURING;
+		return;
+	}
+
+	if (PA_nBit[rec->Screen]) {
+		memcpy(rec->Frame, PA_DrawBg[rec->Screen], rec->Width * rec->Height * 2);
+	} else {
+		const u8 *src = (const u8*)PA_DrawBg[rec->Screen];
+		const u16 *pal = (const u16*)(0x05000000 + (0x400 * rec->Screen));
+
+		for (i = 0; i < rec->Width * rec->Height; i++) rec->Frame[i] = pal[src[i]];
+	}
+
+	PA_GifRecordStartCompare(rec);
+}
+
+static void PA_GifRecordCompareLine(PA_GifRecorder *rec) {
+	const u16 *a = rec->Frame + rec->Row * rec->Width;
+	const u16 *b = rec->Prev + rec->Row * rec->Width;
+	s32 x1, x2;
+
+	for (x1 = 0; (x1 < rec->Width) && (((a[x1] ^ b[x1]) & 0x7FFF) == 0); x1++);
+
+	if (x1 < rec->Width) {
+		for (x2 = rec->Width - 1; ((a[x2] ^ b[x2]) & 0x7FFF) == 0; x2--);
+
+		if (x1 < rec->X1) rec->X1 = x1;
+		if (x2 + 1 > rec->X2) rec->X2 = x2 + 1;
+		if (rec->Row < rec->Y1) rec->Y1 = rec->Row;
+		rec->Y2 = rec->Row + 1;
+	}
+
+	rec->Row++;
+}
+
+static void PA_GifRecordQuantizeLine(PA_GifRecorder *rec) {
+	const u16 *line = rec->Prev + rec->Row * rec->Width;
+	s32 x = rec->PX1;
+
+	// Runs of the same color are added at once
+	while (x < rec->PX2) {
+		u16 color = line[x] & 0x7FFF;
+		s32 start = x;
+
+		while ((x < rec->PX2) && ((line[x] & 0x7FFF) == color)) x++;
+
+		PA_OctreeAdd(rec->Octree, color, x - start);
+	}
+
+	rec->Row++;
+}
+
+// Graphic control extension and image descriptor of the area that changed
+static void PA_GifRecordStartImage(PA_GifRecorder *rec) {
+	ColorMapObject *colormap = NULL;
+	u8 gce[4];
+	u32 delay;
+
+	if (rec->Quantize == PA_GIFREC_OCTREE) {
+		s32 count = 0;
+
+		memset(rec->Colors, 0, sizeof(rec->Colors));
+		PA_OctreePalette(rec->Octree, 0, rec->Colors, &count);
+		colormap = MakeMapObject(256, rec->Colors);
+	}
+
+	// Until the next frame that changed, in hundredths of a second
+	delay = ((rec->GrabTime - rec->PrevTime) * 5) / 3;
+	if (delay > 0xFFFF) delay = 0xFFFF;
+
+	gce[0] = 1 << 2; // Leave the frame in place
+	gce[1] = delay & 0xFF;
+	gce[2] = delay >> 8;
+	gce[3] = 0;
+
+	// The encoder doesn't free the last local color map
+	if (rec->Gif->Image.ColorMap) {
+		FreeMapObject(rec->Gif->Image.ColorMap);
+		rec->Gif->Image.ColorMap = NULL;
+	}
+
+	if ((EGifPutExtension(rec->Gif, GRAPHICS_EXT_FUNC_CODE, 4, gce) == GIF_ERROR)
+	    || ((rec->Quantize == PA_GIFREC_OCTREE) && (colormap == NULL))
+	    || (EGifPutImageDesc(rec->Gif, rec->PX1, rec->PY1, rec->PX2 - rec->PX1, rec->PY2 - rec->PY1, 0, colormap) == GIF_ERROR)) {
+		rec->State = PA_GIFREC_FAILED;
+	} else {
+		rec->State = PA_GIFREC_ENCODE;
+		rec->Row = rec->PY1;
+	}
+
+	if (colormap) FreeMapObject(colormap);
+}
+
+// Returns 1 when the frame is finished
+static u8 PA_GifRecordEncodeLine(PA_GifRecorder *rec) {
+	const u16 *line = rec->Prev + rec->Row * rec->Width;
+	s32 x, width = rec->PX2 - rec->PX1;
+
+	if (rec->Quantize == PA_GIFREC_OCTREE) {
+		u16 last = 0xFFFF;
+		u8 index = 0;
+
+		for (x = 0; x < width; x++) {
+			u16 color = line[rec->PX1 + x] & 0x7FFF;
+
+			if (color != last) {
+				index = PA_OctreeIndex(rec->Octree, color);
+				last = color;
+			}
+
+			rec->Line[x] = index;
+		}
+	} else {
+		for (x = 0; x < width; x++) rec->Line[x] = PA_GifRecordFixedIndex(line[rec->PX1 + x]);
+	}
+
+	if (EGifPutLine(rec->Gif, rec->Line, width) == GIF_ERROR) {
+		rec->State = PA_GIFREC_FAILED;
+		return 0;
+	}
+
+	if (++rec->Row < rec->PY2) return 0;
+
+	rec->Frames++;
+	PA_GifRecordKeep(rec); // The new frame waits for its time on screen in turn
+
+	return 1;
+}
+
+// Do some work on the current frame, returns 1 when it's written
+static u8 PA_GifRecordWork(PA_GifRecorder *rec) {
+	switch (rec->State) {
+		case PA_GIFREC_COMPARE:
+			if (rec->Row < rec->Height) {
+				PA_GifRecordCompareLine(rec);
+			} else if (!rec->HasPrev) { // First frame, written when the next one comes
+				PA_GifRecordKeep(rec);
+			} else if (rec->X1 >= rec->X2) { // Nothing changed, the frame before stays longer
+				rec->State = PA_GIFREC_IDLE;
+			} else {
+				PA_GifRecordWritePrev(rec);
+			}
+			break;
+
+		case PA_GIFREC_QUANTIZE:
+			if (rec->Row < rec->PY2) PA_GifRecordQuantizeLine(rec);
+			else PA_GifRecordStartImage(rec);
+			break;
+
+		case PA_GIFREC_ENCODE:
+			return PA_GifRecordEncodeLine(rec);
+	}
+
+	return 0;
+}
+
+u8 PA_GifRecordStep(PA_GifRecorder *rec) {
+	s32 start = PA_GetVcount();
+	u8 written = 0;
+
+	if ((rec->State == PA_GIFREC_IDLE) && ((s32)(PA_VBLCount - rec->GrabTime) >= rec->Interval)) PA_GifRecordGrab(rec);
+
+	// The capture is done once the enable bit is cleared
+	if ((rec->State == PA_GIFREC_CAPTURING) && !(REG_DISPCAPCNT & (1 << 31))) {
+		memcpy(rec->Frame, PA_GifRecordBank(rec->Screen), rec->Width * rec->Height * 2);
+		PA_GifRecordStartCompare(rec);
+	}
+
+	while ((rec->State >= PA_GIFREC_COMPARE) && (rec->State < PA_GIFREC_FAILED) && !written
+	       && (PA_GifRecordLinesSince(start) < rec->Budget)) {
+		written = PA_GifRecordWork(rec);
+	}
+
+	rec->StepLines = PA_GifRecordLinesSince(start);
+
+	return written;
+}
+
+void PA_GifRecordStop(PA_GifRecorder *rec) {
+	if (rec == NULL) return;
+
+	if (rec->State == PA_GIFREC_CAPTURING) REG_DISPCAPCNT = 0;
+
+	// A frame being written is finished, then the last one is written with the time until now
+	while ((rec->State == PA_GIFREC_QUANTIZE) || (rec->State == PA_GIFREC_ENCODE)) PA_GifRecordWork(rec);
+
+	if (rec->HasPrev && (rec->State != PA_GIFREC_FAILED)) {
+		rec->GrabTime = PA_VBLCount;
+		if (rec->GrabTime == rec->PrevTime) rec->GrabTime += rec->Interval;
+
+		PA_GifRecordWritePrev(rec);
+		while ((rec->State == PA_GIFREC_QUANTIZE) || (rec->State == PA_GIFREC_ENCODE))
+			if (PA_GifRecordWork(rec)) break;
+	}
+
+	if (rec->Gif) EGifCloseFile(rec->Gif);
+	if (rec->File) fclose(rec->File);
+
+	free(rec->Frame);
+	free(rec->Prev);
+	free(rec->Line);
+	free(rec->Octree);
+	free(rec);
+}
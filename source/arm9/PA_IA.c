@@ -3,77 +3,39 @@
 u16 *maze[255];
 //u16 mazex, mazey;
 
-s8 PA_Astar(u16 width, u16 height) {
-	u16 maze2[width][height];
-	u8 chemin[width][height];
-	u8 bloc[width][height];
-	u8 arriveex = 0, arriveey = 0, debutx = 0, debuty = 0;
-	u8 i, j;
-	u8 exit;
-
-	for (j = 0; j < height; j++)for (i = 0; i < width; i++)maze2[i][j] = maze[i][j];
-
-	for (j = 0; j < height; j++)for (i = 0; i < width; i++)bloc[i][j] = 0;
+static PA_PathGrid *PA_AstarGrid = NULL;
 
-	for (j = 0; j < height; j++)for (i = 0; i < width; i++) {
-			if (maze2[i][j] == 1) {
-				debutx = i;  debuty = j;
-			}
+s8 PA_Astar(u16 width, u16 height) {
+	u16 startx = 0, starty = 0, goalx = 0, goaly = 0;
+	PA_PathPoint path[2];
+	u16 i, j;
+
+	// The grid is kept for the next calls with the same size
+	if ((PA_AstarGrid == NULL) || (PA_AstarGrid->Width != width) || (PA_AstarGrid->Height != height)) {
+		PA_PathDelete(PA_AstarGrid);
+		PA_AstarGrid = PA_PathCreate(width, height, 0);
+		if (PA_AstarGrid == NULL) return -1;
+	}
 
-			if (maze2[i][j] == 2) {
-				maze2[i][j] = 0;  arriveex = i;  arriveey = j;
+	for (j = 0; j < height; j++) {
+		for (i = 0; i < width; i++) {
+			if (maze[i][j] == 1) {
+				startx = i;  starty = j;
+			} else if (maze[i][j] == 2) {
+				goalx = i;  goaly = j;
 			}
 
-			if (maze2[i][j] == 5) {
-				maze2[i][j] = 0;  bloc[i][j] = 1;
-			}
+			PA_PathSetCost(PA_AstarGrid, i, j, (maze[i][j] == 5) ? PA_PATH_WALL : 1);
 		}
-
-	while (1) {
-		if (maze2[arriveex][arriveey] != 0)break;
-
-		exit = 1;
-
-		for (j = 0; j < height; j++)	for (i = 0; i < width; i++) {
-				if (maze2[i][j] > 0) {
-					if (j < height - 1 && maze2[i][j+1] == 0 && bloc[i][j+1] == 0) {
-						maze2[i][j+1] = maze2[i][j] + 1; exit = 0;
-					}
-
-					if (j > 0 && maze2[i][j-1] == 0 && bloc[i][j-1] == 0) {
-						maze2[i][j-1] = maze2[i][j] + 1; exit = 0;
-					}
-
-					if (i < width - 1 && maze2[i+1][j] == 0 && bloc[i+1][j] == 0) {
-						maze2[i+1][j] = maze2[i][j] + 1; exit = 0;
-					}
-
-					if (i > 0 && maze2[i-1][j] == 0 && bloc[i-1][j] == 0) {
-						maze2[i-1][j] = maze2[i][j] + 1; exit = 0;
-					}
-				}
-			}
-
-		if (exit == 1) return -1;
 	}
 
-	for (j = 0; j < height; j++)for (i = 0; i < width; i++)chemin[i][j] = 0;
-
-	while (1) {
-		if (chemin[debutx][debuty] == 1)break;
+	if (PA_PathFind(PA_AstarGrid, startx, starty, goalx, goaly) != PA_PATH_FOUND) return -1;
 
-		chemin[arriveex][arriveey] = 1;
-
-		if (arriveey < height - 1 && maze2[arriveex][arriveey+1] < maze2[arriveex][arriveey] && maze2[arriveex][arriveey+1] != 0 && bloc[arriveex][arriveey+1] == 0) arriveey++;
-		else if (arriveey > 0 && maze2[arriveex][arriveey-1] < maze2[arriveex][arriveey] && maze2[arriveex][arriveey-1] != 0 && bloc[arriveex][arriveey-1] == 0) arriveey--;
-		else if (arriveex < width - 1 && maze2[arriveex+1][arriveey] < maze2[arriveex][arriveey] && maze2[arriveex+1][arriveey] != 0 && bloc[arriveex+1][arriveey] == 0) arriveex++;
-		else if (arriveex > 0 && maze2[arriveex-1][arriveey] < maze2[arriveex][arriveey] && maze2[arriveex-1][arriveey] != 0 && bloc[arriveex-1][arriveey] == 0) arriveex--;
-	}
+	if (PA_PathGet(PA_AstarGrid, path, 2) < 2) return 0; // Already there
 
-	if (chemin[debutx-1][debuty] == 1)return 1;
-	else if (chemin[debutx+1][debuty] == 1)return 2;
-	else if (chemin[debutx][debuty-1] == 1)return 3;
-	else if (chemin[debutx][debuty+1] == 1)return 4;
+	if (path[1].x < startx) return 1;
+	else if (path[1].x > startx) return 2;
+	else if (path[1].y < starty) return 3;
 
-	return 0;
+	return 4;
 }
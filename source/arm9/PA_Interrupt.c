@@ -10,9 +10,14 @@ funcpointer MotionVBL = PA_Nothing;
 funcpointer GHPadVBL  = PA_Nothing;
 funcpointer PaddleVBL = PA_Nothing;
 funcpointer SpriteVBL = PA_Nothing;
+funcpointer PaletteVBL = PA_Nothing;
+funcpointer RasterVBL = PA_Nothing;
+funcpointer UploadVBL = PA_Nothing;
+funcpointer Dual3DVBL = PA_Nothing;
 
 s32 PA_VBLCounter[16]; // VBL counters
 bool PA_VBLCounterOn[16]; // VBL counters enable/disable flag
+vu32 PA_VBLCount; // Number of VBLs since PA_Init
 
 //static bool PA_RandInit = false;
 
@@ -29,6 +34,8 @@ static inline void PA_RunCounters(){
 }
 
 void PA_vblFunc(){
+	PA_ProfileBegin(PA_PROFILE_VBL); // Also where the profiler's frames start
+
 	// Flush the legacy IPC
 	DC_FlushRange((void*) &PA_IPC, sizeof(PA_IPCType));
 
@@ -36,8 +43,22 @@ void PA_vblFunc(){
 	PA_UpdatePad();
 	PA_UpdateStylus();
 
+	// Show each 3D scene on its screen
+	Dual3DVBL();
+
 	SpriteVBL();
 
+	// Copy the graphics queued during the frame
+	PA_ProfileBegin(PA_PROFILE_UPLOAD);
+	UploadVBL();
+	PA_ProfileEnd();
+
+	// Upload the palettes that changed
+	PaletteVBL();
+
+	// Start the raster effects for the next frame
+	RasterVBL();
+
 	// Update the external pads
 	MotionVBL();
 	GHPadVBL();
@@ -48,7 +69,10 @@ void PA_vblFunc(){
 
 	// Run the counters
 	PA_RunCounters();
+	PA_VBLCount++;
 
 	// Run the user's custom VBL function
 	CustomVBL();
+
+	PA_ProfileEnd();
 }
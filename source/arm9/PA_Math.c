@@ -3,25 +3,22 @@
 u32 RandomValue = 1;
 
 u16 PA_AdjustAngle(u16 angle, s16 anglerot, s32 startx, s32 starty, s32 targetx, s32 targety) {
-	u64 distances[3];
-	startx = startx << 8; // Fixed point...
-	starty = starty << 8; // Fixed point...
-	targetx = targetx << 8; // Fixed point...
-	targety = targety << 8; // Fixed point...
+	s64 dx = targetx - startx;
+	s64 dy = starty - targety; // Angles go up
+	s64 dots[3];
 	u16 tempangle = (angle - anglerot) & 511;
-	// Calcul des distances en fonction des angles
-	distances[0] = PA_Distance(startx + PA_Cos(tempangle), starty - PA_Sin(tempangle), targetx, targety);
-	tempangle += anglerot;
-	tempangle &= 511;
-	distances[1] = PA_Distance(startx + PA_Cos(tempangle), starty - PA_Sin(tempangle), targetx, targety);
-	tempangle += anglerot;
-	tempangle &= 511;
-	distances[2] = PA_Distance(startx + PA_Cos(tempangle), starty - PA_Sin(tempangle), targetx, targety);
+
+	// The closest direction to the target is the one going the most towards it
+	dots[0] = PA_Cos(tempangle) * dx + PA_Sin(tempangle) * dy;
+	tempangle = (tempangle + anglerot) & 511;
+	dots[1] = PA_Cos(tempangle) * dx + PA_Sin(tempangle) * dy;
+	tempangle = (tempangle + anglerot) & 511;
+	dots[2] = PA_Cos(tempangle) * dx + PA_Sin(tempangle) * dy;
 
 	// On regarde si l'angle est optimal. Si ce n'est pas le cas,
 	// on fait tourner toujours dans le meme sens...
-	if (distances[0] < distances[1])  angle -= anglerot;
-	else if (distances[2] < distances[1])  angle += anglerot;
+	if (dots[0] > dots[1])  angle -= anglerot;
+	else if (dots[2] > dots[1])  angle += anglerot;
 
 	return (angle&511);
 }
@@ -27,14 +27,64 @@ BGAFF_EX _m7_bgaff_ex[192];  // affine parameters for each line
          \~french Numéro du fond. 2 en mode 1, 2 ou 3 en mode 2
 */
 
+static BGAFF_EX PA_Mode7Lines[PA_RASTER_LINES + 1]; // Affine registers for each line
+static s8 PA_Mode7Effect = -1;
+static s32 PA_Mode7Last[5]; // Camera the lines were computed for
+
+// Affine parameters of a line, seen at the distance line from the top
+static inline void PA_Mode7Line(BGAFF_EX *aff, s32 line) {
+	s32 ww, wcc, wss, wxr, wyr;
+
+	ww = (mode7cam_y << 4) / line;		// .8*.16 /.12 = 20.12
+	wcc = ww * mode7cos >> 5;					// .12*.8 /.5 = 17.15
+	wss = ww * mode7sin >> 5;					// .12*.8 /.5 = 17.15
+	// NOTE: when you do P * q0
+	// - for x-offset (q0_x): >>7, then *120
+	// - for y-offset (q0_y): *160, then >>7
+	// Bad things happen if you don't.
+	// horizontal scale and offset
+	wxr = 128 * (wcc >> 7);				// .8
+	wyr = (mode7_distance * wss) >> 7;				// .8
+	aff->pa = wcc >> 7;
+	aff->dx = mode7cam_x - wxr + wyr;
+	// vertical scale and offset
+	wxr = 128 * (wss >> 7);				// .8
+	wyr = (mode7_distance * wcc) >> 7;				// .8
+	aff->pc = wss >> 7;
+	aff->dy = mode7cam_z - wxr - wyr;
+}
+
+// Recompute the lines at the VBL when the camera moved
+static void PA_Mode7Prepare(void) {
+	s32 y;
+
+	if ((PA_Mode7Last[0] == mode7cam_x) && (PA_Mode7Last[1] == mode7cam_y) && (PA_Mode7Last[2] == mode7cam_z)
+		&& (PA_Mode7Last[3] == mode7alpha) && (PA_Mode7Last[4] == mode7_distance)) return;
+
+	PA_Mode7Last[0] = mode7cam_x; PA_Mode7Last[1] = mode7cam_y; PA_Mode7Last[2] = mode7cam_z;
+	PA_Mode7Last[3] = mode7alpha; PA_Mode7Last[4] = mode7_distance;
+
+	for (y = 0; y < PA_RASTER_LINES; y++) PA_Mode7Line(PA_Mode7Lines + y, y ? y : 1);
+}
+
 void PA_InitMode7(u8 bg_select) {
 	mode7cam_x = X0; mode7cam_y = Y0; mode7cam_z = Z0;
 	mode7alpha = 0;
 	mode7cos = 256; mode7sin = 0;	// temporaries for cos and sin alpha
 	mode7_distance = 160;
-//PA_StartInt(INT_HBLANK, hbl_mode7);
-	irqSet(IRQ_HBLANK, hbl_mode7);
-	irqEnable(IRQ_HBLANK);
+
+	PA_DeInitMode7();
+
+	// The raster effects write the lines, so mode 7 works with other effects
+	memset(PA_Mode7Lines, 0, sizeof(PA_Mode7Lines)); // pb and pd stay at 0
+	PA_Mode7Last[1] = -1;
+	PA_Mode7Prepare();
+	PA_Mode7Effect = PA_RasterAdd(&PA_BGXPA(0, bg_select), PA_Mode7Lines, sizeof(BGAFF_EX), PA_Mode7Prepare);
+}
+
+void PA_DeInitMode7(void) {
+	PA_RasterRemove(PA_Mode7Effect);
+	PA_Mode7Effect = -1;
 }
 
 
@@ -53,32 +103,18 @@ u8 m7_distance = 160;
 
 u8 PAcount;
 
+// Old HBlank function, kept for programs that install it themselves
 void hbl_mode7(void) {
-	u8 screen = 0;
-	u8 bg = 3;
-	s32 ww, wcc, wss, wxr, wyr;
-//	ww= (mode7cam_y*DIV[REG_VCOUNT])>>12;		// .8*.16 /.12 = 20.12
+	BGAFF_EX aff;
 	s16 vc = REG_VCOUNT;
 
 	if (vc > 192) vc = 0;
 
-	ww = (mode7cam_y << 4) / (vc + 1);		// .8*.16 /.12 = 20.12
-	wcc = ww * mode7cos >> 5;					// .12*.8 /.5 = 17.15
-	wss = ww * mode7sin >> 5;					// .12*.8 /.5 = 17.15
-	// NOTE: when you do P * q0
-	// - for x-offset (q0_x): >>7, then *120
-	// - for y-offset (q0_y): *160, then >>7
-	// Bad things happen if you don't.
-	// horizontal scale and offset
-	wxr = 128 * (wcc >> 7);				// .8
-	wyr = (mode7_distance * wss) >> 7;				// .8
-	PA_BGXPA(screen, bg) = wcc >> 7;
-	PA_BGXX(screen, bg) = mode7cam_x - wxr + wyr;
-	// vertical scale and offset
-	wxr = 128 * (wss >> 7);				// .8
-	wyr = (mode7_distance * wcc) >> 7;				// .8
-	PA_BGXPC(screen, bg) = wss >> 7;
-	PA_BGXY(screen, bg) = mode7cam_z - wxr - wyr;
+	PA_Mode7Line(&aff, vc + 1);
+	PA_BGXPA(0, 3) = aff.pa;
+	PA_BGXX(0, 3) = aff.dx;
+	PA_BGXPC(0, 3) = aff.pc;
+	PA_BGXY(0, 3) = aff.dy;
 	// REG_IF = INT_HBLANK;		// cleared by isr switchblock
 }
 
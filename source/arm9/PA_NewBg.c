@@ -120,6 +120,7 @@ void PA_AddBitmapFont(int slot, const PA_BgStruct* font){
 	bit8_tiles[slot] = (u8*) font->BgTiles;
 	pa_bittextdefaultsize[slot] = (u8*) font->FontSizes;
 	pa_bittextpoliceheight[slot] = font->FontHeight;
+	PA_ResetGlyphCache(slot);
 }
 
 void PA_Add16cFont(int slot, const PA_BgStruct* font){
@@ -129,4 +130,5 @@ void PA_Add16cFont(int slot, const PA_BgStruct* font){
 	c16_tiles[slot] = (u32*) font->BgTiles;
 	pa_bittextdefaultsize[slot] = (u8*) font->FontSizes;
 	pa_bittextpoliceheight[slot] = font->FontHeight;
+	PA_ResetGlyphCache(slot);
 }
@@ -2,6 +2,10 @@
 
 u8 PA_ExtPal[2][2]; // 0 si pas étendu, 1 sinon
 
+// Sprite palettes handed out by PA_AllocSpritePal, found again from their colors
+u8 pa_sprpalrefs[2][16];
+static u32 pa_sprpalkey[2][16][2]; // Two hashes of the 256 colors
+
 void PA_InitSpriteExtPal(void) {
 	// Palettes étendus pour les 256 couleurs...
 	vramSetBankG(VRAM_G_SPRITE_EXT_PALETTE);
@@ -12,19 +16,61 @@ void PA_InitSpriteExtPal(void) {
 	REG_DISPCNT_SUB |= DISPLAY_SPR_EXT_PALETTE;
 	PA_LoadSpritePal(0, 0, (void*)PAL_SPRITE0);
 	PA_LoadSpritePal(1, 0, (void*)PAL_SPRITE1);
+	memset(pa_sprpalrefs, 0, sizeof(pa_sprpalrefs));
 }
 
 void PA_LoadSpriteExtPal(u8 screen, u16 palette_number, void* palette) {
-	DC_FlushRange(palette, 512);
-	if (screen == 0) {
-		vramSetBankG(VRAM_G_LCD);  // On passe en mode LCD pour pouvoir ecrire dessus, on reviendre en palette apres
-		dmaCopy(palette,VRAM_G_EXT_SPR_PALETTE[palette_number],512);
-		vramSetBankG(VRAM_G_SPRITE_EXT_PALETTE);
-	} else {
-		vramSetBankI(VRAM_I_LCD);  // On passe en mode LCD pour pouvoir ecrire dessus, on reviendre en palette apres
-		dmaCopy(palette,VRAM_I_EXT_SPR_PALETTE[palette_number],512);
-		vramSetBankI(VRAM_I_SUB_SPRITE_EXT_PALETTE);
+	if (PA_PalShadowOn) { // Uploaded at the next VBL
+		PA_PalShadowLoad(PA_PAL_SPRITEEXT(screen, palette_number), palette);
+		return;
+	}
+
+	// The bank goes in LCD mode during the copy
+	if (screen == 0) PA_UploadCopy(palette, VRAM_G_EXT_SPR_PALETTE[palette_number], 512, PA_UPLOAD_SPRITEEXTPAL(0));
+	else PA_UploadCopy(palette, VRAM_I_EXT_SPR_PALETTE[palette_number], 512, PA_UPLOAD_SPRITEEXTPAL(1));
+}
+
+// FNV-1a and a sum of the colors, rotated : both equal for two different palettes is not going to happen among 16
+static void PA_SpritePalKey(const u16 *palette, u32 *key) {
+	u32 fnv = 2166136261u, sum = 0;
+	u16 i;
+
+	for (i = 0; i < 256; i++) {
+		fnv = (fnv ^ palette[i]) * 16777619u;
+		sum = ((sum << 5) | (sum >> 27)) + palette[i];
+	}
+	key[0] = fnv;
+	key[1] = sum;
+}
+
+s8 PA_AllocSpritePal(u8 screen, void* palette) {
+	u32 key[2];
+	s8 i, slot = -1;
+
+	PA_SpritePalKey((const u16*)palette, key);
+
+	// From the last one, the first palettes are usually loaded by hand
+	for (i = 15; i >= 0; i--) {
+		if (!pa_sprpalrefs[screen][i]) {
+			if (slot < 0) slot = i;
+		}
+		else if ((pa_sprpalkey[screen][i][0] == key[0]) && (pa_sprpalkey[screen][i][1] == key[1])) {
+			pa_sprpalrefs[screen][i]++;
+			return i;
+		}
 	}
+	if (slot < 0) return -1;
+
+	pa_sprpalrefs[screen][slot] = 1;
+	pa_sprpalkey[screen][slot][0] = key[0];
+	pa_sprpalkey[screen][slot][1] = key[1];
+	PA_LoadSpriteExtPal(screen, slot, palette);
+
+	return slot;
+}
+
+void PA_FreeSpritePal(u8 screen, u8 palette_number) {
+	if (pa_sprpalrefs[screen][palette_number]) pa_sprpalrefs[screen][palette_number]--;
 }
 
 void PA_InitBgExtPal(void) {
@@ -46,14 +92,12 @@ void PA_InitBgExtPal(void) {
 }
 
 void PA_LoadBgPalN(u8 screen, u8 bg_number, u8 pal_number, void* palette) {
-	DC_FlushRange(palette, 512);
-	if (screen == 0) {
-		vramSetBankE(VRAM_E_LCD);  // On passe en mode LCD pour pouvoir ecrire dessus, on reviendre en palette apres
-		dmaCopy(palette,&VRAM_E_EXT_PALETTE[bg_number][pal_number],512);
-		vramSetBankE(VRAM_E_BG_EXT_PALETTE);
-	} else {
-		vramSetBankH(VRAM_H_LCD);  // On passe en mode LCD pour pouvoir ecrire dessus, on reviendre en palette apres
-		dmaCopy(palette,&VRAM_H_EXT_PALETTE[bg_number][pal_number],512);
-		vramSetBankH(VRAM_H_SUB_BG_EXT_PALETTE);
+	if (PA_PalShadowOn) { // Uploaded at the next VBL
+		PA_PalShadowLoad(PA_PAL_BGEXT(screen, bg_number, pal_number), palette);
+		return;
 	}
+
+	// The bank goes in LCD mode during the copy
+	if (screen == 0) PA_UploadCopy(palette, &VRAM_E_EXT_PALETTE[bg_number][pal_number], 512, PA_UPLOAD_BGEXTPAL(0));
+	else PA_UploadCopy(palette, &VRAM_H_EXT_PALETTE[bg_number][pal_number], 512, PA_UPLOAD_BGEXTPAL(1));
 }
@@ -1,33 +1,49 @@
 #include <PA9.h>
 
-void PA_CreatePalBright(u16 *pal, u16 *newpal, s8 bright) {
+// The 3 channels go through tables, 32 entries each, already shifted
+static void PA_ApplyColTables(const u16 *r, const u16 *g, const u16 *b, const u16 *pal, u16 *newpal) {
 	u16 i;
-	s8 r, g, b;
 
 	for (i = 0; i < 256; i++) {
-		r = pal[i] & 31; PA_AdjustCol(r, bright);
-		g = (pal[i] >> 5) & 31; PA_AdjustCol(g, bright);
-		b = (pal[i] >> 10) & 31; PA_AdjustCol(b, bright);
-		newpal[i] = PA_RGB(r, g, b);
+		u16 c = pal[i];
+		newpal[i] = (1 << 15) | r[c & 31] | g[(c >> 5) & 31] | b[(c >> 10) & 31];
 	}
 }
 
+void PA_CreatePalBright(u16 *pal, u16 *newpal, s8 bright) {
+	u16 r[32], g[32], b[32];
+	s8 i, c;
+
+	for (i = 0; i < 32; i++) {
+		c = i; PA_AdjustCol(c, bright);
+		r[i] = c; g[i] = c << 5; b[i] = c << 10;
+	}
+
+	PA_ApplyColTables(r, g, b, pal, newpal);
+}
+
 
 void PA_CreatePalTransition(u16 *pal, u16 *newpal, s8 level, u8 destr, u8 destg, u8 destb) {
-	u16 i;
-	s16 r, g, b;
+	u16 r[32], g[32], b[32];
+	s16 i;
 
-	for (i = 0; i < 256; i++) {
-		r = ((pal[i] & 31) * (31 - level) + level * destr) >> 5;
-		g = (((pal[i] >> 5) & 31) * (31 - level) + level * destr) >> 5;
-		b = (((pal[i] >> 10) & 31) * (31 - level) + level * destr) >> 5;
-		newpal[i] = PA_RGB(r, g, b);
+	for (i = 0; i < 32; i++) {
+		r[i] = (i * (31 - level) + level * destr) >> 5;
+		g[i] = ((i * (31 - level) + level * destg) >> 5) << 5;
+		b[i] = ((i * (31 - level) + level * destb) >> 5) << 10;
 	}
+
+	PA_ApplyColTables(r, g, b, pal, newpal);
 }
 
 void PA_SetBgPalNCol(u8 screen, u8 bg_number, u8 pal_number, u8 color_number, u16 color) {
 	u16 *palcolor;
 
+	if (PA_PalShadowOn) { // Uploaded at the next VBL
+		PA_PalShadowSetCol(PA_PAL_BGEXT(screen, bg_number, pal_number), color_number, color);
+		return;
+	}
+
 	if (screen == 0) {
 		vramSetBankE(VRAM_E_LCD);  // On passe en mode LCD pour pouvoir ecrire dessus, on reviendre en palette apres
 		palcolor = (u16*)(VRAM_E + (bg_number << 12) + (pal_number << 8));
@@ -44,6 +60,11 @@ void PA_SetBgPalNCol(u8 screen, u8 bg_number, u8 pal_number, u8 color_number, u1
 void PA_SetSpritePalCol(u8 screen, u8 pal_number, u8 color_number, u16 color) {
 	u16 *palcolor;
 
+	if (PA_PalShadowOn) { // Uploaded at the next VBL
+		PA_PalShadowSetCol(PA_PAL_SPRITEEXT(screen, pal_number), color_number, color);
+		return;
+	}
+
 	if (screen == 0) {
 		vramSetBankG(VRAM_G_LCD);	// bank contents can only be changed in LCD mode
 		palcolor = (u16*)(VRAM_G + (pal_number << 8));
@@ -0,0 +1,268 @@
+#include <PA9.h>
+
+//////////////////////////////////////////////////////////////////////
+// Palettes kept in RAM, uploaded once per VBL
+//////////////////////////////////////////////////////////////////////
+
+PA_PalShadow PA_PalShadows[2 * PA_PAL_PER_SCREEN];
+u8 PA_PalShadowOn = 0;
+
+// Each channel of a color goes through its own table, already shifted
+typedef struct {
+	u16 R[32], G[32], B[32];
+} PA_PalTable;
+
+// Fade to a color : c + (dest - c) * level / 32, for each value of c
+static void PA_PalFadeTable(PA_PalTable *t, u8 level, u16 color) {
+	s32 r = color & 31, g = (color >> 5) & 31, b = (color >> 10) & 31;
+	s32 c;
+
+	for (c = 0; c < 32; c++) {
+		t->R[c] = c + (((r - c) * level) >> 5);
+		t->G[c] = (c + (((g - c) * level) >> 5)) << 5;
+		t->B[c] = (c + (((b - c) * level) >> 5)) << 10;
+	}
+}
+
+static void PA_PalApplyTable(const PA_PalTable *t, const u16 *src, u16 *dest, s32 n) {
+	while (n--) {
+		u16 c = *src++;
+		*dest++ = t->R[c & 31] | t->G[(c >> 5) & 31] | t->B[(c >> 10) & 31] | (c & 0x8000);
+	}
+}
+
+// Crossfade : the difference between the 2 channels goes through the table
+static void PA_PalApplyCross(u8 level, const u16 *src, const u16 *target, u16 *dest, s32 n) {
+	s8 delta[63];
+	s32 d;
+
+	for (d = -31; d < 32; d++) delta[d + 31] = (d * level) >> 5;
+
+	while (n--) {
+		s32 a = *src++, b = *target++;
+		s32 r = a & 31, g = (a >> 5) & 31, bl = (a >> 10) & 31;
+
+		r += delta[(b & 31) - r + 31];
+		g += delta[((b >> 5) & 31) - g + 31];
+		bl += delta[((b >> 10) & 31) - bl + 31];
+		*dest++ = r | (g << 5) | (bl << 10) | (a & 0x8000);
+	}
+}
+
+// Recompute the shown colors from first to first+n-1 and mark the palette for upload
+static void PA_PalShadowRefresh(PA_PalShadow *p, u16 first, u16 n) {
+	PA_PalTable table;
+
+	if (p->Effect == PA_PALFX_FADE) {
+		PA_PalFadeTable(&table, p->Level, p->Color);
+		PA_PalApplyTable(&table, p->Base + first, p->Shown + first, n);
+	} else if (p->Effect == PA_PALFX_CROSS) {
+		PA_PalApplyCross(p->Level, p->Base + first, p->Target + first, p->Shown + first, n);
+	} else {
+		memcpy(p->Shown + first, p->Base + first, n << 1);
+	}
+
+	p->Dirty = 1; // Only once the colors are ready, the VBL can come at any time
+}
+
+// Extended palettes are in VRAM banks that can only be read and written in LCD mode
+static u16* PA_PalExtAddress(u8 screen, u16 n) {
+	if (n < 66) { // Backgrounds, 4 blocks of 16 palettes
+		n -= 2;
+		return (screen ? VRAM_H : VRAM_E) + ((n >> 4) << 12) + ((n & 15) << 8);
+	}
+
+	return (screen ? VRAM_I : VRAM_G) + ((n - 66) << 8);
+}
+
+static inline u8 PA_PalExtOn(u8 screen, u16 n) {
+	return PA_ExtPal[(n < 66) ? 1 : 0][screen];
+}
+
+static void PA_PalExtBank(u8 screen, u16 n, u8 lcd) {
+	if (n < 66) {
+		if (screen) vramSetBankH(lcd ? VRAM_H_LCD : VRAM_H_SUB_BG_EXT_PALETTE);
+		else vramSetBankE(lcd ? VRAM_E_LCD : VRAM_E_BG_EXT_PALETTE);
+	} else {
+		if (screen) vramSetBankI(lcd ? VRAM_I_LCD : VRAM_I_SUB_SPRITE_EXT_PALETTE);
+		else vramSetBankG(lcd ? VRAM_G_LCD : VRAM_G_SPRITE_EXT_PALETTE);
+	}
+}
+
+// 512 bytes with the CPU : the VBL can interrupt a DMA set up by the program
+static inline void PA_PalCopy(u16 *dest, const u16 *src) {
+	u32 *d = (u32*)dest;
+	const u32 *s = (const u32*)src;
+	s32 i;
+
+	for (i = 0; i < 128; i += 4) {
+		d[i] = s[i]; d[i + 1] = s[i + 1]; d[i + 2] = s[i + 2]; d[i + 3] = s[i + 3];
+	}
+}
+
+void PA_PalShadowUpload(void) {
+	u8 screen;
+	u16 n;
+
+	for (screen = 0; screen < 2; screen++) {
+		PA_PalShadow *p = PA_PalShadows + PA_PAL_BG(screen);
+
+		if (p[0].Dirty) {
+			p[0].Dirty = 0;
+			PA_PalCopy((u16*)(PAL_BG0 + (screen << 10)), p[0].Shown);
+		}
+
+		if (p[1].Dirty) {
+			p[1].Dirty = 0;
+			PA_PalCopy((u16*)(PAL_SPRITE0 + (screen << 10)), p[1].Shown);
+		}
+
+		// Backgrounds then sprites, each bank is switched once
+		for (n = 2; n < PA_PAL_PER_SCREEN; ) {
+			u16 end = (n < 66) ? 66 : PA_PAL_PER_SCREEN;
+			u8 lcd = 0;
+
+			if (PA_PalExtOn(screen, n)) {
+				for (; n < end; n++) {
+					if (!p[n].Dirty) continue;
+
+					if (!lcd) {
+						PA_PalExtBank(screen, n, 1);
+						lcd = 1;
+					}
+
+					p[n].Dirty = 0;
+					PA_PalCopy(PA_PalExtAddress(screen, n), p[n].Shown);
+				}
+
+				if (lcd) PA_PalExtBank(screen, end - 1, 0);
+			}
+
+			n = end;
+		}
+	}
+}
+
+void PA_PalShadowInit(void) {
+	if (PA_PalShadowOn) return;
+
+	memset(PA_PalShadows, 0, sizeof(PA_PalShadows));
+	PA_PalShadowOn = 1;
+	PaletteVBL = PA_PalShadowUpload;
+}
+
+void PA_PalShadowStop(void) {
+	u16 i;
+
+	PaletteVBL = PA_Nothing;
+	PA_PalShadowOn = 0;
+
+	for (i = 0; i < 2 * PA_PAL_PER_SCREEN; i++) free(PA_PalShadows[i].Base);
+
+	memset(PA_PalShadows, 0, sizeof(PA_PalShadows));
+}
+
+u16* PA_PalShadowGet(u16 pal) {
+	PA_PalShadow *p = PA_PalShadows + pal;
+	u8 screen = pal / PA_PAL_PER_SCREEN;
+	u16 n = pal % PA_PAL_PER_SCREEN;
+
+	PA_Assert(pal < 2 * PA_PAL_PER_SCREEN, "Wrong palette number");
+
+	if (p->Base) return p->Base;
+
+	p->Base = (u16*)malloc(1024);
+	if (p->Base == NULL) return NULL;
+	p->Shown = p->Base + 256;
+
+	// Start from what the hardware has now
+	if (n < 2) {
+		memcpy(p->Base, (void*)(PAL_BG0 + (screen << 10) + (n << 9)), 512);
+	} else if (PA_PalExtOn(screen, n)) {
+		u16 ime = REG_IME;
+		REG_IME = 0; // The VBL upload would switch the bank back
+		PA_PalExtBank(screen, n, 1);
+		PA_PalCopy(p->Base, PA_PalExtAddress(screen, n));
+		PA_PalExtBank(screen, n, 0);
+		REG_IME = ime;
+	} else {
+		memset(p->Base, 0, 512);
+	}
+
+	memcpy(p->Shown, p->Base, 512);
+
+	return p->Base;
+}
+
+void PA_PalShadowUpdate(u16 pal) {
+	PA_PalShadow *p = PA_PalShadows + pal;
+
+	if (p->Base) PA_PalShadowRefresh(p, 0, 256);
+}
+
+void PA_PalShadowLoad(u16 pal, const void *colors) {
+	u16 *base = PA_PalShadowGet(pal);
+
+	if (base == NULL) return;
+
+	memcpy(base, colors, 512);
+	PA_PalShadowRefresh(PA_PalShadows + pal, 0, 256);
+}
+
+void PA_PalShadowSetCol(u16 pal, u8 color_number, u16 color) {
+	u16 *base = PA_PalShadowGet(pal);
+
+	if (base == NULL) return;
+
+	base[color_number] = color;
+	PA_PalShadowRefresh(PA_PalShadows + pal, color_number, 1);
+}
+
+void PA_PalShadowFade(u16 pal, u8 level, u16 color) {
+	PA_PalShadow *p = PA_PalShadows + pal;
+
+	if (PA_PalShadowGet(pal) == NULL) return;
+
+	p->Effect = level ? PA_PALFX_FADE : PA_PALFX_NONE;
+	p->Level = (level > 32) ? 32 : level;
+	p->Color = color;
+	PA_PalShadowRefresh(p, 0, 256);
+}
+
+void PA_PalShadowCrossfade(u16 pal, u8 level, const u16 *target) {
+	PA_PalShadow *p = PA_PalShadows + pal;
+
+	if (PA_PalShadowGet(pal) == NULL) return;
+
+	p->Effect = level ? PA_PALFX_CROSS : PA_PALFX_NONE;
+	p->Level = (level > 32) ? 32 : level;
+	p->Target = target;
+	PA_PalShadowRefresh(p, 0, 256);
+}
+
+void PA_PalShadowScreenFade(u8 screen, u8 level, u16 color) {
+	PA_PalShadow *p = PA_PalShadows + PA_PAL_BG(screen);
+	PA_PalTable table;
+	u16 n;
+
+	if (level > 32) level = 32;
+
+	// The standard palettes are always part of the screen
+	PA_PalShadowGet(PA_PAL_BG(screen));
+	PA_PalShadowGet(PA_PAL_SPRITE(screen));
+
+	PA_PalFadeTable(&table, level, color);
+
+	for (n = 0; n < PA_PAL_PER_SCREEN; n++) {
+		if (p[n].Base == NULL) continue;
+
+		p[n].Effect = level ? PA_PALFX_FADE : PA_PALFX_NONE;
+		p[n].Level = level;
+		p[n].Color = color;
+
+		if (level) PA_PalApplyTable(&table, p[n].Base, p[n].Shown, 256);
+		else memcpy(p[n].Shown, p[n].Base, 512);
+
+		p[n].Dirty = 1;
+	}
+}
@@ -0,0 +1,324 @@
+#include <PA9.h>
+
+//////////////////////////////////////////////////////////////////////
+// Pathfinding on a grid : A* and flow fields share the same search,
+// a binary heap of the cells to look at and a stamp per cell so the
+// arrays are never cleared
+//////////////////////////////////////////////////////////////////////
+
+const s8 PA_PathDX[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+const s8 PA_PathDY[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+#define PA_PATH_DONE  0x80 // In Dir, the cell won't change anymore
+#define PA_PATH_FIRST 0x0F // In Dir, the cell the search started from
+
+static u8 PA_PathSearchInit(PA_PathSearch *s, u32 cells) {
+	memset(s, 0, sizeof(PA_PathSearch));
+
+	s->G = (u32*)malloc(cells * sizeof(u32));
+	s->Stamp = (u16*)calloc(cells, sizeof(u16));
+	s->Dir = (u8*)malloc(cells);
+	s->OpenSize = 256;
+	s->Open = (PA_PathOpen*)malloc(s->OpenSize * sizeof(PA_PathOpen));
+	s->Status = PA_PATH_NONE;
+	s->Search = 1; // The stamps start at 0, so no cell belongs to a search yet
+
+	return s->G && s->Stamp && s->Dir && s->Open;
+}
+
+static void PA_PathSearchFree(PA_PathSearch *s) {
+	free(s->G);
+	free(s->Stamp);
+	free(s->Dir);
+	free(s->Open);
+}
+
+// Binary heap, smallest F on top. A cell can be in it more than once, the
+// old copies are skipped when they come out.
+static u8 PA_PathPush(PA_PathSearch *s, u32 f, u32 cell) {
+	u32 i = s->OpenCount++;
+
+	if (i == s->OpenSize) {
+		PA_PathOpen *open = (PA_PathOpen*)realloc(s->Open, 2 * s->OpenSize * sizeof(PA_PathOpen));
+
+		if (open == NULL) {
+			s->OpenCount--;
+			return 0;
+		}
+
+		s->Open = open;
+		s->OpenSize *= 2;
+	}
+
+	while (i) {
+		u32 parent = (i - 1) >> 1;
+
+		if (s->Open[parent].F <= f) break;
+
+		s->Open[i] = s->Open[parent];
+		i = parent;
+	}
+
+	s->Open[i].F = f;
+	s->Open[i].Cell = cell;
+
+	return 1;
+}
+
+static u32 PA_PathPop(PA_PathSearch *s) {
+	PA_PathOpen *open = s->Open;
+	u32 cell = open[0].Cell;
+	PA_PathOpen last = open[--s->OpenCount];
+	u32 i = 0, child;
+
+	while ((child = (i << 1) + 1) < s->OpenCount) {
+		if ((child + 1 < s->OpenCount) && (open[child + 1].F < open[child].F)) child++;
+		if (open[child].F >= last.F) break;
+
+		open[i] = open[child];
+		i = child;
+	}
+
+	open[i] = last;
+
+	return cell;
+}
+
+static void PA_PathBegin(PA_PathSearch *s, u32 cells, u32 first, u32 f) {
+	if (++s->Search == 0) { // Stamps went around, start them again
+		memset(s->Stamp, 0, cells * sizeof(u16));
+		s->Search = 1;
+	}
+
+	s->OpenCount = 0;
+	s->Stamp[first] = s->Search;
+	s->G[first] = 0;
+	s->Dir[first] = PA_PATH_FIRST;
+	PA_PathPush(s, f, first);
+	s->Status = PA_PATH_SEARCHING;
+}
+
+// Octile distance, never more than the real cost since cells cost 1 or more
+static inline u32 PA_PathGuess(PA_PathGrid *grid, u32 cell, u32 goal) {
+	s32 dx = (s32)(cell % grid->Width) - (s32)(goal % grid->Width);
+	s32 dy = (s32)(cell / grid->Width) - (s32)(goal / grid->Width);
+
+	if (dx < 0) dx = -dx;
+	if (dy < 0) dy = -dy;
+
+	if (!grid->Diagonals) return PA_PATH_STRAIGHT * (dx + dy);
+	if (dx < dy) return PA_PATH_STRAIGHT * dy + (PA_PATH_DIAGONAL - PA_PATH_STRAIGHT) * dx;
+
+	return PA_PATH_STRAIGHT * dx + (PA_PATH_DIAGONAL - PA_PATH_STRAIGHT) * dy;
+}
+
+// Look at budget cells at most. A* goes from the start and stops at the goal,
+// flow fields (flow = 1) go from the goal to every cell, the cost being the
+// one of the cell walked from.
+static s8 PA_PathRun(PA_PathGrid *grid, PA_PathSearch *s, u32 budget, u8 flow) {
+	const u8 *cost = grid->Cost;
+	s32 width = grid->Width, height = grid->Height;
+	u8 dirs = grid->Diagonals ? 1 : 2;
+	s32 offset[8];
+	u32 done = 0;
+	u8 d;
+
+	if (s->Status != PA_PATH_SEARCHING) return s->Status;
+
+	for (d = 0; d < 8; d++) offset[d] = PA_PathDY[d] * width + PA_PathDX[d];
+
+	while (s->OpenCount) {
+		u32 cell, g;
+		s32 x, y;
+
+		if (budget && (done == budget)) break;
+
+		cell = PA_PathPop(s);
+		if (s->Dir[cell] & PA_PATH_DONE) continue; // Older copy
+
+		s->Dir[cell] |= PA_PATH_DONE;
+		done++;
+
+		if (!flow && (cell == s->Goal)) {
+			s->Status = PA_PATH_FOUND;
+			return PA_PATH_FOUND;
+		}
+
+		g = s->G[cell];
+		x = cell % width;
+		y = cell / width;
+
+		for (d = 0; d < 8; d += dirs) {
+			s32 nx = x + PA_PathDX[d], ny = y + PA_PathDY[d];
+			u32 next = cell + offset[d], ng;
+
+			if ((nx < 0) || (ny < 0) || (nx >= width) || (ny >= height) || (cost[next] == PA_PATH_WALL)) continue;
+
+			if (d & 1) { // Diagonals don't cut corners
+				if ((cost[cell + PA_PathDX[d]] == PA_PATH_WALL) || (cost[cell + PA_PathDY[d] * width] == PA_PATH_WALL)) continue;
+				ng = g + PA_PATH_DIAGONAL * cost[flow ? cell : next];
+			} else {
+				ng = g + PA_PATH_STRAIGHT * cost[flow ? cell : next];
+			}
+
+			if (s->Stamp[next] == s->Search) {
+				if ((s->Dir[next] & PA_PATH_DONE) || (s->G[next] <= ng)) continue;
+			} else {
+				s->Stamp[next] = s->Search;
+			}
+
+			s->G[next] = ng;
+			s->Dir[next] = flow ? ((d + 4) & 7) : d; // Flow fields keep the way back to the goal
+
+			if (!PA_PathPush(s, flow ? ng : ng + PA_PathGuess(grid, next, s->Goal), next)) {
+				s->Status = PA_PATH_NONE;
+				return PA_PATH_NONE;
+			}
+		}
+	}
+
+	if (s->OpenCount == 0) s->Status = flow ? PA_PATH_FOUND : PA_PATH_NONE;
+
+	return s->Status;
+}
+
+PA_PathGrid* PA_PathCreate(u16 width, u16 height, u8 diagonals) {
+	u32 cells = width * height;
+	PA_PathGrid *grid = (PA_PathGrid*)malloc(sizeof(PA_PathGrid));
+
+	if (grid == NULL) return NULL;
+
+	grid->Width = width;
+	grid->Height = height;
+	grid->Diagonals = diagonals;
+	grid->Cost = (u8*)malloc(cells);
+
+	if (!PA_PathSearchInit(&grid->Astar, cells) || (grid->Cost == NULL)) {
+		PA_PathDelete(grid);
+		return NULL;
+	}
+
+	memset(grid->Cost, 1, cells);
+
+	return grid;
+}
+
+void PA_PathDelete(PA_PathGrid *grid) {
+	if (grid == NULL) return;
+
+	PA_PathSearchFree(&grid->Astar);
+	free(grid->Cost);
+	free(grid);
+}
+
+s8 PA_PathStart(PA_PathGrid *grid, u16 startx, u16 starty, u16 goalx, u16 goaly) {
+	PA_PathSearch *s = &grid->Astar;
+
+	PA_Assert((startx < grid->Width) && (starty < grid->Height) && (goalx < grid->Width) && (goaly < grid->Height), "Path outside of the grid");
+
+	s->Start = starty * grid->Width + startx;
+	s->Goal = goaly * grid->Width + goalx;
+
+	if ((grid->Cost[s->Start] == PA_PATH_WALL) || (grid->Cost[s->Goal] == PA_PATH_WALL)) {
+		s->Status = PA_PATH_NONE;
+		return PA_PATH_NONE;
+	}
+
+	PA_PathBegin(s, grid->Width * grid->Height, s->Start, PA_PathGuess(grid, s->Start, s->Goal));
+
+	return PA_PATH_SEARCHING;
+}
+
+s8 PA_PathStep(PA_PathGrid *grid, u32 budget) {
+	return PA_PathRun(grid, &grid->Astar, budget, 0);
+}
+
+u32 PA_PathGet(PA_PathGrid *grid, PA_PathPoint *points, u32 max) {
+	PA_PathSearch *s = &grid->Astar;
+	u32 length = 1, cell, i;
+
+	if (s->Status != PA_PATH_FOUND) return 0;
+
+	// Walk back from the goal once to count the cells, then to fill them in
+	for (cell = s->Goal; cell != s->Start; length++) {
+		u8 d = s->Dir[cell] & 7;
+		cell -= PA_PathDY[d] * grid->Width + PA_PathDX[d];
+	}
+
+	if (points == NULL) return length;
+
+	for (cell = s->Goal, i = length; i > 0; i--) {
+		u8 d = s->Dir[cell] & 7;
+
+		if (i <= max) {
+			points[i - 1].x = cell % grid->Width;
+			points[i - 1].y = cell / grid->Width;
+		}
+
+		cell -= PA_PathDY[d] * grid->Width + PA_PathDX[d];
+	}
+
+	return length;
+}
+
+PA_PathField* PA_PathFieldCreate(PA_PathGrid *grid) {
+	PA_PathField *field = (PA_PathField*)malloc(sizeof(PA_PathField));
+
+	if (field == NULL) return NULL;
+
+	field->Grid = grid;
+
+	if (!PA_PathSearchInit(&field->Flow, grid->Width * grid->Height)) {
+		PA_PathFieldDelete(field);
+		return NULL;
+	}
+
+	return field;
+}
+
+void PA_PathFieldDelete(PA_PathField *field) {
+	if (field == NULL) return;
+
+	PA_PathSearchFree(&field->Flow);
+	free(field);
+}
+
+s8 PA_PathFieldStart(PA_PathField *field, u16 goalx, u16 goaly) {
+	PA_PathGrid *grid = field->Grid;
+	PA_PathSearch *s = &field->Flow;
+
+	PA_Assert((goalx < grid->Width) && (goaly < grid->Height), "Goal outside of the grid");
+
+	s->Goal = s->Start = goaly * grid->Width + goalx;
+
+	if (grid->Cost[s->Goal] == PA_PATH_WALL) {
+		s->Status = PA_PATH_NONE;
+		return PA_PATH_NONE;
+	}
+
+	PA_PathBegin(s, grid->Width * grid->Height, s->Goal, 0);
+
+	return PA_PATH_SEARCHING;
+}
+
+s8 PA_PathFieldStep(PA_PathField *field, u32 budget) {
+	return PA_PathRun(field->Grid, &field->Flow, budget, 1);
+}
+
+u8 PA_PathFieldDir(PA_PathField *field, u16 x, u16 y) {
+	PA_PathSearch *s = &field->Flow;
+	u32 cell = y * field->Grid->Width + x;
+
+	if ((s->Stamp[cell] != s->Search) || !(s->Dir[cell] & PA_PATH_DONE) || (cell == s->Goal)) return PA_PATH_NODIR;
+
+	return s->Dir[cell] & 7;
+}
+
+u32 PA_PathFieldCost(PA_PathField *field, u16 x, u16 y) {
+	PA_PathSearch *s = &field->Flow;
+	u32 cell = y * field->Grid->Width + x;
+
+	if ((s->Stamp[cell] != s->Search) || !(s->Dir[cell] & PA_PATH_DONE)) return 0xFFFFFFFF;
+
+	return s->G[cell];
+}
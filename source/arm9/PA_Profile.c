@@ -0,0 +1,299 @@
+#include <PA9.h>
+
+//////////////////////////////////////////////////////////////////////
+// Frame profiler : two cascaded timers at the bus clock, zones counted
+// once however deep they nest, and a ring buffer of starts and ends
+//////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	u32 Time;
+	u8 Zone;
+	u8 Type; // Bit 0 : end, bit 1 : in the VBL
+} PA_ProfileEvent;
+
+u8 PA_ProfileOn;
+PA_ProfileZoneInfo PA_ProfileZones[PA_PROFILE_ZONES] = {
+	{"VBL"}, {"OAM"}, {"Upload"}, {"3D"}, {"Text"}, {"GIF"}, {"JPEG"}
+};
+u32 PA_ProfileBusyTicks;
+
+static u8 pa_profiletimer;
+static u32 pa_profileticks[PA_PROFILE_ZONES]; // This frame
+static u16 pa_profilecalls[PA_PROFILE_ZONES];
+
+// Main code and VBL, each its own stack
+static u8 pa_profileopen[2][PA_PROFILE_ZONES]; // Started and not ended, the time counts from the first
+static u32 pa_profilestart[2][PA_PROFILE_ZONES];
+static u32 pa_profileirqstart[PA_PROFILE_ZONES]; // Main code only
+static u8 pa_profilestack[2][PA_PROFILE_DEPTH]; // PA_PROFILE_ZONES for a zone that had no number
+static u8 pa_profiledepth[2], pa_profileskipped[2];
+static u8 pa_profilevbl; // In the VBL
+static u32 pa_profileirq; // Ticks spent in the VBL, taken off the zones it interrupts
+static u32 pa_profileframe; // Start of the frame
+static u32 pa_profileidle; // When the main code started waiting for the VBL
+static u8 pa_profileidled;
+
+static PA_ProfileEvent *pa_profileevents;
+static u16 pa_profilemaxevents, pa_profilenext, pa_profilecount;
+
+static FILE *pa_profilefile;
+
+// The high half is read twice, in case the low half carried in between
+static inline u32 PA_ProfileTicks(void) {
+	u16 high = TIMER_DATA(pa_profiletimer + 1);
+	u16 low = TIMER_DATA(pa_profiletimer);
+	u16 high2 = TIMER_DATA(pa_profiletimer + 1);
+
+	if (high != high2) low = TIMER_DATA(pa_profiletimer);
+	return (high2 << 16) | low;
+}
+
+static inline void PA_ProfileRecord(u32 time, u8 zone, u8 type) {
+	PA_ProfileEvent *event;
+
+	if (!pa_profilemaxevents) return;
+
+	event = pa_profileevents + pa_profilenext;
+	event->Time = time;
+	event->Zone = zone;
+	event->Type = type;
+	if (++pa_profilenext == pa_profilemaxevents) pa_profilenext = 0;
+	if (pa_profilecount < pa_profilemaxevents) pa_profilecount++;
+}
+
+// At each VBL, the ticks of the frame that ended
+static void PA_ProfileNewFrame(u32 now) {
+	u8 i;
+
+	for (i = 0; i < PA_PROFILE_ZONES; i++) {
+		PA_ProfileZones[i].Ticks = pa_profileticks[i];
+		PA_ProfileZones[i].Calls = pa_profilecalls[i];
+		if (pa_profileticks[i] > PA_ProfileZones[i].Max) PA_ProfileZones[i].Max = pa_profileticks[i];
+		pa_profileticks[i] = 0;
+		pa_profilecalls[i] = 0;
+	}
+
+	// Without a wait, the main code took the whole frame
+	PA_ProfileBusyTicks = (pa_profileidled ? pa_profileidle : now) - pa_profileframe;
+	pa_profileframe = now;
+	pa_profileidled = 0;
+}
+
+u8 PA_ProfileStart(u8 timer, u16 events) {
+	u8 i;
+
+	PA_Assert((timer == 0) || (timer == 2), "The profiler uses timers 0 and 1 or 2 and 3");
+	if ((timer != 0) && (timer != 2)) return 0;
+
+	PA_ProfileStop();
+
+	if (events) {
+		pa_profileevents = (PA_ProfileEvent*)malloc(events * sizeof(PA_ProfileEvent));
+		if (pa_profileevents == NULL) return 0;
+	}
+	pa_profilemaxevents = events;
+	pa_profilenext = pa_profilecount = 0;
+
+	for (i = 0; i < PA_PROFILE_ZONES; i++) {
+		PA_ProfileZones[i].Ticks = PA_ProfileZones[i].Max = 0;
+		PA_ProfileZones[i].Calls = 0;
+		pa_profileticks[i] = pa_profilecalls[i] = 0;
+		pa_profileopen[0][i] = pa_profileopen[1][i] = 0;
+	}
+	pa_profiledepth[0] = pa_profiledepth[1] = 0;
+	pa_profileskipped[0] = pa_profileskipped[1] = 0;
+	pa_profilevbl = 0;
+	pa_profileirq = 0;
+	pa_profileidled = 0;
+
+	// The second timer counts the overflows of the first, at the bus clock
+	pa_profiletimer = timer;
+	TIMER_CR(timer) = 0;
+	TIMER_CR(timer + 1) = 0;
+	TIMER_DATA(timer) = 0;
+	TIMER_DATA(timer + 1) = 0;
+	TIMER_CR(timer + 1) = TIMER_CASCADE | TIMER_ENABLE;
+	TIMER_CR(timer) = TIMER_DIV_1 | TIMER_ENABLE;
+
+	pa_profileframe = PA_ProfileTicks();
+	PA_ProfileOn = 1;
+
+	return 1;
+}
+
+void PA_ProfileStop(void) {
+	if (!PA_ProfileOn && (pa_profileevents == NULL)) return;
+
+	PA_ProfileOn = 0;
+	TIMER_CR(pa_profiletimer) = 0;
+	TIMER_CR(pa_profiletimer + 1) = 0;
+
+	free(pa_profileevents);
+	pa_profileevents = NULL;
+	pa_profilemaxevents = 0;
+}
+
+u8 PA_ProfileZone(const char *name) {
+	u8 i;
+
+	for (i = 0; (i < PA_PROFILE_ZONES) && PA_ProfileZones[i].Name; i++)
+		if ((PA_ProfileZones[i].Name == name) || (strcmp(PA_ProfileZones[i].Name, name) == 0)) return i;
+
+	if (i < PA_PROFILE_ZONES) PA_ProfileZones[i].Name = name;
+	return i;
+}
+
+void PA_ProfilePush(u8 zone) {
+	u16 ime = REG_IME;
+	u32 now;
+	u8 vbl;
+
+	REG_IME = 0;
+	now = PA_ProfileTicks();
+
+	if (zone == PA_PROFILE_VBL) {
+		PA_ProfileNewFrame(now);
+		pa_profilevbl = 1;
+	}
+	vbl = pa_profilevbl;
+
+	if (pa_profiledepth[vbl] == PA_PROFILE_DEPTH) { // Too deep, ended without being counted
+		pa_profileskipped[vbl]++;
+		REG_IME = ime;
+		return;
+	}
+	if (zone >= PA_PROFILE_ZONES) zone = PA_PROFILE_ZONES; // No zones left : kept so that its end matches
+	pa_profilestack[vbl][pa_profiledepth[vbl]++] = zone;
+	if (zone == PA_PROFILE_ZONES) {
+		REG_IME = ime;
+		return;
+	}
+
+	if (pa_profileopen[vbl][zone]++ == 0) {
+		pa_profilestart[vbl][zone] = now;
+		if (!vbl) pa_profileirqstart[zone] = pa_profileirq;
+	}
+	pa_profilecalls[zone]++;
+	PA_ProfileRecord(now, zone, vbl << 1);
+
+	REG_IME = ime;
+}
+
+void PA_ProfilePop(void) {
+	u16 ime = REG_IME;
+	u32 now, ticks;
+	u8 vbl, zone;
+
+	REG_IME = 0;
+	now = PA_ProfileTicks();
+	vbl = pa_profilevbl;
+
+	if (pa_profileskipped[vbl]) {
+		pa_profileskipped[vbl]--;
+		REG_IME = ime;
+		return;
+	}
+	if (pa_profiledepth[vbl] == 0) { // Started before PA_ProfileStart
+		REG_IME = ime;
+		return;
+	}
+	zone = pa_profilestack[vbl][--pa_profiledepth[vbl]];
+	if (zone == PA_PROFILE_ZONES) {
+		REG_IME = ime;
+		return;
+	}
+
+	if (--pa_profileopen[vbl][zone] == 0) {
+		ticks = now - pa_profilestart[vbl][zone];
+		if (!vbl) ticks -= pa_profileirq - pa_profileirqstart[zone];
+		pa_profileticks[zone] += ticks;
+	}
+	PA_ProfileRecord(now, zone, 1 | (vbl << 1));
+
+	if (zone == PA_PROFILE_VBL) {
+		pa_profileirq += now - pa_profilestart[1][zone];
+		pa_profilevbl = 0;
+	}
+
+	REG_IME = ime;
+}
+
+void PA_ProfileIdle(void) {
+	u16 ime = REG_IME;
+
+	REG_IME = 0;
+	if (!pa_profileidled && !pa_profilevbl) { // The first wait of the frame
+		pa_profileidle = PA_ProfileTicks();
+		pa_profileidled = 1;
+	}
+	REG_IME = ime;
+}
+
+void PA_ProfileShowBars(u8 screen, u16 y) {
+	char bar[20]; // 7 + 19 + 6 characters, a line of text
+	u8 i, j;
+
+	PA_OutputText(screen, 0, y++, "Busy %3d%%  VBL %3d%% of vblank   ",
+	              (s32)(((u64)PA_ProfileBusyTicks * 100) / PA_PROFILE_FRAME),
+	              (s32)(((u64)PA_ProfileZones[PA_PROFILE_VBL].Ticks * 100) / PA_PROFILE_VBLANK));
+
+	for (i = 0; i < PA_PROFILE_ZONES; i++) {
+		u32 share;
+
+		if (!PA_ProfileZones[i].Name || !PA_ProfileZones[i].Max) continue;
+
+		share = ((u64)PA_ProfileZones[i].Ticks * 1000) / PA_PROFILE_FRAME; // Tenths of a percent
+		for (j = 0; j < 19; j++) bar[j] = (share * 19 >= (u32)(j + 1) * 1000 - 500) ? '#' : '.';
+		bar[19] = 0;
+
+		PA_OutputText(screen, 0, y++, "%-7.7s%s%3d.%d%%", PA_ProfileZones[i].Name, bar, share / 10, share % 10);
+	}
+}
+
+void PA_ProfileDump(void (*output)(const char *line)) {
+	char line[96];
+	u8 depth[2] = {0, 0}, on = PA_ProfileOn;
+	u16 i, n;
+
+	PA_ProfileOn = 0; // Nothing added while reading
+
+	output("[");
+	n = (pa_profilenext + pa_profilemaxevents - pa_profilecount) % (pa_profilemaxevents ? pa_profilemaxevents : 1);
+	for (i = 0; i < pa_profilecount; i++, n = (n + 1 == pa_profilemaxevents) ? 0 : n + 1) {
+		const PA_ProfileEvent *event = pa_profileevents + n;
+		u8 vbl = event->Type >> 1, end = event->Type & 1;
+		u64 ns = ((u64)event->Time * 1000000000) / PA_PROFILE_HZ;
+
+		// The oldest ends may have lost their start
+		if (end) {
+			if (depth[vbl] == 0) continue;
+			depth[vbl]--;
+		}
+		else depth[vbl]++;
+
+		PA_Format(line, sizeof(line), "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%u.%03u,\"pid\":1,\"tid\":%d},",
+		          PA_ProfileZones[event->Zone].Name, end ? 'E' : 'B', (u32)(ns / 1000), (u32)(ns % 1000), vbl + 1);
+		output(line);
+	}
+	output("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Main\"}},");
+	output("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"VBL\"}}");
+	output("]");
+
+	PA_ProfileOn = on;
+}
+
+static void PA_ProfileFileLine(const char *line) {
+	fputs(line, pa_profilefile);
+	fputc('\n', pa_profilefile);
+}
+
+u8 PA_ProfileSave(const char *filename) {
+	pa_profilefile = fopen(filename, "w");
+	if (pa_profilefile == NULL) return 0;
+
+	PA_ProfileDump(PA_ProfileFileLine);
+	fclose(pa_profilefile);
+	pa_profilefile = NULL;
+
+	return 1;
+}
@@ -0,0 +1,233 @@
+#include <PA9.h>
+
+//////////////////////////////////////////////////////////////////////
+// Raster effects : registers and palettes changed at each scanline
+//////////////////////////////////////////////////////////////////////
+
+PA_RasterEffect PA_RasterEffects[PA_RASTER_MAX];
+
+static PA_RasterGroup PA_RasterGroups[PA_RASTER_MAX];
+static u8 PA_RasterOrder[PA_RASTER_MAX]; // Effects sorted by destination
+static u8 PA_RasterGroupCount = 0;
+static u8 PA_RasterCpuCount = 0;         // Groups written by the interrupt, they come last
+static u8 PA_RasterHBLOn = 0;
+
+static inline void PA_RasterCopy(u8 *dest, const u8 *src, u16 size) {
+	if ((((u32)dest | (u32)src | size) & 3) == 0) {
+		vu32 *d = (vu32*)dest;
+		const u32 *s = (const u32*)src;
+		for (size >>= 2; size; size--) *d++ = *s++;
+	} else { // Registers, VRAM and palettes can't be written by bytes
+		vu16 *d = (vu16*)dest;
+		const u16 *s = (const u16*)src;
+		for (size >>= 1; size; size--) *d++ = *s++;
+	}
+}
+
+// Lines 1 to 191 of the groups that didn't get a DMA channel, line 0 is written at the VBL
+static void PA_RasterHBL(void) {
+	s32 line = PA_GetVcount() + 1; // Line about to be drawn
+	u8 i;
+
+	if ((line < 1) || (line >= PA_RASTER_LINES)) return;
+
+	for (i = PA_RasterGroupCount - PA_RasterCpuCount; i < PA_RasterGroupCount; i++) {
+		PA_RasterGroup *g = PA_RasterGroups + i;
+		if (g->Table) PA_RasterCopy(g->Dest, g->Table + line * g->Size, g->Size);
+	}
+}
+
+static void PA_RasterStopDMA(void) {
+	u8 i;
+
+	for (i = 0; i < PA_RASTER_CHANNELS; i++) DMA_CR(PA_RASTER_DMA + i) = 0;
+}
+
+// Sort the effects, merge the ones that follow each other and give the DMA
+// channels to the biggest groups. Called with the interrupts off.
+static u8 PA_RasterPlan(void) {
+	u8 count = 0, i, j;
+	u8 ok = 1;
+
+	PA_RasterStopDMA();
+
+	for (i = 0; i < PA_RasterGroupCount; i++) free(PA_RasterGroups[i].Merged);
+	PA_RasterGroupCount = 0;
+	PA_RasterCpuCount = 0;
+
+	for (i = 0; i < PA_RASTER_MAX; i++) {
+		if (PA_RasterEffects[i].Dest == NULL) continue;
+
+		for (j = count; (j > 0) && (PA_RasterEffects[PA_RasterOrder[j - 1]].Dest > PA_RasterEffects[i].Dest); j--)
+			PA_RasterOrder[j] = PA_RasterOrder[j - 1];
+
+		PA_RasterOrder[j] = i;
+		count++;
+	}
+
+	for (i = 0; i < count; i++) {
+		PA_RasterEffect *e = PA_RasterEffects + PA_RasterOrder[i];
+		PA_RasterGroup *g = PA_RasterGroups + PA_RasterGroupCount - 1;
+
+		if (PA_RasterGroupCount && (g->Dest + g->Size == e->Dest) && (g->Size + e->Size <= PA_RASTER_MERGE)) {
+			g->Size += e->Size;
+			g->Count++;
+			continue;
+		}
+
+		g = PA_RasterGroups + PA_RasterGroupCount++;
+		g->Dest = e->Dest;
+		g->Table = e->Table;
+		g->Merged = NULL;
+		g->Size = e->Size;
+		g->First = i;
+		g->Count = 1;
+	}
+
+	// Biggest groups first, they cost the most to copy with the CPU
+	for (i = 1; i < PA_RasterGroupCount; i++) {
+		PA_RasterGroup g = PA_RasterGroups[i];
+
+		for (j = i; (j > 0) && (PA_RasterGroups[j - 1].Size < g.Size); j--)
+			PA_RasterGroups[j] = PA_RasterGroups[j - 1];
+
+		PA_RasterGroups[j] = g;
+	}
+
+	for (i = 0; i < PA_RasterGroupCount; i++)
+		PA_RasterGroups[i].Channel = (i < PA_RASTER_CHANNELS) ? PA_RASTER_DMA + i : PA_RASTER_CPU;
+
+	// The DMA reads one line after the last one, so a single effect of a DMA
+	// channel is copied too, its table only has 192 lines
+	for (i = 0; i < PA_RasterGroupCount; i++) {
+		PA_RasterGroup *g = PA_RasterGroups + i;
+
+		if ((g->Count > 1) || (g->Channel != PA_RASTER_CPU)) {
+			g->Table = NULL; // Until the VBL copies the lines
+			g->Merged = (u8*)malloc((PA_RASTER_LINES + 1) * g->Size);
+			if (g->Merged == NULL) ok = 0;
+		}
+	}
+
+	PA_RasterCpuCount = (PA_RasterGroupCount > PA_RASTER_CHANNELS) ? PA_RasterGroupCount - PA_RASTER_CHANNELS : 0;
+
+	if (PA_RasterCpuCount) {
+		irqSet(IRQ_HBLANK, PA_RasterHBL);
+		irqEnable(IRQ_HBLANK);
+		PA_RasterHBLOn = 1;
+	} else if (PA_RasterHBLOn) {
+		irqDisable(IRQ_HBLANK);
+		PA_RasterHBLOn = 0;
+	}
+
+	RasterVBL = PA_RasterGroupCount ? PA_RasterVBL : PA_Nothing;
+
+	return ok;
+}
+
+void PA_RasterVBL(void) {
+	u32 total = 0;
+	u8 i, j;
+
+	PA_RasterStopDMA(); // The last line read the table once more, start again from line 1
+
+	for (i = 0; i < PA_RASTER_MAX; i++) {
+		PA_RasterEffect *e = PA_RasterEffects + i;
+
+		if (e->Dest == NULL) continue;
+
+		if (e->NextTable) {
+			e->Table = e->NextTable;
+			e->NextTable = NULL;
+		}
+
+		if (e->Prepare) e->Prepare();
+	}
+
+	for (i = 0; i < PA_RasterGroupCount; i++) {
+		PA_RasterGroup *g = PA_RasterGroups + i;
+
+		if (g->Merged) { // Lines of each effect side by side
+			u8 *line = g->Merged;
+			s32 y;
+
+			for (y = 0; y < PA_RASTER_LINES; y++) {
+				for (j = g->First; j < g->First + g->Count; j++) {
+					PA_RasterEffect *e = PA_RasterEffects + PA_RasterOrder[j];
+					memcpy(line, e->Table + y * e->Size, e->Size);
+					line += e->Size;
+				}
+			}
+
+			memcpy(line, line - g->Size, g->Size); // Read after the last line
+			g->Table = g->Merged;
+		} else {
+			g->Table = PA_RasterEffects[PA_RasterOrder[g->First]].Table;
+		}
+
+		if (g->Channel != PA_RASTER_CPU) total += PA_RASTER_LINES * g->Size;
+	}
+
+	// The DMA reads the main RAM, not the cache
+	if (total > 16384) {
+		DC_FlushAll();
+	} else {
+		for (i = 0; i < PA_RasterGroupCount; i++)
+			if (PA_RasterGroups[i].Channel != PA_RASTER_CPU)
+				DC_FlushRange((void*)PA_RasterGroups[i].Table, (PA_RASTER_LINES + 1) * PA_RasterGroups[i].Size);
+	}
+
+	for (i = 0; i < PA_RasterGroupCount; i++) {
+		PA_RasterGroup *g = PA_RasterGroups + i;
+
+		PA_RasterCopy(g->Dest, g->Table, g->Size); // Line 0
+
+		if (g->Channel != PA_RASTER_CPU) {
+			// Each HBlank copies the next line to the same place
+			u8 words = ((((u32)g->Dest | (u32)g->Table | g->Size) & 3) == 0);
+
+			dmaSetParams(g->Channel, g->Table + g->Size, g->Dest,
+				DMA_ENABLE | DMA_REPEAT | DMA_START_HBL | DMA_DST_RESET |
+				(words ? (DMA_32_BIT | (g->Size >> 2)) : (DMA_16_BIT | (g->Size >> 1))));
+		}
+	}
+}
+
+s8 PA_RasterAdd(volatile void *dest, const void *table, u16 size, funcpointer prepare) {
+	u16 ime = REG_IME;
+	s8 i;
+
+	PA_Assert((size & 1) == 0, "Raster effects need a size multiple of 2");
+
+	for (i = 0; (i < PA_RASTER_MAX) && PA_RasterEffects[i].Dest; i++);
+
+	if (i == PA_RASTER_MAX) return -1;
+
+	REG_IME = 0; // The VBL and HBL use the groups
+	PA_RasterEffects[i].Dest = (u8*)dest;
+	PA_RasterEffects[i].Table = (const u8*)table;
+	PA_RasterEffects[i].NextTable = NULL;
+	PA_RasterEffects[i].Size = size;
+	PA_RasterEffects[i].Prepare = prepare;
+
+	if (!PA_RasterPlan()) { // Not enough memory to merge it
+		PA_RasterEffects[i].Dest = NULL;
+		PA_RasterPlan();
+		i = -1;
+	}
+
+	REG_IME = ime;
+
+	return i;
+}
+
+void PA_RasterRemove(s8 effect) {
+	u16 ime = REG_IME;
+
+	if ((effect < 0) || (PA_RasterEffects[effect].Dest == NULL)) return;
+
+	REG_IME = 0;
+	PA_RasterEffects[effect].Dest = NULL;
+	PA_RasterPlan();
+	REG_IME = ime;
+}
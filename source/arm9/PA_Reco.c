@@ -1,15 +1,16 @@
 #include <PA9.h>
 
-PA_StylusPosition PA_StylusPos[20000];
-
 PA_RecoValues PA_Reco;
+PA_RecoPath PA_RecoPts;
 
 char PA_RecoShape[16];
 
 u8 PA_UseGraffiti = true;
+s32 PA_RecoStrokeDelay = 0; // Frames to wait for another stroke, 0 for single strokes
 
-u8 PA_CustomReco = 0; // number of custom shapes
-PA_FormType PA_CustomShape[200];
+u16 PA_CustomReco = 0; // number of custom shapes
+PA_FormType *PA_CustomShape = NULL;
+static u16 PA_CustomSpace = 0;
 
 PA_RecoInfos PA_RecoInfo;
 
@@ -49,11 +50,36 @@ PA_FormType PA_Graffiti[PA_RECOTESTS] = {
 
 
 
-static void PA_AddStylusPos(u8 x, u8 y) {
-	if (!((x == PA_StylusPos[PA_Reco.nvalues-1].x) && (y == PA_StylusPos[PA_Reco.nvalues-1].y))) {
-		PA_StylusPos[PA_Reco.nvalues].x = x;
-		PA_StylusPos[PA_Reco.nvalues].y = y;
-		PA_Reco.nvalues++;
+
+
+//////////////////////////////////////////////////////////////////////
+// The drawing is kept as PA_RECO_POINTS points evenly spaced along the
+// path : when they are all used, every other point is dropped and the
+// spacing doubles, so a drawing of any length takes the same memory.
+//////////////////////////////////////////////////////////////////////
+
+static inline void PA_AddStylusPos(u8 x, u8 y) {
+	u32 n = PA_Reco.nvalues; // Position of this pixel along the path
+
+	if ((x == PA_RecoPts.X) && (y == PA_RecoPts.Y)) return;
+
+	PA_RecoPts.X = x;
+	PA_RecoPts.Y = y;
+	PA_Reco.nvalues++;
+
+	if (n != (u32)PA_RecoPts.Count * PA_RecoPts.Step) return;
+
+	PA_RecoPts.Points[PA_RecoPts.Count].x = x;
+	PA_RecoPts.Points[PA_RecoPts.Count].y = y;
+	PA_RecoPts.Count++;
+
+	if (PA_RecoPts.Count == PA_RECO_POINTS) {
+		s32 i;
+
+		for (i = 1; i < PA_RECO_POINTS / 2; i++) PA_RecoPts.Points[i] = PA_RecoPts.Points[i << 1];
+
+		PA_RecoPts.Count = PA_RECO_POINTS / 2;
+		PA_RecoPts.Step <<= 1;
 	}
 }
 
@@ -111,9 +137,339 @@ void PA_StylusLine(u8 x1, u8 y1, u8 x2, u8 y2) {
 	}
 }
 
+void PA_RecoStart(u8 x, u8 y) {
+	PA_Reco.nvalues = 0;
+	PA_RecoPts.Count = 0;
+	PA_RecoPts.Step = 1;
+	PA_RecoPts.Strokes = 1;
+	PA_RecoPts.X = ~x; // Not the same pixel
+	PA_AddStylusPos(x, y);
+
+	PA_Reco.oldn = PA_Reco.veryold = 1;
+	PA_RecoPts.OldX = PA_RecoPts.VeryOldX = x;
+	PA_RecoPts.OldY = PA_RecoPts.VeryOldY = y;
+
+	PA_RecoInfo.startX = x; // start values
+	PA_RecoInfo.startY = y;
+}
+
+void PA_RecoNextStroke(u8 x, u8 y) {
+	PA_StylusLine(PA_RecoPts.X, PA_RecoPts.Y, x, y); // The jump is part of the shape
+	PA_RecoPts.Strokes++;
+}
+
+void PA_RecoEndFrame(void) {
+	PA_Reco.veryold = PA_Reco.oldn;
+	PA_RecoPts.VeryOldX = PA_RecoPts.OldX;
+	PA_RecoPts.VeryOldY = PA_RecoPts.OldY;
+	PA_Reco.oldn = PA_Reco.nvalues;
+	PA_RecoPts.OldX = PA_RecoPts.X;
+	PA_RecoPts.OldY = PA_RecoPts.Y;
+}
+
+void PA_RecoEndStroke(void) {
+	u32 last;
+
+	// The last frame often moves when the stylus is lifted
+	PA_Reco.nvalues = PA_Reco.veryold;
+	PA_RecoPts.X = PA_RecoPts.VeryOldX;
+	PA_RecoPts.Y = PA_RecoPts.VeryOldY;
+
+	last = (PA_Reco.nvalues - 1) / PA_RecoPts.Step + 1;
+	if (PA_RecoPts.Count > last) PA_RecoPts.Count = last;
+
+	PA_Reco.oldn = PA_Reco.nvalues;
+	PA_RecoPts.OldX = PA_RecoPts.X;
+	PA_RecoPts.OldY = PA_RecoPts.Y;
+}
+
+// Pixel n of the path, between the points that were kept
+static PA_StylusPosition PA_RecoPointAt(u32 n) {
+	PA_StylusPosition p, a, b;
+	u32 end = PA_Reco.nvalues - 1;
+	u32 k = n / PA_RecoPts.Step;
+	s32 pos, span;
+
+	if (k + 1 < PA_RecoPts.Count) { // Between 2 kept points
+		a = PA_RecoPts.Points[k];
+		b = PA_RecoPts.Points[k + 1];
+		pos = n - k * PA_RecoPts.Step;
+		span = PA_RecoPts.Step;
+	} else { // Between the last kept point and the end
+		k = PA_RecoPts.Count - 1;
+		a = PA_RecoPts.Points[k];
+		b.x = PA_RecoPts.X;
+		b.y = PA_RecoPts.Y;
+		pos = n - k * PA_RecoPts.Step;
+		span = end - k * PA_RecoPts.Step;
+	}
+
+	if (span == 0) return a;
+
+	p.x = a.x + ((b.x - a.x) * pos + (span >> 1)) / span;
+	p.y = a.y + ((b.y - a.y) * pos + (span >> 1)) / span;
+
+	return p;
+}
+
+
+//////////////////////////////////////////////////////////////////////
+// Shapes are found with an index : they are sorted by the direction of
+// each of their 15 segments, rounded to 8 directions, one segment after
+// the other like the levels of a tree. The first 4 segments make buckets,
+// looked at from the smallest possible difference, and each bucket is
+// split again by the next segments. The smallest possible difference of
+// a branch is known from its directions alone, so far branches are never
+// looked at. With a few shapes, comparing them all is faster.
+//////////////////////////////////////////////////////////////////////
+
+#define PA_RECO_KEYBITS 3    // 8 directions for each segment in the index
+#define PA_RECO_KEYN 4       // Segments making the buckets
+#define PA_RECO_MAXLOW (PA_RECO_KEYN * 16)
+#define PA_RECO_LINEAR 64    // Below that many shapes, they are all compared
+#define PA_RECO_LEAF 8       // Branches with that many shapes are compared at once
+#define PA_RECO_STROKEDIFF 8 // Added to the difference for each stroke more or less
+
+// The bucket segments first, then the others far apart, they differ the most
+static const u8 PA_RecoKeyPos[15] = {1, 5, 9, 13, 7, 3, 11, 0, 14, 2, 6, 10, 4, 8, 12};
+
+static u16 *PA_RecoIds = NULL;          // Shapes sorted by their directions, built-in ones first when equal
+static u16 *PA_RecoUsed, *PA_RecoFirst; // Buckets with shapes, and their first shape in PA_RecoIds
+static u16 *PA_RecoOrder;               // The order to look at the buckets
+static u8 *PA_RecoLow;                  // Smallest difference in each of these buckets
+static u16 PA_RecoUsedCount = 0;
+static u8 PA_RecoIndexOk = 0;
+
+typedef struct {
+	s8 q[15];
+	u8 bound[15][1 << PA_RECO_KEYBITS]; // Smallest difference for each direction of the segments, in index order
+	u8 strokes;
+	s32 diff;
+	u16 best;
+} PA_RecoQuery;
+
+// Difference between 2 directions, out of 32
+static inline s32 PA_RecoDiff(s32 a, s32 b) {
+	s32 d = (a - b) & 31;
+	return (d > 16) ? 32 - d : d;
+}
+
+static inline PA_FormType* PA_RecoForm(u16 id) {
+	return (id < PA_RECOTESTS) ? &PA_Graffiti[id] : &PA_CustomShape[id - PA_RECOTESTS];
+}
+
+// Rounded direction of a shape at a level of the index
+static inline u8 PA_RecoDigit(u16 id, u8 level) {
+	return ((PA_RecoForm(id)->code[PA_RecoKeyPos[level]] - '0') & 31) >> (5 - PA_RECO_KEYBITS);
+}
+
+static inline u16 PA_RecoKey(u16 id) {
+	u16 key = 0;
+	s32 i;
+
+	for (i = 0; i < PA_RECO_KEYN; i++) key = (key << PA_RECO_KEYBITS) | PA_RecoDigit(id, i);
+
+	return key;
+}
+
+static void PA_RecoBuildIndex(void) {
+	u32 total = PA_RECOTESTS + PA_CustomReco, i;
+	u16 count[1 << PA_RECO_KEYBITS], *temp;
+	s32 level;
+
+	free(PA_RecoIds);
+	PA_RecoIds = NULL;
+	PA_RecoIndexOk = 1;
+
+	if (total < PA_RECO_LINEAR) return; // All the shapes are compared
+
+	PA_RecoIds = (u16*)malloc(total * (5 * sizeof(u16) + 1)); // There are never more buckets than shapes
+	if (PA_RecoIds == NULL) return;
+
+	temp = PA_RecoIds + total;
+	PA_RecoUsed = temp + total;
+	PA_RecoFirst = PA_RecoUsed + total;
+	PA_RecoOrder = PA_RecoFirst + total;
+	PA_RecoLow = (u8*)(PA_RecoOrder + total);
+
+	// Sorted one level at a time from the last, keeping the order of the
+	// level before, so equal shapes stay in the order they were added
+	for (i = 0; i < total; i++) PA_RecoIds[i] = i;
+
+	for (level = 14; level >= 0; level--) {
+		u16 pos = 0;
+		s32 j;
+
+		memset(count, 0, sizeof(count));
+		for (i = 0; i < total; i++) count[PA_RecoDigit(PA_RecoIds[i], level)]++;
+
+		for (j = 0; j < (1 << PA_RECO_KEYBITS); j++) {
+			u16 n = count[j];
+			count[j] = pos;
+			pos += n;
+		}
+
+		for (i = 0; i < total; i++) temp[count[PA_RecoDigit(PA_RecoIds[i], level)]++] = PA_RecoIds[i];
+		memcpy(PA_RecoIds, temp, total * sizeof(u16));
+	}
+
+	PA_RecoUsedCount = 0;
+	for (i = 0; i < total; i++) {
+		u16 key = PA_RecoKey(PA_RecoIds[i]);
+
+		if ((PA_RecoUsedCount == 0) || (PA_RecoUsed[PA_RecoUsedCount - 1] != key)) {
+			PA_RecoUsed[PA_RecoUsedCount] = key;
+			PA_RecoFirst[PA_RecoUsedCount++] = i;
+		}
+	}
+}
+
+static void PA_RecoCompare(PA_RecoQuery *r, u16 id) {
+	PA_FormType *form;
+	s32 d, j;
+	u8 s;
+
+	if ((id < PA_RECOTESTS) && !PA_UseGraffiti) return;
+
+	form = PA_RecoForm(id);
+	s = form->strokes ? form->strokes : 1;
+	d = (s > r->strokes) ? (s - r->strokes) * PA_RECO_STROKEDIFF : (r->strokes - s) * PA_RECO_STROKEDIFF;
+
+	for (j = 0; (j < 15) && (d <= r->diff); j++) d += PA_RecoDiff(r->q[j], form->code[j] - '0');
+
+	if ((d < r->diff) || ((d == r->diff) && (id < r->best))) { // Same as the first one found going through all of them
+		r->diff = d;
+		r->best = id;
+	}
+}
+
+// Shapes lo to hi - 1 have the same directions before this level, and low is
+// the smallest difference they can have
+static void PA_RecoSearch(PA_RecoQuery *r, u32 lo, u32 hi, u8 level, s32 low) {
+	u32 start[1 << PA_RECO_KEYBITS], end[1 << PA_RECO_KEYBITS];
+	u8 bound[1 << PA_RECO_KEYBITS];
+	s32 n = 0, i;
+	u32 pos = lo;
+
+	if ((hi - lo <= PA_RECO_LEAF) || (level == 15)) {
+		for (pos = lo; pos < hi; pos++) PA_RecoCompare(r, PA_RecoIds[pos]);
+		return;
+	}
+
+	// The branches of each direction follow each other, the closest are looked at first
+	while (pos < hi) {
+		u8 digit = PA_RecoDigit(PA_RecoIds[pos], level);
+		u32 a = pos + 1, b = hi;
+
+		while (a < b) { // First shape of the next direction
+			u32 mid = (a + b) >> 1;
+			if (PA_RecoDigit(PA_RecoIds[mid], level) <= digit) a = mid + 1;
+			else b = mid;
+		}
+
+		for (i = n; (i > 0) && (bound[i - 1] > r->bound[level][digit]); i--) {
+			start[i] = start[i - 1];
+			end[i] = end[i - 1];
+			bound[i] = bound[i - 1];
+		}
+
+		start[i] = pos;
+		end[i] = a;
+		bound[i] = r->bound[level][digit];
+		n++;
+		pos = a;
+	}
+
+	for (i = 0; (i < n) && (low + bound[i] <= r->diff); i++)
+		PA_RecoSearch(r, start[i], end[i], level + 1, low + bound[i]);
+}
+
+char PA_RecoMatch(const char *code, u8 strokes, s32 *difference) {
+	u32 total = PA_RECOTESTS + PA_CustomReco, i;
+	u16 start[PA_RECO_MAXLOW + 2];
+	PA_RecoQuery r;
+	u16 u;
+	s32 j;
+
+	if (!PA_RecoIndexOk) PA_RecoBuildIndex();
+
+	for (i = 0; i < 15; i++) r.q[i] = (code[i] - '0') & 31;
+	r.strokes = strokes;
+	r.diff = 65000; // Diff max par dfaut
+	r.best = 0xFFFF;
+
+	if (PA_RecoIds == NULL) { // Few shapes, or no memory for the index
+		for (i = 0; i < total; i++) PA_RecoCompare(&r, i);
+	} else {
+		for (i = 0; i < 15; i++) {
+			for (j = 0; j < (1 << PA_RECO_KEYBITS); j++) {
+				s32 v = r.q[PA_RecoKeyPos[i]];
+				s32 lo = j << (5 - PA_RECO_KEYBITS), hi = lo + (1 << (5 - PA_RECO_KEYBITS)) - 1;
+				r.bound[i][j] = ((v >= lo) && (v <= hi)) ? 0 : ((PA_RecoDiff(v, lo) < PA_RecoDiff(v, hi)) ? PA_RecoDiff(v, lo) : PA_RecoDiff(v, hi));
+			}
+		}
+
+		// Buckets from the smallest possible difference, so a close shape is found
+		// early and the other buckets can be skipped
+		memset(start, 0, sizeof(start));
+
+		for (u = 0; u < PA_RecoUsedCount; u++) {
+			u16 key = PA_RecoUsed[u];
+
+			PA_RecoLow[u] = 0;
+			for (j = 0; j < PA_RECO_KEYN; j++) PA_RecoLow[u] += r.bound[PA_RECO_KEYN - 1 - j][(key >> (j * PA_RECO_KEYBITS)) & ((1 << PA_RECO_KEYBITS) - 1)];
+			start[PA_RecoLow[u] + 1]++;
+		}
+
+		for (j = 0; j <= PA_RECO_MAXLOW; j++) start[j + 1] += start[j];
+		for (u = 0; u < PA_RecoUsedCount; u++) PA_RecoOrder[start[PA_RecoLow[u]]++] = u;
+
+		for (u = 0; u < PA_RecoUsedCount; u++) {
+			u16 b = PA_RecoOrder[u];
+
+			if (PA_RecoLow[b] > r.diff) break;
+
+			PA_RecoSearch(&r, PA_RecoFirst[b], (b + 1 < PA_RecoUsedCount) ? PA_RecoFirst[b + 1] : total, PA_RECO_KEYN, PA_RecoLow[b]);
+		}
+	}
+
+	if (difference) *difference = r.diff;
+
+	return (r.best == 0xFFFF) ? 0 : PA_RecoForm(r.best)->letter;
+}
+
+void PA_RecoAddShapeEx(char letter, const char *shape, u8 strokes) {
+	int i;
+
+	if (PA_CustomReco == 0xFFFF - PA_RECOTESTS) return;
+
+	if (PA_CustomReco == PA_CustomSpace) {
+		u16 space = (PA_CustomSpace < 0x4000) ? (PA_CustomSpace ? PA_CustomSpace << 1 : 32) : 0xFFFF - PA_RECOTESTS;
+		PA_FormType *shapes = (PA_FormType*)realloc(PA_CustomShape, space * sizeof(PA_FormType));
+
+		if (shapes == NULL) return;
+
+		PA_CustomShape = shapes;
+		PA_CustomSpace = space;
+	}
+
+	PA_CustomShape[PA_CustomReco].letter = letter;
+	for (i = 0; i < 16; i++)
+		PA_CustomShape[PA_CustomReco].code[i] = shape[i];
+	PA_CustomShape[PA_CustomReco].strokes = strokes;
+	PA_CustomReco++;
+	PA_RecoIndexOk = 0;
+}
+
+void PA_ResetRecoSys(void) {
+	PA_CustomReco = 0;
+	PA_UseGraffiti = 1;
+	PA_RecoIndexOk = 0;
+}
+
 
 #define PA_ShapeAddPoint(i, value){\
-		points[i] = PA_StylusPos[value];\
+		points[i] = PA_RecoPointAt(value);\
 		if (points[i].x < PA_RecoInfo.minX) PA_RecoInfo.minX = points[i].x;\
 		else if (points[i].x > PA_RecoInfo.maxX) PA_RecoInfo.maxX = points[i].x;\
 		if (points[i].y < PA_RecoInfo.minY) PA_RecoInfo.minY = points[i].y;\
@@ -124,19 +480,21 @@ void PA_StylusLine(u8 x1, u8 y1, u8 x2, u8 y2) {
 
 char PA_AnalyzeShape(void) {
 	s32 i;
-//  for (i = 0; i < 32; i++) PA_OutputSimpleText(1, 0, i, "             ");
 	PA_StylusPosition points[17];
 
+	PA_RecoInfo.minX = PA_RecoInfo.maxX = PA_RecoInfo.startX;
+	PA_RecoInfo.minY = PA_RecoInfo.maxY = PA_RecoInfo.startY;
+
 	for (i = 0; i < 16; i++) {
 		PA_ShapeAddPoint(i, (PA_Reco.nvalues*i) >> 4)
 	}
 
 	PA_ShapeAddPoint(16, PA_Reco.nvalues - 1)
-	//points[16] = PA_StylusPos[PA_Reco.nvalues-1];
-	PA_RecoInfo.endX = PA_StylusPos[PA_Reco.nvalues-1].x; // last values
-	PA_RecoInfo.endY = PA_StylusPos[PA_Reco.nvalues-1].y; // last values
+	PA_RecoInfo.endX = points[16].x; // last values
+	PA_RecoInfo.endY = points[16].y; // last values
 	PA_RecoInfo.Length = PA_Reco.nvalues; // Total length
 	PA_RecoInfo.Angle = PA_GetAngle(points[0].x, points[0].y, points[16].x, points[16].y);
+	PA_RecoInfo.Strokes = PA_RecoPts.Strokes;
 
 //Better values
 	if (PA_RecoInfo.minX > 1) PA_RecoInfo.minX -= 2;
@@ -154,80 +512,39 @@ char PA_AnalyzeShape(void) {
 	for (i = 0; i < 15; i++) PA_RecoShape[i] = '0' + (((angles[i] + 16) & 511) >> 4);
 
 	PA_RecoShape[15] = 0;
-	//PA_OutputText(1, 2, 23, PA_RecoShape);
-	u8 letter = 0; // 0 par défaut
-	s32 diff = 65000; // Diff max par défaut
-	u8 j;
-
-	if (PA_UseGraffiti) {
-		for (j = 0; j < PA_RECOTESTS; j++) {
-			s32 tempvalue = 0;
-			s32 tempdiff = 0;
-
-			for (i = 0; i < 15; i++) {
-				tempvalue = (PA_RecoShape[i] - PA_Graffiti[j].code[i]) & 31;
-				tempvalue -= (tempvalue >> 4) << 5; // normalise
-
-				if (tempvalue < 0) tempvalue = -tempvalue;
-
-				tempdiff += tempvalue; // value
-			}
-
-			if (tempdiff < diff) { // Nouvelle lettre !
-				diff = tempdiff;
-				letter = PA_Graffiti[j].letter;
-			}
-		}
-	}
-
-	if (PA_CustomReco > 0) {
-		for (j = 0; j < PA_CustomReco; j++) {
-			s32 tempvalue = 0;
-			s32 tempdiff = 0;
-
-			for (i = 0; i < 15; i++) {
-				tempvalue = (PA_RecoShape[i] - PA_CustomShape[j].code[i]) & 31;
-				tempvalue -= (tempvalue >> 4) << 5; // normalise
 
-				if (tempvalue < 0) tempvalue = -tempvalue;
-
-				tempdiff += tempvalue; // value
-			}
-
-			if (tempdiff < diff) { // Nouvelle lettre !
-				diff = tempdiff;
-				letter = PA_CustomShape[j].letter;
-			}
-		}
-	}
-
-	PA_RecoInfo.Difference = diff; // Difference to perfect shape
-	PA_RecoInfo.Shape = letter;
-	return letter;
+	PA_RecoInfo.Shape = PA_RecoMatch(PA_RecoShape, PA_RecoPts.Strokes, &PA_RecoInfo.Difference);
+	return PA_RecoInfo.Shape;
 }
 
 
 
 char PA_CheckLetter(void) {
 	if (Stylus.Newpress) {
-		PA_Reco.nvalues = 0; // Start over again
-		PA_Reco.oldn = 0;
-		PA_Reco.veryold = 0;
-		PA_RecoInfo.startX = PA_StylusPos[PA_Reco.nvalues].x = Stylus.X; // start values
-		PA_RecoInfo.startY = PA_StylusPos[PA_Reco.nvalues].y = Stylus.Y;
-		PA_RecoInfo.minX = PA_RecoInfo.maxX = PA_RecoInfo.startX;
-		PA_RecoInfo.minY = PA_RecoInfo.maxY = PA_RecoInfo.startY;
-		PA_Reco.nvalues++;
+		if (PA_RecoPts.Waiting) { // Next stroke of the same shape
+			PA_RecoPts.Waiting = 0;
+			PA_RecoNextStroke(Stylus.X, Stylus.Y);
+		} else {
+			PA_RecoStart(Stylus.X, Stylus.Y);
+		}
 	} else if (Stylus.Held) {
-		PA_StylusLine(PA_StylusPos[PA_Reco.nvalues-1].x, PA_StylusPos[PA_Reco.nvalues-1].y, Stylus.X, Stylus.Y);
+		PA_StylusLine(PA_RecoPts.X, PA_RecoPts.Y, Stylus.X, Stylus.Y);
 	}
 
 	if (Stylus.Released) { // Start analyzing...
-		PA_Reco.nvalues = PA_Reco.veryold;
-		return PA_AnalyzeShape();
+		PA_RecoEndStroke();
+
+		if (PA_RecoStrokeDelay <= 0) return PA_AnalyzeShape();
+
+		PA_RecoPts.Waiting = PA_RecoStrokeDelay;
+		return 0;
 	}
 
-	PA_Reco.veryold = PA_Reco.oldn;
-	PA_Reco.oldn = PA_Reco.nvalues;
+	if (PA_RecoPts.Waiting && !Stylus.Held) {
+		if (--PA_RecoPts.Waiting == 0) return PA_AnalyzeShape();
+		return 0;
+	}
+
+	PA_RecoEndFrame();
 	return 0;
 }
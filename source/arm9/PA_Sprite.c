@@ -11,6 +11,23 @@ mem_usage free_mem[2][1024];
 u8 pa_obj_created[2][128];
 u16 FirstGfx[2] = {0, 0};
 
+// Gfx loaded by PA_CreateSprite, found again from their source in hash chains
+u8 pa_gfxshared[2][1024]; // Sprites sharing the gfx, besides the first one
+u8 pa_obj_sharedgfx[2][128];
+static u16 *pa_obj_gfxsrc[2][128]; // Source of each sprite's gfx, for its own copy
+static u8 pa_gfxdedup = PA_GFXDEDUP_OFF;
+u8 pa_gfxkeytype[2][1024]; // 0 not in a chain, else PA_GFXDEDUP_POINTER or PA_GFXDEDUP_CONTENT
+static u32 pa_gfxkey[2][1024]; // Pointer or hash of the pixels
+static u16 pa_gfxbucket[2][64]; // First gfx + 1 of each chain, 0 if empty
+static u16 pa_gfxnext[2][1024]; // Next gfx + 1 in the chain
+
+// Rotsets handed out by PA_AllocRotset, shared by the sprites rotated and zoomed the same way
+u8 pa_rotsetrefs[2][32];
+static s16 pa_rotsetangle[2][32];
+static u16 pa_rotsetzoomx[2][32], pa_rotsetzoomy[2][32];
+static u32 pa_rotsetdirty[2]; // Matrices computed at the next PA_UpdateOAM
+static u8 pa_obj_rotset[2][128]; // Rotset + 1 given by PA_SetSpriteRotZoom, 0 if none
+
 
 s16 nspriteanims = 0; // Number of animated sprites currently...
 spriteanim spriteanims[2][128]; // Init the array on PAlib init...
@@ -69,7 +86,10 @@ void PA_ResetSpriteSysScreen(u8 screen) {
 	for (i = 0; i < 1024; i++) {
 		used_mem[screen][i] = 0;
 		obj_per_gfx[screen][i] = 0;
+		pa_gfxshared[screen][i] = 0;
+		pa_gfxkeytype[screen][i] = 0;
 	}
+	for (i = 0; i < 64; i++) pa_gfxbucket[screen][i] = 0;
 
 	for (n = 0; n < 128; n++) {
 		PA_obj[screen][n].atr0 = 192;
@@ -80,7 +100,9 @@ void PA_ResetSpriteSysScreen(u8 screen) {
 
 	for (n = 0; n < 32; n++) {
 		PA_SetRotset(screen, n, 0, 256, 256);  // Pas de zoom ou de rotation par défaut
+		pa_rotsetrefs[screen][n] = 0;
 	}
+	pa_rotsetdirty[screen] = 0;
 
 	FirstGfx[screen] = 0;
 
@@ -88,6 +110,8 @@ void PA_ResetSpriteSysScreen(u8 screen) {
 		nspriteanims -= spriteanims[screen][n].play; // remove sprites from sprite to animate list
 		spriteanims[screen][n].play = 0;
 		pa_obj_created[screen][n]=0;
+		pa_obj_sharedgfx[screen][n]=0;
+		pa_obj_rotset[screen][n]=0;
 	}
 
 	if (screen == 0) PA_MoveSpriteType = 0;
@@ -145,8 +169,7 @@ u16 PA_CreateGfx(u8 screen, void* obj_data, u8 obj_shape, u8 obj_size, u8 color_
 
 	i = free_mem[screen][n_mem].mem_block; // On met la valeur de coté pour la renvoyer...
 	truenumber = i + FirstGfx[screen];
-	DC_FlushRange(obj_data, (4 * mem_size) << MEM_DECAL);
-	dmaCopyWords(3, obj_data, (void*)(SPRITE_GFX1 + (0x200000 *  screen) + (truenumber << NUMBER_DECAL)), (4 * mem_size) << MEM_DECAL);
+	PA_UploadCopy(obj_data, (void*)(SPRITE_GFX1 + (0x200000 *  screen) + (truenumber << NUMBER_DECAL)), (4 * mem_size) << MEM_DECAL, PA_UPLOAD_DIRECT);
 	used_mem[screen][i] = mem_size;   // Nombre de blocks
 	obj_per_gfx[screen][i] = 0; // Nombre d'objets sur ce gfx...
 	free_mem[screen][n_mem].free -= mem_size;
@@ -164,6 +187,205 @@ u16 PA_CreateGfx(u8 screen, void* obj_data, u8 obj_shape, u8 obj_size, u8 color_
 	return truenumber;
 }
 
+void PA_SetGfxDedup(u8 mode) {
+	pa_gfxdedup = mode;
+}
+
+static inline u16 PA_GfxBucket(u32 key) {
+	return (key ^ (key >> 6) ^ (key >> 12)) & 63;
+}
+
+// FNV-1a, on the size really copied to VRAM
+static u32 PA_GfxHash(const void *data, u32 size) {
+	const u8 *p = (const u8*)data;
+	u32 hash = 2166136261u;
+
+	while (size--) hash = (hash ^ *p++) * 16777619u;
+	return hash;
+}
+
+void PA_UnlinkGfx(u8 screen, u16 gfx) {
+	u16 *link;
+
+	if (!pa_gfxkeytype[screen][gfx]) return;
+
+	link = &pa_gfxbucket[screen][PA_GfxBucket(pa_gfxkey[screen][gfx])];
+	while (*link && (*link != gfx + 1)) link = &pa_gfxnext[screen][*link - 1];
+	if (*link) *link = pa_gfxnext[screen][gfx];
+
+	pa_gfxkeytype[screen][gfx] = 0;
+}
+
+u16 PA_CreateSpriteGfx(u8 screen, u8 obj_number, void* obj_data, u8 obj_shape, u8 obj_size, u8 color_mode) {
+	u16 mem_size = PA_obj_sizes[obj_size][obj_shape] >> (8 - color_mode);
+	u32 size, key;
+	u16 gfx;
+
+	if (mem_size == 0) mem_size++;
+	size = (4 * mem_size) << MEM_DECAL;
+
+	pa_obj_sharedgfx[screen][obj_number] = 1;
+	pa_obj_gfxsrc[screen][obj_number] = (u16*)obj_data;
+
+	if (pa_gfxdedup == PA_GFXDEDUP_OFF) {
+		gfx = PA_CreateGfx(screen, obj_data, obj_shape, obj_size, color_mode);
+		pa_gfxshared[screen][gfx] = 0;
+		return gfx;
+	}
+
+	// Same pointer first, then the same pixels if asked
+	key = (u32)(uintptr_t)obj_data;
+	for (gfx = pa_gfxbucket[screen][PA_GfxBucket(key)]; gfx; gfx = pa_gfxnext[screen][gfx - 1]) {
+		u16 g = gfx - 1;
+		if ((pa_gfxkeytype[screen][g] == PA_GFXDEDUP_POINTER) && (pa_gfxkey[screen][g] == key) && (used_mem[screen][g] == mem_size)) {
+			pa_gfxshared[screen][g]++;
+			return g;
+		}
+	}
+
+	if (pa_gfxdedup == PA_GFXDEDUP_CONTENT) {
+		u8 flushed = 0;
+
+		key = PA_GfxHash(obj_data, size);
+		for (gfx = pa_gfxbucket[screen][PA_GfxBucket(key)]; gfx; gfx = pa_gfxnext[screen][gfx - 1]) {
+			u16 g = gfx - 1;
+			if ((pa_gfxkeytype[screen][g] != PA_GFXDEDUP_CONTENT) || (pa_gfxkey[screen][g] != key) || (used_mem[screen][g] != mem_size)) continue;
+
+			if (PA_UploadOn && !flushed) { // What is compared must already be in VRAM
+				PA_UploadFlush();
+				flushed = 1;
+			}
+			if (memcmp(obj_data, (void*)(SPRITE_GFX1 + (0x200000 * screen) + (g << NUMBER_DECAL)), size) == 0) {
+				pa_gfxshared[screen][g]++;
+				return g;
+			}
+		}
+	}
+	else key = (u32)(uintptr_t)obj_data;
+
+	gfx = PA_CreateGfx(screen, obj_data, obj_shape, obj_size, color_mode);
+	pa_gfxshared[screen][gfx] = 0;
+	pa_gfxkeytype[screen][gfx] = pa_gfxdedup;
+	pa_gfxkey[screen][gfx] = key;
+	pa_gfxnext[screen][gfx] = pa_gfxbucket[screen][PA_GfxBucket(key)];
+	pa_gfxbucket[screen][PA_GfxBucket(key)] = gfx + 1;
+
+	return gfx;
+}
+
+void PA_UnshareSpriteGfx(u8 screen, u8 obj_number) {
+	u16 gfx = PA_GetSpriteGfx(screen, obj_number);
+	u16 atr0 = PA_obj[screen][obj_number].atr0;
+	u8 color_mode = (atr0 >> 13) & 1;
+	u16 newgfx;
+
+	if (!pa_obj_sharedgfx[screen][obj_number]) return;
+	pa_obj_sharedgfx[screen][obj_number] = 0;
+	if (pa_gfxshared[screen][gfx] == 0) { // Alone on it, nothing to copy, but it won't hold that image for long
+		PA_UnlinkGfx(screen, gfx);
+		return;
+	}
+
+	if (((atr0 >> 10) & 3) == 3) color_mode = 2; // 16 bit
+
+	// The frame shown now, from VRAM
+	if (PA_UploadOn) PA_UploadFlush();
+	newgfx = PA_CreateGfx(screen, (void*)(SPRITE_GFX1 + (0x200000 * screen) + (gfx << NUMBER_DECAL)), atr0 >> 14, PA_obj[screen][obj_number].atr1 >> 14, color_mode);
+	PA_SpriteAnimP[screen][newgfx] = pa_obj_gfxsrc[screen][obj_number];
+
+	pa_gfxshared[screen][gfx]--;
+	obj_per_gfx[screen][gfx]--;
+	obj_per_gfx[screen][newgfx] = 1;
+	PA_obj[screen][obj_number].atr2 = (PA_obj[screen][obj_number].atr2 & ~OBJ_GFX) | newgfx;
+}
+
+// Rotset already holding that transform, or -1
+static s8 PA_FindRotset(u8 screen, s16 angle, u16 zoomx, u16 zoomy) {
+	s8 i;
+
+	for (i = 31; i >= 0; i--)
+		if (pa_rotsetrefs[screen][i] && (pa_rotsetangle[screen][i] == angle) && (pa_rotsetzoomx[screen][i] == zoomx) && (pa_rotsetzoomy[screen][i] == zoomy))
+			return i;
+	return -1;
+}
+
+// The matrix itself waits for PA_UpdateOAM
+static void PA_KeyRotset(u8 screen, u8 rotset, s16 angle, u16 zoomx, u16 zoomy) {
+	u16 ime = REG_IME;
+	REG_IME = 0;
+	pa_rotsetangle[screen][rotset] = angle;
+	pa_rotsetzoomx[screen][rotset] = zoomx;
+	pa_rotsetzoomy[screen][rotset] = zoomy;
+	pa_rotsetdirty[screen] |= 1u << rotset;
+	REG_IME = ime;
+}
+
+s8 PA_AllocRotset(u8 screen, s16 angle, u16 zoomx, u16 zoomy) {
+	s8 i;
+
+	angle &= 511;
+	i = PA_FindRotset(screen, angle, zoomx, zoomy);
+	if (i >= 0) {
+		pa_rotsetrefs[screen][i]++;
+		return i;
+	}
+
+	// From the last one, the first rotsets are usually numbered by hand
+	for (i = 31; (i >= 0) && pa_rotsetrefs[screen][i]; i--);
+	if (i < 0) return -1;
+
+	pa_rotsetrefs[screen][i] = 1;
+	PA_KeyRotset(screen, i, angle, zoomx, zoomy);
+	return i;
+}
+
+void PA_FreeRotset(u8 screen, u8 rotset) {
+	if (pa_rotsetrefs[screen][rotset]) pa_rotsetrefs[screen][rotset]--;
+}
+
+u8 PA_SetSpriteRotZoom(u8 screen, u8 sprite, s16 angle, u16 zoomx, u16 zoomy) {
+	s8 old = pa_obj_rotset[screen][sprite] - 1, rotset;
+
+	angle &= 511;
+	if ((old >= 0) && (pa_rotsetangle[screen][old] == angle) && (pa_rotsetzoomx[screen][old] == zoomx) && (pa_rotsetzoomy[screen][old] == zoomy))
+		return 1; // Nothing changed
+
+	rotset = PA_FindRotset(screen, angle, zoomx, zoomy);
+	if (rotset >= 0) pa_rotsetrefs[screen][rotset]++;
+	else if ((old >= 0) && (pa_rotsetrefs[screen][old] == 1)) { // Alone on its rotset, changed in place
+		PA_KeyRotset(screen, old, angle, zoomx, zoomy);
+		return 1;
+	}
+	else {
+		rotset = PA_AllocRotset(screen, angle, zoomx, zoomy);
+		if (rotset < 0) return 0; // All used, the sprite keeps its transform
+	}
+
+	if (old >= 0) PA_FreeRotset(screen, old);
+	pa_obj_rotset[screen][sprite] = rotset + 1;
+	PA_SetSpriteRotEnable(screen, sprite, rotset);
+	return 1;
+}
+
+void PA_SetSpriteRotZoomDisable(u8 screen, u8 sprite) {
+	if (pa_obj_rotset[screen][sprite]) PA_FreeRotset(screen, pa_obj_rotset[screen][sprite] - 1);
+	pa_obj_rotset[screen][sprite] = 0;
+	PA_SetSpriteRotDisable(screen, sprite);
+}
+
+// Matrices of the rotsets changed during the frame, each computed once however many sprites use it
+static inline void PA_UpdateRotsets(void) {
+	u8 screen, i;
+
+	for (screen = 0; screen < 2; screen++) {
+		u32 dirty = pa_rotsetdirty[screen];
+
+		pa_rotsetdirty[screen] = 0;
+		for (i = 0; dirty; i++, dirty >>= 1)
+			if (dirty & 1) PA_SetRotset(screen, i, pa_rotsetangle[screen][i], pa_rotsetzoomx[screen][i], pa_rotsetzoomy[screen][i]);
+	}
+}
+
 
 void PA_DeleteSprite(u8 screen, u8 obj_number) {
 	//check if sprite is created first
@@ -171,6 +393,11 @@ void PA_DeleteSprite(u8 screen, u8 obj_number) {
 	
 		u16 obj_gfx = PA_GetSpriteGfx(screen, obj_number);
 
+		if (pa_obj_rotset[screen][obj_number]) PA_FreeRotset(screen, pa_obj_rotset[screen][obj_number] - 1);
+		pa_obj_rotset[screen][obj_number] = 0;
+		if (pa_obj_sharedgfx[screen][obj_number] && pa_gfxshared[screen][obj_gfx]) pa_gfxshared[screen][obj_gfx]--;
+		pa_obj_sharedgfx[screen][obj_number] = 0;
+
 		// If there are multiple sprites using the graphics, then save the graphics
 		if (obj_per_gfx[screen][obj_gfx] > 0) {
 			obj_per_gfx[screen][obj_gfx]--;
@@ -200,6 +427,11 @@ void PA_DeleteGfx(u8 screen, u16 obj_gfx) {
 	s8 decal = 0; // Décalage que l'on aura à faire pour classer le tableau...
 	obj_gfx -= FirstGfx[screen];
 	obj_per_gfx[screen][obj_gfx] = 0;
+	pa_gfxshared[screen][obj_gfx] = 0;
+	PA_UnlinkGfx(screen, obj_gfx); // Not found again by PA_CreateSprite
+
+	u16 gfx = obj_gfx, gfxsize = used_mem[screen][gfx];
+	u16 size = gfxsize; // Free block being added, with the one before if they touch : can be bigger than a u8
 
 	// Gestion dynamique de la mémoire...
 	for (i = 0; ((i < n_free_mem[screen]) & !exit); i++) { // On regarde les différents emplacements mémoire pour ajouter le morceau libre dans le tas...
@@ -207,22 +439,22 @@ void PA_DeleteGfx(u8 screen, u16 obj_gfx) {
 			exit = 1; // On va pourvoir sortir, après avir ordonné le tableau...
 			decal = 1;
 
-			if ((obj_gfx > 0) & (free_mem[screen][i - 1].mem_block + free_mem[screen][i - 1].free == obj_gfx)) { // On a 2 cases côtes à côtes, donc pas besoin de décaler, on ajouter la mem dispo...
-				free_mem[screen][i-1].free += used_mem[screen][obj_gfx];
+			if ((i > 0) && (free_mem[screen][i - 1].mem_block + free_mem[screen][i - 1].free == obj_gfx)) { // On a 2 cases côtes à côtes, donc pas besoin de décaler, on ajouter la mem dispo...
+				free_mem[screen][i-1].free += size;
 				obj_gfx = free_mem[screen][i-1].mem_block;
-				used_mem[screen][obj_gfx] = free_mem[screen][i-1].free;
+				size = free_mem[screen][i-1].free;
 				decal = 0;
 			}
 
-			if (obj_gfx + used_mem[screen][obj_gfx] == free_mem[screen][i].mem_block) { // Si le bloc d'après suit parfaitement le bloc qu'on vient d'ajouter...
+			if (obj_gfx + size == free_mem[screen][i].mem_block) { // Si le bloc d'après suit parfaitement le bloc qu'on vient d'ajouter...
 				-- decal;
 				free_mem[screen][i].mem_block = obj_gfx;
-				free_mem[screen][i].free += used_mem[screen][obj_gfx];
+				free_mem[screen][i].free += size;
 			}
 
 			// Si le décalage est de 0, on touche à rien
 			if (decal == -1) { // On doit décaler vers la gauche... les données sont déjà dans le tableau
-				for (j = i - 1; j < n_free_mem[screen]; j++) {// On recopie la liste plus loin...
+				for (j = i - 1; j < n_free_mem[screen] - 1; j++) {// On recopie la liste plus loin...
 					free_mem[screen][j] = free_mem[screen][j + 1];
 				}
 
@@ -230,22 +462,33 @@ void PA_DeleteGfx(u8 screen, u16 obj_gfx) {
 			} else if (decal == 1) { // On doit tout décaler pour faire rentrer la case vide...
 				++n_free_mem[screen];
 
-				for (j = n_free_mem[screen]; j > i; j--) {// On recopie la liste plus loin...
+				for (j = n_free_mem[screen] - 1; j > i; j--) {// On recopie la liste plus loin...
 					free_mem[screen][j] = free_mem[screen][j - 1];
 				}
 
 				free_mem[screen][i].mem_block = obj_gfx;
-				free_mem[screen][i].free = used_mem[screen][obj_gfx];
+				free_mem[screen][i].free = size;
 			}
 		}
 	}
 
+	if (!exit) { // After the last free block, when the end of VRAM is used
+		i = n_free_mem[screen];
+		if ((i > 0) && (free_mem[screen][i - 1].mem_block + free_mem[screen][i - 1].free == obj_gfx)) free_mem[screen][i - 1].free += size;
+		else {
+			free_mem[screen][i].mem_block = obj_gfx;
+			free_mem[screen][i].free = size;
+			++n_free_mem[screen];
+		}
+	}
+
 	// Effacage de la mémoire
-	dmaFillWords(0, (void*)(SPRITE_GFX1 + (0x200000 *  screen) + (obj_gfx << NUMBER_DECAL)), (used_mem[screen][obj_gfx] << MEM_DECAL)*2);
-	used_mem[screen][obj_gfx] = 0;
+	dmaFillWords(0, (void*)(SPRITE_GFX1 + (0x200000 *  screen) + (gfx << NUMBER_DECAL)), (4 * gfxsize) << MEM_DECAL);
+	used_mem[screen][gfx] = 0;
 }
 
 void PA_InitSpriteDraw(u8 screen, u8 sprite) {
+	PA_UnshareSpriteGfx(screen, sprite); // Drawn on alone
 	spriteanims[screen][sprite].lx = PA_GetSpriteLx(screen, sprite);
 	spriteanims[screen][sprite].ly = PA_GetSpriteLy(screen, sprite);
 	spriteanims[screen][sprite].colors = PA_GetSpriteColors(screen, sprite);
@@ -257,6 +500,8 @@ void PA_UpdateOAM(void) {
 	s32 value = 0;
 	s32 value2 = 512;
 
+	if (pa_rotsetdirty[0] | pa_rotsetdirty[1]) PA_UpdateRotsets();
+
 	if (!PA_SpriteExtPrio) {
 		DC_FlushRange(PA_obj, 512 * 4);
 		dmaCopyWords(0, PA_obj, OAM, 512 * 4); // DMA0 Copy
@@ -317,6 +562,8 @@ VoidFn VBLSpriteAnims = PA_Nothing;
 
 void PA_UpdateSpriteVBL(void) {
 	PA_UpdateMoveSprite(); // Met à jour les infos sur les déplacements de sprites
+	PA_ProfileBegin(PA_PROFILE_OAM);
 	PA_UpdateOAM(); // Updates the Object on screen
+	PA_ProfileEnd();
 	VBLSpriteAnims();
 }
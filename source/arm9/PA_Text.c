@@ -19,6 +19,8 @@ u16 PAtext_pal[2] = {0, 0}; // text colors...
 
 textborders PA_TextBox[2];
 
+static char pa_textbuffer[512];
+
 void PA_CreateTextPal(u8 screen, u8 pal_number, u16 r, u16 g, u16 b) {
 	u16 baser, baseg, baseb;
 	int i;
@@ -75,166 +77,35 @@ u16 PA_OutputSimpleText(u8 screen, u16 x, u16 y, const char *text) {
 }
 
 void PA_OutputText(u8 screen, u16 x, u16 y, const char* text, ...) {
-	int j, i, k = 0;
-	u16 textcount = 0; // compte le nombre de lettres...
-	u8 PAtext[32]; // tableau o� l'on copie les nombres et tout...
-	u8 *PAextext; // Extra text
-	s32 PAtextnumber;
-	double tempdouble = 0;
-	va_list varg;           /* Variable identifiant le prochain param�tre. */
-	va_start(varg, text);
 	u8 textcolor = PAtext_pal[screen];
+	u16 basex = x;
+	const char *c;
+	va_list varg;
 
-	for (j = 0; text[j]; j++) {
-		if (text[j] == '%') {
-			if (text[j+1] == 'c') { // change color !
-				PA_SetTextTileCol(screen, text[j+2] - '0');
-				j += 2;
-			} else if (text[j+1] == 's') { // S'il y a %s, c'est une chaine de caract�res...
-				PAextext = (u8*)va_arg(varg, const u8 *);  // Pointeur vers la chaine de charact�res...
-
-				for (i = 0; PAextext[i]; i++) {
-					while (PAextext[i] == '\n') {
-						y++;
-						i++;
-						++textcount;
-						k = i;
-					}
-
-					PA_SetTileLetter(screen, x + textcount - k, y, PAextext[i]);
-					++textcount;
-				}
-
-				j += 1;
-			} else if ((text[j+1] == 'x')) {
-				u32 test = va_arg(varg, u32);
-				u8 temp;
-				u8 started = 0;
-
-				for (i = 0; i < 32; i += 4) {
-					temp = (test >> (28 - i)) & 15;
-
-					if (started || temp) {
-						if (temp >= 10) PA_SetTileLetter(screen, x + textcount, y, 'A' + (temp - 10));
-						else PA_SetTileLetter(screen, x + textcount, y, '0' + (temp));
-
-						textcount++;
-						started = 1;
-					}
-				}
-
-				j++;
-			} else if ((text[j+1] == 'd') || (text[j+1] == 'f')) {
-				double test = 0;
-
-				if (text[j+1] == 'd') {
-					PAtextnumber = va_arg(varg, s32);
-					test = PAtextnumber;
-				} else { // On ne prend que la partie enti�re pour l'instant, on garde le reste pour plus tard :p
-					tempdouble = va_arg(varg, double);
-					test = tempdouble;
-					PAtextnumber = (s32)tempdouble ;
-					tempdouble -= PAtextnumber;
-				}
-
-				s8 neg = 0; // Si negatif, passe � 1...
-
-				if (test < 0) {
-					PAtextnumber = -PAtextnumber;
-					//tempdouble = -tempdouble;
-					neg = 1;
-				}
-
-				for (i = 0; PAtextnumber || (!PAtextnumber && !i); i++) {  // tant que le nombre ne vaut pas 0 mais que i est positif, on continu � la convertir...
-					PAtext[i] = '0' + (PAtextnumber % 10);
-					PAtextnumber = PAtextnumber / 10; // Nombre de d�part...
-				}
-
-				if (neg) {
-					PAtext[i] = '-';
-					++i;
-				}
-
-				for (i--; i > -1; i--) {
-					PA_SetTileLetter(screen, x + textcount, y, PAtext[i]);
-					++ textcount;
-				}
-
-				j += 1;
-
-				if (text[j] == 'f') { // Il reste donc la virgule � traiter...
-					PA_SetTileLetter(screen, x + textcount, y, '.');
-					++ textcount;
-					i = text[j+1] - 48;  // Nombre de chiffres apr�s la virgule...
-					PAtext[1] = 0; // Permet de stopper si c'est vba...
-
-					if (tempdouble < 0) tempdouble = -tempdouble;
-
-					while ((i-- > 0)) { // Pas plus de 6 chiffres apr�s la virgule...
-						tempdouble *= 10;
-						//if (
-						PAtextnumber = (s32)tempdouble;
-						tempdouble -= PAtextnumber;
-						PAtext[0] = '0' + PAtextnumber;
-						PA_SetTileLetter(screen, x + textcount, y, PAtext[0]);
-						++ textcount;
-					}
-
-					j += 1;
-				}
-			} else if ((text[j+3] == 'd') && (text[j+1] != ' ') && (text[j+2] != ' ')) { // C'est plus loin, donc on a genre %02d...
-				PAtextnumber = va_arg(varg, s32);
-				s8 neg = 0; // Si negatif, passe � 1...
-				u8 amettre = text[j+1]; // Nombre � mettre pour remplir
-				s8 nfois = text[j+2] - '0'; // Nombre de caract�res � mettre
-
-				if (PAtextnumber < 0) {
-					PAtextnumber = -PAtextnumber;
-					neg = 1;
-				}
-
-				for (i = 0; PAtextnumber || (!PAtextnumber && !i); i++) {  // tant que le nombre ne vaut pas 0 mais que i est positif, on continu � la convertir...
-					PAtext[i] = 48 + (PAtextnumber % 10);
-					PAtextnumber = PAtextnumber / 10; // Nombre de d�part...
-					nfois--; // Un nombre de moins � mettre...
-				}
-
-				while (nfois > 0) { // On compl�te de 0 est tout...
-					PA_SetTileLetter(screen, x + textcount, y, amettre);
-					++textcount;
-					--nfois;
-				}
-
-				if (neg) {
-					PAtext[i] = '-';
-					++i;
-				}
-
-				for (i--; i > -1; i--) {
-					PA_SetTileLetter(screen, x + textcount, y, PAtext[i]);
-					++ textcount;
-				}
-
-				j += 3;
-			} else { // Sinon c'est juste
-				PA_SetTileLetter(screen, x + textcount, y, text[j]);
-				++textcount;
-			}
-		} else if (text[j] == '\n') {
-			textcount = 0;
-			++y;
-		} else if ((text[j] == '/') && (text[j+1] == 'n')) {
-			textcount = 0;
-			++y;
-			j++;
+	PA_ProfileBegin(PA_PROFILE_TEXT);
+
+	va_start(varg, text);
+	PA_VFormat(pa_textbuffer, sizeof(pa_textbuffer), text, varg);
+	va_end(varg);
+
+	for (c = pa_textbuffer; *c; c++) {
+		if ((c[0] == '%') && (c[1] == 'c') && (c[2] >= '0') && (c[2] <= '9')) { // change color !
+			PA_SetTextTileCol(screen, c[2] - '0');
+			c += 2;
+		} else if ((c[0] == '\n') || ((c[0] == '/') && (c[1] == 'n'))) {
+			if (c[0] == '/') c++;
+
+			x = basex;
+			y++;
 		} else {
-			PA_SetTileLetter(screen, x + textcount, y, text[j]);
-			++textcount;
+			PA_SetTileLetter(screen, x, y, (u8)*c);
+			x++;
 		}
 	}
 
-	va_end(varg);           /* Terminaison. */
 	PA_SetTextTileCol(screen, textcolor); // put back the old color
+
+	PA_ProfileEnd();
 }
 
 
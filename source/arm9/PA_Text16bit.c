@@ -164,6 +164,8 @@ void pa_16bitTextDecompress(u8 size) {
 
 s16 PA_16bitText(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, const char* text, u16 color, u8 size, u8 transp, s32 limit) {
 	s32 i;
+
+	PA_ProfileBegin(PA_PROFILE_TEXT);
 	pa_16bitTextDecompress(size);
 	PA_DoLetterPos(basex, basey, maxx, maxy, text, color, size, limit);
 
@@ -172,5 +174,19 @@ s16 PA_16bitText(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, const char
 	for (i = 0; i < limit; i++) letters16bit[transp](PA_LetterPos.Letter[i].Size, screen, PA_LetterPos.Letter[i].X, PA_LetterPos.Letter[i].Y,
 		        PA_LetterPos.Letter[i].Letter, PA_LetterPos.Letter[i].Color);
 
+	PA_AddDirtyLetterPos(screen, limit, transp);
+
+	PA_ProfileEnd();
 	return limit;
 }
+
+s16 PA_16bitTextf(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, u16 color, u8 size, u8 transp, s32 limit, const char* text, ...) {
+	const char *formatted;
+	va_list varg;
+
+	va_start(varg, text);
+	formatted = PA_FormatBitText(text, varg);
+	va_end(varg);
+
+	return PA_16bitText(screen, basex, basey, maxx, maxy, formatted, color, size, transp, limit);
+}
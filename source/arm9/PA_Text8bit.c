@@ -183,6 +183,8 @@ void pa_8bitTextDecompress(u8 size) {
 
 s16 PA_8bitText(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, const char* text, u8 color, u8 size, u8 transp, s32 limit) {
 	s32 i;
+
+	PA_ProfileBegin(PA_PROFILE_TEXT);
 	pa_8bitTextDecompress(size);
 	PA_DoLetterPos(basex, basey, maxx, maxy, text, color, size, limit);
 
@@ -191,9 +193,23 @@ s16 PA_8bitText(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, const char*
 	for (i = 0; i < limit; i++) letters[transp](PA_LetterPos.Letter[i].Size, screen, PA_LetterPos.Letter[i].X, PA_LetterPos.Letter[i].Y,
 		        PA_LetterPos.Letter[i].Letter, PA_LetterPos.Letter[i].Color);
 
+	PA_AddDirtyLetterPos(screen, limit, transp);
+
+	PA_ProfileEnd();
 	return limit;
 }
 
+s16 PA_8bitTextf(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, u8 color, u8 size, u8 transp, s32 limit, const char* text, ...) {
+	const char *formatted;
+	va_list varg;
+
+	va_start(varg, text);
+	formatted = PA_FormatBitText(text, varg);
+	va_end(varg);
+
+	return PA_8bitText(screen, basex, basey, maxx, maxy, formatted, color, size, transp, limit);
+}
+
 s16 PA_CenterSmartText(u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, const char* text, u8 color, u8 size, u8 transp) {
 	u8 align = textinfo.align;
 	textinfo.align = ALIGN_CENTER;
@@ -47,6 +47,8 @@ u16 pa_bittextsizes[5];
 u8 pa_bittextpoliceheight[10];
 
 LetterPos PA_LetterPos;
+
+static char pa_bittextbuffer[512];
 textinfo_type textinfo = {1, 0, ALIGN_LEFT, 0};
 
 static inline void PA_AddLetterPos(s16 Letter, s16 x, s16 y, u8 size, u16 color) {
@@ -160,3 +162,18 @@ void PA_DoLetterPos(s16 basex, s16 basey, s16 maxx, s16 maxy, const char* text,
 	PA_LetterPos.Letter[PA_LetterPos.NLetters].Y = y;
 }
 
+// Formatted text for the bitmap text functions, which don't use color codes
+const char* PA_FormatBitText(const char *format, va_list args) {
+	char *src, *dst;
+
+	PA_VFormat(pa_bittextbuffer, sizeof(pa_bittextbuffer), format, args);
+
+	for (src = dst = pa_bittextbuffer; *src; src++) {
+		if ((src[0] == '%') && (src[1] == 'c') && (src[2] >= '0') && (src[2] <= '9')) src += 2;
+		else *dst++ = *src;
+	}
+
+	*dst = 0;
+
+	return pa_bittextbuffer;
+}
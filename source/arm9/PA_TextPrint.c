@@ -1,160 +1,79 @@
 #include <PA9.h>
 
-void PA_PrintYPlus(u8 screen) {
+// The text background is used as a ring of 32 lines: the screen shows 24 of
+// them and is scrolled one line up with the hardware scroll when printing
+// goes below the bottom, so only the new line has to be cleared.
+
+static char pa_printbuffer[512];
+static u16 pa_printline[32]; // Map entries of the line being printed
+
+static inline u16* PA_PrintRow(u8 screen, u32 y) {
+	return (u16*)(PA_BgInfo[screen][PAbgtext[screen]].Map + ((y & 31) << 6));
+}
+
+static void PA_ClearPrintRow(u8 screen, u32 y) {
+	u32 *row = (u32*)PA_PrintRow(screen, y);
+	u32 blank = PA_textmap[screen][' '] & ((1 << 12) - 1);
 	u8 i;
 
-	for (i = pa_printx[screen]; i < 32; i++) PA_SetTileLetter(screen, pa_printx[screen], pa_printy[screen]&31, ' '); // Erase
+	blank |= blank << 16;
+
+	for (i = 0; i < 16; i++) row[i] = blank;
+}
+
+// Write the letters start to pa_printx of the current line to the map
+static void PA_PrintFlush(u8 screen, u32 start) {
+	u16 *row = PA_PrintRow(screen, pa_printy[screen]);
+	u32 i;
+
+	for (i = start; i < pa_printx[screen]; i++) row[i] = pa_printline[i];
+}
 
+void PA_PrintYPlus(u8 screen) {
 	pa_printy[screen]++;
 	pa_printx[screen] = 0;
 
-	if (pa_printy[screen] > 24) {
-		pa_printscroll[screen] += 8;
+	// The line may still hold the text printed 32 lines ago
+	PA_ClearPrintRow(screen, pa_printy[screen]);
+
+	if (pa_printy[screen] >= 24) {
+		pa_printscroll[screen] = ((pa_printy[screen] - 23) << 3) & 255;
 		PA_BGScrollY(screen, PAbgtext[screen], pa_printscroll[screen]);
 	}
 }
 
 void PA_Print(u8 screen, const char* text, ...) {
-	s16 j, i;
-	u8 PAtext[32]; // tableau où l'on copie les nombres et tout...
-	u8 *PAextext; // Extra text
-	s32 PAtextnumber;
-	double tempdouble = 0;
-	//BG_PALETTE[255 + (screen * 512)] = textcol[screen]; // On remet la couleur au cas où on ait chargé du texte par-dessus...
-	va_list varg;           /* Variable identifiant le prochain paramètre. */
-	va_start(varg, text);
 	u8 textcolor = PAtext_pal[screen];
+	u32 start = pa_printx[screen];
+	const char *c;
+	va_list varg;
 
-	for (j = 0; text[j]; j++) {
-		if (text[j] == '%') {
-			if (text[j+1] == 'c') { // change color !
-				PA_SetTextTileCol(screen, text[j+2] - '0');
-				j += 2;
-			} else if (text[j+1] == 's') { // S'il y a %s, c'est une chaine de caractères...
-				PAextext = (u8*)va_arg(varg, const u8 *);  // Pointeur vers la chaine de charactères...
-
-				for (i = 0; PAextext[i]; i++) {
-					PA_PrintLetter(screen, PAextext[i]);
-				}
-
-				j += 1;
-			} else if ((text[j+1] == 'x')) {
-				u32 test = va_arg(varg, u32);
-				u8 temp;
-				u8 started = 0;
-
-				for (i = 0; i < 32; i += 4) {
-					temp = (test >> (28 - i)) & 15;
-
-					if (started || temp) {
-						if (temp >= 10) PA_PrintLetter(screen, 'A' + (temp - 10));
-						else PA_PrintLetter(screen, '0' + (temp));
-
-						started = 1;
-					}
-				}
-
-				j++;
-			} else if ((text[j+1] == 'd') || (text[j+1] == 'f')) {
-				double test = 0;
-
-				if (text[j+1] == 'd') {
-					PAtextnumber = va_arg(varg, s32);
-					test = PAtextnumber;
-				} else { // On ne prend que la partie entière pour l'instant, on garde le reste pour plus tard :p
-					tempdouble = va_arg(varg, double);
-					test = tempdouble;
-					PAtextnumber = (s32)tempdouble ;
-					tempdouble -= PAtextnumber;
-				}
-
-				s8 neg = 0; // Si negatif, passe à 1...
-
-				if (test < 0) {
-					PAtextnumber = -PAtextnumber;
-					//tempdouble = -tempdouble;
-					neg = 1;
-				}
-
-				for (i = 0; PAtextnumber || (!PAtextnumber && !i); i++) {  // tant que le nombre ne vaut pas 0 mais que i est positif, on continu à la convertir...
-					PAtext[i] = '0' + (PAtextnumber % 10);
-					PAtextnumber = PAtextnumber / 10; // Nombre de départ...
-				}
-
-				if (neg) {
-					PAtext[i] = '-';
-					++i;
-				}
-
-				for (i--; i > -1; i--) {
-					PA_PrintLetter(screen, PAtext[i]);
-				}
-
-				j += 1;
-
-				if (text[j] == 'f') { // Il reste donc la virgule à traiter...
-					PA_PrintLetter(screen, '.');
-					i = text[j+1] - 48;  // Nombre de chiffres après la virgule...
-					PAtext[1] = 0; // Permet de stopper si c'est vba...
-
-					if (tempdouble < 0) tempdouble = -tempdouble;
-
-					while ((i-- > 0)) { // Pas plus de 6 chiffres après la virgule...
-						tempdouble *= 10;
-						//if (
-						PAtextnumber = (s32)tempdouble;
-						tempdouble -= PAtextnumber;
-						PAtext[0] = '0' + PAtextnumber;
-						PA_PrintLetter(screen, PAtext[0]);
-					}
-
-					j += 1;
-				}
-			} else if ((text[j+3] == 'd') && (text[j+1] != ' ') && (text[j+2] != ' ')) { // C'est plus loin, donc on a genre %02d...
-				PAtextnumber = va_arg(varg, s32);
-				s8 neg = 0; // Si negatif, passe à 1...
-				u8 amettre = text[j+1]; // Nombre à mettre pour remplir
-				s8 nfois = text[j+2] - '0'; // Nombre de caractères à mettre
-
-				if (PAtextnumber < 0) {
-					PAtextnumber = -PAtextnumber;
-					neg = 1;
-				}
-
-				for (i = 0; PAtextnumber || (!PAtextnumber && !i); i++) {  // tant que le nombre ne vaut pas 0 mais que i est positif, on continu à la convertir...
-					PAtext[i] = 48 + (PAtextnumber % 10);
-					PAtextnumber = PAtextnumber / 10; // Nombre de départ...
-					nfois--; // Un nombre de moins à mettre...
-				}
-
-				while (nfois > 0) { // On complète de 0 est tout...
-					PA_PrintLetter(screen, amettre);
-					--nfois;
-				}
-
-				if (neg) {
-					PAtext[i] = '-';
-					++i;
-				}
-
-				for (i--; i > -1; i--) {
-					PA_PrintLetter(screen, PAtext[i]);
-				}
-
-				j += 3;
-			} else { // Sinon c'est juste
-				PA_PrintLetter(screen, text[j]);
-			}
-		} else if (text[j] == '\n') {
-			PA_PrintYPlus(screen);
-		} else if ((text[j] == '/') && (text[j+1] == 'n')) {
+	va_start(varg, text);
+	PA_VFormat(pa_printbuffer, sizeof(pa_printbuffer), text, varg);
+	va_end(varg);
+
+	for (c = pa_printbuffer; *c; c++) {
+		if ((c[0] == '%') && (c[1] == 'c') && (c[2] >= '0') && (c[2] <= '9')) { // change color !
+			PA_SetTextTileCol(screen, c[2] - '0');
+			c += 2;
+		} else if ((c[0] == '\n') || ((c[0] == '/') && (c[1] == 'n'))) {
+			if (c[0] == '/') c++;
+
+			PA_PrintFlush(screen, start);
 			PA_PrintYPlus(screen);
-			j++;
+			start = 0;
 		} else {
-			PA_PrintLetter(screen, text[j]);
+			pa_printline[pa_printx[screen]] = (PA_textmap[screen][(u8)*c] & ((1 << 12) - 1)) + (PAtext_pal[screen] << 12);
+			pa_printx[screen]++;
+
+			if (pa_printx[screen] >= 32) {
+				PA_PrintFlush(screen, start);
+				PA_PrintYPlus(screen);
+				start = 0;
+			}
 		}
 	}
 
-	va_end(varg);           /* Terminaison. */
+	PA_PrintFlush(screen, start);
 	PA_SetTextTileCol(screen, textcolor); // put back the old color
 }
@@ -0,0 +1,332 @@
+#include <PA9.h>
+
+//////////////////////////////////////////////////////////////////////
+// Glyph cache
+//////////////////////////////////////////////////////////////////////
+
+// Rasterised glyphs, 16 lines of 16 pixels per letter, bit 0 is the leftmost
+// pixel. [0] is built from the 8/16 bit fonts, [1] from the 16c fonts, as
+// custom fonts can be different for each system.
+static u16 *pa_glyphmask[2][10];
+static u32 pa_glyphready[2][10][8];
+
+void PA_ResetGlyphCache(int slot) {
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		free(pa_glyphmask[i][slot]);
+		pa_glyphmask[i][slot] = NULL;
+		memset(pa_glyphready[i][slot], 0, sizeof(pa_glyphready[i][slot]));
+	}
+}
+
+static inline u8 PA_GlyphPixel(u8 c16, u8 size, u32 tile, u8 x, u8 y) {
+	u32 i = (tile << 6) + (y << 3) + x;
+	const void *tiles = c16 ? (const void*)c16_tiles[size] : (const void*)bit8_tiles[size];
+
+	if ((size < 5) && (tiles == (const void*)bittext_tiles_blank[size])) // Default font, still compressed
+		return (bittext_tiles_blank[size][i >> 3] >> (i & 7)) & 1;
+
+	if (c16) return (c16_tiles[size][(tile << 3) + y] >> (x << 2)) & 15;
+
+	return bit8_tiles[size][i];
+}
+
+static void PA_RasterGlyphTile(u8 c16, u8 size, u32 tile, u16 *rows, u8 shift) {
+	u8 x, y;
+
+	for (y = 0; y < 8; y++) {
+		u16 bits = 0;
+
+		for (x = 0; x < 8; x++)
+			if (PA_GlyphPixel(c16, size, tile, x, y)) bits |= 1 << x;
+
+		rows[y] |= bits << shift;
+	}
+}
+
+const u16 *PA_GetGlyph(u8 c16, u8 size, u8 letter) {
+	u16 *rows;
+
+	if (pa_glyphmask[c16][size] == NULL) {
+		pa_glyphmask[c16][size] = (u16*)calloc(256 * 16, sizeof(u16));
+		PA_Assert(pa_glyphmask[c16][size] != NULL, "Not enough memory for the glyph cache");
+	}
+
+	rows = pa_glyphmask[c16][size] + (letter << 4);
+
+	if (!(pa_glyphready[c16][size][letter >> 5] & BIT(letter & 31))) {
+		if (pa_bittextpoliceheight[size] > 8) { // 4 tiles per letter
+			u16 firstpos = ((letter & 31) << 1) + ((letter >> 5) << 7);
+			PA_RasterGlyphTile(c16, size, bittext_maps[size][firstpos], rows, 0);
+			PA_RasterGlyphTile(c16, size, bittext_maps[size][firstpos + 1], rows, 8);
+			PA_RasterGlyphTile(c16, size, bittext_maps[size][firstpos + 64], rows + 8, 0);
+			PA_RasterGlyphTile(c16, size, bittext_maps[size][firstpos + 65], rows + 8, 8);
+		} else {
+			PA_RasterGlyphTile(c16, size, bittext_maps[size][letter], rows, 0);
+		}
+
+		pa_glyphready[c16][size][letter >> 5] |= BIT(letter & 31);
+	}
+
+	return rows;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Glyph blitters, also used by the font atlases
+//////////////////////////////////////////////////////////////////////
+
+// Pixels of a pair of 8 bit pixels selected by 2 bits of a glyph line
+static const u16 pa_pairmask[4] = {0x0000, 0x00FF, 0xFF00, 0xFFFF};
+
+void PA_BlitGlyph8bit(u8 screen, s16 x, s16 y, const u16 *rows, u8 lx, u8 ly, u8 color, u8 transp) {
+	u16 lut[4] = {0, color, color << 8, color | (color << 8)};
+	u32 cover = ((1 << lx) - 1) << (x & 1);
+	u16 *line = PA_DrawBg[screen] + (y << 7) + (x >> 1);
+	u8 j;
+
+	for (j = 0; j < ly; j++, line += 128) {
+		u32 ink = (rows[j] << (x & 1)) & cover;
+		u32 c = cover;
+		u16 *dst = line;
+
+		if (transp) {
+			for (; ink; ink >>= 2, dst++) {
+				u32 pair = ink & 3;
+
+				if (pair == 3) *dst = lut[3];
+				else if (pair) *dst = (*dst & ~pa_pairmask[pair]) | lut[pair];
+			}
+		} else {
+			for (; c; c >>= 2, ink >>= 2, dst++) {
+				u32 pair = c & 3;
+
+				if (pair == 3) *dst = lut[ink & 3];
+				else *dst = (*dst & ~pa_pairmask[pair]) | lut[ink & 3];
+			}
+		}
+	}
+}
+
+void PA_BlitGlyph16bit(u8 screen, s16 x, s16 y, const u16 *rows, u8 lx, u8 ly, u16 color, u8 transp) {
+	u32 lut[4] = {0, color, color << 16, color | (color << 16)};
+	u16 *line = PA_DrawBg[screen] + (y << 8) + x;
+	u8 i, j;
+
+	for (j = 0; j < ly; j++, line += 256) {
+		u32 ink = rows[j] & ((1 << lx) - 1);
+		u16 *dst = line;
+
+		if (transp) {
+			for (; ink; ink >>= 1, dst++)
+				if (ink & 1) *dst = color;
+		} else {
+			i = 0;
+
+			if (x & 1) { // Align to write 2 pixels at a time
+				*dst++ = (ink & 1) ? color : 0;
+				ink >>= 1;
+				i++;
+			}
+
+			for (; i + 1 < lx; i += 2, ink >>= 2, dst += 2)
+				*(u32*)dst = lut[ink & 3];
+
+			if (i < lx) *dst = (ink & 1) ? color : 0;
+		}
+	}
+}
+
+// Expand 4 bits of a glyph line to 4 pixels of a 16c background
+static const u16 pa_nibbleexpand[16] = {
+	0x0000, 0x0001, 0x0010, 0x0011, 0x0100, 0x0101, 0x0110, 0x0111,
+	0x1000, 0x1001, 0x1010, 0x1011, 0x1100, 0x1101, 0x1110, 0x1111
+};
+
+void PA_BlitGlyph16c(u8 screen, s16 x, s16 y, const u16 *rows, u8 ly, u8 color) {
+	x += 8;
+	y += 8;
+
+	u32 shift = (x & 7) << 2;
+	u32 *col = PA_Draw1632[screen] + PA_16cPos(x, y);
+	u8 j;
+
+	for (j = 0; j < ly; j++, col++) {
+		u32 bits = rows[j];
+
+		if (!bits) continue;
+
+		u32 lo = (pa_nibbleexpand[bits & 15] | (pa_nibbleexpand[(bits >> 4) & 15] << 16)) * color;
+		u32 hi = (pa_nibbleexpand[(bits >> 8) & 15] | (pa_nibbleexpand[(bits >> 12) & 15] << 16)) * color;
+
+		if (shift) {
+			col[0] |= lo << shift;
+			col[26 * 8] |= (lo >> (32 - shift)) | (hi << shift);
+			if (hi) col[26 * 8 * 2] |= hi >> (32 - shift);
+		} else {
+			col[0] |= lo;
+			if (hi) col[26 * 8] |= hi;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Text runs
+//////////////////////////////////////////////////////////////////////
+
+void PA_InitTextRun(PA_TextRun *run, u8 mode, u8 screen, s16 basex, s16 basey, s16 maxx, s16 maxy, u16 color, u8 size, u8 transp) {
+	memset(run, 0, sizeof(PA_TextRun));
+	run->Mode = mode;
+	run->Screen = screen;
+	run->BaseX = basex;
+	run->BaseY = basey;
+	run->MaxX = maxx;
+	run->MaxY = maxy;
+	run->Color = color;
+	run->Size = size;
+	run->Transp = ((mode == PA_TEXTRUN_16C) || transp) ? 1 : 0;
+	run->Limit = 100000;
+}
+
+static void PA_LayoutTextRun(PA_TextRun *run) {
+	s32 i;
+
+	run->NGlyphs = 0;
+	run->Dirty = 1;
+
+	if (run->Text == NULL) return;
+
+	PA_DoLetterPos(run->BaseX, run->BaseY, run->MaxX, run->MaxY, run->Text, run->Color, run->Size, 100000);
+
+	if (PA_LetterPos.NLetters > run->GlyphSpace) {
+		free(run->Glyphs);
+		run->GlyphSpace = PA_LetterPos.NLetters;
+		run->Glyphs = (PA_TextRunGlyph*)malloc(run->GlyphSpace * sizeof(PA_TextRunGlyph));
+		PA_Assert(run->Glyphs != NULL, "Not enough memory for the text run");
+	}
+
+	for (i = 0; i < PA_LetterPos.NLetters; i++) {
+		u8 letter = PA_LetterPos.Letter[i].Letter;
+		run->Glyphs[i].X = PA_LetterPos.Letter[i].X;
+		run->Glyphs[i].Y = PA_LetterPos.Letter[i].Y;
+		run->Glyphs[i].Letter = letter;
+		run->Glyphs[i].Width = pa_bittextdefaultsize[run->Size][letter];
+	}
+
+	run->NGlyphs = PA_LetterPos.NLetters;
+}
+
+u8 PA_SetTextRun(PA_TextRun *run, const char *text) {
+	if (run->Text && (strcmp(run->Text, text) == 0)) return 0; // Nothing to do
+
+	free(run->Text);
+	run->Text = strdup(text);
+	PA_LayoutTextRun(run);
+
+	return 1;
+}
+
+void PA_SetTextRunColor(PA_TextRun *run, u16 color) {
+	if (run->Color == color) return;
+
+	run->Color = color;
+	run->Dirty = 1;
+}
+
+void PA_SetTextRunPos(PA_TextRun *run, s16 basex, s16 basey, s16 maxx, s16 maxy) {
+	if ((run->BaseX == basex) && (run->BaseY == basey) && (run->MaxX == maxx) && (run->MaxY == maxy)) return;
+
+	run->BaseX = basex;
+	run->BaseY = basey;
+	run->MaxX = maxx;
+	run->MaxY = maxy;
+	PA_LayoutTextRun(run);
+}
+
+void PA_SetTextRunLimit(PA_TextRun *run, s32 limit) {
+	if (run->Limit == limit) return;
+
+	run->Limit = limit;
+	run->Dirty = 1;
+}
+
+static void PA_ClearTextRunArea(PA_TextRun *run) {
+	u8 screen = run->Screen;
+	s16 x, y;
+
+	if (run->X1 >= run->X2) return;
+
+	if (run->Mode == PA_TEXTRUN_16C) {
+		PA_16cClearZone(screen, run->X1, run->Y1, run->X2 - 1, run->Y2 - 1);
+		return;
+	}
+
+	PA_AddDirtyRect(screen, run->X1, run->Y1, run->X2, run->Y2);
+
+	for (y = run->Y1; y < run->Y2; y++) {
+		if (run->Mode == PA_TEXTRUN_16BIT) {
+			dmaFillHalfWords(0, PA_DrawBg[screen] + (y << 8) + run->X1, (run->X2 - run->X1) << 1);
+		} else {
+			x = run->X1;
+
+			if (x & 1) PA_Put8bitPixel(screen, x++, y, 0);
+
+			for (; x + 1 < run->X2; x += 2) PA_DrawBg[screen][(y << 7) + (x >> 1)] = 0;
+
+			if (x < run->X2) PA_Put8bitPixel(screen, x, y, 0);
+		}
+	}
+}
+
+s32 PA_DrawTextRun(PA_TextRun *run) {
+	u8 size = run->Size;
+	u8 ly = pa_bittextpoliceheight[size];
+	u8 c16 = (run->Mode == PA_TEXTRUN_16C);
+	s32 i, limit = run->NGlyphs;
+
+	if (!run->Dirty) return 0;
+
+	if (limit > run->Limit) limit = run->Limit;
+
+	// Erase the old text unless it's transparent and drawn on top of
+	// something else that can't be restored
+	if (run->Drawn && (!run->Transp || c16)) PA_ClearTextRunArea(run);
+
+	run->X1 = 256; run->Y1 = 192; run->X2 = 0; run->Y2 = 0;
+
+	for (i = 0; i < limit; i++) {
+		PA_TextRunGlyph *glyph = &run->Glyphs[i];
+		const u16 *rows = PA_GetGlyph(c16, size, (u8)glyph->Letter);
+		u8 lx = glyph->Width;
+
+		if (run->Mode == PA_TEXTRUN_8BIT)
+			PA_BlitGlyph8bit(run->Screen, glyph->X, glyph->Y, rows, glyph->Width, ly, run->Color, run->Transp);
+		else if (run->Mode == PA_TEXTRUN_16BIT)
+			PA_BlitGlyph16bit(run->Screen, glyph->X, glyph->Y, rows, glyph->Width, ly, run->Color, run->Transp);
+		else {
+			PA_BlitGlyph16c(run->Screen, glyph->X, glyph->Y, rows, ly, run->Color);
+			lx = (ly > 8) ? 16 : 8; // 16c letters are drawn as whole tiles
+		}
+
+		if (glyph->X < run->X1) run->X1 = glyph->X;
+		if (glyph->Y < run->Y1) run->Y1 = glyph->Y;
+		if (glyph->X + lx > run->X2) run->X2 = glyph->X + lx;
+		if (glyph->Y + ly > run->Y2) run->Y2 = glyph->Y + ly;
+	}
+
+	if (!c16) PA_AddDirtyRect(run->Screen, run->X1, run->Y1, run->X2, run->Y2);
+
+	run->Dirty = 0;
+	run->Drawn = 1;
+
+	return limit;
+}
+
+void PA_DeleteTextRun(PA_TextRun *run) {
+	free(run->Text);
+	free(run->Glyphs);
+	run->Text = NULL;
+	run->Glyphs = NULL;
+	run->NGlyphs = 0;
+	run->GlyphSpace = 0;
+}
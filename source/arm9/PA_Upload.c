@@ -0,0 +1,222 @@
+#include <PA9.h>
+
+//////////////////////////////////////////////////////////////////////
+// Copies to VRAM queued and done during the VBL, one queue per bank
+// so each bank is switched once whatever the order of the copies
+//////////////////////////////////////////////////////////////////////
+
+extern u8 pa_3Dbanks;
+
+typedef struct {
+	PA_UploadItem Items[PA_UPLOAD_MAX];
+	u16 First, Count; // Ring buffer
+} PA_UploadQueue;
+
+static PA_UploadQueue PA_UploadQueues[PA_UPLOAD_BANKS];
+static u32 PA_UploadBudget = PA_UPLOAD_BUDGET;
+static u32 PA_UploadQueued; // Bytes queued since the last VBL
+static u16 PA_UploadMerged;
+static u8 PA_UploadNextBank; // Bank copied first at the next VBL, so none waits forever
+
+u8 PA_UploadOn = 0;
+PA_UploadStats PA_UploadCounters;
+
+static const u32 PA_UploadZero = 0;
+
+// Banks in LCD mode can be written by the CPU and the DMA
+static void PA_UploadBank(u8 bank, u8 lcd) {
+	switch (bank) {
+		case PA_UPLOAD_TEXTURE:
+			vramSetBankA(lcd ? VRAM_A_LCD : VRAM_A_TEXTURE);
+			if (pa_3Dbanks == 2) vramSetBankB(lcd ? VRAM_B_LCD : VRAM_B_TEXTURE);
+			break;
+		case PA_UPLOAD_SPRITEEXTPAL(0):
+			vramSetBankG(lcd ? VRAM_G_LCD : VRAM_G_SPRITE_EXT_PALETTE);
+			break;
+		case PA_UPLOAD_SPRITEEXTPAL(1):
+			vramSetBankI(lcd ? VRAM_I_LCD : VRAM_I_SUB_SPRITE_EXT_PALETTE);
+			break;
+		case PA_UPLOAD_BGEXTPAL(0):
+			vramSetBankE(lcd ? VRAM_E_LCD : VRAM_E_BG_EXT_PALETTE);
+			break;
+		case PA_UPLOAD_BGEXTPAL(1):
+			vramSetBankH(lcd ? VRAM_H_LCD : VRAM_H_SUB_BG_EXT_PALETTE);
+			break;
+		default:
+			break;
+	}
+}
+
+// Copy with the VBL's DMA channel, 32 bits at a time when everything is aligned
+static void PA_UploadDMA(const u8 *src, u8 *dest, u32 size) {
+	u32 mode = DMA_SRC_INC;
+
+	if (src == NULL) { // Fill : the same word over and over
+		src = (const u8*)&PA_UploadZero;
+		mode = DMA_SRC_FIX;
+	}
+
+	if (((u32)src | (u32)dest | size) & 3)
+		DMA_CopyEx(PA_UPLOAD_DMA, src, dest, size >> 1, DMA_16NOW | mode);
+	else
+		DMA_CopyEx(PA_UPLOAD_DMA, src, dest, size >> 2, DMA_32NOW | mode);
+}
+
+// Copy from the queues, budget bytes at most (0 for everything)
+static void PA_UploadRun(u32 budget) {
+	u32 uploaded = 0;
+	u16 copies = 0, switches = 0;
+	u8 i, full = 0, flushed = 0;
+
+	for (i = 0; (i < PA_UPLOAD_BANKS) && !full; i++) {
+		u8 bank = (PA_UploadNextBank + i) % PA_UPLOAD_BANKS;
+		PA_UploadQueue *q = PA_UploadQueues + bank;
+
+		if (q->Count == 0) continue;
+
+		if (!flushed) { // Once for all the copies, and not at all when nothing is queued
+			DC_FlushAll();
+			flushed = 1;
+		}
+
+		PA_UploadBank(bank, 1);
+		if (bank != PA_UPLOAD_DIRECT) switches++;
+
+		while (q->Count) {
+			PA_UploadItem *item = q->Items + q->First;
+			u32 size = item->Size;
+
+			if (budget && (uploaded + size > budget)) { // Copy the beginning, the rest waits
+				size = (budget - uploaded) & ~3;
+				full = 1;
+				PA_UploadNextBank = bank;
+			}
+
+			if (size) {
+				PA_UploadDMA(item->Src, item->Dest, size);
+				uploaded += size;
+				copies++;
+			}
+
+			if (full) {
+				if (item->Src) item->Src += size;
+				item->Dest += size;
+				item->Size -= size;
+				break;
+			}
+
+			q->First = (q->First + 1) % PA_UPLOAD_MAX;
+			q->Count--;
+		}
+
+		PA_UploadBank(bank, 0);
+	}
+
+	if (!full) PA_UploadNextBank = 0;
+
+	PA_UploadCounters.Uploaded = uploaded;
+	PA_UploadCounters.Copies = copies;
+	PA_UploadCounters.Switches = switches;
+	PA_UploadCounters.Deferred = PA_UploadPending();
+}
+
+void PA_UploadVBL(void) {
+	PA_UploadCounters.Queued = PA_UploadQueued;
+	PA_UploadCounters.Merged = PA_UploadMerged;
+	PA_UploadQueued = 0;
+	PA_UploadMerged = 0;
+
+	PA_UploadRun(PA_UploadBudget);
+}
+
+u32 PA_UploadPending(void) {
+	u32 bytes = 0;
+	u8 bank;
+	u16 i;
+
+	for (bank = 0; bank < PA_UPLOAD_BANKS; bank++) {
+		PA_UploadQueue *q = PA_UploadQueues + bank;
+
+		for (i = 0; i < q->Count; i++) bytes += q->Items[(q->First + i) % PA_UPLOAD_MAX].Size;
+	}
+
+	return bytes;
+}
+
+void PA_UploadFlush(void) {
+	u16 ime = REG_IME;
+	REG_IME = 0; // The VBL copies from the same queues
+	PA_UploadRun(0);
+	REG_IME = ime;
+}
+
+void PA_UploadCopy(const void *src, void *dest, u32 size, u8 bank) {
+	PA_UploadQueue *q = PA_UploadQueues + bank;
+	PA_UploadItem *last;
+	u16 ime;
+
+	PA_Assert(bank < PA_UPLOAD_BANKS, "Wrong upload bank");
+
+	if (size == 0) return;
+
+	if (!PA_UploadOn) { // Right away
+		if (src) DC_FlushRange(src, size);
+		PA_UploadBank(bank, 1);
+		if (src) dmaCopy(src, dest, size);
+		else dmaFillWords(0, dest, size);
+		PA_UploadBank(bank, 0);
+		return;
+	}
+
+	ime = REG_IME;
+	REG_IME = 0;
+
+	if (q->Count == PA_UPLOAD_MAX) { // Nothing can wait anymore
+		PA_UploadRun(0);
+	}
+
+	PA_UploadQueued += size;
+	last = q->Items + (q->First + q->Count + PA_UPLOAD_MAX - 1) % PA_UPLOAD_MAX;
+
+	// Following the last copy, both in memory and in VRAM : make it longer
+	if (q->Count && (last->Dest + last->Size == (u8*)dest) &&
+	    (src ? (last->Src && (last->Src + last->Size == (const u8*)src)) : (last->Src == NULL))) {
+		last->Size += size;
+		PA_UploadMerged++;
+	} else {
+		PA_UploadItem *item = q->Items + (q->First + q->Count) % PA_UPLOAD_MAX;
+
+		item->Src = (const u8*)src;
+		item->Dest = (u8*)dest;
+		item->Size = size;
+		q->Count++;
+	}
+
+	REG_IME = ime;
+}
+
+void PA_UploadInit(u32 budget) {
+	PA_UploadBudget = budget;
+
+	if (PA_UploadOn) return;
+
+	memset(PA_UploadQueues, 0, sizeof(PA_UploadQueues));
+	memset(&PA_UploadCounters, 0, sizeof(PA_UploadCounters));
+	PA_UploadQueued = 0;
+	PA_UploadMerged = 0;
+	PA_UploadNextBank = 0;
+	PA_UploadOn = 1;
+	UploadVBL = PA_UploadVBL;
+}
+
+void PA_UploadStop(void) {
+	if (!PA_UploadOn) return;
+
+	UploadVBL = PA_Nothing;
+	PA_UploadFlush();
+	PA_UploadOn = 0;
+}
+
+void PA_UploadSetBudget(u32 budget) {
+	PA_UploadBudget = budget;
+}
@@ -51,8 +51,8 @@
 static int DGifGetWord(GifFileType *GifFile, GifWord *Word);
 static int DGifSetupDecompress(GifFileType *GifFile);
 static int DGifDecompressLine(GifFileType *GifFile, GifPixelType *Line,
-                              int LineLen);
-static int DGifGetPrefixChar(GifPrefixType *Prefix, int Code, int ClearCode);
+                              unsigned short *Line16,
+                              const unsigned short *Palette, int LineLen);
 static int DGifDecompressInput(GifFileType *GifFile, int *Code);
 static int DGifBufferedInput(GifFileType *GifFile, GifByteType *Buf,
                              GifByteType *NextByte);
@@ -267,9 +267,9 @@ DGifGetImageDesc(GifFileType * GifFile) {
     GifFile->Image.Interlace = (Buf[0] & 0x40);
     if (Buf[0] & 0x80) {    /* Does this image have local color map? */
 
-        /*** FIXME: Why do we check both of these in order to do this? 
-         * Why do we have both Image and SavedImages? */
-        if (GifFile->Image.ColorMap && GifFile->SavedImages == NULL)
+        /* SavedImages keeps its own copy of the color map, so the one of
+         * the last image can always be freed: */
+        if (GifFile->Image.ColorMap)
             FreeMapObject(GifFile->Image.ColorMap);
 
         GifFile->Image.ColorMap = MakeMapObject(1 << BitsPerPixel, NULL);
@@ -336,12 +336,15 @@ DGifGetImageDesc(GifFileType * GifFile) {
 }
 
 /******************************************************************************
- * Get one full scanned line (Line) of length LineLen from GIF file.
+ * Get LineLen pixels from GIF file, as palette indexes in Line or as colors
+ * in Line16 if it isn't NULL.
  *****************************************************************************/
-int
-DGifGetLine(GifFileType * GifFile,
-            GifPixelType * Line,
-            int LineLen) {
+static int
+DGifGetPixels(GifFileType * GifFile,
+              GifPixelType * Line,
+              unsigned short * Line16,
+              const unsigned short * Palette,
+              int LineLen) {
 
     GifByteType *Dummy;
     GifFilePrivateType *Private = (GifFilePrivateType *) GifFile->Private;
@@ -364,7 +367,7 @@ DGifGetLine(GifFileType * GifFile,
         return GIF_ERROR;
     }
 
-    if (DGifDecompressLine(GifFile, Line, LineLen) == GIF_OK) {
+    if (DGifDecompressLine(GifFile, Line, Line16, Palette, LineLen) == GIF_OK) {
         if (Private->PixelCount == 0) {
             /* We probably would not be called any more, so lets clean
              * everything before we return: need to flush out all rest of
@@ -380,6 +383,68 @@ DGifGetLine(GifFileType * GifFile,
         return GIF_ERROR;
 }
 
+/******************************************************************************
+ * Get one full scanned line (Line) of length LineLen from GIF file.
+ *****************************************************************************/
+int
+DGifGetLine(GifFileType * GifFile,
+            GifPixelType * Line,
+            int LineLen) {
+
+    return DGifGetPixels(GifFile, Line, NULL, NULL, LineLen);
+}
+
+/******************************************************************************
+ * Get one full scanned line of length LineLen from GIF file, as 16 bit colors
+ * looked up in Palette while decoding.
+ *****************************************************************************/
+int
+DGifGetLine16(GifFileType * GifFile,
+              unsigned short * Line,
+              int LineLen,
+              const unsigned short * Palette) {
+
+    return DGifGetPixels(GifFile, NULL, Line, Palette, LineLen);
+}
+
+/******************************************************************************
+ * Get the whole image straight into Dest, Pitch pixels per line, taking care
+ * of interlacing. Dest holds palette indexes, or 16 bit colors looked up in
+ * Palette if it isn't NULL. Dest must accept byte writes for indexes.
+ *****************************************************************************/
+int
+DGifGetImage(GifFileType * GifFile,
+             void * Dest,
+             int Pitch,
+             const unsigned short * Palette) {
+
+    static const int InterlacedOffset[] = { 0, 4, 2, 1 };
+    static const int InterlacedJumps[] = { 8, 8, 4, 2 };
+    int i, j, Width = GifFile->Image.Width, Height = GifFile->Image.Height;
+
+    for (i = 0; i < 4; i++) {
+        int Start = GifFile->Image.Interlace ? InterlacedOffset[i] : 0;
+        int Jump = GifFile->Image.Interlace ? InterlacedJumps[i] : 1;
+
+        for (j = Start; j < Height; j += Jump) {
+            if (Palette) {
+                if (DGifGetPixels(GifFile, NULL, (unsigned short *)Dest + j * Pitch,
+                                  Palette, Width) == GIF_ERROR)
+                    return GIF_ERROR;
+            } else {
+                if (DGifGetPixels(GifFile, (GifPixelType *)Dest + j * Pitch,
+                                  NULL, NULL, Width) == GIF_ERROR)
+                    return GIF_ERROR;
+            }
+        }
+
+        if (!GifFile->Image.Interlace)
+            break;
+    }
+
+    return GIF_OK;
+}
+
 /******************************************************************************
  * Put one pixel (Pixel) into GIF file.
  *****************************************************************************/
@@ -405,7 +470,7 @@ DGifGetPixel(GifFileType * GifFile,
         return GIF_ERROR;
     }
 
-    if (DGifDecompressLine(GifFile, &Pixel, 1) == GIF_OK) {
+    if (DGifDecompressLine(GifFile, &Pixel, NULL, NULL, 1) == GIF_OK) {
         if (Private->PixelCount == 0) {
             /* We probably would not be called any more, so lets clean
              * everything before we return: need to flush out all rest of
@@ -614,7 +679,6 @@ DGifSetupDecompress(GifFileType * GifFile) {
 
     int i, BitsPerPixel;
     GifByteType CodeSize;
-    GifPrefixType *Prefix;
     GifFilePrivateType *Private = (GifFilePrivateType *)GifFile->Private;
 
     READ(GifFile, &CodeSize, 1);    /* Read Code size from file. */
@@ -632,40 +696,57 @@ DGifSetupDecompress(GifFileType * GifFile) {
     Private->CrntShiftState = 0;    /* No information in CrntShiftDWord. */
     Private->CrntShiftDWord = 0;
 
-    Prefix = Private->Prefix;
-    for (i = 0; i <= LZ_MAX_CODE; i++)
-        Prefix[i] = NO_SUCH_CODE;
+    /* Pixel codes are strings of one pixel, the other codes are empty until
+     * the decoder defines them, which sets all the rest: */
+    for (i = 0; i < Private->ClearCode; i++) {
+        Private->Prefix[i] = NO_SUCH_CODE;
+        Private->Suffix[i] = Private->FirstChar[i] = i;
+        Private->Length[i] = 1;
+    }
+    memset(Private->Length + Private->ClearCode, 0,
+           (LZ_MAX_CODE + 1 - Private->ClearCode) * sizeof(GifPrefixType));
 
     return GIF_OK;
 }
 
 /******************************************************************************
  * The LZ decompression routine:
- * This version decompress the given gif file into Line of length LineLen.
+ * This version decompress the given gif file into Line of length LineLen, or
+ * into Line16 through Palette if Line16 isn't NULL.
  * This routine can be called few times (one per scan line, for example), in
  * order the complete the whole image.
+ * Each code keeps the length and the first pixel of its string, so a string
+ * is written in place from its last pixel back through the prefixes, in one
+ * pass. The stack is only used for a string that doesn't fit in the line.
  *****************************************************************************/
 static int
 DGifDecompressLine(GifFileType * GifFile,
                    GifPixelType * Line,
+                   unsigned short * Line16,
+                   const unsigned short * Palette,
                    int LineLen) {
 
     int i = 0;
-    int j, CrntCode, EOFCode, ClearCode, CrntPrefix, LastCode, StackPtr;
-    GifByteType *Stack, *Suffix;
-    GifPrefixType *Prefix;
+    int j, Len, Code, CrntCode, EOFCode, ClearCode, LastCode, StackPtr;
+    GifByteType *Stack, *Suffix, *FirstChar;
+    GifPrefixType *Prefix, *Length;
     GifFilePrivateType *Private = (GifFilePrivateType *) GifFile->Private;
 
     StackPtr = Private->StackPtr;
     Prefix = Private->Prefix;
     Suffix = Private->Suffix;
+    FirstChar = Private->FirstChar;
+    Length = Private->Length;
     Stack = Private->Stack;
     EOFCode = Private->EOFCode;
     ClearCode = Private->ClearCode;
     LastCode = Private->LastCode;
 
-    if (StackPtr != 0) {
-        /* Let pop the stack off before continueing to read the gif file: */
+    /* Let pop the stack off before continueing to read the gif file: */
+    if (Line16) {
+        while (StackPtr != 0 && i < LineLen)
+            Line16[i++] = Palette[Stack[--StackPtr]];
+    } else {
         while (StackPtr != 0 && i < LineLen)
             Line[i++] = Stack[--StackPtr];
     }
@@ -684,78 +765,70 @@ DGifDecompressLine(GifFileType * GifFile,
             }
             i++;
         } else if (CrntCode == ClearCode) {
-            /* We need to start over again: */
-            for (j = 0; j <= LZ_MAX_CODE; j++)
-                Prefix[j] = NO_SUCH_CODE;
+            /* We need to start over again, only the codes defined since the
+             * last clear code have to be emptied: */
+            for (j = EOFCode + 1; j <= LZ_MAX_CODE && j < Private->RunningCode; j++)
+                Length[j] = 0;
             Private->RunningCode = Private->EOFCode + 1;
             Private->RunningBits = Private->BitsPerPixel + 1;
             Private->MaxCode1 = 1 << Private->RunningBits;
             LastCode = Private->LastCode = NO_SUCH_CODE;
         } else {
-            /* Its regular code - if in pixel range simply add it to output
-             * stream, otherwise trace to codes linked list until the prefix
-             * is in pixel range: */
-            if (CrntCode < ClearCode) {
-                /* This is simple - its pixel scalar, so add it to output: */
-                Line[i++] = CrntCode;
-            } else {
-                /* Its a code to needed to be traced: trace the linked list
-                 * until the prefix is a pixel, while pushing the suffix
-                 * pixels on our stack. If we done, pop the stack in reverse
-                 * (thats what stack is good for!) order to output.  */
-                if (Prefix[CrntCode] == NO_SUCH_CODE) {
-                    /* Only allowed if CrntCode is exactly the running code:
-                     * In that case CrntCode = XXXCode, CrntCode or the
-                     * prefix code is last code and the suffix char is
-                     * exactly the prefix of last code! */
-                    if (CrntCode == Private->RunningCode - 2) {
-                        CrntPrefix = LastCode;
-                        Suffix[Private->RunningCode - 2] =
-                           Stack[StackPtr++] = DGifGetPrefixChar(Prefix,
-                                                                 LastCode,
-                                                                 ClearCode);
-                    } else {
-                        _GifError = D_GIF_ERR_IMAGE_DEFECT;
-                        return GIF_ERROR;
-                    }
-                } else
-                    CrntPrefix = CrntCode;
-
-                /* Now (if image is O.K.) we should not get an NO_SUCH_CODE
-                 * During the trace. As we might loop forever, in case of
-                 * defective image, we count the number of loops we trace
-                 * and stop if we got LZ_MAX_CODE. obviously we can not
-                 * loop more than that.  */
-                j = 0;
-                while (j++ <= LZ_MAX_CODE &&
-                       CrntPrefix > ClearCode && CrntPrefix <= LZ_MAX_CODE) {
-                    Stack[StackPtr++] = Suffix[CrntPrefix];
-                    CrntPrefix = Prefix[CrntPrefix];
-                }
-                if (j >= LZ_MAX_CODE || CrntPrefix > LZ_MAX_CODE) {
+            if (Length[CrntCode] == 0) {
+                /* Only allowed if CrntCode is exactly the running code:
+                 * In that case the string is the last code's string followed
+                 * by its own first pixel. */
+                if (CrntCode == Private->RunningCode - 2 &&
+                    LastCode != NO_SUCH_CODE) {
+                    Prefix[CrntCode] = LastCode;
+                    Suffix[CrntCode] = FirstChar[CrntCode] = FirstChar[LastCode];
+                    Length[CrntCode] = Length[LastCode] + 1;
+                } else {
                     _GifError = D_GIF_ERR_IMAGE_DEFECT;
                     return GIF_ERROR;
                 }
-                /* Push the last character on stack: */
-                Stack[StackPtr++] = CrntPrefix;
-
-                /* Now lets pop all the stack into output: */
-                while (StackPtr != 0 && i < LineLen)
-                    Line[i++] = Stack[--StackPtr];
+            } else if (LastCode != NO_SUCH_CODE &&
+                       Length[Private->RunningCode - 2] == 0) {
+                /* New string: the last one followed by the first pixel of
+                 * this one. Once the table is full no code is redefined. */
+                Code = Private->RunningCode - 2;
+                Prefix[Code] = LastCode;
+                Suffix[Code] = FirstChar[CrntCode];
+                FirstChar[Code] = FirstChar[LastCode];
+                Length[Code] = Length[LastCode] + 1;
             }
-            if (LastCode != NO_SUCH_CODE) {
-                Prefix[Private->RunningCode - 2] = LastCode;
-
-                if (CrntCode == Private->RunningCode - 2) {
-                    /* Only allowed if CrntCode is exactly the running code:
-                     * In that case CrntCode = XXXCode, CrntCode or the
-                     * prefix code is last code and the suffix char is
-                     * exactly the prefix of last code! */
-                    Suffix[Private->RunningCode - 2] =
-                       DGifGetPrefixChar(Prefix, LastCode, ClearCode);
+
+            Len = Length[CrntCode];
+            Code = CrntCode;
+
+            if (i + Len <= LineLen) {
+                /* The whole string fits, write it from its end: */
+                if (Line16) {
+                    for (j = i + Len - 1; j >= i; j--) {
+                        Line16[j] = Palette[Suffix[Code]];
+                        Code = Prefix[Code];
+                    }
+                } else {
+                    for (j = i + Len - 1; j >= i; j--) {
+                        Line[j] = Suffix[Code];
+                        Code = Prefix[Code];
+                    }
+                }
+                i += Len;
+            } else {
+                /* Push the string on the stack, the end of it will go to the
+                 * next line: */
+                for (j = 0; j < Len; j++) {
+                    Stack[StackPtr++] = Suffix[Code];
+                    Code = Prefix[Code];
+                }
+
+                if (Line16) {
+                    while (StackPtr != 0 && i < LineLen)
+                        Line16[i++] = Palette[Stack[--StackPtr]];
                 } else {
-                    Suffix[Private->RunningCode - 2] =
-                       DGifGetPrefixChar(Prefix, CrntCode, ClearCode);
+                    while (StackPtr != 0 && i < LineLen)
+                        Line[i++] = Stack[--StackPtr];
                 }
             }
             LastCode = CrntCode;
@@ -768,24 +841,6 @@ DGifDecompressLine(GifFileType * GifFile,
     return GIF_OK;
 }
 
-/******************************************************************************
- * Routine to trace the Prefixes linked list until we get a prefix which is
- * not code, but a pixel value (less than ClearCode). Returns that pixel value.
- * If image is defective, we might loop here forever, so we limit the loops to
- * the maximum possible if image O.k. - LZ_MAX_CODE times.
- *****************************************************************************/
-static int
-DGifGetPrefixChar(GifPrefixType *Prefix,
-                  int Code,
-                  int ClearCode) {
-
-    int i = 0;
-
-    while (Code > ClearCode && i++ <= LZ_MAX_CODE)
-        Code = Prefix[Code];
-    return Code;
-}
-
 /******************************************************************************
  * Interface for accessing the LZ codes directly. Set Code to the real code
  * (12bits), or to -1 if EOF code is returned.
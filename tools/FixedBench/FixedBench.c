@@ -0,0 +1,222 @@
+// FixedBench - checks the precision of the PAlib fixed point math (PA_Fixed.c)
+// and times it, on a computer. Returns 1 if a precision check fails.
+//
+// Build it on Linux, from this folder (see ../host/ReadMe.txt):
+//   make -C ../host
+//   gcc -O2 -no-pie -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast -I../host -I../../include -I../../include/arm9 -o FixedBench FixedBench.c ../host/build/libPAhost.a -lm
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+#include "PA9.h"
+
+#define PI 3.14159265358979323846
+#define COUNT 1000000
+
+static s32 failed = 0;
+
+static void Check(const char *name, double error, double bound) {
+	printf("%-28s max error %8.3f (bound %g) %s\n", name, error, bound, (error <= bound) ? "ok" : "FAILED");
+	if (error > bound) failed = 1;
+}
+
+static double Now(void) {
+	return (double)clock() / CLOCKS_PER_SEC;
+}
+
+static s32 Random(s32 bits) {
+	s32 v = ((rand() << 16) ^ rand()) & ((1u << bits) - 1);
+	return (rand() & 1) ? -v : v;
+}
+
+// Difference between 2 angles on a circle of the given size
+static double AngleError(double a, double b, double turn) {
+	double d = fmod(fabs(a - b), turn);
+	return (d > turn / 2) ? turn - d : d;
+}
+
+static void Precision(void) {
+	double err;
+	s32 i;
+
+	err = 0;
+	for (i = 0; i < 4096; i++) {
+		double e = fabs(PA_SinF(i) - 4096 * sin(i * 2 * PI / 4096));
+		double c = fabs(PA_CosF(i) - 4096 * cos(i * 2 * PI / 4096));
+		if (e > err) err = e;
+		if (c > err) err = c;
+	}
+	Check("PA_SinF, PA_CosF", err, 0.5);
+
+	err = 0;
+	for (i = 0; i < COUNT; i++) {
+		s32 x = Random(1 + i % 31), y = Random(1 + (i / 31) % 31);
+		double exact;
+
+		if ((x == 0) && (y == 0)) continue;
+
+		exact = atan2(y, x) * 4096 / (2 * PI);
+		if (exact < 0) exact += 4096;
+		exact = AngleError(PA_Atan2F(y, x), exact, 4096);
+		if (exact > err) err = exact;
+	}
+	Check("PA_Atan2F", err, 1);
+
+	err = 0;
+	for (i = 0; i < COUNT; i++) {
+		u32 v = (i < 70000) ? i : (((u32)rand() << 16) ^ rand()) >> (i & 15);
+		PA_SqrtStart(v);
+		if ((u64)PA_SqrtResult() * PA_SqrtResult() > v) err = 1;
+		if ((u64)(PA_SqrtResult() + 1) * (PA_SqrtResult() + 1) <= v) err = 1;
+	}
+	Check("PA_Sqrt32 (rounded down)", err, 0);
+
+	err = 0;
+	for (i = 0; i < COUNT; i++) {
+		s32 x = Random(1 + i % 30), y = Random(1 + (i / 30) % 30);
+		double e = fabs(PA_LengthF(x, y) - sqrt((double)x * x + (double)y * y));
+		if (e > err) err = e;
+	}
+	Check("PA_LengthF", err, 1);
+
+	err = 0;
+	for (i = 0; i < COUNT; i++) {
+		s32 x = Random(8 + i % 12);
+		double e;
+
+		if (x == 0) continue;
+		e = fabs(PA_InvF32(x) - 4096.0 * 4096.0 / x);
+		if (e > err) err = e;
+	}
+	Check("PA_InvF32", err, 1);
+
+	err = 0;
+	for (i = 0; i < COUNT / 10; i++) {
+		PA_Point v = {Random(20), Random(20)};
+		double len;
+
+		if ((v.x == 0) && (v.y == 0)) continue;
+		PA_NormalizeF(&v);
+		len = fabs(sqrt((double)v.x * v.x + (double)v.y * v.y) - 4096);
+		if (len > err) err = len;
+	}
+	Check("PA_NormalizeF (length)", err, 2);
+
+	err = 0;
+	for (i = 0; i < COUNT / 10; i++) {
+		PA_Transform2 t;
+		PA_Point p = {Random(16), Random(16)}, q;
+		s32 angle = rand() & 4095, scale = 1024 + (rand() & 8191);
+		double a = angle * 2 * PI / 4096, s = scale / 4096.0;
+		double x = (cos(a) * p.x - sin(a) * p.y) * s + 100, y = (sin(a) * p.x + cos(a) * p.y) * s - 50;
+		double e;
+
+		PA_Transform2RotScale(&t, angle, scale, 100, -50);
+		PA_TransformPoints(&t, &p, &q, 1);
+
+		// The matrix is rounded to 1/4096 and the sines to 1/4096 of the scale,
+		// so the error grows with the coordinates
+		e = (fabs(q.x - x) + fabs(q.y - y)) / (2 + (fabs(p.x) + fabs(p.y)) * (1 + s) / 4096);
+		if (e > err) err = e;
+	}
+	Check("PA_TransformPoints", err, 1);
+
+	// The arrays give the same results as one at a time
+	{
+		PA_Point pos[1000];
+		u32 dist[1000];
+		u16 angle[1000];
+
+		for (i = 0; i < 1000; i++) {
+			pos[i].x = Random(16);
+			pos[i].y = Random(16);
+		}
+
+		PA_PointsDistance(pos, 1000, 12, -7, dist);
+		PA_PointsAngle(pos, 1000, 12, -7, angle);
+
+		err = 0;
+		for (i = 0; i < 1000; i++) {
+			if (dist[i] != PA_LengthF(pos[i].x - 12, pos[i].y + 7)) err = 1;
+			if (angle[i] != PA_Atan2F(pos[i].y + 7, pos[i].x - 12)) err = 1;
+		}
+		Check("PA_PointsDistance/Angle", err, 0);
+	}
+
+	// PA_GetAngle is now PA_Atan2F rounded to 512 angles, with y going up
+	err = 0;
+	for (i = 0; i < COUNT; i++) {
+		s32 x = Random(9), y = Random(9);
+		double exact, got;
+
+		if ((x == 0) && (y == 0)) continue;
+		exact = atan2(-y, x) * 512 / (2 * PI);
+		got = ((PA_Atan2F(-y, x) + 4) >> 3) & 511;
+		exact = AngleError(got, exact < 0 ? exact + 512 : exact, 512);
+		if (exact > err) err = exact;
+	}
+	Check("PA_GetAngle (512 angles)", err, 0.5 + 1.0 / 8);
+}
+
+static void Speed(void) {
+	static PA_Point pos[COUNT / 10], out[COUNT / 10];
+	static u16 angles[COUNT / 10];
+	static u32 dists[COUNT / 10];
+	volatile double dsum = 0;
+	volatile s32 isum = 0;
+	PA_Transform2 t;
+	double t0;
+	s32 i;
+
+	for (i = 0; i < COUNT / 10; i++) {
+		pos[i].x = Random(14);
+		pos[i].y = Random(14);
+	}
+
+	printf("\nOn this computer, the DS divider and square root done in C:\n");
+
+	t0 = Now();
+	for (i = 0; i < COUNT * 10; i++) isum += PA_SinF(i);
+	printf("%-28s %8.1f ns\n", "PA_SinF", (Now() - t0) * 1e9 / (COUNT * 10));
+
+	t0 = Now();
+	for (i = 0; i < COUNT * 10; i++) dsum += sin(i * (2 * PI / 4096));
+	printf("%-28s %8.1f ns\n", "sin (double)", (Now() - t0) * 1e9 / (COUNT * 10));
+
+	t0 = Now();
+	for (i = 0; i < COUNT; i++) isum += PA_Atan2F(pos[i % (COUNT / 10)].y, pos[i % (COUNT / 10)].x);
+	printf("%-28s %8.1f ns\n", "PA_Atan2F", (Now() - t0) * 1e9 / COUNT);
+
+	t0 = Now();
+	for (i = 0; i < COUNT; i++) dsum += atan2(pos[i % (COUNT / 10)].y, pos[i % (COUNT / 10)].x);
+	printf("%-28s %8.1f ns\n", "atan2 (double)", (Now() - t0) * 1e9 / COUNT);
+
+	t0 = Now();
+	for (i = 0; i < 10; i++) PA_PointsAngle(pos, COUNT / 10, 5, 5, angles);
+	printf("%-28s %8.1f ns per point\n", "PA_PointsAngle", (Now() - t0) * 1e9 / COUNT);
+
+	t0 = Now();
+	for (i = 0; i < 10; i++) PA_PointsDistance(pos, COUNT / 10, 5, 5, dists);
+	printf("%-28s %8.1f ns per point\n", "PA_PointsDistance", (Now() - t0) * 1e9 / COUNT);
+
+	PA_Transform2RotScale(&t, 300, 5000, 10, 10);
+	t0 = Now();
+	for (i = 0; i < 10; i++) PA_TransformPoints(&t, pos, out, COUNT / 10);
+	printf("%-28s %8.1f ns per point\n", "PA_TransformPoints", (Now() - t0) * 1e9 / COUNT);
+
+	t0 = Now();
+	for (i = 0; i < 10; i++) PA_MovePoints(out, pos, COUNT / 10);
+	printf("%-28s %8.1f ns per point\n", "PA_MovePoints", (Now() - t0) * 1e9 / COUNT);
+
+	(void)dsum; (void)isum;
+}
+
+int main(void) {
+	srand(1);
+
+	Precision();
+	Speed();
+
+	return failed;
+}
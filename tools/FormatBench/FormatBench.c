@@ -0,0 +1,205 @@
+// FormatBench - checks the PAlib text formatting (PA_Format.c) against the C library's
+// snprintf and times both, on a computer. Returns 1 if a check fails.
+//
+// Build it on Linux, from this folder (see ../host/ReadMe.txt):
+//   make -C ../host
+//   gcc -O2 -no-pie -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast -I../host -I../../include -I../../include/arm9 -o FormatBench FormatBench.c ../host/build/libPAhost.a -lm
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "PA9.h"
+
+#define COUNT 200000
+
+static s32 Errors;
+
+static double Now(void) {
+	return (double)clock() / CLOCKS_PER_SEC;
+}
+
+static u32 Random32(void) {
+	u32 v = ((u32)rand() << 16) ^ (u32)rand();
+	return v >> (rand() & 31); // Small numbers as often as big ones
+}
+
+static u64 Random64(void) {
+	return (((u64)Random32() << 32) | Random32()) >> (rand() & 63);
+}
+
+// A random % with flags, width and precision, then the conversion
+static void RandomSpec(char *spec, const char *flags, u8 precision, const char *conversion) {
+	s32 n = 0, i;
+
+	spec[n++] = '%';
+	for (i = 0; flags[i]; i++)
+		if (rand() & 3) {} else spec[n++] = flags[i];
+	if (rand() & 1) n += sprintf(spec + n, "%d", rand() % 20);
+	if (precision && (rand() & 1)) n += sprintf(spec + n, ".%d", rand() % 10);
+	strcpy(spec + n, conversion);
+}
+
+static void Compare(const char *spec, const char *mine, const char *expected) {
+	if (strcmp(mine, expected) == 0) return;
+	if (Errors < 20) printf("  FAILED : \"%s\" gives \"%s\" instead of \"%s\"\n", spec, mine, expected);
+	Errors++;
+}
+
+// The decimals are rounded half away from zero, snprintf rounds exact halves to even
+static double AwayFromHalf(double value, s32 precision) {
+	char digits[400], *point;
+	s32 i;
+
+	snprintf(digits, sizeof(digits), "%.300f", value);
+	point = strchr(digits, '.');
+	if (point[precision + 1] != '5') return value;
+	for (i = precision + 2; point[i]; i++) if (point[i] != '0') return value;
+
+	return nextafter(value, (value < 0) ? -INFINITY : INFINITY);
+}
+
+static void TestIntegers(void) {
+	char spec[32], mine[128], expected[128];
+	s32 i;
+
+	printf("Integers, %d of each with random flags, width and precision\n", COUNT);
+	for (i = 0; i < COUNT; i++) {
+		s32 d = (s32)Random32() * ((rand() & 1) ? -1 : 1);
+		u32 u = Random32();
+		s64 ld = (s64)Random64() * ((rand() & 1) ? -1 : 1);
+		u64 lu = Random64();
+
+		RandomSpec(spec, "-0+ ", 1, "d");
+		PA_Format(mine, sizeof(mine), spec, d); snprintf(expected, sizeof(expected), spec, d);
+		Compare(spec, mine, expected);
+
+		RandomSpec(spec, "-0+ ", 1, "lld");
+		PA_Format(mine, sizeof(mine), spec, ld); snprintf(expected, sizeof(expected), spec, ld);
+		Compare(spec, mine, expected);
+
+		RandomSpec(spec, "-0", 1, "u");
+		PA_Format(mine, sizeof(mine), spec, u); snprintf(expected, sizeof(expected), spec, u);
+		Compare(spec, mine, expected);
+
+		RandomSpec(spec, "-0", 1, "llu");
+		PA_Format(mine, sizeof(mine), spec, lu); snprintf(expected, sizeof(expected), spec, lu);
+		Compare(spec, mine, expected);
+
+		// %x is in capitals, like the text functions always wrote it
+		RandomSpec(spec, "-0", 1, "X");
+		PA_Format(mine, sizeof(mine), spec, u); snprintf(expected, sizeof(expected), spec, u);
+		Compare(spec, mine, expected);
+		spec[strlen(spec) - 1] = 'x';
+		PA_Format(mine, sizeof(mine), spec, u);
+		Compare(spec, mine, expected);
+	}
+}
+
+static void TestText(void) {
+	static const char *texts[] = {"", "a", "Hello", "PAlib text", "0123456789abcdefghij"};
+	char spec[32], mine[128], expected[128];
+	s32 i;
+
+	printf("Text, %%s and %%c, %d of each\n", COUNT);
+	for (i = 0; i < COUNT; i++) {
+		const char *text = texts[rand() % 5];
+		char c = 'A' + rand() % 26;
+
+		RandomSpec(spec, "-", 1, "s");
+		PA_Format(mine, sizeof(mine), spec, text); snprintf(expected, sizeof(expected), spec, text);
+		Compare(spec, mine, expected);
+
+		RandomSpec(spec, "-", 0, "c");
+		PA_Format(mine, sizeof(mine), spec, c); snprintf(expected, sizeof(expected), spec, c);
+		Compare(spec, mine, expected);
+	}
+
+	// Color codes are left for the text functions, %% and the cut at the end of the buffer
+	PA_Format(mine, sizeof(mine), "%c1Red%c0 100%%"); Compare("%c1Red%c0 100%%", mine, "%c1Red%c0 100%");
+	PA_Format(mine, 8, "%d apples", 12345); Compare("%d apples, cut", mine, "12345 a");
+	Compare("length", (PA_Format(mine, 8, "%d apples", 12345) == 7) ? "" : "wrong", "");
+}
+
+static void TestDecimals(void) {
+	char spec[32], mine[128], expected[128];
+	s32 i;
+
+	printf("Decimals, %%f and fixed point %%q/%%Q, %d of each\n", COUNT);
+	for (i = 0; i < COUNT; i++) {
+		double f = ldexp((double)(s32)(((u32)rand() << 16) ^ rand()), (rand() % 60) - 50);
+		s32 q = (s32)Random32() * ((rand() & 1) ? -1 : 1);
+		s32 precision;
+
+		RandomSpec(spec, "-0+ ", 1, "f");
+		precision = strchr(spec, '.') ? atoi(strchr(spec, '.') + 1) : 6;
+		PA_Format(mine, sizeof(mine), spec, f);
+		snprintf(expected, sizeof(expected), spec, AwayFromHalf(f, precision));
+		Compare(spec, mine, expected);
+
+		RandomSpec(spec, "-0+ ", 1, "q");
+		precision = strchr(spec, '.') ? atoi(strchr(spec, '.') + 1) : 3;
+		PA_Format(mine, sizeof(mine), spec, q);
+		spec[strlen(spec) - 1] = 'f';
+		if (!strchr(spec, '.')) strcpy(spec + strlen(spec) - 1, ".3f");
+		snprintf(expected, sizeof(expected), spec, AwayFromHalf(q / 256.0, precision));
+		Compare(spec, mine, expected);
+
+		RandomSpec(spec, "-0+ ", 1, "Q");
+		precision = strchr(spec, '.') ? atoi(strchr(spec, '.') + 1) : 3;
+		PA_Format(mine, sizeof(mine), spec, q);
+		spec[strlen(spec) - 1] = 'f';
+		if (!strchr(spec, '.')) strcpy(spec + strlen(spec) - 1, ".3f");
+		snprintf(expected, sizeof(expected), spec, AwayFromHalf(q / 4096.0, precision));
+		Compare(spec, mine, expected);
+	}
+}
+
+// Characters written per millisecond for a typical line of a game's text
+static void Bench(void) {
+	char out[128];
+	s32 i, chars = 0;
+	double t1, t2;
+
+	t1 = Now();
+	for (i = 0; i < COUNT * 5; i++) chars += PA_Format(out, sizeof(out), "Score %8d  Lives %d  Time %02d:%02d  %s", i * 17, i & 7, (i >> 6) % 60, i % 60, "Go");
+	t1 = Now() - t1;
+
+	t2 = Now();
+	for (i = 0; i < COUNT * 5; i++) snprintf(out, sizeof(out), "Score %8d  Lives %d  Time %02d:%02d  %s", i * 17, i & 7, (i >> 6) % 60, i % 60, "Go");
+	t2 = Now() - t2;
+
+	printf("Times, integers and text, on a computer\n");
+	printf("  PA_Format %8.0f characters per ms\n", chars / (t1 * 1000));
+	printf("  snprintf  %8.0f characters per ms\n", chars / (t2 * 1000));
+
+	chars = 0;
+	t1 = Now();
+	for (i = 0; i < COUNT * 5; i++) chars += PA_Format(out, sizeof(out), "X %.2f Y %.2f Speed %f", i * 0.37, i * -1.5, i / 3.0);
+	t1 = Now() - t1;
+
+	t2 = Now();
+	for (i = 0; i < COUNT * 5; i++) snprintf(out, sizeof(out), "X %.2f Y %.2f Speed %f", i * 0.37, i * -1.5, i / 3.0);
+	t2 = Now() - t2;
+
+	printf("Times, %%f, on a computer\n");
+	printf("  PA_Format %8.0f characters per ms\n", chars / (t1 * 1000));
+	printf("  snprintf  %8.0f characters per ms\n", chars / (t2 * 1000));
+}
+
+int main(void) {
+	srand(1);
+
+	TestIntegers();
+	TestText();
+	TestDecimals();
+	Bench();
+
+	if (Errors) {
+		printf("%d errors\n", Errors);
+		return 1;
+	}
+	printf("All good\n");
+	return 0;
+}
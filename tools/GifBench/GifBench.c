@@ -0,0 +1,192 @@
+// GifBench - checks and times the gif decoder (source/arm9/gif/dgif_lib.c) on a computer
+//
+// Build with any C compiler, from this folder:
+//   gcc -O2 -I../../include/arm9/gif -o GifBench GifBench.c OldDgif.c ../../source/arm9/gif/dgif_lib.c ../../source/arm9/gif/gifalloc.c ../../source/arm9/gif/gif_err.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "gif_lib.h"
+
+GifFileType *OldDGifOpen(void *userData, InputFunc readFunc);
+int OldDGifGetRecordType(GifFileType *GifFile, GifRecordType *GifType);
+int OldDGifGetImageDesc(GifFileType *GifFile);
+int OldDGifGetLine(GifFileType *GifFile, GifPixelType *GifLine, int GifLineLen);
+int OldDGifGetExtension(GifFileType *GifFile, int *GifExtCode, GifByteType **GifExtension);
+int OldDGifGetExtensionNext(GifFileType *GifFile, GifByteType **GifExtension);
+int OldDGifCloseFile(GifFileType *GifFile);
+
+#define MINTIME 0.2 // Seconds each decoder runs on each file
+
+// Same reading as PA_Gif.c, from memory
+static int ReadFunc(GifFileType *GifFile, GifByteType *buf, int count) {
+	char *ptr = (char*)GifFile->UserData;
+	memcpy(buf, ptr, count);
+	GifFile->UserData = ptr + count;
+	return count;
+}
+
+static double Now(void) {
+	return (double)clock() / CLOCKS_PER_SEC;
+}
+
+// Decodes all the frames of a gif one over the other on a canvas, the way
+// PA_Gif.c draws them, and appends the canvas to out after each frame :
+// 8 bit palette indexes, or 16 bit colors if bits is 16. Old decodes each
+// line to a buffer and copies it, like PA_Gif.c did before, the new decoder
+// goes through DGifGetImage. Returns the number of frames, -1 on an error,
+// and the size of a frame in framesize.
+static int Decode(const unsigned char *data, int old, int bits, unsigned char *out, int outsize, int *framesize) {
+	static const int InterlacedOffset[] = {0, 4, 2, 1}, InterlacedJumps[] = {8, 8, 4, 2};
+	GifFileType *gif = old ? OldDGifOpen((void*)data, ReadFunc) : DGifOpen((void*)data, ReadFunc);
+	GifPixelType line[4096];
+	unsigned short palette[256];
+	unsigned char *canvas;
+	GifRecordType type;
+	int frames = 0, size, i, j, k;
+
+	if (gif == NULL) return -1;
+
+	*framesize = size = gif->SWidth * gif->SHeight * (bits / 8);
+	canvas = (unsigned char*)calloc(size, 1);
+
+	do {
+		// Some gifs have a few bytes after the last frame, where the decoding stops
+		if ((old ? OldDGifGetRecordType(gif, &type) : DGifGetRecordType(gif, &type)) == GIF_ERROR) break;
+		if (type == UNDEFINED_RECORD_TYPE) break;
+
+		if (type == IMAGE_DESC_RECORD_TYPE) {
+			ColorMapObject *map;
+			int row, col, width, height;
+
+			if ((old ? OldDGifGetImageDesc(gif) : DGifGetImageDesc(gif)) == GIF_ERROR) goto Error;
+
+			row = gif->Image.Top;
+			col = gif->Image.Left;
+			width = gif->Image.Width;
+			height = gif->Image.Height;
+			if ((col + width > gif->SWidth) || (row + height > gif->SHeight) || (width > 4096)) goto Error;
+
+			map = gif->Image.ColorMap ? gif->Image.ColorMap : gif->SColorMap;
+			memset(palette, 0, sizeof(palette));
+			for (i = 0; map && (i < map->ColorCount); i++) // PA_RGB8
+				palette[i] = (map->Colors[i].Red >> 3) | ((map->Colors[i].Green >> 3) << 5) | ((map->Colors[i].Blue >> 3) << 10) | 0x8000;
+
+			if (old) {
+				for (i = 0; i < (gif->Image.Interlace ? 4 : 1); i++) {
+					for (j = row + (gif->Image.Interlace ? InterlacedOffset[i] : 0); j < row + height; j += gif->Image.Interlace ? InterlacedJumps[i] : 1) {
+						if (OldDGifGetLine(gif, line, width) == GIF_ERROR) goto Error;
+
+						if (bits == 16) for (k = 0; k < width; k++) ((unsigned short*)canvas)[j * gif->SWidth + col + k] = palette[line[k]];
+						else memcpy(canvas + j * gif->SWidth + col, line, width);
+					}
+				}
+			} else if (DGifGetImage(gif, canvas + ((row * gif->SWidth + col) * (bits / 8)), gif->SWidth, (bits == 16) ? palette : NULL) == GIF_ERROR) {
+				goto Error;
+			}
+
+			if ((frames + 1) * size > outsize) goto Error;
+			memcpy(out + frames * size, canvas, size);
+			frames++;
+		} else if (type == EXTENSION_RECORD_TYPE) {
+			GifByteType *ext;
+			int code;
+
+			if ((old ? OldDGifGetExtension(gif, &code, &ext) : DGifGetExtension(gif, &code, &ext)) == GIF_ERROR) goto Error;
+			while (ext != NULL)
+				if ((old ? OldDGifGetExtensionNext(gif, &ext) : DGifGetExtensionNext(gif, &ext)) == GIF_ERROR) goto Error;
+		}
+	} while (type != TERMINATE_RECORD_TYPE);
+	goto Done;
+
+Error:
+	frames = -1;
+Done:
+	free(canvas);
+	if (old) OldDGifCloseFile(gif);
+	else DGifCloseFile(gif);
+
+	return frames;
+}
+
+// Decodes one way until MINTIME is spent, returns the milliseconds per decoding
+static double Time(const unsigned char *data, int old, int bits, unsigned char *out, int outsize) {
+	double t0 = Now(), t;
+	int n = 0, framesize;
+
+	do {
+		Decode(data, old, bits, out, outsize, &framesize);
+		n++;
+	} while ((t = Now() - t0) < MINTIME);
+
+	return t * 1000 / n;
+}
+
+int main(int argc, char **argv) {
+	int outsize = 64 << 20, errors = 0, files = 0, i, bits;
+	unsigned char *outold = (unsigned char*)malloc(outsize), *outnew = (unsigned char*)malloc(outsize);
+	double told[2] = {0, 0}, tnew[2] = {0, 0};
+
+	if (argc < 2) {
+		printf("Usage: GifBench file.gif ...\n");
+		return 1;
+	}
+
+	printf("%-60s %6s %5s %9s %9s %8s\n", "", "frames", "bits", "old ms", "new ms", "speedup");
+
+	for (i = 1; i < argc; i++) {
+		FILE *f = fopen(argv[i], "rb");
+		unsigned char *data;
+		long size;
+
+		if (f == NULL) {
+			printf("Can't open %s\n", argv[i]);
+			errors++;
+			continue;
+		}
+
+		fseek(f, 0, SEEK_END);
+		size = ftell(f);
+		fseek(f, 0, SEEK_SET);
+		data = (unsigned char*)calloc(size + 4096, 1); // The decoder may read a little past a broken end
+		if (fread(data, 1, size, f) != (size_t)size) size = 0;
+		fclose(f);
+
+		files++;
+
+		for (bits = 8; bits <= 16; bits += 8) {
+			int sold, snew, fold = Decode(data, 1, bits, outold, outsize, &sold), fnew = Decode(data, 0, bits, outnew, outsize, &snew);
+			double a, b;
+
+			if ((fold != fnew) || (fold < 0)) {
+				printf("%-60s FAILED : %d frames with the old decoder, %d with the new one\n", argv[i], fold, fnew);
+				errors++;
+				break;
+			}
+
+			if (memcmp(outold, outnew, (size_t)sold * fold)) {
+				printf("%-60s FAILED : different pixels in %d bit\n", argv[i], bits);
+				errors++;
+				break;
+			}
+
+			a = Time(data, 1, bits, outold, outsize);
+			b = Time(data, 0, bits, outnew, outsize);
+			told[bits / 16] += a;
+			tnew[bits / 16] += b;
+
+			printf("%-60s %6d %5d %9.3f %9.3f %7.2fx\n", (bits == 8) ? argv[i] : "", fold, bits, a, b, a / b);
+		}
+
+		free(data);
+	}
+
+	printf("\n%d files, %d different : old %.2f ms, new %.2f ms in 8 bit (%.2fx), old %.2f ms, new %.2f ms in 16 bit (%.2fx)\n", files, errors,
+		told[0], tnew[0], told[0] / tnew[0], told[1], tnew[1], told[1] / tnew[1]);
+
+	free(outold);
+	free(outnew);
+
+	return errors ? 1 : 0;
+}
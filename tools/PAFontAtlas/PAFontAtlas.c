@@ -0,0 +1,355 @@
+// PAFontAtlas - builds PAlib font atlases (PA_FontAtlas.h) from PAGfx fonts
+//
+// Build with any C compiler, for example:
+//   gcc -O2 -o PAFontAtlas PAFontAtlas.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAGIC   0x41464150 // "PAFA"
+#define VERSION 1
+#define HEADER_SIZE 32
+
+typedef struct {
+	unsigned int Code;
+	unsigned char Width, Advance;
+	unsigned short Rows[16];
+} Glyph;
+
+typedef struct {
+	unsigned int Left, Right; // Codepoints while reading, glyph numbers when writing
+	int Amount;
+} Kern;
+
+static Glyph *glyphs = NULL;
+static int nglyphs = 0, glyphspace = 0;
+static Kern *kerns = NULL;
+static int nkerns = 0, kernspace = 0;
+static int fontheight = 0;
+
+static void *ReadFile(const char *name, long *size) {
+	FILE *f = fopen(name, "rb");
+	void *data;
+
+	if (f == NULL) {
+		fprintf(stderr, "Can't open %s\n", name);
+		exit(1);
+	}
+
+	fseek(f, 0, SEEK_END);
+	*size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	data = malloc(*size + 1);
+
+	if ((data == NULL) || (fread(data, 1, *size, f) != (size_t)*size)) {
+		fprintf(stderr, "Can't read %s\n", name);
+		exit(1);
+	}
+
+	fclose(f);
+	return data;
+}
+
+static void *ReadPart(const char *prefix, const char *part, long *size) {
+	char name[1024];
+
+	snprintf(name, sizeof(name), "%s_%s.bin", prefix, part);
+	return ReadFile(name, size);
+}
+
+static Glyph *AddGlyph(unsigned int code) {
+	int i;
+
+	for (i = 0; i < nglyphs; i++)
+		if (glyphs[i].Code == code) return &glyphs[i]; // Later fonts replace the letters of the previous ones
+
+	if (nglyphs == glyphspace) {
+		glyphspace = glyphspace ? glyphspace * 2 : 256;
+		glyphs = (Glyph*)realloc(glyphs, glyphspace * sizeof(Glyph));
+	}
+
+	return &glyphs[nglyphs++];
+}
+
+// Pixel of a tile from the PAGfx tiles, 8 bit or 4 bit
+static int TilePixel(const unsigned char *tiles, long tilessize, int c16, unsigned int tile, int x, int y) {
+	long i;
+
+	if (c16) {
+		i = (tile << 5) + (y << 2) + (x >> 1);
+		if (i >= tilessize) return 0;
+		return (tiles[i] >> ((x & 1) << 2)) & 15;
+	}
+
+	i = (tile << 6) + (y << 3) + x;
+	if (i >= tilessize) return 0;
+	return tiles[i];
+}
+
+static void DrawTile(Glyph *glyph, const unsigned char *tiles, long tilessize, int c16, unsigned int tile, int dx, int dy) {
+	int x, y;
+
+	tile &= 0x3FF; // Remove the flip bits
+
+	for (y = 0; y < 8; y++)
+		for (x = 0; x < 8; x++)
+			if (TilePixel(tiles, tilessize, c16, tile, x, y)) glyph->Rows[dy + y] |= 1 << (dx + x);
+}
+
+// Same layout as PA_DoLetterPos: 32 letters per line, 1 tile per letter up to
+// 8 pixels high, 2x2 tiles above that
+static void AddFont(const char *prefix, int height, unsigned int base, int c16) {
+	long tilessize, mapsize, sizessize;
+	unsigned char *tiles = (unsigned char*)ReadPart(prefix, "Tiles", &tilessize);
+	unsigned short *map = (unsigned short*)ReadPart(prefix, "Map", &mapsize);
+	unsigned char *sizes = (unsigned char*)ReadPart(prefix, "Sizes", &sizessize);
+	int letter;
+
+	if ((height < 1) || (height > 16)) {
+		fprintf(stderr, "%s: the height must be between 1 and 16\n", prefix);
+		exit(1);
+	}
+
+	if (height > fontheight) fontheight = height;
+
+	for (letter = 32; (letter < 256) && (letter < sizessize); letter++) {
+		Glyph *glyph;
+		long firstpos;
+
+		if (sizes[letter] == 0) continue; // Not in the font
+
+		glyph = AddGlyph(base + letter);
+		memset(glyph, 0, sizeof(Glyph));
+		glyph->Code = base + letter;
+		glyph->Advance = sizes[letter];
+		glyph->Width = (sizes[letter] > 16) ? 16 : sizes[letter];
+
+		if (height > 8) {
+			firstpos = ((letter & 31) << 1) + ((letter >> 5) << 7);
+
+			if ((firstpos + 65) * 2 >= mapsize) continue;
+
+			DrawTile(glyph, tiles, tilessize, c16, map[firstpos], 0, 0);
+			DrawTile(glyph, tiles, tilessize, c16, map[firstpos + 1], 8, 0);
+			DrawTile(glyph, tiles, tilessize, c16, map[firstpos + 64], 0, 8);
+			DrawTile(glyph, tiles, tilessize, c16, map[firstpos + 65], 8, 8);
+		} else if (letter * 2 < mapsize) {
+			DrawTile(glyph, tiles, tilessize, c16, map[letter], 0, 0);
+		}
+
+		// Keep only the pixels of the letter
+		for (firstpos = 0; firstpos < 16; firstpos++) glyph->Rows[firstpos] &= (1 << glyph->Width) - 1;
+	}
+
+	free(tiles);
+	free(map);
+	free(sizes);
+}
+
+// A letter in UTF-8, or U+XXXX
+static unsigned int ReadCode(const char *s) {
+	const unsigned char *u = (const unsigned char*)s;
+
+	if ((u[0] == 'U') && (u[1] == '+')) return strtoul(s + 2, NULL, 16);
+	if (u[0] < 0x80) return u[0];
+	if ((u[0] & 0xE0) == 0xC0) return ((u[0] & 0x1F) << 6) | (u[1] & 0x3F);
+	if ((u[0] & 0xF0) == 0xE0) return ((u[0] & 0x0F) << 12) | ((u[1] & 0x3F) << 6) | (u[2] & 0x3F);
+	return ((u[0] & 0x07) << 18) | ((u[1] & 0x3F) << 12) | ((u[2] & 0x3F) << 6) | (u[3] & 0x3F);
+}
+
+// Lines of "left right amount", # for comments
+static void ReadKerning(const char *name) {
+	long size;
+	char *text = (char*)ReadFile(name, &size);
+	char *line;
+
+	text[size] = 0;
+
+	for (line = strtok(text, "\r\n"); line; line = strtok(NULL, "\r\n")) {
+		char left[16], right[16];
+		int amount;
+
+		unsigned int l, r;
+		int i;
+
+		if ((line[0] == '#') || (sscanf(line, "%15s %15s %d", left, right, &amount) != 3)) continue;
+
+		l = ReadCode(left);
+		r = ReadCode(right);
+
+		for (i = 0; i < nkerns; i++)
+			if ((kerns[i].Left == l) && (kerns[i].Right == r)) break; // Same pair again, keep the last one
+
+		if (i < nkerns) {
+			kerns[i].Amount = amount;
+			continue;
+		}
+
+		if (nkerns == kernspace) {
+			kernspace = kernspace ? kernspace * 2 : 256;
+			kerns = (Kern*)realloc(kerns, kernspace * sizeof(Kern));
+		}
+
+		kerns[nkerns].Left = l;
+		kerns[nkerns].Right = r;
+		kerns[nkerns].Amount = amount;
+		nkerns++;
+	}
+
+	free(text);
+}
+
+static int CompareGlyphs(const void *a, const void *b) {
+	unsigned int ca = ((const Glyph*)a)->Code, cb = ((const Glyph*)b)->Code;
+	return (ca > cb) - (ca < cb);
+}
+
+static int CompareKerns(const void *a, const void *b) {
+	const Kern *ka = (const Kern*)a, *kb = (const Kern*)b;
+	unsigned int pa = (ka->Left << 16) | ka->Right, pb = (kb->Left << 16) | kb->Right;
+	return (pa > pb) - (pa < pb);
+}
+
+static int FindGlyph(unsigned int code) {
+	int low = 0, high = nglyphs - 1;
+
+	while (low <= high) {
+		int mid = (low + high) >> 1;
+
+		if (glyphs[mid].Code == code) return mid;
+
+		if (glyphs[mid].Code < code) low = mid + 1;
+		else high = mid - 1;
+	}
+
+	return -1;
+}
+
+static void Write16(FILE *f, unsigned int v) {
+	fputc(v & 0xFF, f);
+	fputc((v >> 8) & 0xFF, f);
+}
+
+static void Write32(FILE *f, unsigned int v) {
+	Write16(f, v & 0xFFFF);
+	Write16(f, v >> 16);
+}
+
+static void Align4(FILE *f) {
+	while (ftell(f) & 3) fputc(0, f);
+}
+
+static void WriteAtlas(const char *name, int pageshift) {
+	FILE *f = fopen(name, "wb");
+	unsigned int codes = HEADER_SIZE;
+	unsigned int metrics = codes + nglyphs * 4;
+	unsigned int kernoffset = (metrics + nglyphs * 2 + 3) & ~3;
+	unsigned int pages;
+	int i, j, n = 0;
+
+	if (f == NULL) {
+		fprintf(stderr, "Can't write %s\n", name);
+		exit(1);
+	}
+
+	// Kerning pairs use glyph numbers, drop the ones for missing letters
+	for (i = 0; i < nkerns; i++) {
+		int left = FindGlyph(kerns[i].Left), right = FindGlyph(kerns[i].Right);
+
+		if ((left < 0) || (right < 0) || (kerns[i].Amount == 0)) continue;
+
+		kerns[n].Left = left;
+		kerns[n].Right = right;
+		kerns[n].Amount = kerns[i].Amount;
+		n++;
+	}
+
+	nkerns = n;
+	qsort(kerns, nkerns, sizeof(Kern), CompareKerns);
+	pages = (kernoffset + nkerns * 6 + 3) & ~3;
+
+	Write32(f, MAGIC);
+	Write16(f, VERSION);
+	fputc(fontheight, f);
+	fputc(pageshift, f);
+	Write32(f, nglyphs);
+	Write32(f, nkerns);
+	Write32(f, codes);
+	Write32(f, metrics);
+	Write32(f, kernoffset);
+	Write32(f, pages);
+
+	for (i = 0; i < nglyphs; i++) Write32(f, glyphs[i].Code);
+
+	for (i = 0; i < nglyphs; i++) {
+		fputc(glyphs[i].Width, f);
+		fputc(glyphs[i].Advance, f);
+	}
+
+	Align4(f);
+
+	for (i = 0; i < nkerns; i++) {
+		Write16(f, kerns[i].Left);
+		Write16(f, kerns[i].Right);
+		Write16(f, kerns[i].Amount & 0xFFFF);
+	}
+
+	Align4(f);
+
+	// Glyphs follow each other, pages are just groups of 1 << pageshift glyphs
+	for (i = 0; i < nglyphs; i++)
+		for (j = 0; j < fontheight; j++) Write16(f, glyphs[i].Rows[j]);
+
+	printf("%s: %d letters, %d kerning pairs, %d pages of %d bytes\n", name, nglyphs, nkerns,
+	       (nglyphs + (1 << pageshift) - 1) >> pageshift, (fontheight << pageshift) * 2);
+
+	fclose(f);
+}
+
+static void Usage(void) {
+	printf("PAFontAtlas - makes a font atlas from PAGfx 8bitfont/4bitfont outputs\n\n");
+	printf("Usage: PAFontAtlas output.bin [options] font height [[options] font height ...]\n\n");
+	printf("  font        prefix of the PAGfx files, for example gfx/bin/bigfont\n");
+	printf("              (reads bigfont_Tiles.bin, bigfont_Map.bin and bigfont_Sizes.bin)\n");
+	printf("  height      height of the font in pixels, as in its PA_BgStruct (16 at most)\n\n");
+	printf("  -base N     the letters of the next fonts start at the codepoint N (default 0,\n");
+	printf("              the 256 letters are then Latin-1). N can be in hex (0x3000).\n");
+	printf("  -4bit       the next fonts are 16c fonts, -8bit to go back (default)\n");
+	printf("  -kern file  kerning pairs, one \"left right amount\" per line, letters in\n");
+	printf("              UTF-8 or as U+XXXX\n");
+	printf("  -page N     2^N letters per page (default 6, 64 letters)\n");
+	exit(1);
+}
+
+int main(int argc, char **argv) {
+	unsigned int base = 0;
+	int c16 = 0, pageshift = 6, i;
+
+	if (argc < 4) Usage();
+
+	for (i = 2; i < argc; i++) {
+		if (strcmp(argv[i], "-base") == 0 && (i + 1 < argc)) base = strtoul(argv[++i], NULL, 0);
+		else if (strcmp(argv[i], "-4bit") == 0) c16 = 1;
+		else if (strcmp(argv[i], "-8bit") == 0) c16 = 0;
+		else if (strcmp(argv[i], "-kern") == 0 && (i + 1 < argc)) ReadKerning(argv[++i]);
+		else if (strcmp(argv[i], "-page") == 0 && (i + 1 < argc)) pageshift = atoi(argv[++i]);
+		else if (argv[i][0] == '-' || (i + 1 >= argc)) Usage();
+		else {
+			AddFont(argv[i], atoi(argv[i + 1]), base, c16);
+			i++;
+		}
+	}
+
+	if ((pageshift < 0) || (pageshift > 15)) Usage();
+
+	if (nglyphs == 0) {
+		fprintf(stderr, "No letters found\n");
+		return 1;
+	}
+
+	qsort(glyphs, nglyphs, sizeof(Glyph), CompareGlyphs);
+	WriteAtlas(argv[1], pageshift);
+
+	return 0;
+}
@@ -0,0 +1,159 @@
+// ParticleBench - checks and times the PAlib 3D particles (PA_3DParticles.c) on a computer.
+// Returns 1 if a check fails.
+//
+// Build it on Linux, from this folder (see ../host/ReadMe.txt):
+//   make -C ../host
+//   gcc -O2 -no-pie -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast -I../host -I../../include -I../../include/arm9 -o ParticleBench ParticleBench.c ../host/build/libPAhost.a -lm
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "PA9.h"
+
+static s32 Errors;
+
+#define CHECK(cond, ...) do { if (!(cond)) { printf("  FAILED : "); printf(__VA_ARGS__); printf("\n"); Errors++; } } while (0)
+
+static double Now(void) {
+	return (double)clock() / CLOCKS_PER_SEC;
+}
+
+// The GFX_VERTEX16 writes since the last HostGfxClear, 2 per vertex
+static u32 VertexWrites(u32 *first) {
+	u32 i, n = 0;
+
+	for (i = 0; i < HostGfxCount; i++) {
+		if (HostGfx[i].Port != 0x0400048C) continue;
+		if ((n == 0) && first) *first = HostGfx[i].Value;
+		n++;
+	}
+	return n;
+}
+
+static s32 Alive(void) {
+	s32 e, n = 0;
+	for (e = 0; e < PA_3DEMITTERS_MAX; e++) n += pa_3demitters[e].NParticles;
+	return n;
+}
+
+// Positions in .8 fixed point are exact, so a particle has to be where the sums say
+static void TestMotion(void) {
+	s32 x, y, vx, vy, frame, e;
+
+	printf("Motion, one particle with gravity for 100 frames\n");
+	PA_3DResetParticles();
+	e = PA_3DCreateEmitter(0, 8, 8, 0, 20, 50);
+	PA_3DSetEmitterDirection(e, 0, 0, 1 << 8, 0); // Right, 1 pixel per frame
+	PA_3DSetEmitterGravity(e, -1, 3);
+	PA_3DSetEmitterLife(e, 1000, 0);
+	PA_3DEmitterBurst(e, 1);
+
+	x = 20 << 8; y = 50 << 8;
+	vx = (PA_Cos(0) * (1 << 8)) >> 8; vy = -(PA_Sin(0) * (1 << 8)) >> 8;
+	for (frame = 0; frame < 100; frame++) {
+		PA_3DUpdateParticles();
+		vx += -1; vy += 3;
+		x += vx; y += vy;
+	}
+
+	HostGfxClear();
+	PA_3DDrawParticles(0, 100);
+	CHECK(PA_3DParticleInfos.Alive == 1, "%d particles alive instead of 1", PA_3DParticleInfos.Alive);
+	CHECK(PA_3DParticleInfos.Drawn == 1, "particle not drawn");
+	if (PA_3DParticleInfos.Drawn == 1) {
+		u32 v = 0; // First corner, bottom left
+		VertexWrites(&v);
+		CHECK((s16)(v & 0xFFFF) == (x >> 8) - 4, "x %d instead of %d", (s16)(v & 0xFFFF), (x >> 8) - 4);
+		CHECK((s16)(v >> 16) == 192 - ((y >> 8) + 4), "y %d instead of %d", 192 - (s16)(v >> 16), (y >> 8) + 4);
+	}
+}
+
+// Lives, emitters and the budget
+static void TestLives(void) {
+	s32 e, i, frame;
+
+	printf("Lives, emitters and the budget\n");
+	PA_3DResetParticles();
+
+	// A life of 0 has to end at the first update, not wrap around
+	e = PA_3DCreateEmitter(0, 8, 8, 0, 128, 96);
+	PA_3DSetEmitterLife(e, 0, 0);
+	PA_3DEmitterBurst(e, 10);
+	PA_3DUpdateParticles();
+	CHECK(PA_3DParticleInfos.Alive == 0, "life 0 : %d particles still alive", PA_3DParticleInfos.Alive);
+
+	// Lives from 10 to 20 : all gone after 20 frames
+	PA_3DSetEmitterLife(e, 10, 10);
+	PA_3DEmitterBurst(e, 1000);
+	for (frame = 0; frame < 20; frame++) {
+		PA_3DUpdateParticles();
+		CHECK(Alive() == PA_3DParticleInfos.Alive, "frame %d : emitters count %d particles, %d alive", frame, Alive(), PA_3DParticleInfos.Alive);
+		if (frame < 9) CHECK(PA_3DParticleInfos.Alive == 1000, "frame %d : particles died early", frame);
+	}
+	CHECK(PA_3DParticleInfos.Alive == 0, "lives 10 to 20 : %d particles left after 20 frames", PA_3DParticleInfos.Alive);
+
+	// The pool is full at PA_3DPARTICLES_MAX, deleting an emitter takes only its particles
+	for (i = 0; i < 4; i++) {
+		e = PA_3DCreateEmitter(0, 8, 8, 0, 128, 96);
+		PA_3DSetEmitterLife(e, 1000, 0);
+		PA_3DEmitterBurst(e, PA_3DPARTICLES_MAX / 2);
+	}
+	PA_3DUpdateParticles();
+	CHECK(PA_3DParticleInfos.Alive == PA_3DPARTICLES_MAX, "pool : %d particles instead of %d", PA_3DParticleInfos.Alive, PA_3DPARTICLES_MAX);
+	PA_3DDeleteEmitter(1);
+	PA_3DUpdateParticles();
+	CHECK(Alive() == PA_3DParticleInfos.Alive && pa_3demitters[1].NParticles == 0, "delete : particles of emitter 1 left");
+
+	// Nothing past the budget, and only whole quads
+	HostGfxClear();
+	PA_3DDrawParticles(0, 500);
+	CHECK(PA_3DParticleInfos.Drawn == 500, "budget : %d quads drawn instead of 500", PA_3DParticleInfos.Drawn);
+	CHECK(VertexWrites(NULL) == 500 * 8, "budget : %d vertex writes for 500 quads", VertexWrites(NULL));
+	CHECK(PA_3DParticleInfos.Drawn + PA_3DParticleInfos.Culled + PA_3DParticleInfos.Dropped == PA_3DParticleInfos.Alive, "budget : particles lost");
+}
+
+// Particles per millisecond, moved then drawn, with emitters keeping the pool full
+static void Bench(void) {
+	s32 e, frame, frames = 2000;
+	u32 particles = 0;
+	double t, tupdate = 0, tdraw = 0;
+
+	PA_3DResetParticles();
+	for (e = 0; e < 16; e++) {
+		s32 em = PA_3DCreateEmitter(0, 8, 8, 0, 16 * e, 96);
+		PA_3DSetEmitterDirection(em, 128, 64, 512, 256);
+		PA_3DSetEmitterGravity(em, 0, 8);
+		PA_3DSetEmitterLife(em, 60, 30);
+		PA_3DSetEmitterRate(em, 256 * 5); // 5 per frame each, 80 in all : more than the pool holds
+	}
+
+	for (frame = 0; frame < frames; frame++) {
+		t = Now();
+		PA_3DUpdateParticles();
+		tupdate += Now() - t;
+
+		HostGfxClear();
+		t = Now();
+		PA_3DDrawParticles(0, 2048);
+		tdraw += Now() - t;
+
+		particles += PA_3DParticleInfos.Alive;
+	}
+
+	printf("Times, %u particles alive on average, on a computer\n", particles / frames);
+	printf("  update %8.0f particles per ms\n", particles / (tupdate * 1000));
+	printf("  draw   %8.0f particles per ms (2048 quads at most, the rest culled or dropped)\n", particles / (tdraw * 1000));
+}
+
+int main(void) {
+	TestMotion();
+	TestLives();
+	Bench();
+
+	if (Errors) {
+		printf("%d errors\n", Errors);
+		return 1;
+	}
+	printf("All good\n");
+	return 0;
+}
@@ -0,0 +1,244 @@
+// PathBench - checks and times the PAlib pathfinding (PA_Path.c) on a computer
+//
+// Build it on Linux, from this folder (see ../host/ReadMe.txt):
+//   make -C ../host
+//   gcc -O2 -no-pie -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast -I../host -I../../include -I../../include/arm9 -o PathBench PathBench.c ../host/build/libPAhost.a -lm
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "PA9.h"
+
+#define SEARCHES 200
+#define AGENTS   1000
+#define BUDGET   500 // Cells per frame for the searches spread over several frames
+
+static double Now(void) {
+	return (double)clock() / CLOCKS_PER_SEC;
+}
+
+// The search PA_Astar did before, a flood fill of the whole grid until the
+// goal is reached, with the grid copied on the stack
+static s8 OldAstar(u16 **maze, u16 width, u16 height) {
+	u16 maze2[width][height];
+	u8 chemin[width][height];
+	u8 bloc[width][height];
+	u8 arriveex = 0, arriveey = 0, debutx = 0, debuty = 0;
+	u8 i, j;
+	u8 exit;
+
+	for (j = 0; j < height; j++)for (i = 0; i < width; i++)maze2[i][j] = maze[i][j];
+	for (j = 0; j < height; j++)for (i = 0; i < width; i++)bloc[i][j] = 0;
+
+	for (j = 0; j < height; j++)for (i = 0; i < width; i++) {
+			if (maze2[i][j] == 1) { debutx = i;  debuty = j; }
+			if (maze2[i][j] == 2) { maze2[i][j] = 0;  arriveex = i;  arriveey = j; }
+			if (maze2[i][j] == 5) { maze2[i][j] = 0;  bloc[i][j] = 1; }
+		}
+
+	while (1) {
+		if (maze2[arriveex][arriveey] != 0)break;
+		exit = 1;
+
+		for (j = 0; j < height; j++)	for (i = 0; i < width; i++) {
+				if (maze2[i][j] > 0) {
+					if (j < height - 1 && maze2[i][j+1] == 0 && bloc[i][j+1] == 0) { maze2[i][j+1] = maze2[i][j] + 1; exit = 0; }
+					if (j > 0 && maze2[i][j-1] == 0 && bloc[i][j-1] == 0) { maze2[i][j-1] = maze2[i][j] + 1; exit = 0; }
+					if (i < width - 1 && maze2[i+1][j] == 0 && bloc[i+1][j] == 0) { maze2[i+1][j] = maze2[i][j] + 1; exit = 0; }
+					if (i > 0 && maze2[i-1][j] == 0 && bloc[i-1][j] == 0) { maze2[i-1][j] = maze2[i][j] + 1; exit = 0; }
+				}
+			}
+
+		if (exit == 1) return -1;
+	}
+
+	for (j = 0; j < height; j++)for (i = 0; i < width; i++)chemin[i][j] = 0;
+
+	while (1) {
+		if (chemin[debutx][debuty] == 1)break;
+		chemin[arriveex][arriveey] = 1;
+
+		if (arriveey < height - 1 && maze2[arriveex][arriveey+1] < maze2[arriveex][arriveey] && maze2[arriveex][arriveey+1] != 0 && bloc[arriveex][arriveey+1] == 0) arriveey++;
+		else if (arriveey > 0 && maze2[arriveex][arriveey-1] < maze2[arriveex][arriveey] && maze2[arriveex][arriveey-1] != 0 && bloc[arriveex][arriveey-1] == 0) arriveey--;
+		else if (arriveex < width - 1 && maze2[arriveex+1][arriveey] < maze2[arriveex][arriveey] && maze2[arriveex+1][arriveey] != 0 && bloc[arriveex+1][arriveey] == 0) arriveex++;
+		else if (arriveex > 0 && maze2[arriveex-1][arriveey] < maze2[arriveex][arriveey] && maze2[arriveex-1][arriveey] != 0 && bloc[arriveex-1][arriveey] == 0) arriveex--;
+	}
+
+	if (chemin[debutx-1][debuty] == 1)return 1;
+	else if (chemin[debutx+1][debuty] == 1)return 2;
+	else if (chemin[debutx][debuty-1] == 1)return 3;
+	else if (chemin[debutx][debuty+1] == 1)return 4;
+
+	return 0;
+}
+
+// Walls in blocks, and some slower ground
+static void MakeMap(PA_PathGrid *grid, s32 walls, s32 weighted) {
+	s32 x, y, i;
+
+	for (y = 0; y < grid->Height; y++)
+		for (x = 0; x < grid->Width; x++)
+			PA_PathSetCost(grid, x, y, weighted ? 1 + (rand() % 4) : 1);
+
+	for (i = 0; i < grid->Width * grid->Height * walls / 100 / 6; i++) {
+		s32 wx = rand() % grid->Width, wy = rand() % grid->Height;
+		s32 len = 2 + rand() % 8, dir = rand() & 1;
+
+		for (x = 0; x < len; x++)
+			if ((wx + (dir ? x : 0) < grid->Width) && (wy + (dir ? 0 : x) < grid->Height))
+				PA_PathSetCost(grid, wx + (dir ? x : 0), wy + (dir ? 0 : x), PA_PATH_WALL);
+	}
+}
+
+static void RandomCell(PA_PathGrid *grid, u16 *x, u16 *y) {
+	do {
+		*x = rand() % grid->Width;
+		*y = rand() % grid->Height;
+	} while (PA_PathGetCost(grid, *x, *y) == PA_PATH_WALL);
+}
+
+static s32 Errors;
+
+static void Bench(u16 size, u8 diagonals, s32 weighted) {
+	PA_PathGrid *grid = PA_PathCreate(size, size, diagonals);
+	PA_PathField *field = PA_PathFieldCreate(grid);
+	PA_PathPoint *path = (PA_PathPoint*)malloc(size * size * sizeof(PA_PathPoint));
+	u16 sx[SEARCHES], sy[SEARCHES], gx[SEARCHES], gy[SEARCHES];
+	s32 i, found = 0, optimal = 0, frames = 0, maxframes = 0, moving = 0;
+	double t0, tfind, tfield = 0, tstep = 0, tmaxstep = 0, tagents;
+	u32 length = 0;
+
+	MakeMap(grid, 25, weighted);
+
+	// Nothing to read from a field that was never started
+	for (i = 0; i < size * size; i++)
+		if ((PA_PathFieldDir(field, i % size, i / size) != PA_PATH_NODIR) || (PA_PathFieldCost(field, i % size, i / size) != 0xFFFFFFFF)) {
+			printf("  FAILED : cell %d of a field not started has a direction\n", i);
+			Errors++;
+			break;
+		}
+
+	for (i = 0; i < SEARCHES; i++) {
+		RandomCell(grid, &sx[i], &sy[i]);
+		RandomCell(grid, &gx[i], &gy[i]);
+	}
+
+	// Whole searches
+	t0 = Now();
+	for (i = 0; i < SEARCHES; i++) {
+		if (PA_PathFind(grid, sx[i], sy[i], gx[i], gy[i]) == PA_PATH_FOUND) {
+			found++;
+			length += PA_PathGet(grid, path, size * size);
+		}
+	}
+	tfind = Now() - t0;
+
+	// Same searches, a few cells per frame, and checked against a flow field
+	for (i = 0; i < SEARCHES; i++) {
+		s32 f = 0;
+		s8 status = PA_PathStart(grid, sx[i], sy[i], gx[i], gy[i]);
+		u32 cost;
+
+		while (status == PA_PATH_SEARCHING) {
+			double s0 = Now();
+			status = PA_PathStep(grid, BUDGET);
+			s0 = Now() - s0;
+			tstep += s0;
+			if (s0 > tmaxstep) tmaxstep = s0;
+			f++;
+		}
+
+		frames += f;
+		if (f > maxframes) maxframes = f;
+
+		cost = (status == PA_PATH_FOUND) ? PA_PathCost(grid) : 0xFFFFFFFF;
+
+		t0 = Now();
+		PA_PathFieldStart(field, gx[i], gy[i]);
+		PA_PathFieldStep(field, 0);
+		tfield += Now() - t0;
+
+		if (cost == PA_PathFieldCost(field, sx[i], sy[i])) optimal++;
+	}
+
+	// Many units on the last field, each one reads its direction
+	t0 = Now();
+	for (i = 0; i < AGENTS * 100; i++) {
+		u8 d = PA_PathFieldDir(field, rand() % size, rand() % size);
+		if (d != PA_PATH_NODIR) moving++;
+	}
+	tagents = (Now() - t0) / 100;
+
+	printf("%dx%d, %s, %s : %d/%d found, %d%% same cost as the flow field, %.0f cells long\n", size, size, diagonals ? "8 directions" : "4 directions",
+		weighted ? "costs 1-4" : "costs 1", found, SEARCHES, optimal * 100 / SEARCHES, found ? (double)length / found : 0);
+	printf("   A*                   %9.1f us per search\n", tfind * 1e6 / SEARCHES);
+	printf("   A* by %d cells      %9.1f us per frame, %.1f us at most, %.1f frames (%d at most)\n", BUDGET,
+		tstep * 1e6 / frames, tmaxstep * 1e6, (double)frames / SEARCHES, maxframes);
+	printf("   Flow field           %9.1f us for the whole grid\n", tfield * 1e6 / SEARCHES);
+	printf("   %d units on it     %9.1f us per frame (%d%% can move)\n", AGENTS, tagents * 1e6, moving / AGENTS);
+
+	free(path);
+	PA_PathFieldDelete(field);
+	PA_PathDelete(grid);
+}
+
+// The old search on the same map, it only takes 255 columns and u8 coordinates
+static void BenchOld(u16 size) {
+	PA_PathGrid *grid = PA_PathCreate(size, size, 0);
+	u16 **maze = (u16**)malloc(size * sizeof(u16*));
+	s32 i, x, y, same = 0, tests = 20;
+	double told = 0, tnew = 0, t0;
+
+	MakeMap(grid, 25, 0);
+
+	for (x = 0; x < size; x++) maze[x] = (u16*)malloc(size * sizeof(u16));
+
+	for (i = 0; i < tests; i++) {
+		u16 sx, sy, gx, gy;
+		PA_PathPoint path[2];
+		s8 old, now;
+
+		RandomCell(grid, &sx, &sy);
+		RandomCell(grid, &gx, &gy);
+
+		for (x = 0; x < size; x++)
+			for (y = 0; y < size; y++)
+				maze[x][y] = (PA_PathGetCost(grid, x, y) == PA_PATH_WALL) ? 5 : 0;
+
+		maze[sx][sy] = 1;
+		maze[gx][gy] = 2;
+
+		t0 = Now();
+		old = OldAstar(maze, size, size);
+		told += Now() - t0;
+
+		t0 = Now();
+		now = PA_PathFind(grid, sx, sy, gx, gy);
+		tnew += Now() - t0;
+
+		// Both take a shortest path, not always the same one : compare the lengths
+		if ((old == -1) == (now != PA_PATH_FOUND)) same++;
+		(void)path;
+	}
+
+	printf("%dx%d, old flood fill : %9.1f us per search, new A* %.1f us, %d/%d agree on a path existing\n", size, size,
+		told * 1e6 / tests, tnew * 1e6 / tests, same, tests);
+
+	for (x = 0; x < size; x++) free(maze[x]);
+	free(maze);
+	PA_PathDelete(grid);
+}
+
+int main(void) {
+	srand(1);
+
+	Bench(128, 0, 0);
+	Bench(128, 1, 1);
+	Bench(256, 0, 0);
+	Bench(256, 1, 1);
+	BenchOld(64);
+	BenchOld(128);
+
+	return Errors ? 1 : 0;
+}
@@ -0,0 +1,279 @@
+// RecoBench - checks and times the PAlib shape recognition (PA_Reco.c) on a computer
+//
+// Build it on Linux, from this folder (see ../host/ReadMe.txt):
+//   make -C ../host
+//   gcc -O2 -no-pie -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast -I../host -I../../include -I../../include/arm9 -o RecoBench RecoBench.c ../host/build/libPAhost.a -lm
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "PA9.h"
+
+char PA_AnalyzeShape(void);
+
+// The way shapes were found before the index : every shape, in order
+static char LinearMatch(const char *code, u8 strokes, s32 *difference) {
+	s32 diff = 65000, i, j;
+	char letter = 0;
+
+	for (i = 0; i < PA_RECOTESTS + PA_CustomReco; i++) {
+		PA_FormType *form = (i < PA_RECOTESTS) ? &PA_Graffiti[i] : &PA_CustomShape[i - PA_RECOTESTS];
+		s32 s = form->strokes ? form->strokes : 1;
+		s32 d = abs(s - strokes) * 8;
+
+		if ((i < PA_RECOTESTS) && !PA_UseGraffiti) continue;
+
+		for (j = 0; j < 15; j++) {
+			s32 t = (code[j] - form->code[j]) & 31;
+			d += (t > 16) ? 32 - t : t;
+		}
+
+		if (d < diff) {
+			diff = d;
+			letter = form->letter;
+		}
+	}
+
+	*difference = diff;
+	return letter;
+}
+
+static double Now(void) {
+	return (double)clock() / CLOCKS_PER_SEC;
+}
+
+static void RandomCode(char *code) {
+	s32 i, a = rand() & 31;
+
+	for (i = 0; i < 15; i++) { // Directions change slowly along a shape
+		a = (a + (rand() % 7) - 3) & 31;
+		code[i] = '0' + a;
+	}
+
+	code[15] = 0;
+}
+
+// A shape seen again, with a few directions off by 1 or 2
+static void NoisyCode(const char *from, char *code, s32 noise) {
+	s32 i;
+
+	for (i = 0; i < 15; i++) code[i] = '0' + ((from[i] - '0' + ((rand() % (2 * noise + 1)) - noise)) & 31);
+
+	code[15] = 0;
+}
+
+// One frame of stylus, read by PAlib at the VBL like on the DS, then PA_CheckLetter
+static char Frame(u8 held, s32 x, s32 y) {
+	HostSetInput(held ? KEY_TOUCH : 0, x, y);
+	PA_WaitForVBL();
+
+	return PA_CheckLetter();
+}
+
+// Stroke files : one shape per line, "letter x,y x,y ... | x,y ..." with | between strokes
+static void PlayFile(const char *name, s32 delay) {
+	FILE *f = fopen(name, "r");
+	char line[65536];
+	s32 total = 0, good = 0;
+
+	if (f == NULL) {
+		printf("Can't open %s\n", name);
+		return;
+	}
+
+	PA_SetRecoStrokeDelay(delay);
+
+	while (fgets(line, sizeof(line), f)) {
+		char letter = line[0], found = 0;
+		char *p = line + 1;
+		s32 x, y, n, i;
+
+		if ((letter == '\n') || (letter == '#')) continue;
+
+		while (*p) {
+			while (*p == ' ') p++;
+
+			if (*p == '|') { // Lift the stylus, a few frames less than the delay
+				found = Frame(0, 0, 0);
+				for (i = 1; (i < delay - 1) && !found; i++) found = Frame(0, 0, 0);
+				p++;
+			} else if (sscanf(p, "%d,%d%n", &x, &y, &n) == 2) {
+				found = Frame(1, x, y);
+				p += n;
+			} else {
+				break;
+			}
+		}
+
+		found = Frame(0, 0, 0);
+		for (i = 0; (i < delay + 1) && !found; i++) found = Frame(0, 0, 0);
+
+		total++;
+		if (found == letter) good++;
+		else printf("  '%c' read as '%c' (%s, %d strokes)\n", letter, (found >= ' ') ? found : '?', PA_RecoShape, PA_RecoInfo.Strokes);
+	}
+
+	fclose(f);
+
+	if (total) printf("%s : %d/%d shapes found (%.1f%%)\n", name, good, total, 100.0 * good / total);
+}
+
+// Draw a letter from its code, one segment per direction, to check the whole path
+static s32 DrawCheck(void) {
+	s32 i, good = 0;
+
+	PA_SetRecoStrokeDelay(0);
+
+	for (i = 1; i < PA_RECOTESTS; i++) {
+		double x = 128, y = 96, a;
+		s32 j, k;
+
+		for (j = 0; j < 16; j++) {
+			// The codes are the angles from a point back to the one 2 samples before
+			a = (((PA_Graffiti[i].code[j < 15 ? j : 14] - '0') & 31) - 0.5) * 3.14159265358979 / 16 + 3.14159265358979;
+
+			for (k = 0; k < 3; k++) { // Small steps, like the stylus at 60 frames per second
+				Frame(1, (s32)(x + 0.5), (s32)(y + 0.5));
+				x += cos(a) * 2.5;
+				y -= sin(a) * 2.5;
+			}
+		}
+
+		Frame(1, (s32)(x + 0.5), (s32)(y + 0.5));
+		Frame(1, (s32)(x + 0.5), (s32)(y + 0.5));
+		if (Frame(0, 0, 0) == PA_Graffiti[i].letter) good++;
+	}
+
+	return good;
+}
+
+// Random number from -1 to 1
+static double Jitter(void) {
+	return 2.0 * rand() / RAND_MAX - 1;
+}
+
+// Write a stroke file from the Graffiti letters, each drawn several times at
+// random sizes, speeds and slants, with a shaky hand
+static void MakeFile(const char *name, s32 times) {
+	FILE *f = fopen(name, "w");
+	s32 i, t;
+
+	if (f == NULL) {
+		printf("Can't write %s\n", name);
+		return;
+	}
+
+	fprintf(f, "# Graffiti letters written by RecoBench -make %s %d : random size, speed,\n", name, times);
+	fprintf(f, "# slant and shake, in the stylus positions PA_CheckLetter gets each frame\n");
+
+	srand(2);
+
+	for (i = 1; i < PA_RECOTESTS; i++) {
+		if ((PA_Graffiti[i].letter < 'a') || (PA_Graffiti[i].letter > 'z')) continue;
+
+		for (t = 0; t < times; t++) {
+			double px[128], py[128], x = 0, y = 0, a, minx = 0, maxx = 0, miny = 0, maxy = 0;
+			double step = 2.5 + 0.7 * Jitter(), slant = 1.5 * Jitter();
+			s32 frames = 3 + (rand() % 2), n = 0, j, k;
+
+			for (j = 0; j < 16; j++) {
+				a = (((PA_Graffiti[i].code[j < 15 ? j : 14] - '0') & 31) - 0.5 + slant + Jitter()) * 3.14159265358979 / 16 + 3.14159265358979;
+
+				for (k = 0; k <= frames; k++) {
+					if ((k == frames) && (j < 15)) break; // Last point once the letter is done
+
+					px[n] = x;
+					py[n++] = y;
+					if (x < minx) minx = x;
+					if (x > maxx) maxx = x;
+					if (y < miny) miny = y;
+					if (y > maxy) maxy = y;
+					x += cos(a) * step + 0.4 * Jitter();
+					y -= sin(a) * step + 0.4 * Jitter();
+				}
+			}
+
+			// Somewhere on the screen
+			x = -minx + (255 - (maxx - minx)) * (0.5 + 0.5 * Jitter());
+			y = -miny + (191 - (maxy - miny)) * (0.5 + 0.5 * Jitter());
+
+			fputc(PA_Graffiti[i].letter, f);
+			for (j = 0; j < n; j++) fprintf(f, " %d,%d", (s32)(px[j] + x + 0.5), (s32)(py[j] + y + 0.5));
+			fputc('\n', f);
+		}
+	}
+
+	fclose(f);
+	srand(1);
+}
+
+int main(int argc, char **argv) {
+	static const s32 sizes[] = {0, 100, 1000, 5000, 20000};
+	s32 queries = 20000, s, i;
+	char (*codes)[16];
+
+	srand(1);
+	PA_Init();
+
+	if ((argc == 4) && !strcmp(argv[1], "-make")) {
+		MakeFile(argv[2], atoi(argv[3]));
+		return 0;
+	}
+
+	for (i = 1; i < argc; i++) PlayFile(argv[i], 20);
+
+	codes = malloc(queries * 16);
+
+	printf("Graffiti letters drawn through PA_CheckLetter : %d/%d found\n", DrawCheck(), PA_RECOTESTS - 1);
+	printf("Memory for the drawing : %d bytes, whatever its length\n\n", (s32)sizeof(PA_RecoPts));
+
+	printf("%8s %8s %10s %12s %12s %8s\n", "shapes", "queries", "same", "linear us", "index us", "speedup");
+
+	for (s = 0; s < 3 * (s32)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+		s32 random = (s % 3) == 1, samples = (s % 3) == 2, same = 0;
+		double t0, t1, t2;
+		char letter[2];
+		s32 d1, d2;
+
+		PA_ResetRecoSys();
+
+		for (i = 0; i < sizes[s / 3]; i++) {
+			char code[16];
+			if (samples) NoisyCode(PA_Graffiti[1 + (i % (PA_RECOTESTS - 1))].code, code, 2);
+			else RandomCode(code);
+			PA_RecoAddShapeEx(' ' + (i % 95), code, 1);
+		}
+
+		// Shapes that exist, drawn a little differently, or anything
+		for (i = 0; i < queries; i++) {
+			s32 id = rand() % (PA_RECOTESTS + sizes[s / 3]);
+			const char *from = (id < PA_RECOTESTS) ? PA_Graffiti[id].code : PA_CustomShape[id - PA_RECOTESTS].code;
+
+			if (random) RandomCode(codes[i]);
+			else NoisyCode(from, codes[i], 1);
+		}
+
+		PA_RecoMatch(codes[0], 1, &d2); // Builds the index
+
+		t0 = Now();
+		for (i = 0; i < queries; i++) LinearMatch(codes[i], 1, &d1);
+		t1 = Now();
+		for (i = 0; i < queries; i++) PA_RecoMatch(codes[i], 1, &d2);
+		t2 = Now();
+
+		for (i = 0; i < queries; i++) {
+			letter[0] = LinearMatch(codes[i], 1, &d1);
+			letter[1] = PA_RecoMatch(codes[i], 1, &d2);
+			if ((letter[0] == letter[1]) && (d1 == d2)) same++;
+		}
+
+		printf("%8d %8s %9d%% %12.2f %12.2f %7.1fx\n", sizes[s / 3], random ? "random" : (samples ? "samples" : "drawn"), same * 100 / queries,
+			(t1 - t0) * 1e6 / queries, (t2 - t1) * 1e6 / queries, (t1 - t0) / ((t2 - t1) > 0 ? (t2 - t1) : 1e-9));
+	}
+
+	free(codes);
+
+	return 0;
+}
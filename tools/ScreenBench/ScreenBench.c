@@ -0,0 +1,417 @@
+// ScreenBench - checks what PAlib shows on the screens, drawn by ../host:
+// large maps scrolled, text, drawing, gif and jpeg. Returns 1 if a check fails.
+//
+// Build it on Linux, from this folder (see ../host/ReadMe.txt), with libjpeg to compare the jpeg with:
+//   make -C ../host
+//   gcc -O2 -no-pie -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast -I../host -I../../include -I../../include/arm9 -o ScreenBench ScreenBench.c ../host/build/libPAhost.a -ljpeg -lm
+// Run it with a name, like "ScreenBench shot", to also write the screens of each check to shot_<check>.png.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <jpeglib.h>
+#include "PA9.h"
+
+#define GIF_FILE  "../../examples/Backgrounds/Transitions/BrightnessFade2/data/test.gif"
+#define GIF_SMALL "../../examples/Demos/PassingBy/data/Mollusk.gif"
+#define JPEG_FILE "../../examples/Bitmap/LoadJpeg/data/Photo.jpg"
+
+static s32 Errors;
+static const char *Shots;
+
+#define CHECK(cond, ...) do { if (!(cond)) { printf("  FAILED : "); printf(__VA_ARGS__); printf("\n"); Errors++; } } while (0)
+
+// The color a screen shows at x, y after the last frame
+static u16 Shown(u8 screen, s32 x, s32 y) {
+	return HostScreen[screen][y][x];
+}
+
+// Both screens of the last frame to <Shots>_<name>.png, if asked for
+static void Shot(const char *name) {
+	char file[256];
+
+	if (!Shots) return;
+	snprintf(file, sizeof(file), "%s_%s.png", Shots, name);
+	CHECK(HostWriteScreens(file), "can't write %s", file);
+}
+
+static u8 *ReadFile(const char *name, u32 *size) {
+	FILE *f = fopen(name, "rb");
+	u8 *data;
+	long length;
+
+	if (!f) {
+		printf("Can't open %s\n", name);
+		exit(1);
+	}
+	fseek(f, 0, SEEK_END);
+	length = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	data = (u8*)malloc(length + 4); // Read by words on the DS
+	if (fread(data, 1, length, f) != (size_t)length) length = 0;
+	fclose(f);
+	*size = length;
+	return data;
+}
+
+// Starts each check from the screens PA_Init leaves: mode 0, nothing shown
+static void ResetScreens(void) {
+	u8 screen;
+
+	PA_ResetBgSys();
+	for (screen = 0; screen < 2; screen++) {
+		PA_SetVideoMode(screen, 0);
+		PA_nBit[screen] = 0;
+		BG_PALETTE[screen << 9] = 0; // Black backdrop
+	}
+}
+
+// Large maps
+// ----------
+
+#define MAP_W 160 // In tiles : 1280x1024 pixels, wider and higher than the 512x256 of the DS map
+#define MAP_H 128
+
+static u8 LargeTiles[256 << 6];
+static u16 LargeMap[MAP_W * MAP_H];
+static u16 LargePal[256];
+
+// What the map shows at x, y, repeated in both directions
+static u16 LargePixel(s32 x, s32 y) {
+	u16 tile;
+	s32 tx, ty;
+
+	x = PA_Modulo(x, MAP_W << 3);
+	y = PA_Modulo(y, MAP_H << 3);
+	tile = LargeMap[(y >> 3) * MAP_W + (x >> 3)];
+	tx = (tile & TILE_HFLIP) ? 7 - (x & 7) : (x & 7);
+	ty = (tile & TILE_VFLIP) ? 7 - (y & 7) : (y & 7);
+	return LargePal[LargeTiles[((tile & 1023) << 6) + (ty << 3) + tx]];
+}
+
+// Pixels of the screen that aren't the map scrolled to x, y
+static s32 LargeWrong(u8 screen, s32 x, s32 y) {
+	s32 i, j, wrong = 0;
+
+	for (j = 0; j < 192; j++)
+		for (i = 0; i < 256; i++) wrong += (Shown(screen, i, j) != LargePixel(x + i, y + j));
+	return wrong;
+}
+
+// A map bigger than the DS one, scrolled a little each frame with some jumps, on both screens
+static void TestLargeMap(void) {
+	PA_BgStruct bg = { PA_BgLarge, MAP_W << 3, MAP_H << 3 };
+	s32 i, frame, x[2] = {0, 0}, y[2] = {0, 0}, wrongframes[2] = {0, 0};
+	u8 screen;
+
+	printf("Large map, 1280x1024 scrolled on both screens for 1000 frames\n");
+	ResetScreens();
+	for (i = 0; i < (s32)sizeof(LargeTiles); i++) LargeTiles[i] = rand() % 255 + 1; // Never transparent
+	for (i = 0; i < MAP_W * MAP_H; i++) LargeMap[i] = (rand() & 255) | (rand() & (TILE_HFLIP | TILE_VFLIP));
+	for (i = 0; i < 256; i++) LargePal[i] = (i * 131 + 7) & 0x7FFF;
+
+	bg.BgTiles = LargeTiles;
+	bg.BgMap = LargeMap;
+	bg.BgPalette = LargePal;
+	bg.BgTiles_size = sizeof(LargeTiles);
+	bg.BgMap_size = sizeof(LargeMap);
+	PA_LoadBackground(0, 1, &bg);
+	PA_LoadBackground(1, 3, &bg);
+
+	for (frame = 0; frame < 1000; frame++) {
+		for (screen = 0; screen < 2; screen++) {
+			if (rand() % 100 == 0) { // Jump
+				x[screen] += rand() % 4096 - 2048;
+				y[screen] += rand() % 4096 - 2048;
+			}
+			else {
+				x[screen] += rand() % 25 - 12;
+				y[screen] += rand() % 25 - 12;
+			}
+			PA_EasyBgScrollXY(screen, screen ? 3 : 1, x[screen], y[screen]);
+		}
+		PA_WaitForVBL();
+
+		for (screen = 0; screen < 2; screen++) {
+			s32 wrong = LargeWrong(screen, x[screen], y[screen]);
+			if (wrong && !wrongframes[screen]) printf("  screen %d, frame %d at %d, %d : %d pixels wrong\n", screen, frame, x[screen], y[screen], wrong);
+			wrongframes[screen] += (wrong > 0);
+		}
+	}
+	for (screen = 0; screen < 2; screen++) CHECK(!wrongframes[screen], "screen %d wrong on %d frames", screen, wrongframes[screen]);
+	Shot("largemap");
+}
+
+// Text
+// ----
+
+// Lines y0 to y1 (excluded) the same on both screens
+static u8 SameLines(s32 y0, s32 y1) {
+	s32 y;
+
+	for (y = y0; y < y1; y++)
+		if (memcmp(HostScreen[0][y], HostScreen[1][y], 512) != 0) return 0;
+	return 1;
+}
+
+// Pixels of an 8x8 text cell other than the backdrop
+static s32 CellPixels(u8 screen, s32 cx, s32 cy) {
+	s32 x, y, n = 0;
+
+	for (y = 0; y < 8; y++)
+		for (x = 0; x < 8; x++) n += (Shown(screen, cx * 8 + x, cy * 8 + y) != BG_PALETTE[screen << 9]);
+	return n;
+}
+
+// The default text on both screens, the one of screen 0 written as the reference for screen 1
+static void TestText(void) {
+	s32 i, row;
+
+	printf("Text, tiled on both screens\n");
+	ResetScreens();
+	PA_InitText(0, 0);
+	PA_InitText(1, 0);
+
+	PA_OutputSimpleText(0, 2, 3, "Score 42");
+	PA_OutputText(1, 2, 3, "Score %d", 42);
+	PA_WaitForVBL();
+	CHECK(SameLines(0, 192), "PA_OutputText not the same as PA_OutputSimpleText");
+	for (i = 0; i < 8; i++) {
+		if (i == 5) CHECK(CellPixels(0, 2 + i, 3) == 0, "the space is drawn");
+		else CHECK(CellPixels(0, 2 + i, 3) > 0, "letter %d not drawn", i);
+	}
+	CHECK(CellPixels(0, 10, 3) == 0 && CellPixels(0, 2, 4) == 0, "text drawn out of its cells");
+	Shot("text");
+
+	// The console scrolls up once the bottom is reached : it shows the last 23 lines over an empty one
+	PA_ClearTextBg(0);
+	PA_ClearTextBg(1);
+	for (i = 0; i < 40; i++) PA_Print(1, "Line %d\n", i);
+	for (row = 0; row < 23; row++) PA_OutputText(0, 0, row, "Line %d", 40 - 23 + row);
+	PA_WaitForVBL();
+	CHECK(SameLines(0, 192), "PA_Print lines not where they should be after scrolling");
+	Shot("print");
+}
+
+// Drawing
+// -------
+
+static u16 Expected[192][256];
+
+// The screen against Expected, bit 15 of the colors left out
+static s32 DrawWrong(u8 screen) {
+	s32 x, y, wrong = 0;
+
+	for (y = 0; y < 192; y++)
+		for (x = 0; x < 256; x++) wrong += (Shown(screen, x, y) != (Expected[y][x] & 0x7FFF));
+	return wrong;
+}
+
+// 16 bit pixels, lines, rectangles and text on screen 0, 8 bit ones on screen 1
+static void TestDraw(void) {
+	u16 red = PA_RGB(31, 0, 0), green = PA_RGB(0, 31, 0), blue = PA_RGB(0, 0, 31), white = PA_RGB(31, 31, 31);
+	s32 i, x, y, drawn, moved;
+
+	printf("Drawing, 16 bit on screen 0 and 8 bit on screen 1\n");
+	ResetScreens();
+	PA_Init16bitBg(0, 3);
+	PA_Init8bitBg(1, 3);
+	memset(Expected, 0, sizeof(Expected));
+
+	PA_Put16bitPixel(0, 5, 6, red);
+	Expected[6][5] = red;
+	PA_Draw16bitLine(0, 10, 20, 100, 20, green); // Both ends drawn
+	for (x = 10; x <= 100; x++) Expected[20][x] = green;
+	PA_Draw16bitLine(0, 120, 60, 120, 10, green);
+	for (y = 10; y <= 60; y++) Expected[y][120] = green;
+	PA_Draw16bitLine(0, 130, 10, 170, 50, blue);
+	for (i = 0; i <= 40; i++) Expected[10 + i][130 + i] = blue;
+	PA_Draw16bitRect(0, 20, 100, 60, 140, red); // The end is left out
+	for (y = 100; y < 140; y++)
+		for (x = 20; x < 60; x++) Expected[y][x] = red;
+	PA_WaitForVBL();
+	CHECK(DrawWrong(0) == 0, "16 bit : %d pixels wrong", DrawWrong(0));
+
+	// The same text twice, 30 pixels apart, white and nowhere else
+	CHECK(PA_16bitText(0, 150, 100, 255, 129, "Hello", white, 3, 0, 100) == 5, "16 bit text : not 5 letters");
+	PA_16bitText(0, 150, 130, 255, 159, "Hello", white, 3, 0, 100);
+	PA_WaitForVBL();
+	for (y = 100, drawn = moved = 0; y < 130; y++)
+		for (x = 150; x < 256; x++) {
+			drawn += (Shown(0, x, y) == (white & 0x7FFF));
+			moved += (Shown(0, x, y) != Shown(0, x, y + 30));
+		}
+	CHECK(drawn > 0 && moved == 0, "16 bit text : %d pixels drawn, %d not the same 30 pixels below", drawn, moved);
+	for (y = 100; y < 160; y++)
+		for (x = 150; x < 256; x++) Expected[y][x] = Shown(0, x, y);
+	CHECK(DrawWrong(0) == 0, "16 bit text : %d pixels drawn out of its box", DrawWrong(0));
+
+	// 8 bit : palette colors, and the pixels next to each other in a 16 bit word
+	memset(Expected, 0, sizeof(Expected));
+	PA_SetBgPalCol(1, 7, PA_RGB(0, 31, 31));
+	PA_SetBgPalCol(1, 8, PA_RGB(31, 31, 0));
+	PA_Put8bitPixel(1, 9, 9, 7);
+	PA_Put8bitPixel(1, 10, 9, 8);
+	Expected[9][9] = PA_RGB(0, 31, 31);
+	Expected[9][10] = PA_RGB(31, 31, 0);
+	PA_Draw8bitLine(1, 3, 50, 200, 50, 8);
+	for (x = 3; x <= 200; x++) Expected[50][x] = PA_RGB(31, 31, 0);
+	PA_Draw8bitLine(1, 33, 60, 33, 180, 7);
+	for (y = 60; y <= 180; y++) Expected[y][33] = PA_RGB(0, 31, 31);
+	PA_WaitForVBL();
+	CHECK(DrawWrong(1) == 0, "8 bit : %d pixels wrong", DrawWrong(1));
+	Shot("draw");
+
+	// Double buffer : drawn on the hidden buffer, shown once swapped
+	PA_Init16bitDblBuffer(0, 3);
+	PA_Draw16bitRect(0, 0, 0, 256, 192, blue);
+	PA_WaitForVBL();
+	CHECK(Shown(0, 128, 96) == 0, "double buffer : drawn before the swap");
+	PA_16bitSwapBuffer(0);
+	PA_WaitForVBL();
+	CHECK(Shown(0, 128, 96) == (blue & 0x7FFF) && Shown(0, 0, 0) == (blue & 0x7FFF), "double buffer : not shown after the swap");
+}
+
+// Gif
+// ---
+
+static const u8 *GifPos;
+
+static int GifRead(GifFileType *gif, GifByteType *buf, int count) {
+	(void)gif;
+	memcpy(buf, GifPos, count);
+	GifPos += count;
+	return count;
+}
+
+// The first image of a gif, decoded on its own : Expected gets its colors at x, y
+static void GifExpected(const u8 *data, s32 x, s32 y) {
+	static const s32 offsets[4] = {0, 4, 2, 1}, jumps[4] = {8, 8, 4, 2};
+	static GifPixelType line[2048];
+	GifFileType *gif;
+	GifRecordType type;
+	ColorMapObject *map;
+	s32 pass, row, i, width, height;
+
+	GifPos = data;
+	gif = DGifOpen(NULL, GifRead);
+	do {
+		DGifGetRecordType(gif, &type);
+		if (type == EXTENSION_RECORD_TYPE) {
+			GifByteType *extension;
+			s32 code;
+			DGifGetExtension(gif, &code, &extension);
+			while (extension) DGifGetExtensionNext(gif, &extension);
+		}
+	} while (type != IMAGE_DESC_RECORD_TYPE && type != TERMINATE_RECORD_TYPE);
+	if (type == TERMINATE_RECORD_TYPE || DGifGetImageDesc(gif) == GIF_ERROR) {
+		printf("  No image in the gif\n");
+		exit(1);
+	}
+
+	map = gif->Image.ColorMap ? gif->Image.ColorMap : gif->SColorMap;
+	width = gif->Image.Width;
+	height = gif->Image.Height;
+	x += gif->Image.Left;
+	y += gif->Image.Top;
+	for (pass = 0; pass < 4; pass++)
+		for (row = gif->Image.Interlace ? offsets[pass] : pass ? height : 0; row < height; row += gif->Image.Interlace ? jumps[pass] : 1) {
+			DGifGetLine(gif, line, width);
+			for (i = 0; i < width; i++) {
+				GifColorType *c = &map->Colors[line[i]];
+				Expected[y + row][x + i] = PA_RGB(c->Red >> 3, c->Green >> 3, c->Blue >> 3);
+			}
+		}
+	DGifCloseFile(gif);
+}
+
+// PA_LoadGif on a 16 bit and an 8 bit background, and PA_LoadGifXY
+static void TestGif(void) {
+	u32 size, small_size;
+	u8 *data = ReadFile(GIF_FILE, &size), *small = ReadFile(GIF_SMALL, &small_size);
+
+	printf("Gif, %s\n", GIF_FILE);
+	ResetScreens();
+	PA_Init16bitBg(0, 3);
+	PA_Init8bitBg(1, 3);
+	PA_LoadGif(0, data);
+	PA_LoadGif(1, data);
+	PA_WaitForVBL();
+	GifExpected(data, 0, 0);
+	CHECK(DrawWrong(0) == 0, "16 bit : %d pixels wrong", DrawWrong(0));
+	CHECK(DrawWrong(1) == 0, "8 bit : %d pixels wrong", DrawWrong(1));
+	Shot("gif");
+
+	PA_LoadGifXY(0, 100, 50, small);
+	PA_WaitForVBL();
+	GifExpected(small, 100, 50);
+	CHECK(DrawWrong(0) == 0, "16 bit at 100, 50 : %d pixels wrong", DrawWrong(0));
+
+	free(data);
+	free(small);
+}
+
+// Jpeg
+// ----
+
+// PA_LoadJpeg against libjpeg, on the 5 bits of each color
+static void TestJpeg(void) {
+	struct jpeg_decompress_struct info;
+	struct jpeg_error_mgr error;
+	u8 line[256 * 3];
+	u32 size;
+	u8 *data = ReadFile(JPEG_FILE, &size);
+	s32 x, y, c, far = 0, diff, total = 0;
+
+	printf("Jpeg, %s\n", JPEG_FILE);
+	ResetScreens();
+	PA_Init16bitBg(0, 3);
+	PA_LoadJpeg(0, data);
+	PA_WaitForVBL();
+	Shot("jpeg");
+
+	info.err = jpeg_std_error(&error);
+	jpeg_create_decompress(&info);
+	jpeg_mem_src(&info, data, size);
+	jpeg_read_header(&info, TRUE);
+	info.do_fancy_upsampling = FALSE; // Each color sample over its pixels, like PAlib
+	jpeg_start_decompress(&info);
+	CHECK(info.output_width == 256 && info.output_height == 192 && info.output_components == 3, "not a 256x192 color jpeg");
+
+	for (y = 0; y < 192 && info.output_scanline < info.output_height; y++) {
+		u8 *p = line;
+		jpeg_read_scanlines(&info, &p, 1);
+		for (x = 0; x < 256; x++)
+			for (c = 0; c < 3; c++) {
+				diff = abs(((Shown(0, x, y) >> (5 * c)) & 31) - (line[x * 3 + c] >> 3));
+				total += diff;
+				far += (diff > 3);
+			}
+	}
+	jpeg_finish_decompress(&info);
+	jpeg_destroy_decompress(&info);
+
+	// Both round their own way : most colors within 1 of 31, none over 3
+	printf("  %.3f of 31 off on average\n", (double)total / (256 * 192 * 3));
+	CHECK(total < 256 * 192 * 3 / 2 && far == 0, "%.3f of 31 off on average, %d colors off by more than 3", (double)total / (256 * 192 * 3), far);
+	free(data);
+}
+
+int main(int argc, char **argv) {
+	srand(1);
+	PA_Init();
+	Shots = (argc > 1) ? argv[1] : NULL;
+
+	TestLargeMap();
+	TestText();
+	TestDraw();
+	TestGif();
+	TestJpeg();
+
+	if (Errors) {
+		printf("%d errors\n", Errors);
+		return 1;
+	}
+	printf("All good\n");
+	return 0;
+}
@@ -0,0 +1,346 @@
+// SpriteBench - checks and times the PAlib sprite VRAM allocator (PA_Sprite.c) on a computer,
+// and checks what the sprites show on the screen drawn by ../host
+//
+// Build it on Linux, from this folder (see ../host/ReadMe.txt):
+//   make -C ../host
+//   gcc -O2 -no-pie -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast -I../host -I../../include -I../../include/arm9 -o SpriteBench SpriteBench.c ../host/build/libPAhost.a -lm
+// Run it with a file name to also write the screen of the render check to that PNG file.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "PA9.h"
+
+static s32 Errors;
+
+#define CHECK(cond, ...) do { if (!(cond)) { printf("  FAILED : "); printf(__VA_ARGS__); printf("\n"); Errors++; } } while (0)
+
+static double Now(void) {
+	return (double)clock() / CLOCKS_PER_SEC;
+}
+
+static u8 *SpriteVRAM(u8 screen, u16 gfx) {
+	return (u8*)(SPRITE_GFX1 + (0x200000 * screen) + (gfx << NUMBER_DECAL));
+}
+
+static u32 GfxBytes(u8 shape, u8 size, u8 color_mode) {
+	u16 mem_size = PA_obj_sizes[size][shape] >> (8 - color_mode);
+	if (mem_size == 0) mem_size++;
+	return (4 * mem_size) << MEM_DECAL;
+}
+
+static u16 FreeBlocks(u8 screen, u16 *largest) {
+	u16 i, blocks = 0;
+
+	*largest = 0;
+	for (i = 0; i < n_free_mem[screen]; i++) {
+		blocks += free_mem[screen][i].free;
+		if (free_mem[screen][i].free > *largest) *largest = free_mem[screen][i].free;
+	}
+	return blocks;
+}
+
+// The free list is sorted, its blocks don't touch each other nor a gfx, and everything adds up to the 1024 blocks.
+// used_mem is only read where a gfx starts : PA_DeleteGfx leaves old sizes inside merged free blocks.
+static void CheckFreeList(u8 screen, const s16 *gfx, s32 ngfx, const char *when) {
+	u8 owner[1024];
+	s32 i, j, total = 0;
+
+	memset(owner, 0, sizeof(owner));
+	for (i = 0; i < ngfx; i++) {
+		if (gfx[i] < 0) continue;
+		for (j = gfx[i]; j < gfx[i] + used_mem[screen][gfx[i]]; j++) {
+			CHECK(j < 1024 && !owner[j], "%s : gfx %d goes over block %d", when, gfx[i], j);
+			if (j < 1024) owner[j] = 1;
+		}
+		total += used_mem[screen][gfx[i]];
+	}
+
+	for (i = 0; i < n_free_mem[screen]; i++) {
+		s32 start = free_mem[screen][i].mem_block, end = start + free_mem[screen][i].free;
+
+		if (i > 0) CHECK(free_mem[screen][i - 1].mem_block + free_mem[screen][i - 1].free < start, "%s : free blocks %d and %d out of order or not merged", when, i - 1, i);
+		for (j = start; j < end && j < 1024; j++) {
+			CHECK(!owner[j], "%s : free block %d is used by a gfx", when, j);
+			owner[j] = 2;
+		}
+		total += free_mem[screen][i].free;
+	}
+
+	CHECK(total == 1024, "%s : %d blocks instead of 1024", when, total);
+}
+
+static void Fill(u8 *data, u32 size, u32 seed) {
+	u32 i;
+	for (i = 0; i < size; i++) data[i] = (u8)((seed = seed * 1103515245 + 12345) >> 16);
+}
+
+// Random gfx created and deleted, each checked against its image
+static void TestAllocator(void) {
+	static u8 images[64][8192]; // Up to 64x64 in 16 bit
+	s16 gfx[64];
+	u8 shapes[64], sizes[64], modes[64];
+	s32 n, i, live = 0;
+
+	printf("Allocator, 200000 random PA_CreateGfx and PA_DeleteGfx\n");
+	PA_ResetSpriteSys();
+	for (i = 0; i < 64; i++) gfx[i] = -1;
+
+	for (n = 0; n < 200000; n++) {
+		i = rand() & 63;
+
+		if (gfx[i] < 0) {
+			u16 largest;
+			shapes[i] = rand() % 3;
+			sizes[i] = rand() & 3;
+			modes[i] = rand() % 3;
+			FreeBlocks(0, &largest);
+			if (((GfxBytes(shapes[i], sizes[i], modes[i]) >> 7)) > largest) continue; // PA_CreateGfx stops the DS there
+			Fill(images[i], GfxBytes(shapes[i], sizes[i], modes[i]), n);
+			gfx[i] = PA_CreateGfx(0, images[i], shapes[i], sizes[i], modes[i]);
+			live++;
+		}
+		else {
+			CHECK(memcmp(SpriteVRAM(0, gfx[i]), images[i], GfxBytes(shapes[i], sizes[i], modes[i])) == 0, "gfx %d changed", gfx[i]);
+			PA_DeleteGfx(0, gfx[i]);
+			gfx[i] = -1;
+			live--;
+		}
+
+		if ((n & 1023) == 0) CheckFreeList(0, gfx, 64, "random");
+	}
+
+	for (i = 0; i < 64; i++) if (gfx[i] >= 0) PA_DeleteGfx(0, gfx[i]);
+	CheckFreeList(0, gfx, 0, "all deleted");
+	CHECK(n_free_mem[0] == 1 && free_mem[0][0].free == 1024, "VRAM not in one block at the end");
+}
+
+// Sprites from the same images share them, until one is drawn on
+static void TestSharing(void) {
+	static u8 images[8][1024], copies[8][1024];
+	u16 largest;
+	s32 i;
+
+	printf("Sharing, 128 sprites from 8 images\n");
+	PA_ResetSpriteSys();
+	for (i = 0; i < 8; i++) {
+		Fill(images[i], 1024, i + 1);
+		memcpy(copies[i], images[i], 1024);
+	}
+
+	PA_SetGfxDedup(PA_GFXDEDUP_POINTER);
+	for (i = 0; i < 128; i++) PA_CreateSprite(0, i, images[i & 7], OBJ_SIZE_32X32, 1, 0, 0, 0);
+	CHECK(FreeBlocks(0, &largest) == 1024 - 8 * 8, "pointer : %d blocks used for 8 images", 1024 - FreeBlocks(0, &largest));
+
+	// Drawn on : its own copy, the 15 others keep the image
+	PA_InitSpriteDraw(0, 3);
+	CHECK(FreeBlocks(0, &largest) == 1024 - 9 * 8, "drawn on : no copy made");
+	CHECK(PA_GetSpriteGfx(0, 3) != PA_GetSpriteGfx(0, 11), "drawn on : still shared");
+	spriteanims[0][3].gfx[0] ^= 0xFFFF;
+	CHECK(memcmp(SpriteVRAM(0, PA_GetSpriteGfx(0, 11)), images[3], 1024) == 0, "drawn on : the other sprites changed");
+
+	for (i = 0; i < 128; i++) PA_DeleteSprite(0, i);
+	CheckFreeList(0, NULL, 0, "pointer");
+	CHECK(FreeBlocks(0, &largest) == 1024, "pointer : %d blocks left after deleting the sprites", 1024 - FreeBlocks(0, &largest));
+
+	// Copies of the images are only found from their pixels
+	for (i = 0; i < 16; i++) PA_CreateSprite(0, i, (i & 8) ? copies[i & 7] : images[i & 7], OBJ_SIZE_32X32, 1, 0, 0, 0);
+	CHECK(FreeBlocks(0, &largest) == 1024 - 16 * 8, "pointer : copies shared");
+	for (i = 0; i < 16; i++) PA_DeleteSprite(0, i);
+
+	PA_SetGfxDedup(PA_GFXDEDUP_CONTENT);
+	for (i = 0; i < 16; i++) PA_CreateSprite(0, i, (i & 8) ? copies[i & 7] : images[i & 7], OBJ_SIZE_32X32, 1, 0, 0, 0);
+	CHECK(FreeBlocks(0, &largest) == 1024 - 8 * 8, "content : copies not shared");
+	for (i = 0; i < 16; i++) PA_DeleteSprite(0, i);
+	CheckFreeList(0, NULL, 0, "content");
+
+	// Alone on its gfx and animated : that gfx no longer holds frame 0
+	static u8 frames[2][1024];
+	Fill(frames[0], 1024, 100);
+	Fill(frames[1], 1024, 101);
+	PA_SetGfxDedup(PA_GFXDEDUP_POINTER);
+	PA_CreateSprite(0, 0, frames, OBJ_SIZE_32X32, 1, 0, 0, 0);
+	PA_SetSpriteAnim(0, 0, 1);
+	PA_CreateSprite(0, 1, frames, OBJ_SIZE_32X32, 1, 0, 0, 0);
+	CHECK(memcmp(SpriteVRAM(0, PA_GetSpriteGfx(0, 1)), frames[0], 1024) == 0, "animated alone : the new sprite shows frame 1");
+	CHECK(memcmp(SpriteVRAM(0, PA_GetSpriteGfx(0, 0)), frames[1], 1024) == 0, "animated alone : frame 1 not shown");
+	PA_DeleteSprite(0, 0);
+	PA_DeleteSprite(0, 1);
+	CheckFreeList(0, NULL, 0, "animated alone");
+
+	PA_SetGfxDedup(PA_GFXDEDUP_OFF);
+}
+
+// Sprites with the same angle and zoom share a rotset, computed at PA_UpdateOAM
+static void TestRotsets(void) {
+	static u8 image[1024];
+	s32 i, frame, used, ok = 1;
+
+	printf("Rotsets, 128 sprites turning at 16 angles\n");
+	PA_ResetSpriteSys();
+	for (i = 0; i < 128; i++) PA_CreateSprite(0, i, image, OBJ_SIZE_32X32, 1, 0, 0, 0);
+
+	for (frame = 0; frame < 512; frame++) {
+		for (i = 0; i < 128; i++) ok &= PA_SetSpriteRotZoom(0, i, frame + ((i & 15) << 5), 256 + frame, 256);
+		PA_UpdateOAM();
+
+		for (i = 0; i < 128; i++) {
+			u8 rotset = (PA_obj[0][i].atr1 >> 9) & 31;
+			s16 angle = (frame + ((i & 15) << 5)) & 511;
+			if (PA_obj[0][rotset << 2].atr3 != (u16)((PA_Cos(angle) * (256 + frame)) >> 8)) ok = 0;
+		}
+	}
+	CHECK(ok, "wrong matrix or no rotset left");
+
+	for (i = used = 0; i < 32; i++) used += (pa_rotsetrefs[0][i] > 0);
+	CHECK(used == 16, "%d rotsets used for 16 angles", used);
+
+	for (i = 0; i < 128; i++) PA_DeleteSprite(0, i);
+	for (i = used = 0; i < 32; i++) used += (pa_rotsetrefs[0][i] > 0);
+	CHECK(used == 0, "%d rotsets left after deleting the sprites", used);
+}
+
+// Tiled gfx from a color index for each pixel, 4 or 8 bits per pixel
+static void MakeTiles(u8 *data, s32 w, s32 h, u8 color_mode, u8 (*pixel)(s32 x, s32 y)) {
+	s32 x, y;
+
+	memset(data, 0, (w * h) >> (1 - color_mode));
+	for (y = 0; y < h; y++)
+		for (x = 0; x < w; x++) {
+			s32 pos = (((y >> 3) * (w >> 3) + (x >> 3)) << 6) + ((y & 7) << 3) + (x & 7);
+			if (color_mode) data[pos] = pixel(x, y);
+			else data[pos >> 1] |= pixel(x, y) << ((pos & 1) << 2);
+		}
+}
+
+static u8 Pixel256(s32 x, s32 y) {
+	return (x + 32 * y) % 255 + 1;
+}
+
+static u8 Pixel16(s32 x, s32 y) {
+	return ((x + y) & 7) ? (x + y) % 15 + 1 : 0; // Some transparent pixels
+}
+
+// The color the top screen shows at x, y after the last frame
+static u16 Shown(s32 x, s32 y) {
+	return HostScreen[0][y][x];
+}
+
+// Sprites placed, flipped, clipped, over each other and turned, shown on the next frame
+static void TestRender(const char *png) {
+	static u8 image256[1024], image16[512];
+	static u16 palette[256];
+	s32 i, x, y, ok;
+
+	printf("Render, sprites drawn from OAM and VRAM\n");
+	PA_ResetSpriteSys();
+	for (i = 0; i < 256; i++) palette[i] = (i * 97) & 0x7FFF; // All different
+	PA_LoadSpritePal(0, 0, palette); // Extended palette 0 for the 256 color sprites
+	memcpy(SPRITE_PALETTE, palette, 512); // And the 16 color ones
+	BG_PALETTE[0] = 0; // Black where there is no sprite
+	MakeTiles(image256, 32, 32, 1, Pixel256);
+	MakeTiles(image16, 32, 32, 0, Pixel16);
+
+	PA_CreateSprite(0, 0, image256, OBJ_SIZE_32X32, 1, 0, 10, 20);
+	PA_CreateSprite(0, 1, image256, OBJ_SIZE_32X32, 1, 0, 60, 20);
+	PA_SetSpriteHflip(0, 1, 1);
+	PA_CreateSprite(0, 2, image256, OBJ_SIZE_32X32, 1, 0, 110, 20);
+	PA_SetSpriteVflip(0, 2, 1);
+	PA_CreateSprite(0, 3, image16, OBJ_SIZE_32X32, 0, 3, 240, 180); // Cut by the right and bottom borders
+	PA_CreateSprite(0, 4, image256, OBJ_SIZE_32X32, 1, 0, 26, 36); // Under sprite 0
+	PA_CreateSprite(0, 5, image256, OBJ_SIZE_32X32, 1, 0, 180, 20); // Over sprite 6 from its priority
+	PA_CreateSprite(0, 6, image256, OBJ_SIZE_32X32, 1, 0, 196, 36);
+	PA_SetSpritePrio(0, 6, 2);
+	PA_SetSpritePrio(0, 5, 3);
+	PA_CreateSprite(0, 7, image256, OBJ_SIZE_32X32, 1, 0, 10, 100); // Hidden
+	PA_SetSpriteDblsize(0, 7, 1);
+	PA_CreateSprite(0, 8, image256, OBJ_SIZE_32X32, 1, 0, 60, 100);
+	PA_SetSpriteRotZoom(0, 8, 0, 256, 256);
+	PA_CreateSprite(0, 9, image256, OBJ_SIZE_32X32, 1, 0, 110, 100);
+	PA_SetSpriteRotZoom(0, 9, 256, 256, 256); // Half a turn
+	PA_CreateSprite(0, 10, image256, OBJ_SIZE_32X32, 1, 0, 160, 100);
+	PA_SetSpriteRotZoom(0, 10, 0, 512, 512); // Half as big
+	PA_UpdateOAM();
+	PA_WaitForVBL();
+
+	for (y = 0, ok = 1; y < 32; y++)
+		for (x = 0; x < 32; x++) {
+			u16 color = palette[Pixel256(x, y)];
+			if ((x < 16) || (y < 16)) ok &= (Shown(10 + x, 20 + y) == color); // Sprite 4 under the rest
+			ok &= (Shown(60 + 31 - x, 20 + y) == color);
+			ok &= (Shown(110 + x, 20 + 31 - y) == color);
+			ok &= (Shown(60 + x, 100 + y) == color); // Turned by 0
+			if ((x > 0) && (y > 0)) ok &= (Shown(110 + 32 - x, 100 + 32 - y) == color); // Half a turn, from the center
+			ok &= (Shown(10 + x, 100 + y) == 0);
+		}
+	CHECK(ok, "sprites 0 to 2 or 7 to 9 wrong");
+
+	for (y = 0, ok = 1; y < 32; y++)
+		for (x = 0; x < 32; x++) {
+			u8 index = Pixel16(x, y);
+			u16 color = index ? palette[48 + index] : 0;
+			if ((240 + x < 256) && (180 + y < 192)) ok &= (Shown(240 + x, 180 + y) == color);
+			if (y < 12) ok &= (Shown(x, 180 + y) == 0); // Not drawn again on the left
+			if (y < 20) ok &= (Shown(224 + x, y) == 0); // Nor at the top
+		}
+	CHECK(ok, "16 color sprite 3 wrong or not cut");
+
+	CHECK(Shown(26 + 20, 36 + 20) == palette[Pixel256(20, 20)], "sprite 4 not shown");
+	CHECK(Shown(10 + 20, 20 + 20) == palette[Pixel256(20, 20)], "sprite 0 not over sprite 4");
+	CHECK(Shown(196 + 4, 36 + 4) == palette[Pixel256(4, 4)], "sprite 6 not over sprite 5 of lower priority");
+
+	for (y = 0, ok = 1; y < 32; y++) // Half as big : every other pixel, around the center
+		for (x = 0; x < 32; x++) {
+			u8 inside = (x >= 8) && (x < 24) && (y >= 8) && (y < 24);
+			u16 color = inside ? palette[Pixel256(2 * (x - 8), 2 * (y - 8))] : 0;
+			ok &= (Shown(160 + x, 100 + y) == color);
+		}
+	CHECK(ok, "zoomed sprite 10 wrong");
+
+	if (png) CHECK(HostWritePNG(png, &HostScreen[0][0][0], 256, 192), "can't write %s", png);
+
+	for (i = 0; i < 11; i++) PA_DeleteSprite(0, i);
+}
+
+static void Bench(u8 mode, const char *name) {
+	static u8 images[16][1024];
+	double t;
+	s32 n, i;
+
+	PA_ResetSpriteSys();
+	PA_SetGfxDedup(mode);
+	for (i = 0; i < 16; i++) Fill(images[i], 1024, i + 1);
+
+	t = Now();
+	for (n = 0; n < 2000; n++) {
+		for (i = 0; i < 128; i++) PA_CreateSprite(0, i, images[i & 15], OBJ_SIZE_32X32, 1, 0, 0, 0);
+		for (i = 0; i < 128; i++) PA_DeleteSprite(0, i);
+	}
+	t = Now() - t;
+
+	printf("  %-8s %8.0f sprites created and deleted per second\n", name, 2000 * 128 / t);
+	PA_SetGfxDedup(PA_GFXDEDUP_OFF);
+}
+
+int main(int argc, char **argv) {
+	srand(1);
+	PA_Init();
+
+	TestAllocator();
+	TestSharing();
+	TestRotsets();
+	TestRender((argc > 1) ? argv[1] : NULL);
+
+	printf("Times, 128 sprites of 32x32 from 16 images, on a computer\n");
+	Bench(PA_GFXDEDUP_OFF, "off");
+	Bench(PA_GFXDEDUP_POINTER, "pointer");
+	Bench(PA_GFXDEDUP_CONTENT, "content");
+
+	if (Errors) {
+		printf("%d errors\n", Errors);
+		return 1;
+	}
+	printf("All good\n");
+	return 0;
+}
@@ -0,0 +1,740 @@
+// The DS hardware PAlib talks to, on a computer: the memory at the DS
+// addresses, the VRAM banks, DMA, interrupts, timers, frames, input, the
+// divider and the parts of libnds PAlib calls. See ReadMe.txt.
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "PA9.h"
+
+#define LINES        263
+#define LINE_CYCLES  2130 // At the bus clock, 33.51 MHz
+#define FRAME_CYCLES (LINES * LINE_CYCLES)
+
+u32 HostFrames;
+u16 HostScreen[2][192][256];
+HostGfxCommand *HostGfx;
+u32 HostGfxCount;
+PERSONAL_DATA HostPersonalData;
+
+//////////////////////////////////////////////////////////////////////
+// Memory
+//////////////////////////////////////////////////////////////////////
+
+// The 9 banks are one file, in the order of their LCD addresses, so the same
+// memory can be mapped at the LCD address and where the bank is used
+#define VRAM_FILE_SIZE 0xA4000
+
+static const u32 BankOffsets[9] = {0, 0x20000, 0x40000, 0x60000, 0x80000, 0x90000, 0x94000, 0x98000, 0xA0000};
+static const u32 BankSizes[9] = {0x20000, 0x20000, 0x20000, 0x20000, 0x10000, 0x4000, 0x4000, 0x8000, 0x4000};
+
+static int VramFile = -1;
+static u8 VramMapped[9] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+static vu8 *BankCr(u8 bank) {
+	return (bank < 7) ? &VRAM_A_CR + bank : &VRAM_H_CR + (bank - 7);
+}
+
+// Where the engines see a bank, 0 if they don't (LCD, textures, ARM7...)
+static u32 BankAddress(u8 bank, u8 cr) {
+	u8 mst = cr & 7, ofs = (cr >> 3) & 3;
+	u32 small = 0x4000 * (ofs & 1) + 0x10000 * (ofs >> 1);
+
+	if (!(cr & VRAM_ENABLE)) return 0;
+
+	switch (bank) {
+	case 0:
+	case 1:
+		if (mst == 1) return 0x06000000 + 0x20000 * ofs;
+		if (mst == 2) return 0x06400000 + 0x20000 * (ofs & 1);
+		break;
+	case 2:
+	case 3:
+		if (mst == 1) return 0x06000000 + 0x20000 * ofs;
+		if (mst == 4) return (bank == 2) ? 0x06200000 : 0x06600000;
+		break;
+	case 4:
+		if (mst == 1) return 0x06000000;
+		if (mst == 2) return 0x06400000;
+		break;
+	case 5:
+	case 6:
+		if (mst == 1) return 0x06000000 + small;
+		if (mst == 2) return 0x06400000 + small;
+		break;
+	case 7:
+		if (mst == 1) return 0x06200000;
+		break;
+	case 8:
+		if (mst == 1) return 0x06208000;
+		if (mst == 2) return 0x06600000;
+		break;
+	}
+
+	return 0;
+}
+
+static void *Map(u32 address, u32 size, int prot, int flags, int file, u32 offset) {
+	void *p = mmap((void*)(uintptr_t)address, size, prot, flags, file, offset);
+
+	if (p != (void*)(uintptr_t)address) {
+		fprintf(stderr, "Host: can't map the DS memory at 0x%08X\n", address);
+		exit(1);
+	}
+
+	return p;
+}
+
+// Maps the banks again where their VRAM_x_CR now puts them. Banks mapped at
+// the same place overlap, the last one wins instead of both being mixed.
+static void HostMapVram(void) {
+	u8 bank, changed = 0;
+
+	for (bank = 0; bank < 9; bank++) changed |= (*BankCr(bank) != VramMapped[bank]);
+	if (!changed) return;
+
+	Map(0x06000000, 0x800000, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+
+	for (bank = 0; bank < 9; bank++) {
+		u32 address;
+
+		VramMapped[bank] = *BankCr(bank);
+		address = BankAddress(bank, VramMapped[bank]);
+		if (address) Map(address, BankSizes[bank], PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, VramFile, BankOffsets[bank]);
+	}
+}
+
+__attribute__((constructor)) static void HostInit(void) {
+	const int fixed = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE;
+
+	Map(0x04000000, 0x10000, PROT_READ | PROT_WRITE, fixed, -1, 0);  // Registers
+	Map(0x05000000, 0x1000, PROT_READ | PROT_WRITE, fixed, -1, 0);   // Palettes
+	Map(0x06000000, 0x800000, PROT_READ | PROT_WRITE, fixed, -1, 0); // VRAM as the engines see it
+	Map(0x07000000, 0x1000, PROT_READ | PROT_WRITE, fixed, -1, 0);   // OAM
+	Map(0x08000000, 0x10000, PROT_READ, fixed, -1, 0);               // Nothing in slot 2
+
+	VramFile = memfd_create("vram", 0);
+	if ((VramFile < 0) || (ftruncate(VramFile, VRAM_FILE_SIZE) != 0)) {
+		fprintf(stderr, "Host: can't create the VRAM\n");
+		exit(1);
+	}
+	Map(0x06800000, VRAM_FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED_NOREPLACE, VramFile, 0);
+	HostMapVram();
+
+	// As libnds leaves them before main
+	REG_IME = 1;
+	REG_IE = IRQ_VBLANK;
+	REG_DISPSTAT = BIT(3);
+	REG_POWERCNT = POWER_ALL_2D | POWER_SWAP_LCDS;
+	REG_KEYINPUT = 0x3FF;
+	REG_DIVCNT = DIV_32_32;
+
+	HostPersonalData.birthMonth = 1;
+	HostPersonalData.birthDay = 1;
+	HostPersonalData.name[0] = 'D';
+	HostPersonalData.name[1] = 'S';
+	HostPersonalData.nameLen = 2;
+	HostPersonalData.language = 1; // English
+}
+
+void vramSetBankA(VRAM_A_TYPE a) { VRAM_A_CR = VRAM_ENABLE | a; HostMapVram(); }
+void vramSetBankB(VRAM_B_TYPE b) { VRAM_B_CR = VRAM_ENABLE | b; HostMapVram(); }
+void vramSetBankC(VRAM_C_TYPE c) { VRAM_C_CR = VRAM_ENABLE | c; HostMapVram(); }
+void vramSetBankD(VRAM_D_TYPE d) { VRAM_D_CR = VRAM_ENABLE | d; HostMapVram(); }
+void vramSetBankE(VRAM_E_TYPE e) { VRAM_E_CR = VRAM_ENABLE | e; HostMapVram(); }
+void vramSetBankF(VRAM_F_TYPE f) { VRAM_F_CR = VRAM_ENABLE | f; HostMapVram(); }
+void vramSetBankG(VRAM_G_TYPE g) { VRAM_G_CR = VRAM_ENABLE | g; HostMapVram(); }
+void vramSetBankH(VRAM_H_TYPE h) { VRAM_H_CR = VRAM_ENABLE | h; HostMapVram(); }
+void vramSetBankI(VRAM_I_TYPE i) { VRAM_I_CR = VRAM_ENABLE | i; HostMapVram(); }
+
+u32 vramSetPrimaryBanks(VRAM_A_TYPE a, VRAM_B_TYPE b, VRAM_C_TYPE c, VRAM_D_TYPE d) {
+	u32 old = VRAM_CR;
+
+	VRAM_CR = (VRAM_ENABLE | a) | ((VRAM_ENABLE | b) << 8) | ((VRAM_ENABLE | c) << 16) | ((u32)(VRAM_ENABLE | d) << 24);
+	HostMapVram();
+
+	return old;
+}
+
+u32 vramSetMainBanks(VRAM_A_TYPE a, VRAM_B_TYPE b, VRAM_C_TYPE c, VRAM_D_TYPE d) {
+	return vramSetPrimaryBanks(a, b, c, d);
+}
+
+void vramRestorePrimaryBanks(u32 vramTemp) {
+	VRAM_CR = vramTemp;
+	HostMapVram();
+}
+
+void vramRestoreMainBanks(u32 vramTemp) {
+	vramRestorePrimaryBanks(vramTemp);
+}
+
+u32 vramSetBanks_EFG(VRAM_E_TYPE e, VRAM_F_TYPE f, VRAM_G_TYPE g) {
+	u32 old = VRAM_EFG_CR;
+
+	VRAM_EFG_CR = (VRAM_ENABLE | e) | ((VRAM_ENABLE | f) << 8) | ((VRAM_ENABLE | g) << 16);
+	HostMapVram();
+
+	return old;
+}
+
+void vramRestoreBanks_EFG(u32 vramTemp) {
+	VRAM_EFG_CR = vramTemp;
+	HostMapVram();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Interrupts
+//////////////////////////////////////////////////////////////////////
+
+static VoidFn IrqHandlers[32];
+
+static void HostIrq(u32 mask) {
+	u32 i;
+
+	REG_IF |= mask;
+	if (!REG_IME || !(REG_IE & mask)) return;
+
+	for (i = 0; i < 32; i++) {
+		if (!(mask & REG_IE & (1u << i))) continue;
+
+		REG_IF &= ~(1u << i); // Acknowledged by the libnds dispatcher
+		if (IrqHandlers[i]) {
+			REG_IME = 0; // No nested interrupts
+			IrqHandlers[i]();
+			REG_IME = 1;
+		}
+	}
+}
+
+void irqInit(void) {
+	memset(IrqHandlers, 0, sizeof(IrqHandlers));
+	REG_IE = IRQ_VBLANK;
+	REG_IF = 0; // Written 1s acknowledge on the DS, here it is memory
+	REG_DISPSTAT = BIT(3);
+	REG_IME = 1;
+}
+
+void irqSet(u32 irq, VoidFn handler) {
+	u32 i;
+
+	for (i = 0; i < 32; i++)
+		if (irq & (1u << i)) IrqHandlers[i] = handler;
+}
+
+void irqClear(u32 irq) {
+	irqSet(irq, NULL);
+	irqDisable(irq);
+}
+
+// The display ones also have to be turned on in DISPSTAT
+void irqEnable(u32 irq) {
+	if (irq & IRQ_VBLANK) REG_DISPSTAT |= BIT(3);
+	if (irq & IRQ_HBLANK) REG_DISPSTAT |= BIT(4);
+	if (irq & IRQ_VCOUNT) REG_DISPSTAT |= BIT(5);
+	REG_IE |= irq;
+}
+
+void irqDisable(u32 irq) {
+	if (irq & IRQ_VBLANK) REG_DISPSTAT &= ~BIT(3);
+	if (irq & IRQ_HBLANK) REG_DISPSTAT &= ~BIT(4);
+	if (irq & IRQ_VCOUNT) REG_DISPSTAT &= ~BIT(5);
+	REG_IE &= ~irq;
+}
+
+//////////////////////////////////////////////////////////////////////
+// DMA. The addresses are kept here, the registers only have 32 bits.
+//////////////////////////////////////////////////////////////////////
+
+static uintptr_t DmaSrc[4], DmaDest[4], DmaDestStart[4];
+
+static void HostDma(u8 channel) {
+	u32 cr = DMA_CR(channel), count = cr & 0x1FFFFF, unit = (cr & DMA_32_BIT) ? 4 : 2, i;
+	s32 srcstep = unit, deststep = unit;
+	uintptr_t src = DmaSrc[channel], dest = DmaDest[channel];
+
+	if (count == 0) count = 0x200000;
+	if (cr & DMA_SRC_FIX) srcstep = 0;
+	else if (cr & DMA_SRC_DEC) srcstep = -srcstep;
+	if ((cr & DMA_DST_RESET) == DMA_DST_FIX) deststep = 0;
+	else if ((cr & DMA_DST_RESET) == DMA_DST_DEC) deststep = -deststep;
+
+	for (i = 0; i < count; i++) {
+		// The DMA can't read the ITCM at 0: zeros, which PAlib copies when there is no map
+		u32 value = (src < 0x8000) ? 0 : ((unit == 4) ? *(vu32*)src : *(vu16*)src);
+
+		if (unit == 4) *(vu32*)dest = value;
+		else *(vu16*)dest = value;
+		src += srcstep;
+		dest += deststep;
+	}
+
+	DmaSrc[channel] = src;
+	DmaDest[channel] = ((cr & DMA_DST_RESET) == DMA_DST_RESET) ? DmaDestStart[channel] : dest;
+	DMA_SRC(channel) = (u32)DmaSrc[channel];
+	DMA_DEST(channel) = (u32)DmaDest[channel];
+
+	if (!(cr & DMA_REPEAT) || ((cr & (7 << 27)) == DMA_START_NOW)) DMA_CR(channel) = cr & ~DMA_ENABLE;
+	if (cr & DMA_IRQ_REQ) HostIrq(IRQ_DMA0 << channel);
+}
+
+// The DMAs waiting for this moment (DMA_START_HBL or DMA_START_VBL)
+static void HostDmaStart(u32 timing) {
+	u8 channel;
+
+	for (channel = 0; channel < 4; channel++)
+		if ((DMA_CR(channel) & DMA_ENABLE) && ((DMA_CR(channel) & (7 << 27)) == timing)) HostDma(channel);
+}
+
+void dmaSetParams(u8 channel, const void *src, void *dest, u32 ctrl) {
+	DmaSrc[channel] = (uintptr_t)src;
+	DmaDest[channel] = DmaDestStart[channel] = (uintptr_t)dest;
+	DMA_SRC(channel) = (u32)(uintptr_t)src;
+	DMA_DEST(channel) = (u32)(uintptr_t)dest;
+	DMA_CR(channel) = ctrl;
+
+	if ((ctrl & DMA_ENABLE) && ((ctrl & (7 << 27)) == DMA_START_NOW)) HostDma(channel);
+}
+
+void dmaCopyWords(u8 channel, const void *src, void *dest, u32 size) {
+	dmaSetParams(channel, src, dest, DMA_COPY_WORDS | (size >> 2));
+}
+
+void dmaCopyHalfWords(u8 channel, const void *src, void *dest, u32 size) {
+	dmaSetParams(channel, src, dest, DMA_COPY_HALFWORDS | (size >> 1));
+}
+
+void dmaFillWords(u32 value, void *dest, u32 size) {
+	DMA_FILL(3) = value;
+	dmaSetParams(3, (const void*)&DMA_FILL(3), dest, DMA_SRC_FIX | DMA_COPY_WORDS | (size >> 2));
+}
+
+void dmaFillHalfWords(u16 value, void *dest, u32 size) {
+	DMA_FILL(3) = value;
+	dmaSetParams(3, (const void*)&DMA_FILL(3), dest, DMA_SRC_FIX | DMA_COPY_HALFWORDS | (size >> 1));
+}
+
+//////////////////////////////////////////////////////////////////////
+// Timers, moved once per frame
+//////////////////////////////////////////////////////////////////////
+
+static u16 TimerReload[4];
+static u8 TimerOn[4];
+static u32 TimerCycles[4]; // Left over by the prescaler
+
+static void HostTimers(void) {
+	u32 overflows = 0; // Of the timer before, for the cascade
+	u8 i;
+
+	for (i = 0; i < 4; i++) {
+		u16 cr = TIMER_CR(i);
+		u64 ticks, counter;
+		u32 count = 0;
+
+		if (!(cr & TIMER_ENABLE)) {
+			TimerOn[i] = 0;
+			overflows = 0;
+			continue;
+		}
+		if (!TimerOn[i]) { // Just started: what was written is the reload value
+			TimerOn[i] = 1;
+			TimerReload[i] = TIMER_DATA(i);
+		}
+
+		if ((i > 0) && (cr & TIMER_CASCADE)) {
+			ticks = overflows;
+		} else {
+			static const u8 shifts[4] = {0, 6, 8, 10};
+			TimerCycles[i] += FRAME_CYCLES;
+			ticks = TimerCycles[i] >> shifts[cr & 3];
+			TimerCycles[i] -= ticks << shifts[cr & 3];
+		}
+
+		counter = TIMER_DATA(i) + ticks;
+		while (counter > 0xFFFF) {
+			counter = counter - 0x10000 + TimerReload[i];
+			count++;
+		}
+		TIMER_DATA(i) = counter;
+
+		if (count && (cr & TIMER_IRQ_REQ)) HostIrq(IRQ_TIMER(i));
+		overflows = count;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// Frames
+//////////////////////////////////////////////////////////////////////
+
+static void HostLine(u32 line) {
+	u16 dispstat = REG_DISPSTAT, match = (dispstat >> 8) | ((dispstat & BIT(7)) << 1);
+
+	REG_VCOUNT = line;
+
+	if (line == 192) REG_DISPSTAT |= BIT(0); // VBlank
+	else if (line == LINES - 1) REG_DISPSTAT &= ~BIT(0);
+
+	if (line == match) {
+		REG_DISPSTAT |= BIT(2);
+		if (dispstat & BIT(5)) HostIrq(IRQ_VCOUNT);
+	} else {
+		REG_DISPSTAT &= ~BIT(2);
+	}
+
+	if (line < 192) {
+		HostRenderLine(0, line, HostScreen[0][line]);
+		HostRenderLine(1, line, HostScreen[1][line]);
+	}
+
+	if (line == 192) { // The VBlank interrupt is last, the program goes on from there
+		HostDmaStart(DMA_START_VBL);
+		HostTimers();
+		HostFrames++;
+		if (dispstat & BIT(3)) HostIrq(IRQ_VBLANK);
+		return;
+	}
+
+	REG_DISPSTAT |= BIT(1); // HBlank
+	if (line < 192) HostDmaStart(DMA_START_HBL);
+	if (dispstat & BIT(4)) HostIrq(IRQ_HBLANK);
+	REG_DISPSTAT &= ~BIT(1);
+}
+
+// From the line after the last VBlank to the next VBlank
+void HostFrame(void) {
+	u32 line;
+
+	HostMapVram(); // If VRAM_x_CR were written without vramSetBank
+
+	for (line = 193; line < LINES; line++) HostLine(line);
+	for (line = 0; line <= 192; line++) HostLine(line);
+}
+
+void swiWaitForVBlank(void) {
+	HostFrame();
+}
+
+void cothread_yield_irq(u32 flags) {
+	(void)flags;
+	HostFrame();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Input
+//////////////////////////////////////////////////////////////////////
+
+static u32 HostKeys, KeysNow, KeysOld;
+static s16 HostStylusX, HostStylusY;
+
+void HostSetInput(u32 keys, s16 x, s16 y) {
+	HostKeys = keys;
+	HostStylusX = x;
+	HostStylusY = y;
+}
+
+void scanKeys(void) {
+	KeysOld = KeysNow;
+	KeysNow = HostKeys;
+	REG_KEYINPUT = ~KeysNow & 0x3FF;
+}
+
+u32 keysCurrent(void) { return HostKeys; }
+u32 keysHeld(void) { return KeysNow; }
+u32 keysDown(void) { return KeysNow & ~KeysOld; }
+u32 keysDownRepeat(void) { return keysDown(); }
+u32 keysUp(void) { return KeysOld & ~KeysNow; }
+void keysSetRepeat(u8 setDelay, u8 setRepeat) { (void)setDelay; (void)setRepeat; }
+
+void touchRead(touchPosition *data) {
+	data->px = HostStylusX;
+	data->py = HostStylusY;
+	data->rawx = HostStylusX << 4;
+	data->rawy = HostStylusY << 4;
+	data->z1 = data->z2 = 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Math hardware and BIOS
+//////////////////////////////////////////////////////////////////////
+
+void HostDivide(void) {
+	u8 mode = REG_DIVCNT & 3;
+	s64 num = (mode == DIV_32_32) ? (s64)REG_DIV_NUMER_L : REG_DIV_NUMER;
+	s64 den = (mode == DIV_64_64) ? REG_DIV_DENOM : (s64)REG_DIV_DENOM_L;
+
+	if (den == 0) { // What the DS gives
+		REG_DIV_RESULT = (num < 0) ? 1 : -1;
+		REG_DIVREM_RESULT = num;
+		REG_DIVCNT = mode | BIT(14);
+		return;
+	}
+
+	if ((num == INT64_MIN) && (den == -1)) {
+		REG_DIV_RESULT = num;
+		REG_DIVREM_RESULT = 0;
+	} else {
+		REG_DIV_RESULT = num / den;
+		REG_DIVREM_RESULT = num % den;
+	}
+	REG_DIVCNT = mode;
+}
+
+void HostSqrt(void) {
+	u64 value = (REG_SQRTCNT & SQRT_64) ? REG_SQRT_PARAM : REG_SQRT_PARAM_L, root = 0, bit = (u64)1 << 62;
+
+	while (bit > value) bit >>= 2;
+	while (bit) {
+		if (value >= root + bit) {
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	REG_SQRT_RESULT = root;
+}
+
+s32 swiDivide(s32 numerator, s32 divisor) {
+	return divisor ? numerator / divisor : 0;
+}
+
+s32 swiRemainder(s32 numerator, s32 divisor) {
+	return divisor ? numerator % divisor : 0;
+}
+
+void swiDivMod(s32 numerator, s32 divisor, s32 *result, s32 *remainder) {
+	*result = swiDivide(numerator, divisor);
+	*remainder = swiRemainder(numerator, divisor);
+}
+
+u16 swiSqrt(u32 value) {
+	return sqrt32(value);
+}
+
+void swiDelay(u32 duration) {
+	(void)duration;
+}
+
+//////////////////////////////////////////////////////////////////////
+// FIFO : no ARM7 to answer
+//////////////////////////////////////////////////////////////////////
+
+bool fifoSendAddress(u32 channel, void *address) { (void)channel; (void)address; return true; }
+bool fifoSendValue32(u32 channel, u32 value32) { (void)channel; (void)value32; return true; }
+bool fifoSendDatamsg(u32 channel, u32 num_bytes, u8 *data_array) { (void)channel; (void)num_bytes; (void)data_array; return true; }
+bool fifoSetAddressHandler(u32 channel, FifoAddressHandlerFunc newhandler, void *userdata) { (void)channel; (void)newhandler; (void)userdata; return true; }
+bool fifoSetValue32Handler(u32 channel, FifoValue32HandlerFunc newhandler, void *userdata) { (void)channel; (void)newhandler; (void)userdata; return true; }
+bool fifoSetDatamsgHandler(u32 channel, FifoDatamsgHandlerFunc newhandler, void *userdata) { (void)channel; (void)newhandler; (void)userdata; return true; }
+bool fifoCheckAddress(u32 channel) { (void)channel; return false; }
+bool fifoCheckValue32(u32 channel) { (void)channel; return false; }
+bool fifoCheckDatamsg(u32 channel) { (void)channel; return false; }
+void *fifoGetAddress(u32 channel) { (void)channel; return NULL; }
+u32 fifoGetValue32(u32 channel) { (void)channel; return 0; }
+int fifoGetDatamsg(u32 channel, int buffersize, u8 *destbuffer) { (void)channel; (void)buffersize; (void)destbuffer; return -1; }
+
+//////////////////////////////////////////////////////////////////////
+// 3D commands, and the videoGL functions that send them like libnds
+//////////////////////////////////////////////////////////////////////
+
+static u32 HostGfxSize;
+
+vu32 *HostGfxPort(u32 address) {
+	if (HostGfxCount == HostGfxSize) {
+		HostGfxSize = HostGfxSize ? HostGfxSize * 2 : 1024;
+		HostGfx = (HostGfxCommand*)realloc(HostGfx, HostGfxSize * sizeof(HostGfxCommand));
+		if (HostGfx == NULL) {
+			fprintf(stderr, "Host: out of memory for the 3D commands\n");
+			exit(1);
+		}
+	}
+
+	// Written through the pointer right after, so it goes to the new entry
+	HostGfx[HostGfxCount].Port = address;
+	HostGfx[HostGfxCount].Value = 0;
+	return (vu32*)&HostGfx[HostGfxCount++].Value;
+}
+
+void HostGfxClear(void) {
+	HostGfxCount = 0;
+}
+
+void glMaterialf(int mode, rgb color) {
+	static u32 diffuse_ambient = 0, specular_emission = 0;
+
+	switch (mode) {
+	case GL_AMBIENT: diffuse_ambient = (color << 16) | (diffuse_ambient & 0xFFFF); break;
+	case GL_DIFFUSE: diffuse_ambient = color | (diffuse_ambient & 0xFFFF0000); break;
+	case GL_AMBIENT_AND_DIFFUSE: diffuse_ambient = color + (color << 16); break;
+	case GL_SPECULAR: specular_emission = color | (specular_emission & 0xFFFF0000); break;
+	case GL_SHININESS: break;
+	case GL_EMISSION: specular_emission = (color << 16) | (specular_emission & 0xFFFF); break;
+	}
+
+	GFX_DIFF_AMBIENT = diffuse_ambient;
+	GFX_SPECULAR_EMISSION = specular_emission;
+}
+
+void glResetMatrixStack(void) {
+	GFX_STATUS |= BIT(15); // Clears the stack errors
+	MATRIX_CONTROL = GL_PROJECTION;
+	MATRIX_IDENTITY = 0;
+	MATRIX_CONTROL = GL_MODELVIEW;
+	MATRIX_IDENTITY = 0;
+	MATRIX_CONTROL = GL_TEXTURE;
+	MATRIX_IDENTITY = 0;
+}
+
+void glInit(void) {
+	powerOn(POWER_3D_CORE | POWER_MATRIX);
+	GFX_STATUS = 0;
+	glResetMatrixStack();
+	GFX_CONTROL = 0;
+	GFX_CLEAR_COLOR = 0;
+	GFX_CLEAR_DEPTH = 0x7FFF;
+	GFX_TEX_FORMAT = 0;
+	GFX_POLY_FORMAT = 0;
+	glMatrixMode(GL_MODELVIEW);
+}
+
+static void Rotate(int angle, u8 axis) {
+	double radians = angle * 3.14159265358979 / 16384; // 32768 per turn
+	s32 s = (s32)lround(sin(radians) * 4096), c = (s32)lround(cos(radians) * 4096);
+	s32 m[3][9] = {
+		{4096, 0, 0, 0, c, s, 0, -s, c},
+		{c, 0, -s, 0, 4096, 0, s, 0, c},
+		{c, s, 0, -s, c, 0, 0, 0, 4096}
+	};
+	u8 i;
+
+	for (i = 0; i < 9; i++) MATRIX_MULT3x3 = m[axis][i];
+}
+
+void glRotateXi(int angle) { Rotate(angle, 0); }
+void glRotateYi(int angle) { Rotate(angle, 1); }
+void glRotateZi(int angle) { Rotate(angle, 2); }
+
+void glOrthof32(s32 left, s32 right, s32 bottom, s32 top, s32 zNear, s32 zFar) {
+	MATRIX_MULT4x4 = divf32(inttof32(2), right - left);
+	MATRIX_MULT4x4 = 0;
+	MATRIX_MULT4x4 = 0;
+	MATRIX_MULT4x4 = 0;
+
+	MATRIX_MULT4x4 = 0;
+	MATRIX_MULT4x4 = divf32(inttof32(2), top - bottom);
+	MATRIX_MULT4x4 = 0;
+	MATRIX_MULT4x4 = 0;
+
+	MATRIX_MULT4x4 = 0;
+	MATRIX_MULT4x4 = 0;
+	MATRIX_MULT4x4 = divf32(inttof32(-2), zFar - zNear);
+	MATRIX_MULT4x4 = 0;
+
+	MATRIX_MULT4x4 = -divf32(right + left, right - left);
+	MATRIX_MULT4x4 = -divf32(top + bottom, top - bottom);
+	MATRIX_MULT4x4 = -divf32(zFar + zNear, zFar - zNear);
+	MATRIX_MULT4x4 = inttof32(1);
+}
+
+static void Normalize(s32 *v) {
+	s32 length = sqrtf32(mulf32(v[0], v[0]) + mulf32(v[1], v[1]) + mulf32(v[2], v[2]));
+
+	if (length == 0) return;
+	v[0] = divf32(v[0], length);
+	v[1] = divf32(v[1], length);
+	v[2] = divf32(v[2], length);
+}
+
+static void Cross(const s32 *a, const s32 *b, s32 *result) {
+	result[0] = mulf32(a[1], b[2]) - mulf32(b[1], a[2]);
+	result[1] = mulf32(a[2], b[0]) - mulf32(b[2], a[0]);
+	result[2] = mulf32(a[0], b[1]) - mulf32(b[0], a[1]);
+}
+
+static s32 Dot(const s32 *a, const s32 *b) {
+	return mulf32(a[0], b[0]) + mulf32(a[1], b[1]) + mulf32(a[2], b[2]);
+}
+
+void gluLookAtf32(s32 eyex, s32 eyey, s32 eyez, s32 lookAtx, s32 lookAty, s32 lookAtz, s32 upx, s32 upy, s32 upz) {
+	s32 eye[3] = {eyex, eyey, eyez}, forward[3] = {eyex - lookAtx, eyey - lookAty, eyez - lookAtz};
+	s32 up[3] = {upx, upy, upz}, side[3];
+
+	Normalize(forward);
+	Cross(up, forward, side);
+	Normalize(side);
+	Cross(forward, side, up); // Square to the others
+
+	glMatrixMode(GL_MODELVIEW);
+
+	MATRIX_MULT4x3 = side[0];
+	MATRIX_MULT4x3 = up[0];
+	MATRIX_MULT4x3 = forward[0];
+	MATRIX_MULT4x3 = side[1];
+	MATRIX_MULT4x3 = up[1];
+	MATRIX_MULT4x3 = forward[1];
+	MATRIX_MULT4x3 = side[2];
+	MATRIX_MULT4x3 = up[2];
+	MATRIX_MULT4x3 = forward[2];
+	MATRIX_MULT4x3 = -Dot(eye, side);
+	MATRIX_MULT4x3 = -Dot(eye, up);
+	MATRIX_MULT4x3 = -Dot(eye, forward);
+}
+
+//////////////////////////////////////////////////////////////////////
+// PAlib's assembly, in C
+//////////////////////////////////////////////////////////////////////
+
+int PA_mulf32(int a, int b) {
+	return mulf32(a, b);
+}
+
+int PA_divf32(int a, int b) {
+	PA_Assert(b != 0, "Division by zero");
+	if (b == 0) return 0;
+	return divf32(a, b);
+}
+
+int PA_modf32(int a, int b) {
+	PA_Assert(b != 0, "Division by zero");
+	if (b == 0) return 0;
+	return mod32(a, b);
+}
+
+int PA_sqrtf32(int a) {
+	return sqrtf32((a < 0) ? -a : a);
+}
+
+bool PA_IsEmulator(void) {
+	return 1;
+}
+
+void _PA_iDeaS_OutputText(const char *text) {
+	fputs(text, stdout);
+}
+
+void _PA_iDeaS_Breakpoint(void) {
+}
+
+//////////////////////////////////////////////////////////////////////
+// Errors: printed, and an assert stops the program instead of waiting
+// forever on the screen. PA_Error.c is built with its functions renamed
+// to these PA_Host...Screen, so the screens still show them.
+//////////////////////////////////////////////////////////////////////
+
+void PA_HostErrorScreen(const char *text);
+void PA_HostAssertScreen(const char *condition, const char *message, const char *file, int linen);
+
+void PA_Error(const char *text) {
+	fprintf(stderr, "PA_Error: %s\n", text);
+	PA_HostErrorScreen(text);
+}
+
+void _PA_Assert(const char *condition, const char *message, const char *file, int linen) {
+	fprintf(stderr, "%s:%d: assertion failed: %s\n%s\n", file, linen, condition, message);
+	abort();
+}
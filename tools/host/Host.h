@@ -0,0 +1,57 @@
+// What the host backend adds to PAlib on a computer: the frames, the
+// input, the screens drawn from VRAM and the 3D commands. See ReadMe.txt.
+#ifndef _HOST_H
+#define _HOST_H
+
+#include <nds.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Runs one frame, like the DS between two VBlanks: the 263 lines with their
+// HBlank interrupts and DMAs, the 192 first ones drawn to HostScreen, then
+// the VBlank interrupt, its DMAs, the display capture and the timers.
+// swiWaitForVBlank and PA_WaitForVBL do the same.
+void HostFrame(void);
+
+// Number of frames run since the program started
+extern u32 HostFrames;
+
+// The screens after the last frame, in DS colors (bit 15 always 0):
+// [0] is the main engine (PAlib's screen 0), [1] the sub engine
+extern u16 HostScreen[2][192][256];
+
+// Draws a screen right now from the registers and VRAM, all lines alike,
+// without running a frame. image is 256x192.
+void HostRender(u8 screen, u16 *image);
+
+// Draws one line of a screen, the way HostFrame does
+void HostRenderLine(u8 screen, s32 line, u16 *pixels);
+
+// Writes DS colors to a PNG file, returns 0 if it can't
+u8 HostWritePNG(const char *name, const u16 *image, s32 width, s32 height);
+
+// Writes both screens of the last frame, the top one above the bottom one
+u8 HostWriteScreens(const char *name);
+
+// The keys held (KEY_A...) and, with KEY_TOUCH, where the stylus is. They
+// stay until changed, scanKeys reads them at the next frame.
+void HostSetInput(u32 keys, s16 x, s16 y);
+
+// Each write to a geometry command register (GFX_VERTEX16, MATRIX_PUSH...)
+// since the last HostGfxClear, in order
+typedef struct {
+	u32 Port;  // Address of the register, like 0x0400048C for GFX_VERTEX16
+	u32 Value;
+} HostGfxCommand;
+
+extern HostGfxCommand *HostGfx;
+extern u32 HostGfxCount;
+void HostGfxClear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
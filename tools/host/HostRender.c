@@ -0,0 +1,631 @@
+// Draws the screens the way the DS would, from the registers, palettes,
+// VRAM and OAM that PAlib wrote, one line at a time, and writes them to PNG
+// files. Text, rotating, extended and bitmap backgrounds, sprites of every
+// kind, extended palettes, windows, blending, master brightness and the
+// display capture. Not done: the 3D layer (BG0 in 3D mode stays empty),
+// mosaic and the main memory display.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Host.h"
+
+#define IO16(screen, offset) (*(vu16*)(0x04000000 + ((screen) << 12) + (offset)))
+#define IO32(screen, offset) (*(vu32*)(0x04000000 + ((screen) << 12) + (offset)))
+
+#define LAYER_OBJ      4
+#define LAYER_BACKDROP 5
+
+#define OPAQUE 0x8000 // In the line buffers, the pixel is drawn
+
+// VRAM of each engine, with the size it is read within
+#define BG_VRAM(screen)  ((const u8*)((screen) ? 0x06200000 : 0x06000000))
+#define BG_MASK(screen)  ((screen) ? 0x1FFFF : 0x7FFFF)
+#define OBJ_VRAM(screen) ((const u8*)((screen) ? 0x06600000 : 0x06400000))
+#define OBJ_MASK(screen) ((screen) ? 0x1FFFF : 0x3FFFF)
+#define BG_PAL(screen)   ((const u16*)((screen) ? 0x05000400 : 0x05000000))
+#define OBJ_PAL(screen)  ((const u16*)((screen) ? 0x05000600 : 0x05000200))
+#define OAM_OF(screen)   ((const u16*)((screen) ? 0x07000400 : 0x07000000))
+
+// Banks at their LCD address, the memory the extended palettes are read from
+#define BANK(n) ((u16*)(0x06800000 + (n) * 0x20000))
+#define BANK_E ((u16*)0x06880000)
+#define BANK_F ((u16*)0x06890000)
+#define BANK_G ((u16*)0x06894000)
+#define BANK_H ((u16*)0x06898000)
+#define BANK_I ((u16*)0x068A0000)
+
+static const u8 SpriteSizes[3][4][2] = { // [shape][size] = width, height
+	{{8, 8}, {16, 16}, {32, 32}, {64, 64}},
+	{{16, 8}, {32, 8}, {32, 16}, {64, 32}},
+	{{8, 16}, {8, 32}, {16, 32}, {32, 64}}
+};
+
+// Internal reference points of the rotating BG2 and BG3, set at line 0 and
+// moved by PB and PD after each line, or set again when the register changes
+static s32 RefX[2][2], RefY[2][2], LastX[2][2], LastY[2][2];
+
+static u8 Capturing;
+static u32 CaptureCnt;
+
+// The 16 extended palettes of a BG slot or of the sprites, NULL if no bank has them
+static const u16 *ExtPalette(u8 screen, u8 obj, u8 slot) {
+	u8 e = VRAM_E_CR, f = VRAM_F_CR, g = VRAM_G_CR;
+
+	if (screen) {
+		if (obj) return ((VRAM_I_CR & 0x87) == (VRAM_ENABLE | 3)) ? BANK_I : NULL;
+		return ((VRAM_H_CR & 0x87) == (VRAM_ENABLE | 2)) ? BANK_H + slot * 4096 : NULL;
+	}
+
+	if (obj) {
+		if ((f & 0x87) == (VRAM_ENABLE | 5)) return BANK_F;
+		if ((g & 0x87) == (VRAM_ENABLE | 5)) return BANK_G;
+		return NULL;
+	}
+
+	if ((e & 0x87) == (VRAM_ENABLE | 4)) return BANK_E + slot * 4096;
+	if (((f & 0x87) == (VRAM_ENABLE | 4)) && (((f >> 3) & 1) == (slot >> 1))) return BANK_F + (slot & 1) * 4096;
+	if (((g & 0x87) == (VRAM_ENABLE | 4)) && (((g >> 3) & 1) == (slot >> 1))) return BANK_G + (slot & 1) * 4096;
+	return NULL;
+}
+
+static inline s32 Ref28(u32 value) { // 20.8 fixed point in 28 bits
+	return ((s32)(value << 4)) >> 4;
+}
+
+static void TextLine(u8 screen, u8 bg, s32 y, u16 *out) {
+	u32 dispcnt = IO32(screen, 0), cnt = IO16(screen, 8 + 2 * bg);
+	u32 hofs = IO16(screen, 0x10 + 4 * bg) & 511, vofs = IO16(screen, 0x12 + 4 * bg) & 511;
+	u32 charbase = ((cnt >> 2) & 15) * 0x4000, mapbase = ((cnt >> 8) & 31) * 0x800, mask = BG_MASK(screen);
+	u8 wide = (cnt >> 14) & 1, tall = (cnt >> 15) & 1, colors256 = (cnt & BG_COLOR_256) != 0;
+	const u8 *vram = BG_VRAM(screen);
+	const u16 *pal = BG_PAL(screen), *ext = NULL;
+	u32 ty, x;
+
+	if (screen == 0) {
+		charbase += ((dispcnt >> 24) & 7) * 0x10000;
+		mapbase += ((dispcnt >> 27) & 7) * 0x10000;
+	}
+	if (colors256 && (dispcnt & DISPLAY_BG_EXT_PALETTE)) {
+		ext = ExtPalette(screen, 0, ((bg < 2) && (cnt & BIT(13))) ? bg + 2 : bg);
+		if (ext == NULL) return; // No bank for them, black on the DS
+	}
+
+	ty = (y + vofs) & (tall ? 511 : 255);
+
+	for (x = 0; x < 256; x++) {
+		u32 tx = (x + hofs) & (wide ? 511 : 255);
+		u32 block = (tx >> 8) + ((ty >> 8) ? (wide ? 2 : 1) : 0);
+		u32 entry = *(const u16*)(vram + ((mapbase + block * 0x800 + (((ty >> 3) & 31) * 32 + ((tx >> 3) & 31)) * 2) & mask));
+		u32 tile = entry & 0x3FF, px = tx & 7, py = ty & 7, index;
+
+		if (entry & BIT(10)) px = 7 - px;
+		if (entry & BIT(11)) py = 7 - py;
+
+		if (colors256) {
+			index = vram[(charbase + tile * 64 + py * 8 + px) & mask];
+			if (index) out[x] = (ext ? ext[((entry >> 12) << 8) + index] : pal[index]) | OPAQUE;
+		} else {
+			index = vram[(charbase + tile * 32 + py * 4 + (px >> 1)) & mask];
+			index = (px & 1) ? (index >> 4) : (index & 15);
+			if (index) out[x] = pal[((entry >> 12) << 4) + index] | OPAQUE;
+		}
+	}
+}
+
+// Rotating (kind 0), extended rotating (1), 8 bit bitmap (2), 16 bit bitmap (3) and large bitmap (4) backgrounds
+static void AffineLine(u8 screen, u8 bg, u8 kind, u16 *out) {
+	u32 dispcnt = IO32(screen, 0), cnt = IO16(screen, 8 + 2 * bg), mask = BG_MASK(screen);
+	u32 charbase = ((cnt >> 2) & 15) * 0x4000, mapbase = ((cnt >> 8) & 31) * 0x800;
+	s32 pa = (s16)IO16(screen, 0x20 + 16 * (bg - 2)), pc = (s16)IO16(screen, 0x24 + 16 * (bg - 2));
+	s32 refx = RefX[screen][bg - 2], refy = RefY[screen][bg - 2];
+	s32 width, height, x;
+	u8 wrap = (cnt & BIT(13)) != 0, size = cnt >> 14;
+	const u8 *vram = BG_VRAM(screen);
+	const u16 *pal = BG_PAL(screen), *ext = NULL;
+
+	if (kind <= 1) {
+		width = height = 128 << size;
+		if (screen == 0) {
+			charbase += ((dispcnt >> 24) & 7) * 0x10000;
+			mapbase += ((dispcnt >> 27) & 7) * 0x10000;
+		}
+		if ((kind == 1) && (dispcnt & DISPLAY_BG_EXT_PALETTE)) {
+			ext = ExtPalette(screen, 0, bg);
+			if (ext == NULL) return;
+		}
+	} else if (kind == 4) {
+		width = size ? 1024 : 512;
+		height = size ? 512 : 1024;
+		mapbase = 0;
+		wrap = 0;
+	} else {
+		static const s16 bitmaps[4][2] = {{128, 128}, {256, 256}, {512, 256}, {512, 512}};
+		width = bitmaps[size][0];
+		height = bitmaps[size][1];
+		mapbase = ((cnt >> 8) & 31) * 0x4000;
+	}
+
+	for (x = 0; x < 256; x++) {
+		s32 tx = (refx + pa * x) >> 8, ty = (refy + pc * x) >> 8;
+		u32 index, entry, px, py;
+
+		if (wrap) {
+			tx &= width - 1;
+			ty &= height - 1;
+		} else if ((tx < 0) || (ty < 0) || (tx >= width) || (ty >= height)) {
+			continue;
+		}
+
+		switch (kind) {
+		case 0: // 8 bit map, 256 color tiles
+			index = vram[(mapbase + (ty >> 3) * (width >> 3) + (tx >> 3)) & mask];
+			index = vram[(charbase + index * 64 + (ty & 7) * 8 + (tx & 7)) & mask];
+			if (index) out[x] = pal[index] | OPAQUE;
+			break;
+		case 1: // 16 bit map like the text backgrounds
+			entry = *(const u16*)(vram + ((mapbase + ((ty >> 3) * (width >> 3) + (tx >> 3)) * 2) & mask));
+			px = (entry & BIT(10)) ? 7 - (tx & 7) : (tx & 7);
+			py = (entry & BIT(11)) ? 7 - (ty & 7) : (ty & 7);
+			index = vram[(charbase + (entry & 0x3FF) * 64 + py * 8 + px) & mask];
+			if (index) out[x] = (ext ? ext[((entry >> 12) << 8) + index] : pal[index]) | OPAQUE;
+			break;
+		case 2:
+		case 4:
+			index = vram[(mapbase + ty * width + tx) & mask];
+			if (index) out[x] = pal[index] | OPAQUE;
+			break;
+		default:
+			entry = *(const u16*)(vram + ((mapbase + (ty * width + tx) * 2) & mask));
+			if (entry & 0x8000) out[x] = entry;
+			break;
+		}
+	}
+}
+
+// What kind of background each BG is in each mode : 0 text, 1 rotating, 2 extended, 3 large, 4 none
+static const u8 BgKinds[8][4] = {
+	{0, 0, 0, 0}, {0, 0, 0, 1}, {0, 0, 1, 1}, {0, 0, 0, 2},
+	{0, 0, 1, 2}, {0, 0, 2, 2}, {4, 4, 3, 4}, {4, 4, 4, 4}
+};
+
+static void BgLine(u8 screen, u8 bg, s32 y, u16 *out) {
+	u32 dispcnt = IO32(screen, 0), cnt = IO16(screen, 8 + 2 * bg);
+	u8 kind = BgKinds[dispcnt & 7][bg];
+
+	if ((bg == 0) && (screen == 0) && (dispcnt & ENABLE_3D)) return; // 3D, not drawn here
+	if ((kind == 3) && screen) return;
+
+	switch (kind) {
+	case 0: TextLine(screen, bg, y, out); break;
+	case 1: AffineLine(screen, bg, 0, out); break;
+	case 2: AffineLine(screen, bg, !(cnt & BG_COLOR_256) ? 1 : ((cnt & BIT(2)) ? 3 : 2), out); break;
+	case 3: AffineLine(screen, bg, 4, out); break;
+	}
+}
+
+// Sprites of a line : colors, their priority, semi-transparency (alpha + 1,
+// 0 if opaque) and the sprite window. The lowest priority value is on top,
+// then the lowest sprite number.
+static void SpriteLine(u8 screen, s32 y, u16 *out, u8 *prios, u8 *alphas, u8 *window) {
+	u32 dispcnt = IO32(screen, 0);
+	const u16 *oam = OAM_OF(screen), *pal = OBJ_PAL(screen);
+	const u16 *ext = (dispcnt & DISPLAY_SPR_EXT_PALETTE) ? ExtPalette(screen, 1, 0) : NULL;
+	const u8 *vram = OBJ_VRAM(screen);
+	u32 mask = OBJ_MASK(screen);
+	s32 i;
+
+	for (i = 127; i >= 0; i--) {
+		u16 atr0 = oam[i << 2], atr1 = oam[(i << 2) + 1], atr2 = oam[(i << 2) + 2];
+		u8 rot = (atr0 & BIT(8)) != 0, dbl = (atr0 & BIT(9)) != 0, mode = (atr0 >> 10) & 3;
+		u8 prio = (atr2 >> 10) & 3, shape = atr0 >> 14, colors256 = (atr0 & BIT(13)) != 0;
+		s16 pa = 256, pb = 0, pc = 0, pd = 256;
+		s32 x, w, h, bw, bh, sy, sx;
+		u32 tile = atr2 & 0x3FF, base;
+
+		if (!rot && dbl) continue; // Hidden
+		if (shape == 3) continue;
+
+		w = SpriteSizes[shape][atr1 >> 14][0];
+		h = SpriteSizes[shape][atr1 >> 14][1];
+		bw = (rot && dbl) ? 2 * w : w;
+		bh = (rot && dbl) ? 2 * h : h;
+
+		sy = (y - (atr0 & 255)) & 255;
+		if (sy >= bh) continue;
+
+		x = atr1 & 511;
+		if (x >= 256) x -= 512;
+
+		if (rot) {
+			u8 rotset = (atr1 >> 9) & 31;
+			pa = oam[(rotset << 4) + 3];
+			pb = oam[(rotset << 4) + 7];
+			pc = oam[(rotset << 4) + 11];
+			pd = oam[(rotset << 4) + 15];
+		}
+
+		if (mode == 3) { // 16 bit
+			if (dispcnt & BIT(6)) base = tile * (128 << ((dispcnt >> 22) & 1));
+			else if (dispcnt & BIT(5)) base = (tile & 0x1F) * 0x10 + (tile & ~0x1F) * 0x80;
+			else base = (tile & 0x0F) * 0x10 + (tile & ~0x0F) * 0x80;
+		} else if (dispcnt & DISPLAY_SPR_1D) {
+			base = tile * (32 << ((dispcnt >> 20) & 3));
+		} else {
+			base = tile * 32;
+		}
+
+		for (sx = 0; sx < bw; sx++) {
+			s32 px = x + sx, tx, ty;
+			u32 color = 0, index;
+
+			if ((px < 0) || (px >= 256) || ((mode != 2) && (prio > prios[px]))) continue;
+
+			if (rot) { // From the center of the box
+				s32 dx = sx - (bw >> 1), dy = sy - (bh >> 1);
+				tx = ((pa * dx + pb * dy) >> 8) + (w >> 1);
+				ty = ((pc * dx + pd * dy) >> 8) + (h >> 1);
+				if ((tx < 0) || (tx >= w) || (ty < 0) || (ty >= h)) continue;
+			} else {
+				tx = (atr1 & BIT(12)) ? w - 1 - sx : sx;
+				ty = (atr1 & BIT(13)) ? h - 1 - sy : sy;
+			}
+
+			if (mode == 3) {
+				u32 stride = (dispcnt & BIT(6)) ? w * 2 : ((dispcnt & BIT(5)) ? 512 : 256);
+				color = *(const u16*)(vram + ((base + ty * stride + tx * 2) & mask));
+				if (!(color & 0x8000) || !(atr2 >> 12)) continue;
+			} else {
+				u32 offset;
+
+				if (dispcnt & DISPLAY_SPR_1D) offset = ((ty >> 3) * (w >> 3) + (tx >> 3)) << (colors256 ? 6 : 5);
+				else offset = ((ty >> 3) * 32 + (tx >> 3) * (colors256 ? 2 : 1)) << 5;
+
+				if (colors256) {
+					index = vram[(base + offset + (ty & 7) * 8 + (tx & 7)) & mask];
+					if (index == 0) continue;
+					color = ext ? ext[((atr2 >> 12) << 8) + index] : pal[index];
+				} else {
+					index = vram[(base + offset + (ty & 7) * 4 + ((tx & 7) >> 1)) & mask];
+					index = (tx & 1) ? (index >> 4) : (index & 15);
+					if (index == 0) continue;
+					color = pal[((atr2 >> 12) << 4) + index];
+				}
+			}
+
+			if (mode == 2) {
+				window[px] = 1;
+				continue;
+			}
+
+			out[px] = color | OPAQUE;
+			prios[px] = prio;
+			alphas[px] = (mode == 1) ? 16 : ((mode == 3) ? (atr2 >> 12) + 1 : 0);
+		}
+	}
+}
+
+static inline u16 Blend(u16 a, u16 b, u32 eva, u32 evb) {
+	u32 r = ((a & 31) * eva + (b & 31) * evb) >> 4;
+	u32 g = (((a >> 5) & 31) * eva + ((b >> 5) & 31) * evb) >> 4;
+	u32 bl = (((a >> 10) & 31) * eva + ((b >> 10) & 31) * evb) >> 4;
+
+	if (r > 31) r = 31;
+	if (g > 31) g = 31;
+	if (bl > 31) bl = 31;
+	return r | (g << 5) | (bl << 10);
+}
+
+static inline u16 Brighten(u16 c, u32 factor, u8 up) {
+	u32 r = c & 31, g = (c >> 5) & 31, b = (c >> 10) & 31;
+
+	if (factor > 16) factor = 16;
+	if (up) {
+		r += ((31 - r) * factor) >> 4;
+		g += ((31 - g) * factor) >> 4;
+		b += ((31 - b) * factor) >> 4;
+	} else {
+		r -= (r * factor) >> 4;
+		g -= (g * factor) >> 4;
+		b -= (b * factor) >> 4;
+	}
+	return r | (g << 5) | (b << 10);
+}
+
+// Which layers (bits 0-4) and the effects (bit 5) show at each pixel
+static void WindowLine(u8 screen, s32 y, const u8 *objwindow, u8 *enable) {
+	u32 dispcnt = IO32(screen, 0);
+	u16 winin = IO16(screen, 0x48), winout = IO16(screen, 0x4A);
+	s32 w, x;
+
+	if (!(dispcnt & (DISPLAY_WIN0_ON | DISPLAY_WIN1_ON | DISPLAY_SPR_WIN_ON))) {
+		memset(enable, 0x3F, 256);
+		return;
+	}
+
+	memset(enable, winout & 0x3F, 256);
+
+	if (dispcnt & DISPLAY_SPR_WIN_ON)
+		for (x = 0; x < 256; x++)
+			if (objwindow[x]) enable[x] = (winout >> 8) & 0x3F;
+
+	for (w = 1; w >= 0; w--) { // Window 0 is above window 1
+		u16 h = IO16(screen, 0x40 + 2 * w), v = IO16(screen, 0x44 + 2 * w);
+		s32 x1 = h >> 8, x2 = h & 255, y1 = v >> 8, y2 = v & 255;
+		u8 iny = (y1 <= y2) ? ((y >= y1) && (y < y2)) : ((y >= y1) || (y < y2));
+
+		if (!(dispcnt & (DISPLAY_WIN0_ON << w)) || !iny) continue;
+
+		for (x = 0; x < 256; x++)
+			if ((x1 <= x2) ? ((x >= x1) && (x < x2)) : ((x >= x1) || (x < x2)))
+				enable[x] = (winin >> (8 * w)) & 0x3F;
+	}
+}
+
+// The line before the master brightness
+static void ComposeLine(u8 screen, s32 y, u16 *pixels) {
+	u32 dispcnt = IO32(screen, 0);
+	u16 bgs[4][256], objs[256];
+	u8 prios[256], alphas[256], objwindow[256], enable[256];
+	u16 bldcnt = IO16(screen, 0x50), bldalpha = IO16(screen, 0x52);
+	u32 eva = bldalpha & 31, evb = (bldalpha >> 8) & 31, evy = IO16(screen, 0x54) & 31;
+	u8 effect = (bldcnt >> 6) & 3;
+	u16 backdrop = BG_PAL(screen)[0] & 0x7FFF;
+	u8 order[4], orderprio[4], count = 0, p;
+	s32 bg, x;
+
+	if (y == 0) { // The reference points of the rotating backgrounds are read at the start of the frame
+		for (bg = 0; bg < 2; bg++) {
+			LastX[screen][bg] = IO32(screen, 0x28 + 16 * bg);
+			LastY[screen][bg] = IO32(screen, 0x2C + 16 * bg);
+			RefX[screen][bg] = Ref28(LastX[screen][bg]);
+			RefY[screen][bg] = Ref28(LastY[screen][bg]);
+		}
+	} else {
+		for (bg = 0; bg < 2; bg++) { // Written since the last line : start from there
+			if ((s32)IO32(screen, 0x28 + 16 * bg) != LastX[screen][bg]) RefX[screen][bg] = Ref28(LastX[screen][bg] = IO32(screen, 0x28 + 16 * bg));
+			if ((s32)IO32(screen, 0x2C + 16 * bg) != LastY[screen][bg]) RefY[screen][bg] = Ref28(LastY[screen][bg] = IO32(screen, 0x2C + 16 * bg));
+		}
+	}
+
+	switch ((dispcnt >> 16) & 3) {
+	case 1:
+		break;
+	case 2: // A bank shown as it is, main screen only
+		if (screen == 0) {
+			const u16 *bank = BANK((dispcnt >> 18) & 3) + y * 256;
+			for (x = 0; x < 256; x++) pixels[x] = bank[x] & 0x7FFF;
+			goto Done;
+		}
+		// Fall through
+	default: // Display off, or the main memory FIFO not done here
+		for (x = 0; x < 256; x++) pixels[x] = 0x7FFF;
+		goto Done;
+	}
+
+	if (dispcnt & DISPLAY_SCREEN_OFF) {
+		for (x = 0; x < 256; x++) pixels[x] = 0x7FFF;
+		goto Done;
+	}
+
+	memset(objs, 0, sizeof(objs));
+	memset(prios, 4, sizeof(prios));
+	memset(alphas, 0, sizeof(alphas));
+	memset(objwindow, 0, sizeof(objwindow));
+
+	// The backgrounds shown, from the one on top: by priority, then by number
+	for (p = 0; p < 4; p++) {
+		for (bg = 0; bg < 4; bg++) {
+			if (!(dispcnt & (DISPLAY_BG0_ACTIVE << bg)) || ((IO16(screen, 8 + 2 * bg) & 3) != p)) continue;
+			memset(bgs[bg], 0, sizeof(bgs[bg]));
+			BgLine(screen, bg, y, bgs[bg]);
+			order[count] = bg;
+			orderprio[count++] = p;
+		}
+	}
+	if (dispcnt & DISPLAY_SPR_ACTIVE) SpriteLine(screen, y, objs, prios, alphas, objwindow);
+
+	WindowLine(screen, y, objwindow, enable);
+
+	for (x = 0; x < 256; x++) {
+		u16 color[2] = {backdrop, backdrop};
+		u8 layer[2] = {LAYER_BACKDROP, LAYER_BACKDROP}, found = 0, i;
+		u8 obj = (objs[x] & OPAQUE) && (enable[x] & BIT(LAYER_OBJ)); // Still to place
+
+		// The two layers on top : sprites before the backgrounds of the same priority
+		for (i = 0; (i < count) && (found < 2); i++) {
+			bg = order[i];
+			if (obj && (prios[x] <= orderprio[i])) {
+				color[found] = objs[x] & 0x7FFF;
+				layer[found++] = LAYER_OBJ;
+				obj = 0;
+				if (found == 2) break;
+			}
+			if ((bgs[bg][x] & OPAQUE) && (enable[x] & BIT(bg))) {
+				color[found] = bgs[bg][x] & 0x7FFF;
+				layer[found++] = bg;
+			}
+		}
+		if (obj && (found < 2)) {
+			color[found] = objs[x] & 0x7FFF;
+			layer[found++] = LAYER_OBJ;
+		}
+
+		pixels[x] = color[0];
+
+		if ((layer[0] == LAYER_OBJ) && alphas[x]) { // Semi-transparent sprites blend over any second target
+			if (bldcnt & (BIT(8) << layer[1])) {
+				u32 a = (alphas[x] == 16) ? eva : alphas[x];
+				pixels[x] = Blend(color[0], color[1], a, (alphas[x] == 16) ? evb : 16 - a);
+				continue;
+			}
+		}
+
+		if (!effect || !(enable[x] & BIT(5)) || !(bldcnt & BIT(layer[0]))) continue;
+
+		if ((effect == 1) && (bldcnt & (BIT(8) << layer[1]))) pixels[x] = Blend(color[0], color[1], eva, evb);
+		else if (effect >= 2) pixels[x] = Brighten(color[0], evy, effect == 2);
+	}
+
+Done:
+	for (bg = 0; bg < 2; bg++) { // Next line
+		RefX[screen][bg] += (s16)IO16(screen, 0x22 + 16 * bg);
+		RefY[screen][bg] += (s16)IO16(screen, 0x26 + 16 * bg);
+	}
+}
+
+static void MasterBrightness(u8 screen, u16 *pixels) {
+	u16 bright = IO16(screen, 0x6C);
+	u8 mode = bright >> 14;
+	s32 x;
+
+	if (((mode == 1) || (mode == 2)) && (bright & 31))
+		for (x = 0; x < 256; x++) pixels[x] = Brighten(pixels[x], bright & 31, mode == 1);
+}
+
+// The main screen, the VRAM or both blended, to a bank in LCD mode
+static void CaptureLine(s32 y, const u16 *pixels) {
+	static const s16 sizes[4][2] = {{128, 128}, {256, 64}, {256, 128}, {256, 192}};
+	u32 cnt = CaptureCnt, dispcnt = REG_DISPCNT;
+	s32 w = sizes[(cnt >> 20) & 3][0], h = sizes[(cnt >> 20) & 3][1], x;
+	u16 *dest = BANK((cnt >> 16) & 3);
+	const u16 *vram = BANK((dispcnt >> 18) & 3);
+	u32 write = ((cnt >> 18) & 3) * 0x4000 + y * w, read = ((cnt >> 26) & 3) * 0x4000 + y * 256;
+	u32 eva = cnt & 31, evb = (cnt >> 8) & 31;
+
+	if (y >= h) return;
+
+	for (x = 0; x < w; x++) {
+		u16 a = (cnt & BIT(24)) ? 0 : pixels[x], b = vram[(read + x) & 0xFFFF];
+
+		switch ((cnt >> 29) & 3) {
+		case 0: dest[(write + x) & 0xFFFF] = a | 0x8000; break;
+		case 1: dest[(write + x) & 0xFFFF] = b; break;
+		default: dest[(write + x) & 0xFFFF] = Blend(a, b & 0x7FFF, eva > 16 ? 16 : eva, evb > 16 ? 16 : evb) | 0x8000; break;
+		}
+	}
+
+	if (y == h - 1) { // Done, the DS clears the enable bit
+		REG_DISPCAPCNT &= ~BIT(31);
+		Capturing = 0;
+	}
+}
+
+void HostRenderLine(u8 screen, s32 line, u16 *pixels) {
+	ComposeLine(screen, line, pixels);
+
+	if (screen == 0) {
+		if ((line == 0) && (REG_DISPCAPCNT & BIT(31))) {
+			Capturing = 1;
+			CaptureCnt = REG_DISPCAPCNT;
+		}
+		if (Capturing) CaptureLine(line, pixels);
+	}
+
+	MasterBrightness(screen, pixels);
+}
+
+void HostRender(u8 screen, u16 *image) {
+	s32 y;
+
+	for (y = 0; y < 192; y++) {
+		ComposeLine(screen, y, image + y * 256);
+		MasterBrightness(screen, image + y * 256);
+	}
+}
+
+static u32 Crc(u32 crc, const u8 *data, u32 size) {
+	u32 i, j;
+
+	crc = ~crc;
+	for (i = 0; i < size; i++) {
+		crc ^= data[i];
+		for (j = 0; j < 8; j++) crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+	}
+	return ~crc;
+}
+
+static void Put32(u8 *p, u32 value) {
+	p[0] = value >> 24; p[1] = value >> 16; p[2] = value >> 8; p[3] = value;
+}
+
+static void Chunk(FILE *file, const char *type, const u8 *data, u32 size) {
+	u8 head[8], crc[4];
+
+	Put32(head, size);
+	memcpy(head + 4, type, 4);
+	Put32(crc, Crc(Crc(0, head + 4, 4), data, size));
+	fwrite(head, 1, 8, file);
+	if (size) fwrite(data, 1, size, file);
+	fwrite(crc, 1, 4, file);
+}
+
+// Uncompressed deflate blocks, so it needs no zlib
+u8 HostWritePNG(const char *name, const u16 *image, s32 width, s32 height) {
+	u32 row = 1 + 3 * width, size = row * height, blocks = (size + 65534) / 65535;
+	u8 *raw = (u8*)malloc(size), *zlib = (u8*)malloc(size + 5 * blocks + 6);
+	u8 header[13] = {0, 0, 0, 0, 0, 0, 0, 0, 8, 2, 0, 0, 0}; // 8 bit RGB
+	u32 a = 1, b = 0, i, n = 0;
+	s32 x, y;
+	FILE *file;
+
+	if ((raw == NULL) || (zlib == NULL)) { free(raw); free(zlib); return 0; }
+
+	for (y = 0; y < height; y++) {
+		u8 *p = raw + y * row;
+		*p++ = 0; // No filter
+		for (x = 0; x < width; x++) {
+			u16 color = image[y * width + x];
+			*p++ = ((color & 31) * 255) / 31;
+			*p++ = (((color >> 5) & 31) * 255) / 31;
+			*p++ = (((color >> 10) & 31) * 255) / 31;
+		}
+	}
+
+	zlib[n++] = 0x78;
+	zlib[n++] = 0x01;
+	for (i = 0; i < size; i += 65535) {
+		u32 len = (size - i > 65535) ? 65535 : size - i;
+		zlib[n++] = (i + len == size); // Last block
+		zlib[n++] = len; zlib[n++] = len >> 8;
+		zlib[n++] = ~len; zlib[n++] = ~len >> 8;
+		memcpy(zlib + n, raw + i, len);
+		n += len;
+	}
+	for (i = 0; i < size; i++) {
+		a = (a + raw[i]) % 65521;
+		b = (b + a) % 65521;
+	}
+	Put32(zlib + n, (b << 16) | a);
+	n += 4;
+
+	Put32(header, width);
+	Put32(header + 4, height);
+
+	file = fopen(name, "wb");
+	if (file) {
+		fwrite("\x89PNG\r\n\x1a\n", 1, 8, file);
+		Chunk(file, "IHDR", header, 13);
+		Chunk(file, "IDAT", zlib, n);
+		Chunk(file, "IEND", NULL, 0);
+		fclose(file);
+	}
+
+	free(raw);
+	free(zlib);
+	return file != NULL;
+}
+
+u8 HostWriteScreens(const char *name) {
+	u16 *image = (u16*)malloc(256 * 384 * 2);
+	u8 top = (REG_POWERCNT & POWER_SWAP_LCDS) ? 0 : 1, ok;
+
+	if (image == NULL) return 0;
+
+	memcpy(image, HostScreen[top], 256 * 192 * 2);
+	memcpy(image + 256 * 192, HostScreen[!top], 256 * 192 * 2);
+	ok = HostWritePNG(name, image, 256, 384);
+	free(image);
+
+	return ok;
+}
@@ -0,0 +1,8 @@
+// PA9.h on a computer: all of PAlib, with the host backend of Host.h
+#ifndef _HOST_PA9
+#define _HOST_PA9
+
+#include "../../include/PA9.h"
+#include "Host.h"
+
+#endif
@@ -0,0 +1,32 @@
+// DSWifi on a computer : the wifi never connects. The sockets are the ones
+// of the computer.
+#ifndef _HOST_DSWIFI9
+#define _HOST_DSWIFI9
+
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+enum WIFI_ASSOCSTATUS {
+	ASSOCSTATUS_DISCONNECTED,
+	ASSOCSTATUS_SEARCHING,
+	ASSOCSTATUS_AUTHENTICATING,
+	ASSOCSTATUS_ASSOCIATING,
+	ASSOCSTATUS_ACQUIRINGDHCP,
+	ASSOCSTATUS_ASSOCIATED,
+	ASSOCSTATUS_CANNOTCONNECT
+};
+
+#define INIT_ONLY   false
+#define WFC_CONNECT true
+
+static inline bool Wifi_InitDefault(bool useFirmwareSettings) { (void)useFirmwareSettings; return false; }
+static inline void Wifi_AutoConnect(void) { }
+static inline int Wifi_AssocStatus(void) { return ASSOCSTATUS_CANNOTCONNECT; }
+static inline int Wifi_DisconnectAP(void) { return 0; }
+static inline void Wifi_DisableWifi(void) { }
+static inline void Wifi_EnableWifi(void) { }
+
+#define closesocket(s) close(s)
+
+#endif
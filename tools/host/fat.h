@@ -0,0 +1,10 @@
+// libfat on a computer : the files are the ones of the computer, already there
+#ifndef _HOST_FAT
+#define _HOST_FAT
+
+#include <stdbool.h>
+
+static inline bool fatInitDefault(void) { return true; }
+static inline bool fatInit(unsigned int cacheSize, bool setAsDefaultDevice) { (void)cacheSize; (void)setAsDefaultDevice; return true; }
+
+#endif
@@ -0,0 +1,9 @@
+// NitroFS on a computer : there is no ROM, so nothing to open
+#ifndef _HOST_FILESYSTEM
+#define _HOST_FILESYSTEM
+
+#include <stdbool.h>
+
+static inline bool nitroFSInit(const char *basepath) { (void)basepath; return false; }
+
+#endif
@@ -0,0 +1,1029 @@
+// The part of libnds that PAlib uses, for building PAlib on a computer.
+//
+// Registers, palettes, VRAM and OAM are at the same addresses as on the DS:
+// Host.c maps that memory when the program starts. The defines have the
+// values of libnds, so what PAlib writes there is what the DS would get.
+// The functions that would talk to the hardware are in Host.c.
+#ifndef _HOST_NDS
+#define _HOST_NDS
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <alloca.h> // In stdlib.h with newlib
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//////////////////////////////////////////////////////////////////////
+// Types
+//////////////////////////////////////////////////////////////////////
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef int64_t s64;
+
+typedef volatile u8 vu8;
+typedef volatile u16 vu16;
+typedef volatile u32 vu32;
+typedef volatile u64 vu64;
+typedef volatile s8 vs8;
+typedef volatile s16 vs16;
+typedef volatile s32 vs32;
+typedef volatile s64 vs64;
+
+typedef u8 uint8;
+typedef u16 uint16;
+typedef u32 uint32;
+typedef u64 uint64;
+typedef s8 int8;
+typedef s16 int16;
+typedef s32 int32;
+typedef s64 int64;
+typedef vu8 vuint8;
+typedef vu16 vuint16;
+typedef vu32 vuint32;
+
+typedef void (*VoidFn)(void);
+
+#define BIT(n) (1 << (n))
+#define ALIGN(m) __attribute__((aligned(m)))
+#define ITCM_CODE
+#define ITCM_DATA
+#define DTCM_DATA
+#define DTCM_BSS
+#define ARM_CODE
+#define THUMB_CODE
+
+#define BUS_CLOCK 33513982
+#define CACHE_LINE_SIZE 32
+
+//////////////////////////////////////////////////////////////////////
+// Video
+//////////////////////////////////////////////////////////////////////
+
+#define REG_DISPCNT         (*(vu32*)0x04000000)
+#define REG_DISPCNT_SUB     (*(vu32*)0x04001000)
+#define REG_DISPSTAT        (*(vu16*)0x04000004)
+#define REG_VCOUNT          (*(vu16*)0x04000006)
+#define REG_DISPCAPCNT      (*(vu32*)0x04000064)
+#define REG_MASTER_BRIGHT   (*(vu16*)0x0400006C)
+#define REG_MASTER_BRIGHT_SUB (*(vu16*)0x0400106C)
+#define REG_EXMEMCNT        (*(vu16*)0x04000204)
+#define REG_POWERCNT        (*(vu16*)0x04000304)
+
+#define DISP_IN_VBLANK   BIT(0)
+#define DISP_IN_HBLANK   BIT(1)
+#define DISP_YTRIGGERED  BIT(2)
+#define DISP_VBLANK_IRQ  BIT(3)
+#define DISP_HBLANK_IRQ  BIT(4)
+#define DISP_YTRIGGER_IRQ BIT(5)
+
+#define MODE_0_2D 0x10000
+#define MODE_1_2D 0x10001
+#define MODE_2_2D 0x10002
+#define MODE_3_2D 0x10003
+#define MODE_4_2D 0x10004
+#define MODE_5_2D 0x10005
+#define MODE_6_2D 0x10006
+#define ENABLE_3D BIT(3)
+#define MODE_0_3D (MODE_0_2D | DISPLAY_BG0_ACTIVE | ENABLE_3D)
+#define MODE_1_3D (MODE_1_2D | DISPLAY_BG0_ACTIVE | ENABLE_3D)
+#define MODE_2_3D (MODE_2_2D | DISPLAY_BG0_ACTIVE | ENABLE_3D)
+#define MODE_3_3D (MODE_3_2D | DISPLAY_BG0_ACTIVE | ENABLE_3D)
+#define MODE_4_3D (MODE_4_2D | DISPLAY_BG0_ACTIVE | ENABLE_3D)
+#define MODE_5_3D (MODE_5_2D | DISPLAY_BG0_ACTIVE | ENABLE_3D)
+#define MODE_6_3D (MODE_6_2D | DISPLAY_BG0_ACTIVE | ENABLE_3D)
+#define MODE_FIFO (3 << 16)
+#define MODE_FB0 0x00020000
+#define MODE_FB1 0x00060000
+#define MODE_FB2 0x000A0000
+#define MODE_FB3 0x000E0000
+
+#define DISPLAY_BG0_ACTIVE BIT(8)
+#define DISPLAY_BG1_ACTIVE BIT(9)
+#define DISPLAY_BG2_ACTIVE BIT(10)
+#define DISPLAY_BG3_ACTIVE BIT(11)
+#define DISPLAY_SPR_ACTIVE BIT(12)
+#define DISPLAY_WIN0_ON    BIT(13)
+#define DISPLAY_WIN1_ON    BIT(14)
+#define DISPLAY_SPR_WIN_ON BIT(15)
+#define DISPLAY_SCREEN_OFF BIT(7)
+
+#define DISPLAY_SPR_HBLANK      BIT(23)
+#define DISPLAY_SPR_1D_LAYOUT   BIT(4)
+#define DISPLAY_SPR_1D          BIT(4)
+#define DISPLAY_SPR_2D          (0 << 4)
+#define DISPLAY_SPR_1D_BMP      (4 << 4)
+#define DISPLAY_SPR_2D_BMP_128  (0 << 4)
+#define DISPLAY_SPR_2D_BMP_256  (2 << 4)
+#define DISPLAY_SPR_1D_SIZE_32  (0 << 20)
+#define DISPLAY_SPR_1D_SIZE_64  (1 << 20)
+#define DISPLAY_SPR_1D_SIZE_128 (2 << 20)
+#define DISPLAY_SPR_1D_SIZE_256 (3 << 20)
+#define DISPLAY_SPR_1D_BMP_SIZE_128 (0 << 22)
+#define DISPLAY_SPR_1D_BMP_SIZE_256 (1 << 22)
+#define DISPLAY_SPR_EXT_PALETTE BIT(31)
+#define DISPLAY_BG_EXT_PALETTE  BIT(30)
+#define DISPLAY_CHAR_BASE(n)    (((n) & 7) << 24)
+#define DISPLAY_SCREEN_BASE(n)  (((n) & 7) << 27)
+
+#define POWER_LCD       BIT(0)
+#define POWER_2D_A      BIT(1)
+#define POWER_MATRIX    BIT(2)
+#define POWER_3D_CORE   BIT(3)
+#define POWER_2D_B      BIT(9)
+#define POWER_SWAP_LCDS BIT(15)
+#define POWER_ALL_2D    (POWER_LCD | POWER_2D_A | POWER_2D_B)
+#define POWER_ALL       (POWER_ALL_2D | POWER_3D_CORE | POWER_MATRIX)
+
+#define RGB15(r, g, b)    ((r) | ((g) << 5) | ((b) << 10))
+#define RGB5(r, g, b)     ((r) | ((g) << 5) | ((b) << 10))
+#define RGB8(r, g, b)     (((r) >> 3) | (((g) >> 3) << 5) | (((b) >> 3) << 10))
+#define ARGB16(a, r, g, b) (((a) << 15) | (r) | ((g) << 5) | ((b) << 10))
+
+#define SCREEN_WIDTH  256
+#define SCREEN_HEIGHT 192
+
+#define BG_PALETTE         ((u16*)0x05000000)
+#define SPRITE_PALETTE     ((u16*)0x05000200)
+#define BG_PALETTE_SUB     ((u16*)0x05000400)
+#define SPRITE_PALETTE_SUB ((u16*)0x05000600)
+
+#define BG_GFX         ((u16*)0x06000000)
+#define BG_GFX_SUB     ((u16*)0x06200000)
+#define SPRITE_GFX     ((u16*)0x06400000)
+#define SPRITE_GFX_SUB ((u16*)0x06600000)
+
+#define OAM     ((u16*)0x07000000)
+#define OAM_SUB ((u16*)0x07000400)
+
+// The banks at their LCD address
+#define VRAM_A ((u16*)0x06800000)
+#define VRAM_B ((u16*)0x06820000)
+#define VRAM_C ((u16*)0x06840000)
+#define VRAM_D ((u16*)0x06860000)
+#define VRAM_E ((u16*)0x06880000)
+#define VRAM_F ((u16*)0x06890000)
+#define VRAM_G ((u16*)0x06894000)
+#define VRAM_H ((u16*)0x06898000)
+#define VRAM_I ((u16*)0x068A0000)
+
+// The extended palettes, written with their bank in LCD mode
+typedef u16 _palette[256];
+typedef _palette _ext_palette[16];
+#define VRAM_E_EXT_PALETTE ((_ext_palette*)VRAM_E)
+#define VRAM_F_EXT_PALETTE ((_ext_palette*)VRAM_F)
+#define VRAM_G_EXT_PALETTE ((_ext_palette*)VRAM_G)
+#define VRAM_H_EXT_PALETTE ((_ext_palette*)VRAM_H)
+#define VRAM_F_EXT_SPR_PALETTE ((_palette*)VRAM_F)
+#define VRAM_G_EXT_SPR_PALETTE ((_palette*)VRAM_G)
+#define VRAM_I_EXT_SPR_PALETTE ((_palette*)VRAM_I)
+
+#define VRAM_CR   (*(vu32*)0x04000240)
+#define VRAM_EFG_CR (*(vu32*)0x04000244)
+#define VRAM_A_CR (*(vu8*)0x04000240)
+#define VRAM_B_CR (*(vu8*)0x04000241)
+#define VRAM_C_CR (*(vu8*)0x04000242)
+#define VRAM_D_CR (*(vu8*)0x04000243)
+#define VRAM_E_CR (*(vu8*)0x04000244)
+#define VRAM_F_CR (*(vu8*)0x04000245)
+#define VRAM_G_CR (*(vu8*)0x04000246)
+#define WRAM_CR   (*(vu8*)0x04000247)
+#define VRAM_H_CR (*(vu8*)0x04000248)
+#define VRAM_I_CR (*(vu8*)0x04000249)
+
+#define VRAM_ENABLE BIT(7)
+#define VRAM_OFFSET(n) ((n) << 3)
+
+typedef enum {
+	VRAM_A_LCD = 0,
+	VRAM_A_MAIN_BG = 1,
+	VRAM_A_MAIN_BG_0x06000000 = 1 | VRAM_OFFSET(0),
+	VRAM_A_MAIN_BG_0x06020000 = 1 | VRAM_OFFSET(1),
+	VRAM_A_MAIN_BG_0x06040000 = 1 | VRAM_OFFSET(2),
+	VRAM_A_MAIN_BG_0x06060000 = 1 | VRAM_OFFSET(3),
+	VRAM_A_MAIN_SPRITE = 2,
+	VRAM_A_MAIN_SPRITE_0x06400000 = 2 | VRAM_OFFSET(0),
+	VRAM_A_MAIN_SPRITE_0x06420000 = 2 | VRAM_OFFSET(1),
+	VRAM_A_TEXTURE = 3,
+	VRAM_A_TEXTURE_SLOT0 = 3 | VRAM_OFFSET(0),
+	VRAM_A_TEXTURE_SLOT1 = 3 | VRAM_OFFSET(1),
+	VRAM_A_TEXTURE_SLOT2 = 3 | VRAM_OFFSET(2),
+	VRAM_A_TEXTURE_SLOT3 = 3 | VRAM_OFFSET(3)
+} VRAM_A_TYPE;
+
+typedef enum {
+	VRAM_B_LCD = 0,
+	VRAM_B_MAIN_BG = 1 | VRAM_OFFSET(1),
+	VRAM_B_MAIN_BG_0x06000000 = 1 | VRAM_OFFSET(0),
+	VRAM_B_MAIN_BG_0x06020000 = 1 | VRAM_OFFSET(1),
+	VRAM_B_MAIN_BG_0x06040000 = 1 | VRAM_OFFSET(2),
+	VRAM_B_MAIN_BG_0x06060000 = 1 | VRAM_OFFSET(3),
+	VRAM_B_MAIN_SPRITE = 2,
+	VRAM_B_MAIN_SPRITE_0x06400000 = 2 | VRAM_OFFSET(0),
+	VRAM_B_MAIN_SPRITE_0x06420000 = 2 | VRAM_OFFSET(1),
+	VRAM_B_TEXTURE = 3 | VRAM_OFFSET(1),
+	VRAM_B_TEXTURE_SLOT0 = 3 | VRAM_OFFSET(0),
+	VRAM_B_TEXTURE_SLOT1 = 3 | VRAM_OFFSET(1),
+	VRAM_B_TEXTURE_SLOT2 = 3 | VRAM_OFFSET(2),
+	VRAM_B_TEXTURE_SLOT3 = 3 | VRAM_OFFSET(3)
+} VRAM_B_TYPE;
+
+typedef enum {
+	VRAM_C_LCD = 0,
+	VRAM_C_MAIN_BG = 1 | VRAM_OFFSET(2),
+	VRAM_C_MAIN_BG_0x06000000 = 1 | VRAM_OFFSET(0),
+	VRAM_C_MAIN_BG_0x06020000 = 1 | VRAM_OFFSET(1),
+	VRAM_C_MAIN_BG_0x06040000 = 1 | VRAM_OFFSET(2),
+	VRAM_C_MAIN_BG_0x06060000 = 1 | VRAM_OFFSET(3),
+	VRAM_C_ARM7 = 2,
+	VRAM_C_ARM7_0x06000000 = 2 | VRAM_OFFSET(0),
+	VRAM_C_ARM7_0x06020000 = 2 | VRAM_OFFSET(1),
+	VRAM_C_SUB_BG = 4,
+	VRAM_C_SUB_BG_0x06200000 = 4,
+	VRAM_C_TEXTURE = 3 | VRAM_OFFSET(2),
+	VRAM_C_TEXTURE_SLOT0 = 3 | VRAM_OFFSET(0),
+	VRAM_C_TEXTURE_SLOT1 = 3 | VRAM_OFFSET(1),
+	VRAM_C_TEXTURE_SLOT2 = 3 | VRAM_OFFSET(2),
+	VRAM_C_TEXTURE_SLOT3 = 3 | VRAM_OFFSET(3)
+} VRAM_C_TYPE;
+
+typedef enum {
+	VRAM_D_LCD = 0,
+	VRAM_D_MAIN_BG = 1 | VRAM_OFFSET(3),
+	VRAM_D_MAIN_BG_0x06000000 = 1 | VRAM_OFFSET(0),
+	VRAM_D_MAIN_BG_0x06020000 = 1 | VRAM_OFFSET(1),
+	VRAM_D_MAIN_BG_0x06040000 = 1 | VRAM_OFFSET(2),
+	VRAM_D_MAIN_BG_0x06060000 = 1 | VRAM_OFFSET(3),
+	VRAM_D_ARM7 = 2 | VRAM_OFFSET(1),
+	VRAM_D_ARM7_0x06000000 = 2 | VRAM_OFFSET(0),
+	VRAM_D_ARM7_0x06020000 = 2 | VRAM_OFFSET(1),
+	VRAM_D_SUB_SPRITE = 4,
+	VRAM_D_TEXTURE = 3 | VRAM_OFFSET(3),
+	VRAM_D_TEXTURE_SLOT0 = 3 | VRAM_OFFSET(0),
+	VRAM_D_TEXTURE_SLOT1 = 3 | VRAM_OFFSET(1),
+	VRAM_D_TEXTURE_SLOT2 = 3 | VRAM_OFFSET(2),
+	VRAM_D_TEXTURE_SLOT3 = 3 | VRAM_OFFSET(3)
+} VRAM_D_TYPE;
+
+typedef enum {
+	VRAM_E_LCD = 0,
+	VRAM_E_MAIN_BG = 1,
+	VRAM_E_MAIN_SPRITE = 2,
+	VRAM_E_TEX_PALETTE = 3,
+	VRAM_E_BG_EXT_PALETTE = 4
+} VRAM_E_TYPE;
+
+typedef enum {
+	VRAM_F_LCD = 0,
+	VRAM_F_MAIN_BG = 1,
+	VRAM_F_MAIN_BG_0x06000000 = 1 | VRAM_OFFSET(0),
+	VRAM_F_MAIN_BG_0x06004000 = 1 | VRAM_OFFSET(1),
+	VRAM_F_MAIN_BG_0x06010000 = 1 | VRAM_OFFSET(2),
+	VRAM_F_MAIN_BG_0x06014000 = 1 | VRAM_OFFSET(3),
+	VRAM_F_MAIN_SPRITE = 2,
+	VRAM_F_MAIN_SPRITE_0x06400000 = 2 | VRAM_OFFSET(0),
+	VRAM_F_MAIN_SPRITE_0x06404000 = 2 | VRAM_OFFSET(1),
+	VRAM_F_MAIN_SPRITE_0x06410000 = 2 | VRAM_OFFSET(2),
+	VRAM_F_MAIN_SPRITE_0x06414000 = 2 | VRAM_OFFSET(3),
+	VRAM_F_TEX_PALETTE = 3,
+	VRAM_F_TEX_PALETTE_SLOT0 = 3 | VRAM_OFFSET(0),
+	VRAM_F_TEX_PALETTE_SLOT1 = 3 | VRAM_OFFSET(1),
+	VRAM_F_TEX_PALETTE_SLOT4 = 3 | VRAM_OFFSET(2),
+	VRAM_F_TEX_PALETTE_SLOT5 = 3 | VRAM_OFFSET(3),
+	VRAM_F_BG_EXT_PALETTE = 4,
+	VRAM_F_BG_EXT_PALETTE_SLOT01 = 4 | VRAM_OFFSET(0),
+	VRAM_F_BG_EXT_PALETTE_SLOT23 = 4 | VRAM_OFFSET(1),
+	VRAM_F_SPRITE_EXT_PALETTE = 5
+} VRAM_F_TYPE;
+
+typedef enum {
+	VRAM_G_LCD = 0,
+	VRAM_G_MAIN_BG = 1,
+	VRAM_G_MAIN_BG_0x06000000 = 1 | VRAM_OFFSET(0),
+	VRAM_G_MAIN_BG_0x06004000 = 1 | VRAM_OFFSET(1),
+	VRAM_G_MAIN_BG_0x06010000 = 1 | VRAM_OFFSET(2),
+	VRAM_G_MAIN_BG_0x06014000 = 1 | VRAM_OFFSET(3),
+	VRAM_G_MAIN_SPRITE = 2,
+	VRAM_G_MAIN_SPRITE_0x06400000 = 2 | VRAM_OFFSET(0),
+	VRAM_G_MAIN_SPRITE_0x06404000 = 2 | VRAM_OFFSET(1),
+	VRAM_G_MAIN_SPRITE_0x06410000 = 2 | VRAM_OFFSET(2),
+	VRAM_G_MAIN_SPRITE_0x06414000 = 2 | VRAM_OFFSET(3),
+	VRAM_G_TEX_PALETTE = 3,
+	VRAM_G_TEX_PALETTE_SLOT0 = 3 | VRAM_OFFSET(0),
+	VRAM_G_TEX_PALETTE_SLOT1 = 3 | VRAM_OFFSET(1),
+	VRAM_G_TEX_PALETTE_SLOT4 = 3 | VRAM_OFFSET(2),
+	VRAM_G_TEX_PALETTE_SLOT5 = 3 | VRAM_OFFSET(3),
+	VRAM_G_BG_EXT_PALETTE = 4,
+	VRAM_G_BG_EXT_PALETTE_SLOT01 = 4 | VRAM_OFFSET(0),
+	VRAM_G_BG_EXT_PALETTE_SLOT23 = 4 | VRAM_OFFSET(1),
+	VRAM_G_SPRITE_EXT_PALETTE = 5
+} VRAM_G_TYPE;
+
+typedef enum {
+	VRAM_H_LCD = 0,
+	VRAM_H_SUB_BG = 1,
+	VRAM_H_SUB_BG_EXT_PALETTE = 2
+} VRAM_H_TYPE;
+
+typedef enum {
+	VRAM_I_LCD = 0,
+	VRAM_I_SUB_BG_0x06208000 = 1,
+	VRAM_I_SUB_SPRITE = 2,
+	VRAM_I_SUB_SPRITE_EXT_PALETTE = 3
+} VRAM_I_TYPE;
+
+void vramSetBankA(VRAM_A_TYPE a);
+void vramSetBankB(VRAM_B_TYPE b);
+void vramSetBankC(VRAM_C_TYPE c);
+void vramSetBankD(VRAM_D_TYPE d);
+void vramSetBankE(VRAM_E_TYPE e);
+void vramSetBankF(VRAM_F_TYPE f);
+void vramSetBankG(VRAM_G_TYPE g);
+void vramSetBankH(VRAM_H_TYPE h);
+void vramSetBankI(VRAM_I_TYPE i);
+u32 vramSetPrimaryBanks(VRAM_A_TYPE a, VRAM_B_TYPE b, VRAM_C_TYPE c, VRAM_D_TYPE d);
+u32 vramSetMainBanks(VRAM_A_TYPE a, VRAM_B_TYPE b, VRAM_C_TYPE c, VRAM_D_TYPE d);
+void vramRestorePrimaryBanks(u32 vramTemp);
+void vramRestoreMainBanks(u32 vramTemp);
+u32 vramSetBanks_EFG(VRAM_E_TYPE e, VRAM_F_TYPE f, VRAM_G_TYPE g);
+void vramRestoreBanks_EFG(u32 vramTemp);
+
+static inline void videoSetMode(u32 mode) { REG_DISPCNT = mode; }
+static inline void videoSetModeSub(u32 mode) { REG_DISPCNT_SUB = mode; }
+static inline u32 videoGetMode(void) { return REG_DISPCNT & 0x30007; }
+static inline u32 videoGetModeSub(void) { return REG_DISPCNT_SUB & 0x30007; }
+static inline void videoBgEnable(int number) { REG_DISPCNT |= 1 << (8 + number); }
+static inline void videoBgEnableSub(int number) { REG_DISPCNT_SUB |= 1 << (8 + number); }
+static inline void videoBgDisable(int number) { REG_DISPCNT &= ~(1 << (8 + number)); }
+static inline void videoBgDisableSub(int number) { REG_DISPCNT_SUB &= ~(1 << (8 + number)); }
+static inline void bgExtPaletteEnable(void) { REG_DISPCNT |= DISPLAY_BG_EXT_PALETTE; }
+static inline void bgExtPaletteEnableSub(void) { REG_DISPCNT_SUB |= DISPLAY_BG_EXT_PALETTE; }
+static inline void bgExtPaletteDisable(void) { REG_DISPCNT &= ~DISPLAY_BG_EXT_PALETTE; }
+static inline void bgExtPaletteDisableSub(void) { REG_DISPCNT_SUB &= ~DISPLAY_BG_EXT_PALETTE; }
+static inline void setBrightness(int screen, int level) {
+	int mode = 1 << 14;
+	if (level < 0) { level = -level; mode = 2 << 14; }
+	if (level > 16) level = 16;
+	if (screen & 1) REG_MASTER_BRIGHT = mode | level;
+	if (screen & 2) REG_MASTER_BRIGHT_SUB = mode | level;
+}
+
+static inline void powerOn(int bits) { if (bits & 0xFFFF) REG_POWERCNT |= bits & 0xFFFF; }
+static inline void powerOff(int bits) { if (bits & 0xFFFF) REG_POWERCNT &= ~(bits & 0xFFFF); }
+static inline void lcdSwap(void) { REG_POWERCNT ^= POWER_SWAP_LCDS; }
+static inline void lcdMainOnTop(void) { REG_POWERCNT |= POWER_SWAP_LCDS; }
+static inline void lcdMainOnBottom(void) { REG_POWERCNT &= ~POWER_SWAP_LCDS; }
+
+//////////////////////////////////////////////////////////////////////
+// Backgrounds, windows and blending
+//////////////////////////////////////////////////////////////////////
+
+#define BGCTRL     ((vu16*)0x04000008)
+#define BGCTRL_SUB ((vu16*)0x04001008)
+#define REG_BG0CNT (*(vu16*)0x04000008)
+#define REG_BG1CNT (*(vu16*)0x0400000A)
+#define REG_BG2CNT (*(vu16*)0x0400000C)
+#define REG_BG3CNT (*(vu16*)0x0400000E)
+#define REG_BG0CNT_SUB (*(vu16*)0x04001008)
+#define REG_BG1CNT_SUB (*(vu16*)0x0400100A)
+#define REG_BG2CNT_SUB (*(vu16*)0x0400100C)
+#define REG_BG3CNT_SUB (*(vu16*)0x0400100E)
+
+#define REG_BG0HOFS (*(vu16*)0x04000010)
+#define REG_BG0VOFS (*(vu16*)0x04000012)
+#define REG_BG1HOFS (*(vu16*)0x04000014)
+#define REG_BG1VOFS (*(vu16*)0x04000016)
+#define REG_BG2HOFS (*(vu16*)0x04000018)
+#define REG_BG2VOFS (*(vu16*)0x0400001A)
+#define REG_BG3HOFS (*(vu16*)0x0400001C)
+#define REG_BG3VOFS (*(vu16*)0x0400001E)
+#define REG_BG0HOFS_SUB (*(vu16*)0x04001010)
+#define REG_BG0VOFS_SUB (*(vu16*)0x04001012)
+#define REG_BG1HOFS_SUB (*(vu16*)0x04001014)
+#define REG_BG1VOFS_SUB (*(vu16*)0x04001016)
+#define REG_BG2HOFS_SUB (*(vu16*)0x04001018)
+#define REG_BG2VOFS_SUB (*(vu16*)0x0400101A)
+#define REG_BG3HOFS_SUB (*(vu16*)0x0400101C)
+#define REG_BG3VOFS_SUB (*(vu16*)0x0400101E)
+
+#define REG_BG2PA (*(vs16*)0x04000020)
+#define REG_BG2PB (*(vs16*)0x04000022)
+#define REG_BG2PC (*(vs16*)0x04000024)
+#define REG_BG2PD (*(vs16*)0x04000026)
+#define REG_BG2X  (*(vs32*)0x04000028)
+#define REG_BG2Y  (*(vs32*)0x0400002C)
+#define REG_BG3PA (*(vs16*)0x04000030)
+#define REG_BG3PB (*(vs16*)0x04000032)
+#define REG_BG3PC (*(vs16*)0x04000034)
+#define REG_BG3PD (*(vs16*)0x04000036)
+#define REG_BG3X  (*(vs32*)0x04000038)
+#define REG_BG3Y  (*(vs32*)0x0400003C)
+#define REG_BG2PA_SUB (*(vs16*)0x04001020)
+#define REG_BG2PB_SUB (*(vs16*)0x04001022)
+#define REG_BG2PC_SUB (*(vs16*)0x04001024)
+#define REG_BG2PD_SUB (*(vs16*)0x04001026)
+#define REG_BG2X_SUB  (*(vs32*)0x04001028)
+#define REG_BG2Y_SUB  (*(vs32*)0x0400102C)
+#define REG_BG3PA_SUB (*(vs16*)0x04001030)
+#define REG_BG3PB_SUB (*(vs16*)0x04001032)
+#define REG_BG3PC_SUB (*(vs16*)0x04001034)
+#define REG_BG3PD_SUB (*(vs16*)0x04001036)
+#define REG_BG3X_SUB  (*(vs32*)0x04001038)
+#define REG_BG3Y_SUB  (*(vs32*)0x0400103C)
+
+#define BG_TILE_BASE(base) ((base) << 2)
+#define BG_MAP_BASE(base)  ((base) << 8)
+#define BG_BMP_BASE(base)  ((base) << 8)
+#define BG_PRIORITY(n)     (n)
+#define BG_PRIORITY_0 0
+#define BG_PRIORITY_1 1
+#define BG_PRIORITY_2 2
+#define BG_PRIORITY_3 3
+#define BG_MOSAIC      BIT(6)
+#define BG_COLOR_16    0
+#define BG_COLOR_256   BIT(7)
+#define BG_WRAP_ON     BIT(13)
+#define BG_WRAP_OFF    0
+#define BG_32x32       (0 << 14)
+#define BG_64x32       (1 << 14)
+#define BG_32x64       (2 << 14)
+#define BG_64x64       (3 << 14)
+#define BG_RS_16x16    (0 << 14)
+#define BG_RS_32x32    (1 << 14)
+#define BG_RS_64x64    (2 << 14)
+#define BG_RS_128x128  (3 << 14)
+#define BG_BMP8_128x128  (BG_RS_16x16 | BG_COLOR_256)
+#define BG_BMP8_256x256  (BG_RS_32x32 | BG_COLOR_256)
+#define BG_BMP8_512x256  (BG_RS_64x64 | BG_COLOR_256)
+#define BG_BMP8_512x512  (BG_RS_128x128 | BG_COLOR_256)
+#define BG_BMP8_1024x512 BIT(14)
+#define BG_BMP8_512x1024 0
+#define BG_BMP16_128x128 (BG_RS_16x16 | BG_COLOR_256 | BIT(2))
+#define BG_BMP16_256x256 (BG_RS_32x32 | BG_COLOR_256 | BIT(2))
+#define BG_BMP16_512x256 (BG_RS_64x64 | BG_COLOR_256 | BIT(2))
+#define BG_BMP16_512x512 (BG_RS_128x128 | BG_COLOR_256 | BIT(2))
+#define BG_PALETTE_SLOT0 0
+#define BG_PALETTE_SLOT1 0
+#define BG_PALETTE_SLOT2 BIT(13)
+#define BG_PALETTE_SLOT3 BIT(13)
+
+#define REG_WIN0H   (*(vu16*)0x04000040)
+#define REG_WIN1H   (*(vu16*)0x04000042)
+#define REG_WIN0V   (*(vu16*)0x04000044)
+#define REG_WIN1V   (*(vu16*)0x04000046)
+#define REG_WININ   (*(vu16*)0x04000048)
+#define REG_WINOUT  (*(vu16*)0x0400004A)
+#define REG_MOSAIC  (*(vu16*)0x0400004C)
+#define REG_BLDCNT  (*(vu16*)0x04000050)
+#define REG_BLDALPHA (*(vu16*)0x04000052)
+#define REG_BLDY    (*(vu16*)0x04000054)
+#define REG_WIN0H_SUB   (*(vu16*)0x04001040)
+#define REG_WIN1H_SUB   (*(vu16*)0x04001042)
+#define REG_WIN0V_SUB   (*(vu16*)0x04001044)
+#define REG_WIN1V_SUB   (*(vu16*)0x04001046)
+#define REG_WININ_SUB   (*(vu16*)0x04001048)
+#define REG_WINOUT_SUB  (*(vu16*)0x0400104A)
+#define REG_MOSAIC_SUB  (*(vu16*)0x0400104C)
+#define REG_BLDCNT_SUB  (*(vu16*)0x04001050)
+#define REG_BLDALPHA_SUB (*(vu16*)0x04001052)
+#define REG_BLDY_SUB    (*(vu16*)0x04001054)
+
+#define BLEND_NONE         (0 << 6)
+#define BLEND_ALPHA        (1 << 6)
+#define BLEND_FADE_WHITE   (2 << 6)
+#define BLEND_FADE_BLACK   (3 << 6)
+#define BLEND_SRC_BG0      BIT(0)
+#define BLEND_SRC_BG1      BIT(1)
+#define BLEND_SRC_BG2      BIT(2)
+#define BLEND_SRC_BG3      BIT(3)
+#define BLEND_SRC_SPRITE   BIT(4)
+#define BLEND_SRC_BACKDROP BIT(5)
+#define BLEND_DST_BG0      BIT(8)
+#define BLEND_DST_BG1      BIT(9)
+#define BLEND_DST_BG2      BIT(10)
+#define BLEND_DST_BG3      BIT(11)
+#define BLEND_DST_SPRITE   BIT(12)
+#define BLEND_DST_BACKDROP BIT(13)
+
+//////////////////////////////////////////////////////////////////////
+// DMA
+//////////////////////////////////////////////////////////////////////
+
+#define DMA_SRC(n)  (*(vu32*)(0x040000B0 + ((n) * 12)))
+#define DMA_DEST(n) (*(vu32*)(0x040000B4 + ((n) * 12)))
+#define DMA_CR(n)   (*(vu32*)(0x040000B8 + ((n) * 12)))
+#define DMA_FILL(n) (*(vu32*)(0x040000E0 + ((n) * 4)))
+
+#define DMA_ENABLE     BIT(31)
+#define DMA_BUSY       BIT(31)
+#define DMA_IRQ_REQ    BIT(30)
+#define DMA_START_NOW  0
+#define DMA_START_CARD (5 << 27)
+#define DMA_START_HBL  BIT(29)
+#define DMA_START_VBL  BIT(27)
+#define DMA_START_FIFO (7 << 27)
+#define DMA_DISP_FIFO  (4 << 27)
+#define DMA_16_BIT     0
+#define DMA_32_BIT     BIT(26)
+#define DMA_REPEAT     BIT(25)
+#define DMA_SRC_INC    0
+#define DMA_SRC_DEC    BIT(23)
+#define DMA_SRC_FIX    BIT(24)
+#define DMA_DST_INC    0
+#define DMA_DST_DEC    BIT(21)
+#define DMA_DST_FIX    BIT(22)
+#define DMA_DST_RESET  (3 << 21)
+#define DMA_COPY_WORDS     (DMA_ENABLE | DMA_32_BIT | DMA_START_NOW)
+#define DMA_COPY_HALFWORDS (DMA_ENABLE | DMA_16_BIT | DMA_START_NOW)
+#define DMA_FIFO (DMA_ENABLE | DMA_32_BIT | DMA_DST_FIX | DMA_START_FIFO)
+
+// A DMA started now is done before dmaSetParams returns. The ones started
+// by the HBlank or the VBlank are done by HostFrame.
+void dmaSetParams(u8 channel, const void *src, void *dest, u32 ctrl);
+void dmaCopyWords(u8 channel, const void *src, void *dest, u32 size);
+void dmaCopyHalfWords(u8 channel, const void *src, void *dest, u32 size);
+void dmaFillWords(u32 value, void *dest, u32 size);
+void dmaFillHalfWords(u16 value, void *dest, u32 size);
+static inline void dmaCopy(const void *source, void *dest, u32 size) { dmaCopyHalfWords(3, source, dest, size); }
+static inline void dmaCopyWordsAsynch(u8 channel, const void *src, void *dest, u32 size) { dmaCopyWords(channel, src, dest, size); }
+static inline void dmaCopyHalfWordsAsynch(u8 channel, const void *src, void *dest, u32 size) { dmaCopyHalfWords(channel, src, dest, size); }
+static inline void dmaCopyAsynch(const void *source, void *dest, u32 size) { dmaCopyHalfWords(3, source, dest, size); }
+static inline int dmaBusy(u8 channel) { return (DMA_CR(channel) & DMA_BUSY) >> 31; }
+static inline void dmaStopSafe(u8 channel) { DMA_CR(channel) = 0; }
+
+//////////////////////////////////////////////////////////////////////
+// Timers
+//////////////////////////////////////////////////////////////////////
+
+#define TIMER_DATA(n) (*(vu16*)(0x04000100 + ((n) << 2)))
+#define TIMER_CR(n)   (*(vu16*)(0x04000102 + ((n) << 2)))
+#define TIMER0_DATA (*(vu16*)0x04000100)
+#define TIMER1_DATA (*(vu16*)0x04000104)
+#define TIMER2_DATA (*(vu16*)0x04000108)
+#define TIMER3_DATA (*(vu16*)0x0400010C)
+#define TIMER0_CR   (*(vu16*)0x04000102)
+#define TIMER1_CR   (*(vu16*)0x04000106)
+#define TIMER2_CR   (*(vu16*)0x0400010A)
+#define TIMER3_CR   (*(vu16*)0x0400010E)
+
+#define TIMER_ENABLE   BIT(7)
+#define TIMER_IRQ_REQ  BIT(6)
+#define TIMER_CASCADE  BIT(2)
+#define TIMER_DIV_1    0
+#define TIMER_DIV_64   1
+#define TIMER_DIV_256  2
+#define TIMER_DIV_1024 3
+#define TIMER_FREQ(n)      (-BUS_CLOCK / (n))
+#define TIMER_FREQ_64(n)   (-(BUS_CLOCK >> 6) / (n))
+#define TIMER_FREQ_256(n)  (-(BUS_CLOCK >> 8) / (n))
+#define TIMER_FREQ_1024(n) (-(BUS_CLOCK >> 10) / (n))
+
+//////////////////////////////////////////////////////////////////////
+// Interrupts
+//////////////////////////////////////////////////////////////////////
+
+#define REG_IME (*(vu32*)0x04000208)
+#define REG_IE  (*(vu32*)0x04000210)
+#define REG_IF  (*(vu32*)0x04000214)
+
+#define IRQ_VBLANK        BIT(0)
+#define IRQ_HBLANK        BIT(1)
+#define IRQ_VCOUNT        BIT(2)
+#define IRQ_TIMER0        BIT(3)
+#define IRQ_TIMER1        BIT(4)
+#define IRQ_TIMER2        BIT(5)
+#define IRQ_TIMER3        BIT(6)
+#define IRQ_NETWORK       BIT(7)
+#define IRQ_DMA0          BIT(8)
+#define IRQ_DMA1          BIT(9)
+#define IRQ_DMA2          BIT(10)
+#define IRQ_DMA3          BIT(11)
+#define IRQ_KEYS          BIT(12)
+#define IRQ_CART          BIT(13)
+#define IRQ_IPC_SYNC      BIT(16)
+#define IRQ_FIFO_EMPTY    BIT(17)
+#define IRQ_FIFO_NOT_EMPTY BIT(18)
+#define IRQ_CARD          BIT(19)
+#define IRQ_CARD_LINE     BIT(20)
+#define IRQ_GEOMETRY_FIFO BIT(21)
+#define IRQ_LID           BIT(22)
+#define IRQ_SPI           BIT(23)
+#define IRQ_WIFI          BIT(24)
+#define IRQ_ALL           (~0)
+#define IRQ_TIMER(n)      (1 << ((n) + 3))
+
+typedef void (*IntFn)(void);
+
+void irqInit(void);
+void irqSet(u32 irq, VoidFn handler);
+void irqClear(u32 irq);
+void irqEnable(u32 irq);
+void irqDisable(u32 irq);
+static inline u32 enterCriticalSection(void) { u32 ime = REG_IME; REG_IME = 0; return ime; }
+static inline void leaveCriticalSection(u32 ime) { REG_IME = ime; }
+
+// Both run a frame of HostFrame
+void swiWaitForVBlank(void);
+void cothread_yield_irq(u32 flags);
+static inline void cothread_yield(void) { }
+
+//////////////////////////////////////////////////////////////////////
+// Input
+//////////////////////////////////////////////////////////////////////
+
+#define REG_KEYINPUT (*(vu16*)0x04000130)
+#define REG_KEYCNT   (*(vu16*)0x04000132)
+
+typedef enum {
+	KEY_A = BIT(0),
+	KEY_B = BIT(1),
+	KEY_SELECT = BIT(2),
+	KEY_START = BIT(3),
+	KEY_RIGHT = BIT(4),
+	KEY_LEFT = BIT(5),
+	KEY_UP = BIT(6),
+	KEY_DOWN = BIT(7),
+	KEY_R = BIT(8),
+	KEY_L = BIT(9),
+	KEY_X = BIT(10),
+	KEY_Y = BIT(11),
+	KEY_TOUCH = BIT(12),
+	KEY_LID = BIT(13),
+	KEY_DEBUG = BIT(14)
+} KEYPAD_BITS;
+
+typedef struct touchPosition {
+	u16 rawx;
+	u16 rawy;
+	u16 px;
+	u16 py;
+	u16 z1;
+	u16 z2;
+} touchPosition;
+
+// The keys and the stylus are the ones given to HostSetInput
+void scanKeys(void);
+u32 keysCurrent(void);
+u32 keysHeld(void);
+u32 keysDown(void);
+u32 keysDownRepeat(void);
+u32 keysUp(void);
+void keysSetRepeat(u8 setDelay, u8 setRepeat);
+void touchRead(touchPosition *data);
+
+//////////////////////////////////////////////////////////////////////
+// Math hardware, done in C when its registers are written by these
+//////////////////////////////////////////////////////////////////////
+
+#define REG_DIVCNT          (*(vu16*)0x04000280)
+#define REG_DIV_NUMER       (*(vs64*)0x04000290)
+#define REG_DIV_NUMER_L     (*(vs32*)0x04000290)
+#define REG_DIV_NUMER_H     (*(vs32*)0x04000294)
+#define REG_DIV_DENOM       (*(vs64*)0x04000298)
+#define REG_DIV_DENOM_L     (*(vs32*)0x04000298)
+#define REG_DIV_DENOM_H     (*(vs32*)0x0400029C)
+#define REG_DIV_RESULT      (*(vs64*)0x040002A0)
+#define REG_DIV_RESULT_L    (*(vs32*)0x040002A0)
+#define REG_DIV_RESULT_H    (*(vs32*)0x040002A4)
+#define REG_DIVREM_RESULT   (*(vs64*)0x040002A8)
+#define REG_DIVREM_RESULT_L (*(vs32*)0x040002A8)
+#define REG_DIVREM_RESULT_H (*(vs32*)0x040002AC)
+#define REG_SQRTCNT         (*(vu16*)0x040002B0)
+#define REG_SQRT_RESULT     (*(vu32*)0x040002B4)
+#define REG_SQRT_PARAM      (*(vu64*)0x040002B8)
+#define REG_SQRT_PARAM_L    (*(vu32*)0x040002B8)
+#define REG_SQRT_PARAM_H    (*(vu32*)0x040002BC)
+
+#define DIV_64_64 2
+#define DIV_64_32 1
+#define DIV_32_32 0
+#define DIV_BUSY  BIT(15)
+#define SQRT_64   1
+#define SQRT_32   0
+#define SQRT_BUSY BIT(15)
+
+// Run the divider or the square root on what is in their registers
+void HostDivide(void);
+void HostSqrt(void);
+
+static inline void div32_asynch(s32 num, s32 den) { REG_DIVCNT = DIV_32_32; REG_DIV_NUMER_L = num; REG_DIV_DENOM_L = den; HostDivide(); }
+static inline s32 div32_result(void) { return REG_DIV_RESULT_L; }
+static inline s32 div32(s32 num, s32 den) { div32_asynch(num, den); return div32_result(); }
+static inline void mod32_asynch(s32 num, s32 den) { div32_asynch(num, den); }
+static inline s32 mod32_result(void) { return REG_DIVREM_RESULT_L; }
+static inline s32 mod32(s32 num, s32 den) { mod32_asynch(num, den); return mod32_result(); }
+static inline void div64_asynch(s64 num, s32 den) { REG_DIVCNT = DIV_64_32; REG_DIV_NUMER = num; REG_DIV_DENOM_L = den; HostDivide(); }
+static inline s32 div64_result(void) { return REG_DIV_RESULT_L; }
+static inline s32 div64(s64 num, s32 den) { div64_asynch(num, den); return div64_result(); }
+static inline void divf32_asynch(s32 num, s32 den) { div64_asynch((s64)num << 12, den); }
+static inline s32 divf32_result(void) { return REG_DIV_RESULT_L; }
+static inline s32 divf32(s32 num, s32 den) { divf32_asynch(num, den); return divf32_result(); }
+static inline s32 mulf32(s32 a, s32 b) { return (s32)(((s64)a * b) >> 12); }
+static inline void sqrt32_asynch(u32 a) { REG_SQRTCNT = SQRT_32; REG_SQRT_PARAM_L = a; HostSqrt(); }
+static inline u32 sqrt32_result(void) { return REG_SQRT_RESULT; }
+static inline u32 sqrt32(u32 a) { sqrt32_asynch(a); return sqrt32_result(); }
+static inline void sqrt64_asynch(u64 a) { REG_SQRTCNT = SQRT_64; REG_SQRT_PARAM = a; HostSqrt(); }
+static inline u32 sqrt64_result(void) { return REG_SQRT_RESULT; }
+static inline u32 sqrt64(u64 a) { sqrt64_asynch(a); return sqrt64_result(); }
+#define sqrtf32 nds_sqrtf32 // Not the sqrtf32 of the C library
+static inline void sqrtf32_asynch(s32 a) { sqrt64_asynch((u64)(s64)a << 12); }
+static inline s32 sqrtf32_result(void) { return REG_SQRT_RESULT; }
+static inline s32 sqrtf32(s32 a) { sqrtf32_asynch(a); return sqrtf32_result(); }
+
+#define inttof32(n)   ((n) * (1 << 12))
+#define f32toint(n)   ((n) / (1 << 12))
+#define floattof32(n) ((s32)((n) * (1 << 12)))
+#define f32tofloat(n) (((float)(n)) / (float)(1 << 12))
+
+//////////////////////////////////////////////////////////////////////
+// BIOS and cache
+//////////////////////////////////////////////////////////////////////
+
+s32 swiDivide(s32 numerator, s32 divisor);
+s32 swiRemainder(s32 numerator, s32 divisor);
+void swiDivMod(s32 numerator, s32 divisor, s32 *result, s32 *remainder);
+u16 swiSqrt(u32 value);
+void swiDelay(u32 duration);
+
+// No cache on a computer
+static inline void DC_FlushAll(void) { }
+static inline void DC_FlushRange(const void *base, u32 size) { (void)base; (void)size; }
+static inline void DC_InvalidateAll(void) { }
+static inline void DC_InvalidateRange(const void *base, u32 size) { (void)base; (void)size; }
+static inline void IC_InvalidateAll(void) { }
+static inline void IC_InvalidateRange(const void *base, u32 size) { (void)base; (void)size; }
+static inline void *memUncached(void *address) { return address; }
+static inline void *memCached(void *address) { return address; }
+
+//////////////////////////////////////////////////////////////////////
+// FIFO to the ARM7. There is no ARM7 here : messages are dropped, and
+// nothing ever comes back.
+//////////////////////////////////////////////////////////////////////
+
+#define FIFO_PM      0
+#define FIFO_SOUND   1
+#define FIFO_SYSTEM  2
+#define FIFO_MAXMOD  3
+#define FIFO_DSWIFI  4
+#define FIFO_STORAGE 5
+#define FIFO_FIRMWARE 6
+#define FIFO_RSVD_01 7
+#define FIFO_USER_01 8
+#define FIFO_USER_02 9
+#define FIFO_USER_03 10
+#define FIFO_USER_04 11
+#define FIFO_USER_05 12
+#define FIFO_USER_06 13
+#define FIFO_USER_07 14
+#define FIFO_USER_08 15
+
+typedef void (*FifoAddressHandlerFunc)(void *address, void *userdata);
+typedef void (*FifoValue32HandlerFunc)(u32 value32, void *userdata);
+typedef void (*FifoDatamsgHandlerFunc)(int num_bytes, void *userdata);
+
+bool fifoSendAddress(u32 channel, void *address);
+bool fifoSendValue32(u32 channel, u32 value32);
+bool fifoSendDatamsg(u32 channel, u32 num_bytes, u8 *data_array);
+bool fifoSetAddressHandler(u32 channel, FifoAddressHandlerFunc newhandler, void *userdata);
+bool fifoSetValue32Handler(u32 channel, FifoValue32HandlerFunc newhandler, void *userdata);
+bool fifoSetDatamsgHandler(u32 channel, FifoDatamsgHandlerFunc newhandler, void *userdata);
+bool fifoCheckAddress(u32 channel);
+bool fifoCheckValue32(u32 channel);
+bool fifoCheckDatamsg(u32 channel);
+void *fifoGetAddress(u32 channel);
+u32 fifoGetValue32(u32 channel);
+int fifoGetDatamsg(u32 channel, int buffersize, u8 *destbuffer);
+
+//////////////////////////////////////////////////////////////////////
+// System
+//////////////////////////////////////////////////////////////////////
+
+typedef enum {
+	PM_LED_ON = 0,
+	PM_LED_SLEEP = 1,
+	PM_LED_BLINK = 3
+} PM_LedStates;
+
+#define PM_SOUND_AMP        BIT(0)
+#define PM_SOUND_MUTE       BIT(1)
+#define PM_BACKLIGHT_BOTTOM BIT(2)
+#define PM_BACKLIGHT_TOP    BIT(3)
+#define PM_SYSTEM_PWR       BIT(6)
+#define PM_ARM9_DIRECT      BIT(16)
+#define PM_REQ_ON           (1 << 16)
+#define PM_REQ_OFF          (2 << 16)
+#define PM_REQ_LED          (3 << 16)
+#define PM_REQ_SLEEP        (4 << 16)
+#define PM_REQ_SLEEP_DISABLE (5 << 16)
+#define PM_REQ_SLEEP_ENABLE (6 << 16)
+#define PM_REQ_BATTERY      (7 << 16)
+
+static inline void ledBlink(PM_LedStates state) { (void)state; }
+static inline void systemSleep(void) { }
+static inline u32 getBatteryLevel(void) { return 15; }
+static inline bool isDSiMode(void) { return false; }
+
+// The user settings of the firmware, from HostPersonalData
+typedef struct {
+	u8 RESERVED0[2];
+	u8 theme;
+	u8 birthMonth;
+	u8 birthDay;
+	u8 RESERVED1[1];
+	s16 name[10];
+	u16 nameLen;
+	s16 message[26];
+	u16 messageLen;
+	u8 alarmHour;
+	u8 alarmMinute;
+	u8 RESERVED2[4];
+	u16 calX1, calY1;
+	u8 calX1px, calY1px;
+	u16 calX2, calY2;
+	u8 calX2px, calY2px;
+	struct {
+		unsigned language : 3;
+		unsigned gbaScreen : 1;
+		unsigned defaultBrightness : 2;
+		unsigned autoMode : 1;
+		unsigned RESERVED5 : 2;
+		unsigned settingsLost : 1;
+		unsigned RESERVED6 : 6;
+	} __attribute__((packed));
+	u16 RESERVED3;
+	u32 rtcOffset;
+	u32 RESERVED4;
+} __attribute__((packed)) PERSONAL_DATA;
+
+extern PERSONAL_DATA HostPersonalData;
+#define PersonalData (&HostPersonalData)
+
+// Slot 2 reads as nothing plugged in
+#define GBA_BUS ((vu16*)0x08000000)
+
+//////////////////////////////////////////////////////////////////////
+// 3D. The registers written one command after the other are not memory
+// on the DS but the geometry engine : here each write goes to the list of
+// HostGfxCommands, so what would be drawn can be read back.
+//////////////////////////////////////////////////////////////////////
+
+vu32 *HostGfxPort(u32 address);
+#define HOST_GFX_PORT(address) (*HostGfxPort(address))
+
+#define GFX_CONTROL           (*(vu16*)0x04000060)
+#define GFX_RDLINES_COUNT     (*(vu32*)0x04000320)
+#define GFX_EDGE_TABLE        ((vu16*)0x04000330)
+#define GFX_ALPHA_TEST        (*(vu32*)0x04000340)
+#define GFX_CLEAR_COLOR       (*(vu32*)0x04000350)
+#define GFX_CLEAR_DEPTH       (*(vu16*)0x04000354)
+#define GFX_FOG_COLOR         (*(vu32*)0x04000358)
+#define GFX_FOG_OFFSET        (*(vu32*)0x0400035C)
+#define GFX_FOG_TABLE         ((vu8*)0x04000360)
+#define GFX_TOON_TABLE        ((vu16*)0x04000380)
+#define GFX_STATUS            (*(vu32*)0x04000600)
+#define GFX_BUSY              (GFX_STATUS & BIT(27))
+#define GFX_POLYGON_RAM_USAGE (*(vu16*)0x04000604)
+#define GFX_VERTEX_RAM_USAGE  (*(vu16*)0x04000606)
+#define GFX_CUTOFF_DEPTH      (*(vu16*)0x04000610)
+
+#define GFX_FIFO              HOST_GFX_PORT(0x04000400)
+#define MATRIX_CONTROL        HOST_GFX_PORT(0x04000440)
+#define MATRIX_PUSH           HOST_GFX_PORT(0x04000444)
+#define MATRIX_POP            HOST_GFX_PORT(0x04000448)
+#define MATRIX_STORE          HOST_GFX_PORT(0x0400044C)
+#define MATRIX_RESTORE        HOST_GFX_PORT(0x04000450)
+#define MATRIX_IDENTITY       HOST_GFX_PORT(0x04000454)
+#define MATRIX_LOAD4x4        HOST_GFX_PORT(0x04000458)
+#define MATRIX_LOAD4x3        HOST_GFX_PORT(0x0400045C)
+#define MATRIX_MULT4x4        HOST_GFX_PORT(0x04000460)
+#define MATRIX_MULT4x3        HOST_GFX_PORT(0x04000464)
+#define MATRIX_MULT3x3        HOST_GFX_PORT(0x04000468)
+#define MATRIX_SCALE          HOST_GFX_PORT(0x0400046C)
+#define MATRIX_TRANSLATE      HOST_GFX_PORT(0x04000470)
+#define GFX_COLOR             HOST_GFX_PORT(0x04000480)
+#define GFX_NORMAL            HOST_GFX_PORT(0x04000484)
+#define GFX_TEX_COORD         HOST_GFX_PORT(0x04000488)
+#define GFX_VERTEX16          HOST_GFX_PORT(0x0400048C)
+#define GFX_VERTEX10          HOST_GFX_PORT(0x04000490)
+#define GFX_VERTEX_XY         HOST_GFX_PORT(0x04000494)
+#define GFX_VERTEX_XZ         HOST_GFX_PORT(0x04000498)
+#define GFX_VERTEX_YZ         HOST_GFX_PORT(0x0400049C)
+#define GFX_DIFF_AMBIENT      HOST_GFX_PORT(0x040004C0)
+#define GFX_SPECULAR_EMISSION HOST_GFX_PORT(0x040004C4)
+#define GFX_SHININESS         HOST_GFX_PORT(0x040004D0)
+#define GFX_POLY_FORMAT       HOST_GFX_PORT(0x040004A4)
+#define GFX_TEX_FORMAT        HOST_GFX_PORT(0x040004A8)
+#define GFX_PAL_FORMAT        HOST_GFX_PORT(0x040004AC)
+#define GFX_LIGHT_VECTOR      HOST_GFX_PORT(0x040004C8)
+#define GFX_LIGHT_COLOR       HOST_GFX_PORT(0x040004CC)
+#define GFX_BEGIN             HOST_GFX_PORT(0x04000500)
+#define GFX_END               HOST_GFX_PORT(0x04000504)
+#define GFX_FLUSH             HOST_GFX_PORT(0x04000540)
+#define GFX_VIEWPORT          HOST_GFX_PORT(0x04000580)
+
+typedef s16 t16;
+typedef s16 v16;
+typedef s16 v10;
+typedef s32 f32;
+typedef u16 rgb;
+typedef s32 fixed12d3;
+
+#define inttot16(n)   ((n) * (1 << 4))
+#define t16toint(n)   ((n) / (1 << 4))
+#define floattot16(n) ((t16)((n) * (1 << 4)))
+#define inttov16(n)   ((n) * (1 << 12))
+#define f32tov16(n)   (n)
+#define floattov16(n) ((v16)((n) * (1 << 12)))
+#define inttov10(n)   ((n) * (1 << 9))
+#define f32tov10(n)   ((v10)((n) >> 3))
+#define floattov10(n) ((n) > .998 ? 0x1FF : ((v10)((n) * (1 << 9))))
+#define TEXTURE_PACK(u, v) (((u) & 0xFFFF) | ((v) << 16))
+#define NORMAL_PACK(x, y, z) (((x) & 0x3FF) | (((y) & 0x3FF) << 10) | ((z) << 20))
+#define VERTEX_PACK(x, y) (((x) & 0xFFFF) | ((y) << 16))
+
+#define MAX_TEXTURES 2048
+
+typedef enum {
+	GL_TRIANGLES = 0,
+	GL_QUADS = 1,
+	GL_TRIANGLE = 0,
+	GL_QUAD = 1,
+	GL_TRIANGLE_STRIP = 2,
+	GL_QUAD_STRIP = 3
+} GL_GLBEGIN_ENUM;
+
+typedef enum {
+	GL_PROJECTION = 0,
+	GL_POSITION = 1,
+	GL_MODELVIEW = 2,
+	GL_TEXTURE = 3
+} GL_MATRIX_MODE_ENUM;
+
+typedef enum {
+	GL_AMBIENT = 1,
+	GL_DIFFUSE = 2,
+	GL_AMBIENT_AND_DIFFUSE = 3,
+	GL_SPECULAR = 4,
+	GL_SHININESS = 8,
+	GL_EMISSION = 0x10
+} GL_MATERIALS_ENUM;
+
+enum GL_GLENABLE_ENUM {
+	GL_TEXTURE_2D = BIT(0),
+	GL_TOON_HIGHLIGHT = BIT(1),
+	GL_BLEND = BIT(3),
+	GL_ANTIALIAS = BIT(4),
+	GL_OUTLINE = BIT(5),
+	GL_FOG_ONLY_ALPHA = BIT(6),
+	GL_FOG = BIT(7),
+	GL_COLOR_UNDERFLOW = BIT(12),
+	GL_POLY_OVERFLOW = BIT(13),
+	GL_CLEAR_BMP = BIT(14)
+};
+
+enum GL_TEXTURE_PARAM_ENUM {
+	GL_TEXTURE_WRAP_S = BIT(16),
+	GL_TEXTURE_WRAP_T = BIT(17),
+	GL_TEXTURE_FLIP_S = BIT(18),
+	GL_TEXTURE_FLIP_T = BIT(19),
+	GL_TEXTURE_COLOR0_TRANSPARENT = BIT(29),
+	TEXGEN_OFF = (0 << 30),
+	TEXGEN_TEXCOORD = (1 << 30),
+	TEXGEN_NORMAL = (int)(2U << 30),
+	TEXGEN_POSITION = (int)(3U << 30)
+};
+
+static inline void glFlush(u32 mode) { GFX_FLUSH = mode; }
+static inline void glMatrixMode(int mode) { MATRIX_CONTROL = mode; }
+static inline void glLoadIdentity(void) { MATRIX_IDENTITY = 0; }
+static inline void glPushMatrix(void) { MATRIX_PUSH = 0; }
+static inline void glPopMatrix(int num) { MATRIX_POP = num; }
+static inline void glEnable(int bits) { GFX_CONTROL |= bits; }
+static inline void glDisable(int bits) { GFX_CONTROL &= ~bits; }
+static inline void glClearDepth(fixed12d3 depth) { GFX_CLEAR_DEPTH = depth; }
+static inline void glAlphaFunc(int alphaThreshold) { GFX_ALPHA_TEST = alphaThreshold; }
+static inline void glViewport(u8 x1, u8 y1, u8 x2, u8 y2) { GFX_VIEWPORT = x1 | (y1 << 8) | (x2 << 16) | (y2 << 24); }
+static inline void glMaterialShinyness(void) { GFX_SHININESS = 0; }
+void glMaterialf(int mode, rgb color);
+void glInit(void);
+void glResetMatrixStack(void);
+void glRotateXi(int angle);
+void glRotateYi(int angle);
+void glRotateZi(int angle);
+void glOrthof32(s32 left, s32 right, s32 bottom, s32 top, s32 zNear, s32 zFar);
+void gluLookAtf32(s32 eyex, s32 eyey, s32 eyez, s32 lookAtx, s32 lookAty, s32 lookAtz, s32 upx, s32 upy, s32 upz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,15 @@
+// The DS Motion card on a computer : never found, everything reads 0
+#ifndef _HOST_NDSMOTION
+#define _HOST_NDSMOTION
+
+static inline int motion_init(void) { return 0; }
+static inline void motion_deinit(void) { }
+static inline signed int motion_read_x(void) { return 0; }
+static inline signed int motion_read_y(void) { return 0; }
+static inline signed int motion_read_z(void) { return 0; }
+static inline signed int motion_read_gyro(void) { return 0; }
+static inline int motion_acceleration_x(void) { return 0; }
+static inline int motion_acceleration_y(void) { return 0; }
+static inline int motion_acceleration_z(void) { return 0; }
+
+#endif
@@ -0,0 +1,2 @@
+// Part of nds.h here
+#include <nds.h>